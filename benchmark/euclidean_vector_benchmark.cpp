@@ -0,0 +1,539 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Benchmarks every operation of euclidean_vector from 2 to 10^7 dimensions. Each benchmark
+// reports the magnitudes it reads or writes as items, and their size as bytes.
+//
+// To catch regressions, save a baseline with the benchmark_baseline target and compare against
+// it with the benchmark_compare target, which fails if a benchmark got slower.
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/pairwise.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+#include <streambuf>
+#include <utility>
+#include <vector>
+
+namespace {
+	using comp6771::basic_euclidean_vector;
+	using comp6771::euclidean_vector;
+
+	// 2, 10, 100, ..., 10^7
+	auto dimensions(benchmark::internal::Benchmark* b) -> void {
+		b->RangeMultiplier(10)->Range(2, 10'000'000);
+	}
+
+	auto dimensions_of(benchmark::State const& state) -> int {
+		return static_cast<int>(state.range(0));
+	}
+
+	// Magnitudes that are not all the same, so that nothing can be folded
+	template<typename T = double>
+	auto make_vector(int dimensions, T seed = 1) -> basic_euclidean_vector<T> {
+		auto v = basic_euclidean_vector<T>(dimensions);
+		for (auto i = 0; i < dimensions; ++i) {
+			v[i] = seed + static_cast<T>(i % 17);
+		}
+		return v;
+	}
+
+	// <vectors> vectors of <T> read or written per iteration
+	template<typename T = double>
+	auto set_processed(benchmark::State& state, int vectors = 1) -> void {
+		auto const items = static_cast<std::int64_t>(state.iterations()) * state.range(0);
+		state.SetItemsProcessed(items);
+		state.SetBytesProcessed(items * vectors * static_cast<std::int64_t>(sizeof(T)));
+	}
+
+	// Discards everything written to it, so that operator<< is measured without any I/O
+	class null_buffer : public std::streambuf {
+	protected:
+		auto overflow(int_type c) -> int_type override {
+			return traits_type::not_eof(c);
+		}
+
+		auto xsputn(char const*, std::streamsize count) -> std::streamsize override {
+			return count;
+		}
+	};
+
+	// Constructors
+
+	auto bm_default_constructor(benchmark::State& state) -> void {
+		for (auto _ : state) {
+			auto v = euclidean_vector();
+			benchmark::DoNotOptimize(v);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+	BENCHMARK(bm_default_constructor);
+
+	auto bm_dimensions_constructor(benchmark::State& state) -> void {
+		for (auto _ : state) {
+			auto v = euclidean_vector(dimensions_of(state));
+			benchmark::DoNotOptimize(v);
+		}
+		set_processed(state);
+	}
+	BENCHMARK(bm_dimensions_constructor)->Apply(dimensions);
+
+	auto bm_magnitude_constructor(benchmark::State& state) -> void {
+		for (auto _ : state) {
+			auto v = euclidean_vector(dimensions_of(state), 4.0);
+			benchmark::DoNotOptimize(v);
+		}
+		set_processed(state);
+	}
+	BENCHMARK(bm_magnitude_constructor)->Apply(dimensions);
+
+	auto bm_iterator_constructor(benchmark::State& state) -> void {
+		auto const magnitudes = std::vector<double>(static_cast<std::size_t>(state.range(0)), 4.0);
+		for (auto _ : state) {
+			auto v = euclidean_vector(magnitudes.begin(), magnitudes.end());
+			benchmark::DoNotOptimize(v);
+		}
+		set_processed(state, 2);
+	}
+	BENCHMARK(bm_iterator_constructor)->Apply(dimensions);
+
+	// An initializer_list has a fixed size, so this covers the two sides of the small buffer
+	auto bm_initializer_list_constructor(benchmark::State& state) -> void {
+		for (auto _ : state) {
+			auto small = euclidean_vector{1.0, 2.0, 3.0, 4.0};
+			auto large = euclidean_vector{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0};
+			benchmark::DoNotOptimize(small);
+			benchmark::DoNotOptimize(large);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * 12);
+	}
+	BENCHMARK(bm_initializer_list_constructor);
+
+	// From a monotonic_buffer_resource, which never frees, so the cost is mostly initialisation
+	auto bm_allocator_constructor(benchmark::State& state) -> void {
+		auto buffer = std::vector<std::byte>(static_cast<std::size_t>(state.range(0)) * sizeof(double));
+		for (auto _ : state) {
+			auto arena = std::pmr::monotonic_buffer_resource(buffer.data(), buffer.size());
+			auto v = euclidean_vector(dimensions_of(state), 4.0, &arena);
+			benchmark::DoNotOptimize(v);
+		}
+		set_processed(state);
+	}
+	BENCHMARK(bm_allocator_constructor)->Apply(dimensions);
+
+	auto bm_expression_constructor(benchmark::State& state) -> void {
+		auto const a = make_vector(dimensions_of(state), 1.0);
+		auto const b = make_vector(dimensions_of(state), 2.0);
+		for (auto _ : state) {
+			auto v = euclidean_vector(a + b * 2.0);
+			benchmark::DoNotOptimize(v);
+		}
+		set_processed(state, 3);
+	}
+	BENCHMARK(bm_expression_constructor)->Apply(dimensions);
+
+	// Copy and move
+
+	auto bm_copy_constructor(benchmark::State& state) -> void {
+		auto const original = make_vector(dimensions_of(state));
+		for (auto _ : state) {
+			auto copy = original;
+			benchmark::DoNotOptimize(copy);
+		}
+		set_processed(state, 2);
+	}
+	BENCHMARK(bm_copy_constructor)->Apply(dimensions);
+
+	// Reuses the storage of <copy>, as the dimensions match
+	auto bm_copy_assignment(benchmark::State& state) -> void {
+		auto const original = make_vector(dimensions_of(state));
+		auto copy = euclidean_vector(dimensions_of(state));
+		for (auto _ : state) {
+			copy = original;
+			benchmark::DoNotOptimize(copy);
+			benchmark::ClobberMemory();
+		}
+		set_processed(state, 2);
+	}
+	BENCHMARK(bm_copy_assignment)->Apply(dimensions);
+
+	auto bm_move_constructor(benchmark::State& state) -> void {
+		auto v = make_vector(dimensions_of(state));
+		for (auto _ : state) {
+			auto moved = std::move(v);
+			benchmark::DoNotOptimize(moved);
+			v = std::move(moved);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+	BENCHMARK(bm_move_constructor)->Apply(dimensions);
+
+	auto bm_move_assignment(benchmark::State& state) -> void {
+		auto v = make_vector(dimensions_of(state));
+		auto w = make_vector(dimensions_of(state));
+		for (auto _ : state) {
+			w = std::move(v);
+			v = std::move(w);
+			benchmark::DoNotOptimize(v);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * 2);
+	}
+	BENCHMARK(bm_move_assignment)->Apply(dimensions);
+
+	// Subscripts
+
+	auto bm_subscript(benchmark::State& state) -> void {
+		auto const v = make_vector(dimensions_of(state));
+		for (auto _ : state) {
+			auto sum = 0.0;
+			for (auto i = 0; i < v.dimensions(); ++i) {
+				sum += v[i];
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		set_processed(state);
+	}
+	BENCHMARK(bm_subscript)->Apply(dimensions);
+
+	auto bm_at(benchmark::State& state) -> void {
+		auto const v = make_vector(dimensions_of(state));
+		for (auto _ : state) {
+			auto sum = 0.0;
+			for (auto i = 0; i < v.dimensions(); ++i) {
+				sum += v.at(i);
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		set_processed(state);
+	}
+	BENCHMARK(bm_at)->Apply(dimensions);
+
+	// Writes through the mutable subscript also update the squared norm once it is known
+	auto bm_mutable_subscript(benchmark::State& state) -> void {
+		auto v = make_vector(dimensions_of(state));
+		for (auto _ : state) {
+			for (auto i = 0; i < v.dimensions(); ++i) {
+				v[i] += 1.0;
+			}
+			benchmark::ClobberMemory();
+		}
+		set_processed(state);
+	}
+	BENCHMARK(bm_mutable_subscript)->Apply(dimensions);
+
+	auto bm_mutable_at(benchmark::State& state) -> void {
+		auto v = make_vector(dimensions_of(state));
+		for (auto _ : state) {
+			for (auto i = 0; i < v.dimensions(); ++i) {
+				v.at(i) += 1.0;
+			}
+			benchmark::ClobberMemory();
+		}
+		set_processed(state);
+	}
+	BENCHMARK(bm_mutable_at)->Apply(dimensions);
+
+	// Arithmetic
+
+	auto bm_add_assign(benchmark::State& state) -> void {
+		auto v = make_vector(dimensions_of(state), 1.0);
+		auto const w = make_vector(dimensions_of(state), 2.0);
+		for (auto _ : state) {
+			v += w;
+			benchmark::ClobberMemory();
+		}
+		set_processed(state, 3);
+	}
+	BENCHMARK(bm_add_assign)->Apply(dimensions);
+
+	auto bm_subtract_assign(benchmark::State& state) -> void {
+		auto v = make_vector(dimensions_of(state), 1.0);
+		auto const w = make_vector(dimensions_of(state), 2.0);
+		for (auto _ : state) {
+			v -= w;
+			benchmark::ClobberMemory();
+		}
+		set_processed(state, 3);
+	}
+	BENCHMARK(bm_subtract_assign)->Apply(dimensions);
+
+	// Alternates the factor so that the magnitudes stay finite
+	auto bm_multiply_assign(benchmark::State& state) -> void {
+		auto v = make_vector(dimensions_of(state));
+		auto factor = 2.0;
+		for (auto _ : state) {
+			v *= factor;
+			factor = 1.0 / factor;
+			benchmark::ClobberMemory();
+		}
+		set_processed(state, 2);
+	}
+	BENCHMARK(bm_multiply_assign)->Apply(dimensions);
+
+	auto bm_divide_assign(benchmark::State& state) -> void {
+		auto v = make_vector(dimensions_of(state));
+		auto factor = 2.0;
+		for (auto _ : state) {
+			v /= factor;
+			factor = 1.0 / factor;
+			benchmark::ClobberMemory();
+		}
+		set_processed(state, 2);
+	}
+	BENCHMARK(bm_divide_assign)->Apply(dimensions);
+
+	auto bm_add(benchmark::State& state) -> void {
+		auto const v = make_vector(dimensions_of(state), 1.0);
+		auto const w = make_vector(dimensions_of(state), 2.0);
+		for (auto _ : state) {
+			auto const sum = euclidean_vector(v + w);
+			benchmark::DoNotOptimize(sum);
+		}
+		set_processed(state, 3);
+	}
+	BENCHMARK(bm_add)->Apply(dimensions);
+
+	auto bm_subtract(benchmark::State& state) -> void {
+		auto const v = make_vector(dimensions_of(state), 1.0);
+		auto const w = make_vector(dimensions_of(state), 2.0);
+		for (auto _ : state) {
+			auto const difference = euclidean_vector(v - w);
+			benchmark::DoNotOptimize(difference);
+		}
+		set_processed(state, 3);
+	}
+	BENCHMARK(bm_subtract)->Apply(dimensions);
+
+	auto bm_multiply(benchmark::State& state) -> void {
+		auto const v = make_vector(dimensions_of(state));
+		for (auto _ : state) {
+			auto const product = euclidean_vector(v * 2.0);
+			benchmark::DoNotOptimize(product);
+		}
+		set_processed(state, 2);
+	}
+	BENCHMARK(bm_multiply)->Apply(dimensions);
+
+	auto bm_divide(benchmark::State& state) -> void {
+		auto const v = make_vector(dimensions_of(state));
+		for (auto _ : state) {
+			auto const quotient = euclidean_vector(v / 2.0);
+			benchmark::DoNotOptimize(quotient);
+		}
+		set_processed(state, 2);
+	}
+	BENCHMARK(bm_divide)->Apply(dimensions);
+
+	auto bm_negate(benchmark::State& state) -> void {
+		auto const v = make_vector(dimensions_of(state));
+		for (auto _ : state) {
+			auto const negation = euclidean_vector(-v);
+			benchmark::DoNotOptimize(negation);
+		}
+		set_processed(state, 2);
+	}
+	BENCHMARK(bm_negate)->Apply(dimensions);
+
+	// Evaluated in one pass into one allocation
+	auto bm_fused_expression(benchmark::State& state) -> void {
+		auto const a = make_vector(dimensions_of(state), 1.0);
+		auto const b = make_vector(dimensions_of(state), 2.0);
+		auto const c = make_vector(dimensions_of(state), 3.0);
+		for (auto _ : state) {
+			auto const result = euclidean_vector((a + b) * 2.0 - c);
+			benchmark::DoNotOptimize(result);
+		}
+		set_processed(state, 4);
+	}
+	BENCHMARK(bm_fused_expression)->Apply(dimensions);
+
+	// Utility functions
+
+	template<typename T>
+	auto bm_dot(benchmark::State& state) -> void {
+		auto const x = make_vector<T>(dimensions_of(state), 1);
+		auto const y = make_vector<T>(dimensions_of(state), 2);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::dot(x, y));
+		}
+		set_processed<T>(state, 2);
+	}
+	BENCHMARK_TEMPLATE(bm_dot, double)->Apply(dimensions);
+	BENCHMARK_TEMPLATE(bm_dot, float)->Apply(dimensions);
+
+	// What distance replaces: a temporary for x - y, then its norm
+	auto bm_distance_expression(benchmark::State& state) -> void {
+		auto const x = make_vector<double>(dimensions_of(state), 1);
+		auto const y = make_vector<double>(dimensions_of(state), 2);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(euclidean_vector(x - y)));
+		}
+		set_processed(state, 2);
+	}
+	BENCHMARK(bm_distance_expression)->Apply(dimensions);
+
+	template<typename T>
+	auto bm_distance(benchmark::State& state) -> void {
+		auto const x = make_vector<T>(dimensions_of(state), 1);
+		auto const y = make_vector<T>(dimensions_of(state), 2);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::distance(x, y));
+		}
+		set_processed<T>(state, 2);
+	}
+	BENCHMARK_TEMPLATE(bm_distance, double)->Apply(dimensions);
+	BENCHMARK_TEMPLATE(bm_distance, float)->Apply(dimensions);
+
+	auto bm_manhattan(benchmark::State& state) -> void {
+		auto const x = make_vector<double>(dimensions_of(state), 1);
+		auto const y = make_vector<double>(dimensions_of(state), 2);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::manhattan(x, y));
+		}
+		set_processed(state, 2);
+	}
+	BENCHMARK(bm_manhattan)->Apply(dimensions);
+
+	auto bm_chebyshev(benchmark::State& state) -> void {
+		auto const x = make_vector<double>(dimensions_of(state), 1);
+		auto const y = make_vector<double>(dimensions_of(state), 2);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::chebyshev(x, y));
+		}
+		set_processed(state, 2);
+	}
+	BENCHMARK(bm_chebyshev)->Apply(dimensions);
+
+	// Neither norm is cached, so every call reads both vectors once for all three sums
+	auto bm_cosine_similarity(benchmark::State& state) -> void {
+		auto const x = make_vector<double>(dimensions_of(state), 1);
+		auto const y = make_vector<double>(dimensions_of(state), 2);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::cosine_similarity(x, y));
+		}
+		set_processed(state, 2);
+	}
+	BENCHMARK(bm_cosine_similarity)->Apply(dimensions);
+
+	// Assigning an expression discards the squared norm, so every call computes it
+	template<typename T>
+	auto bm_euclidean_norm_cold(benchmark::State& state) -> void {
+		auto v = make_vector<T>(dimensions_of(state));
+		for (auto _ : state) {
+			v = v * 1;
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		}
+		set_processed<T>(state, 2);
+	}
+	BENCHMARK_TEMPLATE(bm_euclidean_norm_cold, double)->Apply(dimensions);
+	BENCHMARK_TEMPLATE(bm_euclidean_norm_cold, float)->Apply(dimensions);
+
+	// Every call after the first returns the cached norm
+	auto bm_euclidean_norm_warm(benchmark::State& state) -> void {
+		auto const v = make_vector(dimensions_of(state));
+		benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+	BENCHMARK(bm_euclidean_norm_warm)->Apply(dimensions);
+
+	// An online update: one magnitude changes, then the norm is read
+	auto bm_update_then_norm(benchmark::State& state) -> void {
+		auto v = make_vector(dimensions_of(state));
+		benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		auto i = 0;
+		for (auto _ : state) {
+			v[i] = 0.5 * i;
+			i = i + 1 == v.dimensions() ? 0 : i + 1;
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+	BENCHMARK(bm_update_then_norm)->Apply(dimensions);
+
+	// <vectors> vectors of <dimensions> dimensions, compared with every other
+	auto pairwise_sizes(benchmark::internal::Benchmark* b) -> void {
+		b->ArgNames({"vectors", "dimensions"})->Args({256, 128})->Args({1024, 256});
+	}
+
+	auto make_vectors(benchmark::State const& state, double seed) -> std::vector<euclidean_vector> {
+		auto vectors = std::vector<euclidean_vector>();
+		for (auto i = 0; i < state.range(0); ++i) {
+			vectors.push_back(make_vector(static_cast<int>(state.range(1)), seed + i));
+		}
+		return vectors;
+	}
+
+	auto set_pairs_processed(benchmark::State& state) -> void {
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0)
+		                        * state.range(0));
+	}
+
+	// The matrix pairwise_dot replaces: one call to dot per pair
+	auto bm_pairwise_dot_naive(benchmark::State& state) -> void {
+		auto const x = make_vectors(state, 1);
+		auto const y = make_vectors(state, 2);
+		auto result = std::vector<double>(x.size() * y.size());
+		for (auto _ : state) {
+			for (auto i = std::size_t{0}; i < x.size(); ++i) {
+				for (auto j = std::size_t{0}; j < y.size(); ++j) {
+					result[i * y.size() + j] = comp6771::dot(x[i], y[j]);
+				}
+			}
+			benchmark::DoNotOptimize(result.data());
+		}
+		set_pairs_processed(state);
+	}
+	BENCHMARK(bm_pairwise_dot_naive)->Apply(pairwise_sizes)->UseRealTime();
+
+	auto bm_pairwise_dot(benchmark::State& state) -> void {
+		auto const x = make_vectors(state, 1);
+		auto const y = make_vectors(state, 2);
+		auto result = std::vector<double>(x.size() * y.size());
+		for (auto _ : state) {
+			comp6771::pairwise_dot(x, y, result);
+			benchmark::DoNotOptimize(result.data());
+		}
+		set_pairs_processed(state);
+	}
+	BENCHMARK(bm_pairwise_dot)->Apply(pairwise_sizes)->UseRealTime();
+
+	// Only half of the matrix is computed
+	auto bm_pairwise_squared_distance_symmetric(benchmark::State& state) -> void {
+		auto const x = make_vectors(state, 1);
+		auto result = std::vector<double>(x.size() * x.size());
+		for (auto _ : state) {
+			comp6771::pairwise_squared_distance(x, x, result);
+			benchmark::DoNotOptimize(result.data());
+		}
+		set_pairs_processed(state);
+	}
+	BENCHMARK(bm_pairwise_squared_distance_symmetric)->Apply(pairwise_sizes)->UseRealTime();
+
+	auto bm_unit(benchmark::State& state) -> void {
+		auto v = make_vector(dimensions_of(state));
+		for (auto _ : state) {
+			v[0] = 1.0;
+			auto const u = comp6771::unit(v);
+			benchmark::DoNotOptimize(u);
+		}
+		set_processed(state, 3);
+	}
+	BENCHMARK(bm_unit)->Apply(dimensions);
+
+	auto bm_output(benchmark::State& state) -> void {
+		auto const v = make_vector(dimensions_of(state));
+		auto buffer = null_buffer();
+		auto os = std::ostream(&buffer);
+		for (auto _ : state) {
+			os << v;
+		}
+		set_processed(state);
+	}
+	BENCHMARK(bm_output)->Apply(dimensions);
+} // namespace
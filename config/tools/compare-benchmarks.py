@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+# Copyright (c) Christopher Di Bella.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# Compares two sets of Google Benchmark results written with --benchmark_out_format=json, and
+# exits with 1 if any benchmark in both got slower by more than the threshold.
+#
+# Usage: compare-benchmarks.py baseline.json current.json [--threshold 0.10]
+#
+# Results with repetitions are compared by their median, and otherwise by their only run.
+import argparse
+import json
+import sys
+
+
+def load(path):
+    """Returns {benchmark name: real time in nanoseconds}."""
+    with open(path) as f:
+        benchmarks = json.load(f)["benchmarks"]
+
+    scale = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+    runs = {}
+    medians = {}
+    for b in benchmarks:
+        time = b["real_time"] * scale[b.get("time_unit", "ns")]
+        if b.get("run_type") == "aggregate":
+            if b.get("aggregate_name") == "median":
+                medians[b["run_name"]] = time
+        else:
+            runs[b.get("run_name", b["name"])] = time
+    runs.update(medians)
+    return runs
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="fraction a time may grow by before it is a regression")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = []
+    width = max((len(name) for name in current), default=0)
+    print(f"{'benchmark':<{width}} {'baseline':>14} {'current':>14} {'change':>8}")
+    for name, time in current.items():
+        if name not in baseline:
+            print(f"{name:<{width}} {'-':>14} {time:>12.0f}ns {'new':>8}")
+            continue
+        change = time / baseline[name] - 1
+        marker = ""
+        if change > args.threshold:
+            regressions.append(name)
+            marker = "  <- slower"
+        print(f"{name:<{width}} {baseline[name]:>12.0f}ns {time:>12.0f}ns {change:>+8.1%}{marker}")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower than the baseline by more than "
+              f"{args.threshold:.0%}:")
+        for name in regressions:
+            print(f"    {name}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
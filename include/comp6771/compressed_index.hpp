@@ -0,0 +1,174 @@
+#ifndef COMP6771_COMPRESSED_INDEX_HPP
+#define COMP6771_COMPRESSED_INDEX_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+#include "comp6771/nearest_neighbours.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/*
+    Nearest-neighbour search over vectors stored in less than 8 bytes per magnitude, for when
+    reading the vectors from memory rather than computing with them limits a scan.
+
+    Distances are asymmetric: the query stays in double precision and only the stored vectors are
+    compressed, so the only error is in the stored vectors. Results can be re-ranked against the
+    original vectors, which recovers most of the recall lost to compression.
+*/
+namespace comp6771 {
+	enum class compression {
+		// 4 bytes per magnitude
+		float32,
+		// IEEE 754 half precision, 2 bytes per magnitude, for magnitudes within +/-65504
+		float16,
+		// The top half of a float32, 2 bytes per magnitude, with float32's range but 8 bits of
+		// precision
+		bfloat16,
+		// 1 byte per magnitude, scaled so the largest magnitude of each vector is 127
+		int8,
+		// 1 byte per subspace, naming the nearest of up to 256 centroids trained for that subspace
+		product_quantization,
+	};
+
+	[[nodiscard]] auto name(compression c) -> std::string_view;
+
+	struct pq_parameters {
+		// The magnitudes are split into this many contiguous subspaces of (nearly) equal size
+		int subspaces = 8;
+
+		// Centroids per subspace, at most 256
+		int centroids = 256;
+
+		// Iterations of k-means per subspace
+		int iterations = 20;
+
+		// Codebooks are trained on at most this many vectors
+		int training_size = 65536;
+
+		std::uint_fast32_t seed = 100;
+	};
+
+	class compressed_index {
+	public:
+		// Compresses a copy of <vectors>. Product quantization codebooks are trained on them.
+		// Throws euclidean_vector_error if <parameters> are not valid for product_quantization
+		compressed_index(euclidean_vector_batch const& vectors,
+		                 compression mode,
+		                 metric m = metric::l2,
+		                 pq_parameters parameters = {});
+
+		[[nodiscard]] auto size() const -> int;
+		[[nodiscard]] auto dimensions() const -> int;
+		[[nodiscard]] auto mode() const -> compression;
+		[[nodiscard]] auto distance_metric() const -> metric;
+
+		// Bytes stored for each vector, including its scale and norm
+		[[nodiscard]] auto bytes_per_vector() const -> std::size_t;
+
+		// The vector as stored
+		[[nodiscard]] auto decompress(int index) const -> euclidean_vector;
+
+		// The dot product of <query> with the stored vector at <index>
+		template<vector_expression E>
+		[[nodiscard]] auto dot(E const& query, int index) const -> double {
+			detail::dimensions_check(dimensions(), query.dimensions());
+			return with_magnitudes(query, [this, index](double const* magnitudes) {
+				return dot(magnitudes, index);
+			});
+		}
+
+		// The approximately <k> nearest vectors to <query> by the stored vectors, nearest first.
+		// Distances are the same as brute_force_index, but to the stored vectors.
+		// Throws euclidean_vector_error if <query> does not have dimensions() dimensions or <k> is
+		// negative
+		template<vector_expression E>
+		[[nodiscard]] auto search(E const& query, int k) const -> std::vector<neighbour> {
+			detail::dimensions_check(dimensions(), query.dimensions());
+			return with_magnitudes(query, [this, k](double const* magnitudes) {
+				return search(magnitudes, k);
+			});
+		}
+
+		// Finds the <candidates> nearest by the stored vectors, then returns the <k> of those that
+		// are nearest by <originals>, the vectors the index was built from, with exact distances.
+		// Throws euclidean_vector_error if <originals> does not match the index
+		template<vector_expression E>
+		[[nodiscard]] auto search(E const& query,
+		                          int k,
+		                          euclidean_vector_batch const& originals,
+		                          int candidates) const -> std::vector<neighbour> {
+			detail::dimensions_check(dimensions(), query.dimensions());
+			return with_magnitudes(query, [&, this](double const* magnitudes) {
+				return rerank(magnitudes, k, originals, candidates);
+			});
+		}
+
+	private:
+		compression mode_;
+		metric metric_;
+		int size_;
+		int dimensions_;
+
+		// Squared norm of each vector as stored
+		std::vector<float> squared_norms_;
+
+		// One of these holds the vectors, depending on mode_
+		std::vector<float> floats_;
+		std::vector<std::uint16_t> halves_;
+		std::vector<std::int8_t> bytes_;
+		std::vector<float> scales_;
+
+		// Product quantization: codes_[vector * subspaces + s] names a centroid of subspace s, and
+		// centroids_ holds the centroids of each subspace one after another
+		std::vector<std::uint8_t> codes_;
+		std::vector<double> centroids_;
+		std::vector<int> subspace_offsets_;
+		int centroid_count_ = 0;
+
+		template<vector_expression E, typename F>
+		static auto with_magnitudes(E const& query, F f) {
+			if constexpr (std::convertible_to<E, const_euclidean_vector_view>) {
+				return f(const_euclidean_vector_view(query).data());
+			}
+			else {
+				auto const magnitudes = static_cast<std::vector<double>>(query);
+				return f(magnitudes.data());
+			}
+		}
+
+		auto compress(euclidean_vector_batch const& vectors) -> void;
+		auto train(euclidean_vector_batch const& vectors, pq_parameters const& parameters) -> void;
+
+		[[nodiscard]] auto subspaces() const -> std::size_t;
+
+		// Centroid <c> of subspace <s>
+		[[nodiscard]] auto centroid(std::size_t s, std::size_t c) const -> double const*;
+
+		[[nodiscard]] auto dot(double const* query, int index) const -> double;
+
+		// Calls <f>(v, dot product of <query> with vector v) for each v in [first, last). <table> is
+		// the dot_table() of <query> for product quantization, otherwise unused.
+		template<typename F>
+		auto for_each_dot(double const* query,
+		                  std::vector<double> const& table,
+		                  std::size_t first,
+		                  std::size_t last,
+		                  F f) const -> void;
+
+		// For product quantization, the dot product of each subspace of <query> with each centroid
+		[[nodiscard]] auto dot_table(double const* query) const -> std::vector<double>;
+
+		[[nodiscard]] auto search(double const* query, int k) const -> std::vector<neighbour>;
+		[[nodiscard]] auto rerank(double const* query,
+		                          int k,
+		                          euclidean_vector_batch const& originals,
+		                          int candidates) const -> std::vector<neighbour>;
+	};
+} // namespace comp6771
+
+#endif // COMP6771_COMPRESSED_INDEX_HPP
@@ -1,11 +1,28 @@
 #ifndef COMP6771_EUCLIDEAN_VECTOR_HPP
 #define COMP6771_EUCLIDEAN_VECTOR_HPP
 
-#include <__functional_base>
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include "comp6771/instrumentation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <concepts>
 #include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <limits>
 #include <memory>
+#include <memory_resource>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
 
 #include <list>
 #include <vector>
@@ -17,107 +34,904 @@ namespace comp6771 {
 		: std::runtime_error(what) {}
 	};
 
-	class euclidean_vector {
+	// The element types of a basic_euclidean_vector. float halves the memory and bandwidth of
+	// double, and dot and euclidean_norm still accumulate it in double.
+	template<typename T>
+	concept magnitude_type = std::same_as<T, float> or std::same_as<T, double>;
+
+	template<magnitude_type T>
+	class basic_euclidean_vector;
+
+	using euclidean_vector = basic_euclidean_vector<double>;
+
+	namespace detail {
+		template<typename T>
+		inline constexpr bool is_euclidean_vector = false;
+
+		template<typename T>
+		inline constexpr bool is_euclidean_vector<basic_euclidean_vector<T>> = true;
+	} // namespace detail
+
+	// Expression templates
+
+	/* Specialise to true for types that are lazily evaluated euclidean_vector expressions. */
+	template<typename T>
+	inline constexpr bool enable_vector_expression = false;
+
+	/* Anything that has dimensions(), get_allocator() and a const operator[] yielding a float or
+	   double. */
+	template<typename T>
+	concept vector_expression = detail::is_euclidean_vector<T> or enable_vector_expression<T>;
+
+	namespace detail {
+		// Check if the two dimensions match, throw exception if not
+		auto dimensions_check(int lhs, int rhs) -> void;
+
+		// Throw exception if <factor> would divide by zero
+		auto division_check(double factor) -> void;
+
+		// <factor> rounded to <T>, throws exception if it does not fit in <T>. A factor that
+		// overflows to infinity or underflows to 0 would not round each magnitude, but replace it.
+		template<magnitude_type T>
+		auto scalar_cast(double factor) -> T;
+
+		// Throw exception if a vector with <dimensions> dimensions and euclidean norm <norm> has no
+		// unit vector
+		auto unit_check(int dimensions, double norm) -> void;
+
+		// Significant digits written for each magnitude, the same as an ostream's default precision
+		inline constexpr auto text_precision = 6;
+
+		// Writes <dimensions> magnitudes in the same form as euclidean_vector's operator<<
+		template<magnitude_type T>
+		auto write_magnitudes(std::ostream& os, T const* magnitudes, int dimensions) -> std::ostream&;
+
+		// Appends the magnitudes of the vector written at the start of [first, last) to
+		// <magnitudes>. On failure <magnitudes> is unchanged and ptr is <first>.
+		template<magnitude_type T>
+		auto parse_magnitudes(char const* first, char const* last, std::vector<T>& magnitudes)
+		   -> std::from_chars_result;
+
+		// Vectors are held by reference, nested expressions are held by value. This means an
+		// expression must not outlive the vectors it refers to.
+		template<typename E>
+		using expression_operand_t = std::conditional_t<is_euclidean_vector<E>, E const&, E>;
+
+		// The type of <E>'s magnitudes: float or double, and double if the two are mixed
+		template<typename E>
+		using magnitude_t = std::remove_cvref_t<decltype(std::declval<E const&>()[0])>;
+	} // namespace detail
+
+	// Vectors with at least this many dimensions are split into chunks that are evaluated, updated
+	// and reduced on default_thread_pool(). Chunks have a fixed size and partial sums are added in
+	// chunk order, so results do not depend on the number of threads.
+	[[nodiscard]] auto parallel_threshold() -> std::size_t;
+	auto set_parallel_threshold(std::size_t dimensions) -> void;
+
+	namespace detail {
+		// Magnitudes per chunk. Vectors of at most one chunk are never split.
+		inline constexpr auto parallel_chunk = std::size_t{1} << 16U;
+
+		[[nodiscard]] inline auto is_parallel(std::size_t size) -> bool {
+			return size > parallel_chunk and size >= parallel_threshold();
+		}
+
+		// Calls <body>(chunk, first, last) for each chunk of [0, size), in parallel
+		auto parallel_chunks(std::size_t size,
+		                     std::function<void(std::size_t, std::size_t, std::size_t)> const& body)
+		   -> void;
+
+		// Calls <body>(first, last) on ranges that cover [0, size), in parallel if <size> is at
+		// least parallel_threshold()
+		template<typename F>
+		auto for_each_chunk(std::size_t size, F body) -> void {
+			if (not is_parallel(size)) {
+				body(std::size_t{0}, size);
+				return;
+			}
+			parallel_chunks(size, [&body](std::size_t, std::size_t first, std::size_t last) {
+				body(first, last);
+			});
+		}
+
+		// The sum of <partial>(first, last) over ranges that cover [0, size), in chunk order
+		template<typename F>
+		auto reduce_chunks(std::size_t size, F partial) -> double {
+			if (not is_parallel(size)) {
+				return partial(std::size_t{0}, size);
+			}
+			auto sums = std::vector<double>((size + parallel_chunk - 1) / parallel_chunk);
+			parallel_chunks(size, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+				sums[chunk] = partial(first, last);
+			});
+			auto sum = 0.0;
+			for (auto const s : sums) {
+				sum += s;
+			}
+			return sum;
+		}
+
+		// The dispatched kernels, reduced with reduce_chunks. float is accumulated in double.
+		[[nodiscard]] auto dot(double const* x, double const* y, std::size_t size) -> double;
+		[[nodiscard]] auto dot(float const* x, float const* y, std::size_t size) -> double;
+		[[nodiscard]] auto dot(double const* x, float const* y, std::size_t size) -> double;
+		[[nodiscard]] auto dot(float const* x, double const* y, std::size_t size) -> double;
+		[[nodiscard]] auto sum_of_squares(double const* x, std::size_t size) -> double;
+		[[nodiscard]] auto sum_of_squares(float const* x, std::size_t size) -> double;
+	} // namespace detail
+
+	// Provides the explicit casts that euclidean_vector has to every expression
+	template<typename Derived>
+	class vector_expression_base {
+	public:
+		explicit operator std::vector<double>() const {
+			auto const& self = static_cast<Derived const&>(*this);
+			auto result = std::vector<double>(static_cast<std::size_t>(self.dimensions()));
+			for (auto i = 0; i < self.dimensions(); ++i) {
+				result[static_cast<std::size_t>(i)] = self[i];
+			}
+			return result;
+		}
+
+		explicit operator std::list<double>() const {
+			auto const as_vector = static_cast<std::vector<double>>(*this);
+			return std::list<double>(as_vector.begin(), as_vector.end());
+		}
+	};
+
+	// <lhs> op <rhs>, element by element
+	template<typename Op, vector_expression L, vector_expression R>
+	class vector_binary_expression : public vector_expression_base<vector_binary_expression<Op, L, R>> {
 	public:
+		vector_binary_expression(L const& lhs, R const& rhs)
+		: lhs_{lhs}
+		, rhs_{rhs} {
+			detail::dimensions_check(lhs.dimensions(), rhs.dimensions());
+		}
+
+		[[nodiscard]] auto dimensions() const -> int {
+			return lhs_.dimensions();
+		}
+
+		[[nodiscard]] auto get_allocator() const {
+			return lhs_.get_allocator();
+		}
+
+		auto operator[](int index) const {
+			return Op{}(lhs_[index], rhs_[index]);
+		}
+
+	private:
+		detail::expression_operand_t<L> lhs_;
+		detail::expression_operand_t<R> rhs_;
+	};
+
+	// <expression> op <scalar>, element by element. The scalar has the type of the magnitudes, so
+	// that an expression of floats stays in float.
+	template<typename Op, vector_expression E>
+	class vector_scalar_expression : public vector_expression_base<vector_scalar_expression<Op, E>> {
+	public:
+		vector_scalar_expression(E const& expression, detail::magnitude_t<E> scalar)
+		: expression_{expression}
+		, scalar_{scalar} {}
+
+		[[nodiscard]] auto dimensions() const -> int {
+			return expression_.dimensions();
+		}
+
+		[[nodiscard]] auto get_allocator() const {
+			return expression_.get_allocator();
+		}
+
+		auto operator[](int index) const {
+			return Op{}(expression_[index], scalar_);
+		}
+
+	private:
+		detail::expression_operand_t<E> expression_;
+		detail::magnitude_t<E> scalar_;
+	};
+
+	// op <expression>, element by element
+	template<typename Op, vector_expression E>
+	class vector_unary_expression : public vector_expression_base<vector_unary_expression<Op, E>> {
+	public:
+		explicit vector_unary_expression(E const& expression)
+		: expression_{expression} {}
+
+		[[nodiscard]] auto dimensions() const -> int {
+			return expression_.dimensions();
+		}
+
+		[[nodiscard]] auto get_allocator() const {
+			return expression_.get_allocator();
+		}
+
+		auto operator[](int index) const {
+			return Op{}(expression_[index]);
+		}
+
+	private:
+		detail::expression_operand_t<E> expression_;
+	};
+
+	template<typename Op, typename L, typename R>
+	inline constexpr bool enable_vector_expression<vector_binary_expression<Op, L, R>> = true;
+
+	template<typename Op, typename E>
+	inline constexpr bool enable_vector_expression<vector_scalar_expression<Op, E>> = true;
+
+	template<typename Op, typename E>
+	inline constexpr bool enable_vector_expression<vector_unary_expression<Op, E>> = true;
+
+	/*
+	    A euclidean vector of float or double magnitudes. comp6771::euclidean_vector is the double
+	    one. Vectors and expressions of float and double can be mixed, which gives double, but
+	    converting a vector from one element type to the other is explicit.
+	*/
+	template<magnitude_type T>
+	class basic_euclidean_vector {
+	public:
+		using value_type = T;
+
+		// Magnitudes that do not fit inline are allocated from this allocator's memory_resource
+		using allocator_type = std::pmr::polymorphic_allocator<T>;
+
+		// Returned by the mutable operator[] and at(). Writing a magnitude through it applies the
+		// change to the vector's squared norm, rather than discarding the norm.
+		class reference {
+		public:
+			reference(reference const&) = default;
+
+			operator T() const noexcept { // NOLINT(google-explicit-constructor)
+				return *magnitude_;
+			}
+
+			auto operator=(T magnitude) noexcept -> reference& {
+				vector_->update_squared_norm(*magnitude_, magnitude);
+				*magnitude_ = magnitude;
+				return *this;
+			}
+
+			// Assigns the magnitude, as T& would
+			auto operator=(reference const& other) noexcept -> reference& {
+				return *this = static_cast<T>(other);
+			}
+
+			auto operator+=(T x) noexcept -> reference& {
+				return *this = *magnitude_ + x;
+			}
+
+			auto operator-=(T x) noexcept -> reference& {
+				return *this = *magnitude_ - x;
+			}
+
+			auto operator*=(T x) noexcept -> reference& {
+				return *this = *magnitude_ * x;
+			}
+
+			auto operator/=(T x) noexcept -> reference& {
+				return *this = *magnitude_ / x;
+			}
+
+		private:
+			friend class basic_euclidean_vector;
+
+			reference(basic_euclidean_vector& vector, T& magnitude) noexcept
+			: vector_{&vector}
+			, magnitude_{&magnitude} {}
+
+			basic_euclidean_vector* vector_;
+			T* magnitude_;
+		};
+
 		// Constructors
-		euclidean_vector();
+		basic_euclidean_vector();
+		explicit basic_euclidean_vector(allocator_type const&);
 
-		explicit euclidean_vector(int);
+		explicit basic_euclidean_vector(int);
+		basic_euclidean_vector(int, allocator_type const&);
 
-		euclidean_vector(int, double);
+		basic_euclidean_vector(int, T);
+		basic_euclidean_vector(int, T, allocator_type const&);
 
-		euclidean_vector(std::vector<double>::const_iterator, std::vector<double>::const_iterator);
+		basic_euclidean_vector(typename std::vector<T>::const_iterator,
+		                       typename std::vector<T>::const_iterator);
+		basic_euclidean_vector(typename std::vector<T>::const_iterator,
+		                       typename std::vector<T>::const_iterator,
+		                       allocator_type const&);
 
 		// enclidean_vector{} will invoke the default constructor
-		euclidean_vector(std::initializer_list<double>);
+		basic_euclidean_vector(std::initializer_list<T>);
+		basic_euclidean_vector(std::initializer_list<T>, allocator_type const&);
+
+		// Evaluates an expression in a single pass with a single allocation, from the memory
+		// resource of the leftmost vector in the expression unless one is given. Explicit if the
+		// expression's magnitudes are of the other element type.
+		template<typename E>
+		requires enable_vector_expression<E>
+		explicit(not std::same_as<detail::magnitude_t<E>, T>)
+		   basic_euclidean_vector(E const&); // NOLINT(google-explicit-constructor)
+
+		template<typename E>
+		requires enable_vector_expression<E>
+		basic_euclidean_vector(E const&, allocator_type const&);
+
+		// Rounds or widens each magnitude of <other>, several at a time
+		template<magnitude_type U>
+		requires(not std::same_as<U, T>)
+		explicit basic_euclidean_vector(basic_euclidean_vector<U> const& other,
+		                                allocator_type const& allocator = {});
 
 		// Copy Constructor
-		euclidean_vector(euclidean_vector const&);
+		// As with the std::pmr containers, a copy uses the default memory resource unless one is
+		// given, so that it cannot outlive an arena it was copied out of.
+		basic_euclidean_vector(basic_euclidean_vector const&);
+		basic_euclidean_vector(basic_euclidean_vector const&, allocator_type const&);
 
 		// Move Constructor
-		euclidean_vector(euclidean_vector&&) noexcept;
+		basic_euclidean_vector(basic_euclidean_vector&&) noexcept;
+
+		// Only takes over the storage of <other> if the memory resources compare equal
+		basic_euclidean_vector(basic_euclidean_vector&&, allocator_type const&);
 
 		// Destructor
-		~euclidean_vector() = default;
+		~basic_euclidean_vector();
 
 		// Operator Overload
-		auto operator=(euclidean_vector const&) -> euclidean_vector&;
-		auto operator=(euclidean_vector&&) noexcept -> euclidean_vector&;
+		auto operator=(basic_euclidean_vector const&) -> basic_euclidean_vector&;
+		// The memory resource of a vector never changes once it has been constructed, so moving
+		// from a vector with a different one copies the magnitudes.
+		auto operator=(basic_euclidean_vector&&) -> basic_euclidean_vector&;
+
+		// Reuses the existing storage if the dimensions match
+		template<typename E>
+		requires enable_vector_expression<E> and std::same_as<detail::magnitude_t<E>, T>
+		auto operator=(E const&) -> basic_euclidean_vector&;
+
+		auto operator[](int const&) -> reference;
+		auto operator[](int const&) const -> const T&;
+
+		auto operator+() const& -> basic_euclidean_vector;
+		auto operator-() const& -> vector_unary_expression<std::negate<>, basic_euclidean_vector>;
+
+		// Reuse the storage of a temporary
+		auto operator+() && -> basic_euclidean_vector;
+		auto operator-() && -> basic_euclidean_vector;
 
-		auto operator[](int const&) -> double&;
-		auto operator[](int const&) const -> const double&;
+		auto operator+=(basic_euclidean_vector const&) -> basic_euclidean_vector&;
+		auto operator-=(basic_euclidean_vector const&) -> basic_euclidean_vector&;
+		auto operator*=(double) -> basic_euclidean_vector&;
+		auto operator/=(double) -> basic_euclidean_vector&;
 
-		auto operator+() const -> euclidean_vector;
-		auto operator-() const -> euclidean_vector;
+		template<typename E>
+		requires enable_vector_expression<E>
+		auto operator+=(E const&) -> basic_euclidean_vector&;
 
-		auto operator+=(euclidean_vector const&) -> euclidean_vector&;
-		auto operator-=(euclidean_vector const&) -> euclidean_vector&;
-		auto operator*=(double) -> euclidean_vector&;
-		auto operator/=(double) -> euclidean_vector&;
+		template<typename E>
+		requires enable_vector_expression<E>
+		auto operator-=(E const&) -> basic_euclidean_vector&;
 
-		explicit operator std::vector<double>() const;
-		explicit operator std::list<double>() const;
+		explicit operator std::vector<T>() const;
+		explicit operator std::list<T>() const;
 
 		// Member functions
-		[[nodiscard]] auto at(int) const -> double;
-		auto at(int) -> double&;
+		[[nodiscard]] auto at(int) const -> T;
+		auto at(int) -> reference;
 		[[nodiscard]] auto dimensions() const -> int;
+		[[nodiscard]] auto get_allocator() const -> allocator_type;
+
+		// Computes the norm exactly now, rather than when it is first read. Threads that share the
+		// vector afterwards only ever read the norm, so a const vector can be shared without
+		// copying it. Changing the vector keeps the norm up to date as usual.
+		auto freeze_norm() -> double;
 
 		// Friends
-		friend auto operator==(euclidean_vector const&, euclidean_vector const&) -> bool;
-		friend auto operator!=(euclidean_vector const&, euclidean_vector const&) -> bool;
-		friend auto operator+(euclidean_vector const&, euclidean_vector const&) -> euclidean_vector;
-		friend auto operator-(euclidean_vector const&, euclidean_vector const&) -> euclidean_vector;
-		friend auto operator*(euclidean_vector const&, double) -> euclidean_vector;
-		friend auto operator/(euclidean_vector const&, double) -> euclidean_vector;
-		friend auto operator<<(std::ostream&, euclidean_vector const&) -> std::ostream&;
+		friend auto operator==(basic_euclidean_vector const& first, basic_euclidean_vector const& second)
+		   -> bool {
+			return equal(first, second);
+		}
+
+		friend auto operator!=(basic_euclidean_vector const& first, basic_euclidean_vector const& second)
+		   -> bool {
+			return not equal(first, second);
+		}
+
+		friend auto operator<<(std::ostream& os, basic_euclidean_vector const& ev) -> std::ostream& {
+			return detail::write_magnitudes(os, ev.data(), ev.dimensions());
+		}
+
+		// Reads a vector in the form operator<< writes, setting failbit and leaving the vector
+		// unchanged if there is none
+		friend auto operator>>(std::istream& is, basic_euclidean_vector& ev) -> std::istream& {
+			return read(is, ev);
+		}
 
 	private:
-		// ass2 spec requires we use double[]
+		/* Vectors with at most this many dimensions are stored inline, without allocating. */
+		static constexpr std::size_t small_dimensions = 32 / sizeof(T);
+
+		std::pmr::memory_resource* resource_;
 
-		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
-		std::unique_ptr<double[]> magnitude_;
+		// ass2 spec requires we use double[]
+		// Allocated from resource_, only when there are more than small_dimensions magnitudes
+		T* magnitude_;
+		std::array<T, small_dimensions> small_magnitude_;
 		std::size_t dimensions_;
 
-		/* Stores the cached norm. -1 if the cache is invalid. */
-		mutable double cached_norm_;
+		/* The squared norm, kept up to date by writes and arithmetic once it has been computed. -1
+		   if it has to be computed again. Threads reading the same const vector may all compute it
+		   and store it, but they store the same value, so it only needs to be atomic, not ordered. */
+		mutable std::atomic<double> squared_norm_;
+		// A bound on how far squared_norm_ may have drifted from an exact recomputation. Only
+		// changed by non-const members, and 0 whenever squared_norm_ is -1.
+		double squared_norm_error_;
+
+		// Once the drift could exceed this fraction of the squared norm, it is computed again. Each
+		// update adds at least 2^-52 of the squared norm, so this is at most every 4096 updates.
+		static constexpr double squared_norm_tolerance = 0x1p-40;
+
+		// Magnitudes updated at a time by += and -=, which then add up their squares while they
+		// are still in cache
+		static constexpr std::size_t fused_block = 16384 / sizeof(T);
 
 		// Helper functions
 
+		// Only allocates if <dimensions> does not fit in small_magnitude_
+		[[nodiscard]] auto allocate(std::size_t dimensions) const -> T* {
+			if (dimensions <= small_dimensions) {
+				return nullptr;
+			}
+			instrumentation::add(instrumentation::counter::allocations);
+			instrumentation::add(instrumentation::counter::allocated_bytes, dimensions * sizeof(T));
+			return static_cast<T*>(resource_->allocate(dimensions * sizeof(T), alignof(T)));
+		}
+
+		auto deallocate() noexcept -> void {
+			if (magnitude_ != nullptr) {
+				instrumentation::add(instrumentation::counter::deallocations);
+				resource_->deallocate(magnitude_, dimensions_ * sizeof(T), alignof(T));
+				magnitude_ = nullptr;
+			}
+		}
+
+		[[nodiscard]] auto data() noexcept -> T* {
+			return dimensions_ > small_dimensions ? magnitude_ : small_magnitude_.data();
+		}
+
+		[[nodiscard]] auto data() const noexcept -> T const* {
+			return dimensions_ > small_dimensions ? magnitude_ : small_magnitude_.data();
+		}
+
 		// Swap the contents of two euclidea_vector
-		static auto swap(euclidean_vector& first, euclidean_vector& second) noexcept {
+		// Callers must make sure the memory resources compare equal.
+		static auto swap(basic_euclidean_vector& first, basic_euclidean_vector& second) noexcept {
+			std::swap(first.resource_, second.resource_);
 			std::swap(first.dimensions_, second.dimensions_);
 			std::swap(first.magnitude_, second.magnitude_);
-			std::swap(first.cached_norm_, second.cached_norm_);
+			std::swap(first.small_magnitude_, second.small_magnitude_);
+			auto const squared_norm = first.squared_norm();
+			auto const error = first.squared_norm_error_;
+			first.set_squared_norm(second.squared_norm(), second.squared_norm_error_);
+			second.set_squared_norm(squared_norm, error);
+		}
+
+		[[nodiscard]] auto squared_norm() const noexcept -> double {
+			return squared_norm_.load(std::memory_order_relaxed);
+		}
+
+		auto set_squared_norm(double squared_norm, double error) noexcept -> void {
+			squared_norm_.store(squared_norm, std::memory_order_relaxed);
+			squared_norm_error_ = error;
+		}
+
+		auto invalidate_squared_norm() noexcept -> void {
+			set_squared_norm(-1, 0);
 		}
 
-		auto invalidate_cached_norm() {
-			cached_norm_ = -1;
+		// Applies a change of one magnitude from <from> to <to> to the squared norm
+		auto update_squared_norm(T from, T to) noexcept -> void {
+			auto const squared_norm = this->squared_norm();
+			if (squared_norm < 0) {
+				return;
+			}
+			auto const before = static_cast<double>(from) * static_cast<double>(from);
+			auto const after = static_cast<double>(to) * static_cast<double>(to);
+			accept_squared_norm(squared_norm + (after - before),
+			                    squared_norm_error_
+			                       + std::numeric_limits<double>::epsilon()
+			                            * (squared_norm + before + after));
 		}
+
+		// Sets the squared norm, or discards it if it may have drifted too far from an exact
+		// recomputation
+		auto accept_squared_norm(double squared_norm, double error) noexcept -> void {
+			if (error <= squared_norm_tolerance * squared_norm) {
+				set_squared_norm(squared_norm, error);
+			}
+			else {
+				invalidate_squared_norm();
+			}
+		}
+
+		// Calls <update>(first, last) on ranges that cover the magnitudes. If the squared norm is
+		// being kept, it is computed again from each block of magnitudes as soon as it is updated.
+		template<typename F>
+		auto update_magnitudes(F update) -> void;
+
 		// Check if index in range, throw exception if not
-		static auto index_check(euclidean_vector const& ev, int index) -> void;
+		static auto index_check(basic_euclidean_vector const& ev, int index) -> void;
 
 		// Check if dimension of the two vectors matches, throw exception if not
-		static auto dimensions_check(euclidean_vector const& first, euclidean_vector const& second)
-		   -> void;
+		static auto dimensions_check(basic_euclidean_vector const& first,
+		                             basic_euclidean_vector const& second) -> void;
+
+		static auto equal(basic_euclidean_vector const& first, basic_euclidean_vector const& second)
+		   -> bool;
+		static auto read(std::istream& is, basic_euclidean_vector& ev) -> std::istream&;
 
-		static auto merge(euclidean_vector const& subject,
-		                  euclidean_vector const& other,
-		                  std::function<double(double, double)> const& func) -> void;
-		static auto scale(euclidean_vector const& ev,
-		                  double const& factor,
-		                  std::function<double(double, double)> const& func) -> void;
+		template<typename BinaryOperation>
+		static auto merge(basic_euclidean_vector& subject,
+		                  basic_euclidean_vector const& other,
+		                  BinaryOperation func) -> void;
+		template<typename BinaryOperation>
+		static auto scale(basic_euclidean_vector& ev, double factor, BinaryOperation func) -> void;
 
-		// Hidden friends
-		friend auto euclidean_norm(euclidean_vector const& v) -> double;
+		template<magnitude_type U>
+		friend class basic_euclidean_vector;
+
+		template<magnitude_type U>
+		friend auto squared_euclidean_norm(basic_euclidean_vector<U> const& v) -> double;
+
+		template<magnitude_type U>
+		friend auto cosine_similarity(basic_euclidean_vector<U> const& x,
+		                              basic_euclidean_vector<U> const& y) -> double;
 	};
 
+	extern template class basic_euclidean_vector<float>;
+	extern template class basic_euclidean_vector<double>;
+
+	// The const subscript is the leaf of every expression, so it lives here to be inlined.
+	template<magnitude_type T>
+	inline auto basic_euclidean_vector<T>::operator[](int const& index) const -> const T& {
+		assert(index >= 0 && index < dimensions());
+
+		return data()[static_cast<std::size_t>(index)];
+	}
+
+	template<magnitude_type T>
+	template<typename E>
+	requires enable_vector_expression<E>
+	basic_euclidean_vector<T>::basic_euclidean_vector(E const& expression)
+	: basic_euclidean_vector(expression, expression.get_allocator()) {}
+
+	template<magnitude_type T>
+	template<typename E>
+	requires enable_vector_expression<E>
+	basic_euclidean_vector<T>::basic_euclidean_vector(E const& expression,
+	                                                  allocator_type const& allocator)
+	: resource_{allocator.resource()}
+	, magnitude_{allocate(static_cast<std::size_t>(expression.dimensions()))}
+	, small_magnitude_{}
+	, dimensions_{static_cast<std::size_t>(expression.dimensions())}
+	, squared_norm_{-1}
+	, squared_norm_error_{0} {
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::evaluate);
+		auto* const magnitudes = data();
+		detail::for_each_chunk(dimensions_, [&](std::size_t first, std::size_t last) {
+			for (auto i = first; i < last; ++i) {
+				magnitudes[i] = static_cast<T>(expression[static_cast<int>(i)]);
+			}
+		});
+	}
+
+	template<magnitude_type T>
+	template<typename E>
+	requires enable_vector_expression<E> and std::same_as<detail::magnitude_t<E>, T>
+	auto basic_euclidean_vector<T>::operator=(E const& expression) -> basic_euclidean_vector& {
+		if (expression.dimensions() != dimensions()) {
+			auto other = basic_euclidean_vector(expression, get_allocator());
+			swap(*this, other);
+			return *this;
+		}
+
+		// Every element only depends on the same element of its operands, so it is safe to write
+		// over an operand while evaluating.
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::evaluate);
+		auto* const magnitudes = data();
+		detail::for_each_chunk(dimensions_, [&](std::size_t first, std::size_t last) {
+			for (auto i = first; i < last; ++i) {
+				magnitudes[i] = expression[static_cast<int>(i)];
+			}
+		});
+		invalidate_squared_norm();
+		return *this;
+	}
+
+	template<magnitude_type T>
+	template<typename F>
+	auto basic_euclidean_vector<T>::update_magnitudes(F update) -> void {
+		if (squared_norm() < 0) {
+			detail::for_each_chunk(dimensions_, update);
+			return;
+		}
+
+		auto const* const magnitudes = data();
+		auto const squared_norm = detail::reduce_chunks(dimensions_, [&](std::size_t first, std::size_t last) {
+			auto sum_of_squares = 0.0;
+			for (auto block = first; block < last; block += fused_block) {
+				auto const end = std::min(block + fused_block, last);
+				update(block, end);
+				sum_of_squares += kernels::sum_of_squares(magnitudes + block, end - block);
+			}
+			return sum_of_squares;
+		});
+		set_squared_norm(squared_norm, 0);
+	}
+
+	template<magnitude_type T>
+	template<typename E>
+	requires enable_vector_expression<E>
+	auto basic_euclidean_vector<T>::operator+=(E const& expression) -> basic_euclidean_vector& {
+		detail::dimensions_check(dimensions(), expression.dimensions());
+
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::arithmetic);
+		auto* const magnitudes = data();
+		update_magnitudes([&](std::size_t first, std::size_t last) {
+			for (auto i = first; i < last; ++i) {
+				magnitudes[i] += static_cast<T>(expression[static_cast<int>(i)]);
+			}
+		});
+		return *this;
+	}
+
+	template<magnitude_type T>
+	template<typename E>
+	requires enable_vector_expression<E>
+	auto basic_euclidean_vector<T>::operator-=(E const& expression) -> basic_euclidean_vector& {
+		detail::dimensions_check(dimensions(), expression.dimensions());
+
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::arithmetic);
+		auto* const magnitudes = data();
+		update_magnitudes([&](std::size_t first, std::size_t last) {
+			for (auto i = first; i < last; ++i) {
+				magnitudes[i] -= static_cast<T>(expression[static_cast<int>(i)]);
+			}
+		});
+		return *this;
+	}
+
+	// Arithmetic friends: these build expressions which are evaluated once assigned to a
+	// euclidean_vector, or consumed by dot or euclidean_norm.
+	template<vector_expression L, vector_expression R>
+	auto operator+(L const& lhs, R const& rhs) -> vector_binary_expression<std::plus<>, L, R> {
+		return {lhs, rhs};
+	}
+
+	template<vector_expression L, vector_expression R>
+	auto operator-(L const& lhs, R const& rhs) -> vector_binary_expression<std::minus<>, L, R> {
+		return {lhs, rhs};
+	}
+
+	template<vector_expression E>
+	auto operator*(E const& expression, double factor)
+	   -> vector_scalar_expression<std::multiplies<>, E> {
+		return {expression, detail::scalar_cast<detail::magnitude_t<E>>(factor)};
+	}
+
+	template<vector_expression E>
+	auto operator/(E const& expression, double factor)
+	   -> vector_scalar_expression<std::divides<>, E> {
+		detail::division_check(factor);
+		return {expression, detail::scalar_cast<detail::magnitude_t<E>>(factor)};
+	}
+
+	template<typename E>
+	requires enable_vector_expression<E>
+	auto operator-(E const& expression) -> vector_unary_expression<std::negate<>, E> {
+		return vector_unary_expression<std::negate<>, E>(expression);
+	}
+
+	// A temporary euclidean_vector operand is about to be destroyed, so the result is computed in
+	// its storage rather than allocated. These return a euclidean_vector, as an expression would
+	// refer to the destroyed temporary. The other operand must have the same element type, so that
+	// the result does not lose precision.
+	template<magnitude_type T, vector_expression R>
+	requires std::same_as<detail::magnitude_t<R>, T>
+	auto operator+(basic_euclidean_vector<T>&& lhs, R const& rhs) -> basic_euclidean_vector<T> {
+		lhs += rhs;
+		return std::move(lhs);
+	}
+
+	template<magnitude_type T, vector_expression L>
+	requires std::same_as<detail::magnitude_t<L>, T>
+	auto operator+(L const& lhs, basic_euclidean_vector<T>&& rhs) -> basic_euclidean_vector<T> {
+		rhs += lhs;
+		return std::move(rhs);
+	}
+
+	template<magnitude_type T, vector_expression R>
+	requires std::same_as<detail::magnitude_t<R>, T>
+	auto operator-(basic_euclidean_vector<T>&& lhs, R const& rhs) -> basic_euclidean_vector<T> {
+		lhs -= rhs;
+		return std::move(lhs);
+	}
+
+	template<magnitude_type T, vector_expression L>
+	requires std::same_as<detail::magnitude_t<L>, T>
+	auto operator-(L const& lhs, basic_euclidean_vector<T>&& rhs) -> basic_euclidean_vector<T> {
+		rhs = lhs - rhs;
+		return std::move(rhs);
+	}
+
+	// Both are temporaries, so the result reuses the left one
+	template<magnitude_type T>
+	auto operator+(basic_euclidean_vector<T>&& lhs, basic_euclidean_vector<T>&& rhs)
+	   -> basic_euclidean_vector<T>;
+	template<magnitude_type T>
+	auto operator-(basic_euclidean_vector<T>&& lhs, basic_euclidean_vector<T>&& rhs)
+	   -> basic_euclidean_vector<T>;
+
+	template<magnitude_type T>
+	auto operator*(basic_euclidean_vector<T>&& ev, double factor) -> basic_euclidean_vector<T>;
+	template<magnitude_type T>
+	auto operator/(basic_euclidean_vector<T>&& ev, double factor) -> basic_euclidean_vector<T>;
+
 	// Utility functions
 
-	/* Calling euclidean_norm invalidates any mutable references to the contents of the vector. */
-	auto euclidean_norm(euclidean_vector const& v) -> double;
-	auto unit(euclidean_vector const& v) -> euclidean_vector;
-	auto dot(euclidean_vector const& x, euclidean_vector const& y) -> double;
+	/* Computed once, then kept up to date as the vector changes. */
+	template<magnitude_type T>
+	auto euclidean_norm(basic_euclidean_vector<T> const& v) -> double;
+	// euclidean_norm(v) squared, from the same cache and without rounding through a square root
+	template<magnitude_type T>
+	auto squared_euclidean_norm(basic_euclidean_vector<T> const& v) -> double;
+	template<magnitude_type T>
+	auto unit(basic_euclidean_vector<T> const& v) -> basic_euclidean_vector<T>;
+	template<magnitude_type T>
+	auto unit(basic_euclidean_vector<T>&& v) -> basic_euclidean_vector<T>;
+	template<magnitude_type T>
+	auto dot(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y) -> double;
+
+	/* Each is a single pass over both vectors on the calling thread, without building x - y, so
+	   none of them allocate. */
+
+	// euclidean_norm(x - y)
+	template<magnitude_type T>
+	auto distance(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y) -> double;
+	template<magnitude_type T>
+	auto squared_distance(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y)
+	   -> double;
+	// dot(x, y) / (euclidean_norm(x) * euclidean_norm(y)), or 0 if either vector has no magnitude.
+	// Only the dot product is computed if both norms are cached.
+	template<magnitude_type T>
+	auto cosine_similarity(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y)
+	   -> double;
+	// The sum of |x[i] - y[i]|
+	template<magnitude_type T>
+	auto manhattan(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y) -> double;
+	// The largest |x[i] - y[i]|
+	template<magnitude_type T>
+	auto chebyshev(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y) -> double;
+
+	// Freezes the norm of each vector on default_thread_pool(), before sharing a dataset between
+	// threads
+	auto freeze_norms(std::span<basic_euclidean_vector<float>> vectors) -> void;
+	auto freeze_norms(std::span<basic_euclidean_vector<double>> vectors) -> void;
+
+	// Writes <expression> into [first, last) in the same form as operator<<, without allocating.
+	// Returns {last, std::errc::value_too_large} if it does not fit.
+	template<vector_expression E>
+	auto to_chars(char* first, char* last, E const& expression) -> std::to_chars_result {
+		auto const too_large = std::to_chars_result{last, std::errc::value_too_large};
+		if (first == last) {
+			return too_large;
+		}
+		*first++ = '[';
+		for (auto i = 0; i < expression.dimensions(); ++i) {
+			if (i > 0) {
+				if (first == last) {
+					return too_large;
+				}
+				*first++ = ' ';
+			}
+			auto const result = std::to_chars(first,
+			                                  last,
+			                                  expression[i],
+			                                  std::chars_format::general,
+			                                  detail::text_precision);
+			if (result.ec != std::errc{}) {
+				return result;
+			}
+			first = result.ptr;
+		}
+		if (first == last) {
+			return too_large;
+		}
+		*first++ = ']';
+		return {first, std::errc{}};
+	}
+
+	// Reads a vector in the form operator<< writes from the start of [first, last) into <v>. Like
+	// std::from_chars, leading whitespace is not skipped, and <v> is unchanged on failure.
+	template<magnitude_type T>
+	auto from_chars(char const* first, char const* last, basic_euclidean_vector<T>& v)
+	   -> std::from_chars_result;
+
+	namespace detail {
+		// Expressions whose magnitudes are contiguous in memory, which the kernels read directly
+		template<typename E>
+		concept contiguous_expression = is_euclidean_vector<E> or requires(E const& e) {
+			{ e.data() } -> std::convertible_to<magnitude_t<E> const*>;
+		};
+
+		template<contiguous_expression E>
+		auto magnitudes_of(E const& expression) -> magnitude_t<E> const* {
+			if constexpr (is_euclidean_vector<E>) {
+				return expression.dimensions() == 0 ? nullptr : &expression[0];
+			}
+			else {
+				return expression.data();
+			}
+		}
+	} // namespace detail
+
+	// Expressions are consumed in a single pass, without materialising a euclidean_vector.
+	template<typename E>
+	requires enable_vector_expression<E>
+	auto euclidean_norm(E const& expression) -> double {
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::euclidean_norm);
+		if constexpr (detail::contiguous_expression<E>) {
+			return std::sqrt(detail::sum_of_squares(detail::magnitudes_of(expression),
+			                                        static_cast<std::size_t>(expression.dimensions())));
+		}
+		else {
+			auto const size = static_cast<std::size_t>(expression.dimensions());
+			return std::sqrt(detail::reduce_chunks(size, [&](std::size_t first, std::size_t last) {
+				auto sum_of_squares = 0.0;
+				for (auto i = first; i < last; ++i) {
+					auto const magnitude = static_cast<double>(expression[static_cast<int>(i)]);
+					sum_of_squares += magnitude * magnitude;
+				}
+				return sum_of_squares;
+			}));
+		}
+	}
+
+	template<vector_expression X, vector_expression Y>
+	auto dot(X const& x, Y const& y) -> double {
+		detail::dimensions_check(x.dimensions(), y.dimensions());
+
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::dot);
+
+		if constexpr (detail::contiguous_expression<X> and detail::contiguous_expression<Y>) {
+			return detail::dot(detail::magnitudes_of(x),
+			                   detail::magnitudes_of(y),
+			                   static_cast<std::size_t>(x.dimensions()));
+		}
+		else {
+			auto const size = static_cast<std::size_t>(x.dimensions());
+			return detail::reduce_chunks(size, [&](std::size_t first, std::size_t last) {
+				auto dot_product = 0.0;
+				for (auto i = first; i < last; ++i) {
+					dot_product += static_cast<double>(x[static_cast<int>(i)])
+					               * static_cast<double>(y[static_cast<int>(i)]);
+				}
+				return dot_product;
+			});
+		}
+	}
+
+	// Evaluates <expression> once, into the vector that is returned
+	template<typename E>
+	requires enable_vector_expression<E>
+	auto unit(E const& expression) -> basic_euclidean_vector<detail::magnitude_t<E>> {
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::unit);
+		auto result = basic_euclidean_vector<detail::magnitude_t<E>>(expression);
+		auto const norm = euclidean_norm(result);
+		detail::unit_check(result.dimensions(), norm);
+		result /= norm;
+		return result;
+	}
 
 } // namespace comp6771
 #endif // COMP6771_EUCLIDEAN_VECTOR_HPP
@@ -0,0 +1,184 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_BATCH_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_BATCH_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+#include "comp6771/thread_pool.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+/*
+    Many euclidean vectors of the same dimension, stored row after row in a single 64-byte aligned
+    buffer rather than one heap block per vector.
+
+    Rows are accessed as views, which behave like a euclidean_vector for reading and writing.
+    Views, like iterators into a std::vector, are invalidated by anything that grows the batch.
+*/
+namespace comp6771 {
+	class euclidean_vector_batch {
+	public:
+		using allocator_type = std::pmr::polymorphic_allocator<double>;
+
+		// Alignment of the buffer, in bytes
+		static constexpr std::size_t alignment = 64;
+
+		// Constructors
+
+		// An empty batch of vectors with <dimensions> dimensions
+		explicit euclidean_vector_batch(int dimensions, allocator_type const& allocator = {});
+
+		// <size> vectors with <dimensions> dimensions, with every magnitude set to <magnitude>
+		euclidean_vector_batch(int size,
+		                       int dimensions,
+		                       double magnitude,
+		                       allocator_type const& allocator = {});
+
+		euclidean_vector_batch(euclidean_vector_batch const&);
+		euclidean_vector_batch(euclidean_vector_batch&&) noexcept;
+
+		~euclidean_vector_batch();
+
+		// Operator Overload
+		auto operator=(euclidean_vector_batch const&) -> euclidean_vector_batch&;
+		auto operator=(euclidean_vector_batch&&) -> euclidean_vector_batch&;
+
+		auto operator[](int) -> euclidean_vector_view;
+		auto operator[](int) const -> const_euclidean_vector_view;
+
+		// Row by row
+		auto operator+=(euclidean_vector_batch const&) -> euclidean_vector_batch&;
+		auto operator-=(euclidean_vector_batch const&) -> euclidean_vector_batch&;
+
+		// Adds or subtracts the same vector to every row
+		template<vector_expression E>
+		auto operator+=(E const& expression) -> euclidean_vector_batch&;
+		template<vector_expression E>
+		auto operator-=(E const& expression) -> euclidean_vector_batch&;
+
+		auto operator*=(double) -> euclidean_vector_batch&;
+		auto operator/=(double) -> euclidean_vector_batch&;
+
+		// Member functions
+		[[nodiscard]] auto at(int) -> euclidean_vector_view;
+		[[nodiscard]] auto at(int) const -> const_euclidean_vector_view;
+
+		// Number of vectors
+		[[nodiscard]] auto size() const -> int;
+		[[nodiscard]] auto empty() const -> bool;
+		[[nodiscard]] auto capacity() const -> int;
+		[[nodiscard]] auto dimensions() const -> int;
+
+		[[nodiscard]] auto data() -> double*;
+		[[nodiscard]] auto data() const -> double const*;
+
+		[[nodiscard]] auto get_allocator() const -> allocator_type;
+
+		auto reserve(int capacity) -> void;
+
+		// New vectors have all magnitudes set to 0.0
+		auto resize(int size) -> void;
+
+		auto clear() -> void;
+
+		// Throws euclidean_vector_error if <expression> does not have dimensions() dimensions
+		template<vector_expression E>
+		auto push_back(E const& expression) -> void;
+
+	private:
+		std::pmr::memory_resource* resource_;
+		double* magnitudes_;
+		std::size_t size_;
+		std::size_t capacity_;
+		std::size_t dimensions_;
+
+		// Helper functions
+		[[nodiscard]] auto row(std::size_t index) -> double*;
+		[[nodiscard]] auto row(std::size_t index) const -> double const*;
+
+		// Reallocate to fit <capacity> rows, keeping the current rows
+		auto reallocate(std::size_t capacity) -> void;
+
+		auto deallocate() noexcept -> void;
+
+		// Grow geometrically to fit one more row
+		auto grow() -> void;
+
+		auto index_check(int index) const -> void;
+
+		static auto size_check(euclidean_vector_batch const& first, euclidean_vector_batch const& second)
+		   -> void;
+
+		// Adds <sign> * <magnitudes> to every row
+		auto broadcast_add(std::vector<double> const& magnitudes, double sign) -> void;
+	};
+
+	// Utility functions
+
+	// Row by row
+	auto dot(euclidean_vector_batch const& x, euclidean_vector_batch const& y) -> std::vector<double>;
+
+	// Every row with the same vector
+	auto dot(euclidean_vector_batch const& x, const_euclidean_vector_view y) -> std::vector<double>;
+
+	template<vector_expression E>
+	requires(not std::convertible_to<E, const_euclidean_vector_view>)
+	auto dot(euclidean_vector_batch const& x, E const& y) -> std::vector<double>;
+
+	auto euclidean_norm(euclidean_vector_batch const& batch) -> std::vector<double>;
+
+	// Throws euclidean_vector_error if any row has no unit vector
+	auto unit(euclidean_vector_batch const& batch) -> euclidean_vector_batch;
+
+	// Reads every vector in <text>, each in the form euclidean_vector's operator<< writes and
+	// separated by whitespace. Large texts are split between vectors and parsed in parallel.
+	// Throws euclidean_vector_error if <text> holds anything else or the vectors do not all have the
+	// same dimensions
+	auto parse_vectors(std::string_view text) -> euclidean_vector_batch;
+	auto parse_vectors(std::string_view text, thread_pool& pool) -> euclidean_vector_batch;
+
+	template<vector_expression E>
+	auto euclidean_vector_batch::operator+=(E const& expression) -> euclidean_vector_batch& {
+		broadcast_add(static_cast<std::vector<double>>(expression), 1);
+		return *this;
+	}
+
+	template<vector_expression E>
+	auto euclidean_vector_batch::operator-=(E const& expression) -> euclidean_vector_batch& {
+		broadcast_add(static_cast<std::vector<double>>(expression), -1);
+		return *this;
+	}
+
+	template<vector_expression E>
+	auto euclidean_vector_batch::push_back(E const& expression) -> void {
+		detail::dimensions_check(dimensions(), expression.dimensions());
+
+		// <expression> may read from a row of this batch, which growing would invalidate
+		if (size_ == capacity_) {
+			auto const magnitudes = static_cast<std::vector<double>>(expression);
+			grow();
+			std::copy(magnitudes.begin(), magnitudes.end(), row(size_));
+			++size_;
+			return;
+		}
+
+		auto* const magnitudes = row(size_);
+		for (auto i = 0; i < expression.dimensions(); ++i) {
+			magnitudes[static_cast<std::size_t>(i)] = expression[i];
+		}
+		++size_;
+	}
+
+	template<vector_expression E>
+	requires(not std::convertible_to<E, const_euclidean_vector_view>)
+	auto dot(euclidean_vector_batch const& x, E const& y) -> std::vector<double> {
+		auto const magnitudes = static_cast<std::vector<double>>(y);
+		return dot(x, const_euclidean_vector_view(magnitudes.data(), y.dimensions()));
+	}
+} // namespace comp6771
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_BATCH_HPP
@@ -0,0 +1,174 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_KERNELS_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/*
+    Reduction kernels behind dot and euclidean_norm, and the element-wise kernels behind the
+    arithmetic operators.
+
+    Each reduction keeps several independent accumulators so that the loop is bound by throughput
+    rather than by the latency of a single add chain. The widest kernel the host supports is
+    selected the first time a kernel is used, so a single binary runs the best one everywhere.
+
+    Kernels sum in different orders, so results may differ in the last few bits between hosts.
+*/
+namespace comp6771::kernels {
+	enum class instruction_set { scalar, avx2, avx512 };
+
+	// The instruction set that dot and sum_of_squares dispatch to on this host
+	[[nodiscard]] auto selected_instruction_set() -> instruction_set;
+
+	// Whether this host (and this build) can run the kernel for <isa>
+	[[nodiscard]] auto is_supported(instruction_set isa) -> bool;
+
+	[[nodiscard]] auto name(instruction_set isa) -> std::string_view;
+
+	// Dispatched to the selected instruction set
+	[[nodiscard]] auto dot(double const* x, double const* y, std::size_t size) -> double;
+	[[nodiscard]] auto sum_of_squares(double const* x, std::size_t size) -> double;
+
+	// Run a specific kernel, throws euclidean_vector_error if it is not supported
+	[[nodiscard]] auto dot(instruction_set isa, double const* x, double const* y, std::size_t size)
+	   -> double;
+	[[nodiscard]] auto sum_of_squares(instruction_set isa, double const* x, std::size_t size)
+	   -> double;
+
+	// Each float is widened to double before it is multiplied, so these accumulate in double
+	[[nodiscard]] auto dot(float const* x, float const* y, std::size_t size) -> double;
+	[[nodiscard]] auto sum_of_squares(float const* x, std::size_t size) -> double;
+
+	[[nodiscard]] auto dot(instruction_set isa, float const* x, float const* y, std::size_t size)
+	   -> double;
+	[[nodiscard]] auto sum_of_squares(instruction_set isa, float const* x, std::size_t size) -> double;
+
+	// to[i] = static_cast<To>(from[i]) for each of <size> magnitudes
+	auto convert(double const* from, float* to, std::size_t size) -> void;
+	auto convert(float const* from, double* to, std::size_t size) -> void;
+
+	auto convert(instruction_set isa, double const* from, float* to, std::size_t size) -> void;
+	auto convert(instruction_set isa, float const* from, double* to, std::size_t size) -> void;
+
+	// x[i] += y[i], x[i] -= y[i], x[i] *= factor and x[i] /= factor for each of <size> magnitudes,
+	// rounded exactly as the scalar operators would. The vector kernels align their main loop to
+	// <x> and mask the last partial vector.
+	auto add(double* x, double const* y, std::size_t size) -> void;
+	auto subtract(double* x, double const* y, std::size_t size) -> void;
+	auto multiply(double* x, double factor, std::size_t size) -> void;
+	auto divide(double* x, double factor, std::size_t size) -> void;
+	auto add(float* x, float const* y, std::size_t size) -> void;
+	auto subtract(float* x, float const* y, std::size_t size) -> void;
+	auto multiply(float* x, float factor, std::size_t size) -> void;
+	auto divide(float* x, float factor, std::size_t size) -> void;
+
+	auto add(instruction_set isa, double* x, double const* y, std::size_t size) -> void;
+	auto subtract(instruction_set isa, double* x, double const* y, std::size_t size) -> void;
+	auto multiply(instruction_set isa, double* x, double factor, std::size_t size) -> void;
+	auto divide(instruction_set isa, double* x, double factor, std::size_t size) -> void;
+	auto add(instruction_set isa, float* x, float const* y, std::size_t size) -> void;
+	auto subtract(instruction_set isa, float* x, float const* y, std::size_t size) -> void;
+	auto multiply(instruction_set isa, float* x, float factor, std::size_t size) -> void;
+	auto divide(instruction_set isa, float* x, float factor, std::size_t size) -> void;
+
+	// x[0] * y[indices[0]] + ... + x[size - 1] * y[indices[size - 1]], the dot product of a sparse
+	// vector with a dense <y>
+	[[nodiscard]] auto dot_gather(double const* x, int const* indices, std::size_t size, double const* y)
+	   -> double;
+	[[nodiscard]] auto dot_gather(instruction_set isa,
+	                              double const* x,
+	                              int const* indices,
+	                              std::size_t size,
+	                              double const* y) -> double;
+
+	// Distances between <x> and <y> in a single pass, without computing x - y first:
+	// sum((x[i] - y[i])^2), sum(|x[i] - y[i]|) and max(|x[i] - y[i]|)
+	[[nodiscard]] auto squared_distance(double const* x, double const* y, std::size_t size) -> double;
+	[[nodiscard]] auto manhattan(double const* x, double const* y, std::size_t size) -> double;
+	[[nodiscard]] auto chebyshev(double const* x, double const* y, std::size_t size) -> double;
+	[[nodiscard]] auto squared_distance(float const* x, float const* y, std::size_t size) -> double;
+	[[nodiscard]] auto manhattan(float const* x, float const* y, std::size_t size) -> double;
+	[[nodiscard]] auto chebyshev(float const* x, float const* y, std::size_t size) -> double;
+
+	[[nodiscard]] auto
+	squared_distance(instruction_set isa, double const* x, double const* y, std::size_t size)
+	   -> double;
+	[[nodiscard]] auto manhattan(instruction_set isa, double const* x, double const* y, std::size_t size)
+	   -> double;
+	[[nodiscard]] auto chebyshev(instruction_set isa, double const* x, double const* y, std::size_t size)
+	   -> double;
+	[[nodiscard]] auto
+	squared_distance(instruction_set isa, float const* x, float const* y, std::size_t size) -> double;
+	[[nodiscard]] auto manhattan(instruction_set isa, float const* x, float const* y, std::size_t size)
+	   -> double;
+	[[nodiscard]] auto chebyshev(instruction_set isa, float const* x, float const* y, std::size_t size)
+	   -> double;
+
+	struct dot_products {
+		double xy;
+		double xx;
+		double yy;
+	};
+
+	// x . y, x . x and y . y in a single pass, for the cosine of the angle between <x> and <y>
+	[[nodiscard]] auto dot_and_squares(double const* x, double const* y, std::size_t size)
+	   -> dot_products;
+	[[nodiscard]] auto dot_and_squares(float const* x, float const* y, std::size_t size)
+	   -> dot_products;
+
+	[[nodiscard]] auto
+	dot_and_squares(instruction_set isa, double const* x, double const* y, std::size_t size)
+	   -> dot_products;
+	[[nodiscard]] auto
+	dot_and_squares(instruction_set isa, float const* x, float const* y, std::size_t size)
+	   -> dot_products;
+
+	// The block of dot products behind pairwise matrices. <a> holds tile_rows vectors and <b>
+	// tile_columns vectors of <depth> magnitudes, interleaved so that a[k * tile_rows + i] is
+	// magnitude k of vector i. Writes the dot product of vector i of <a> with vector j of <b> to
+	// tile[i * tile_columns + j].
+	inline constexpr auto tile_rows = std::size_t{4};
+	inline constexpr auto tile_columns = std::size_t{8};
+
+	auto dot_tile(double const* a, double const* b, std::size_t depth, double* tile) -> void;
+	auto dot_tile(instruction_set isa, double const* a, double const* b, std::size_t depth, double* tile)
+	   -> void;
+
+	// As dot_tile, but writes the sum of the squared differences of each pair of vectors, which
+	// unlike expanding it through their dot product does not cancel far from the origin
+	auto squared_distance_tile(double const* a, double const* b, std::size_t depth, double* tile)
+	   -> void;
+	auto squared_distance_tile(instruction_set isa,
+	                           double const* a,
+	                           double const* b,
+	                           std::size_t depth,
+	                           double* tile) -> void;
+
+	// Dot products of a double <x> with a compressed <y>, each magnitude of <y> widened to double
+	[[nodiscard]] auto dot(double const* x, float const* y, std::size_t size) -> double;
+	[[nodiscard]] auto dot(double const* x, std::int8_t const* y, std::size_t size) -> double;
+	[[nodiscard]] auto dot_float16(double const* x, std::uint16_t const* y, std::size_t size)
+	   -> double;
+	[[nodiscard]] auto dot_bfloat16(double const* x, std::uint16_t const* y, std::size_t size)
+	   -> double;
+
+	[[nodiscard]] auto dot(instruction_set isa, double const* x, float const* y, std::size_t size)
+	   -> double;
+	[[nodiscard]] auto dot(instruction_set isa, double const* x, std::int8_t const* y, std::size_t size)
+	   -> double;
+	[[nodiscard]] auto
+	dot_float16(instruction_set isa, double const* x, std::uint16_t const* y, std::size_t size)
+	   -> double;
+	[[nodiscard]] auto
+	dot_bfloat16(instruction_set isa, double const* x, std::uint16_t const* y, std::size_t size)
+	   -> double;
+
+	// IEEE 754 half precision and bfloat16, rounding to nearest even
+	[[nodiscard]] auto to_float16(float value) -> std::uint16_t;
+	[[nodiscard]] auto from_float16(std::uint16_t half) -> float;
+	[[nodiscard]] auto to_bfloat16(float value) -> std::uint16_t;
+	[[nodiscard]] auto from_bfloat16(std::uint16_t bfloat) -> float;
+} // namespace comp6771::kernels
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_KERNELS_HPP
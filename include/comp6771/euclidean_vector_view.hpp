@@ -0,0 +1,206 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_VIEW_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_VIEW_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <string>
+
+/*
+    Non-owning views of contiguous magnitudes, like std::span.
+
+    Views take part in euclidean_vector expressions, so they can be mixed with euclidean_vectors in
+    arithmetic, dot, euclidean_norm and unit, and compared, printed or converted the same way.
+    Copying or assigning a view never copies the magnitudes it refers to, and a view does not
+    keep them alive.
+
+    Views wrap magnitudes the library does not own, such as a std::vector<double>, a network
+    buffer or a row of a larger matrix, so they can be used without copying them into a
+    euclidean_vector. Comparing, printing, dot and euclidean_norm all read a view's magnitudes in
+    place.
+*/
+namespace comp6771 {
+	class euclidean_vector_view;
+	class const_euclidean_vector_view;
+
+	namespace detail {
+		// Throws the same exception as euclidean_vector::at()
+		inline auto view_index_check(int index, int dimensions) -> void {
+			if (index < 0 or index >= dimensions) {
+				throw euclidean_vector_error("Index " + std::to_string(index)
+				                             + " is not valid for this euclidean_vector object");
+			}
+		}
+
+		template<typename T>
+		concept euclidean_vector_view_type =
+		   std::same_as<T, euclidean_vector_view> or std::same_as<T, const_euclidean_vector_view>;
+	} // namespace detail
+
+	template<>
+	inline constexpr bool enable_vector_expression<euclidean_vector_view> = true;
+
+	template<>
+	inline constexpr bool enable_vector_expression<const_euclidean_vector_view> = true;
+
+	// Reads and writes through to the magnitudes it refers to
+	class euclidean_vector_view : public vector_expression_base<euclidean_vector_view> {
+	public:
+		euclidean_vector_view() = default;
+
+		euclidean_vector_view(double* magnitudes, int dimensions)
+		: magnitudes_{magnitudes}
+		, dimensions_{dimensions} {}
+
+		// Any contiguous doubles, such as a std::vector<double> or a row of a larger matrix
+		explicit euclidean_vector_view(std::span<double> magnitudes)
+		: magnitudes_{magnitudes.data()}
+		, dimensions_{static_cast<int>(magnitudes.size())} {}
+
+		auto operator[](int index) const -> double& {
+			assert(index >= 0 && index < dimensions_);
+			return magnitudes_[static_cast<std::size_t>(index)];
+		}
+
+		template<vector_expression E>
+		auto operator+=(E const& expression) -> euclidean_vector_view& {
+			detail::dimensions_check(dimensions_, expression.dimensions());
+			for (auto i = 0; i < dimensions_; ++i) {
+				(*this)[i] += expression[i];
+			}
+			return *this;
+		}
+
+		template<vector_expression E>
+		auto operator-=(E const& expression) -> euclidean_vector_view& {
+			detail::dimensions_check(dimensions_, expression.dimensions());
+			for (auto i = 0; i < dimensions_; ++i) {
+				(*this)[i] -= expression[i];
+			}
+			return *this;
+		}
+
+		auto operator*=(double factor) -> euclidean_vector_view& {
+			for (auto i = 0; i < dimensions_; ++i) {
+				(*this)[i] *= factor;
+			}
+			return *this;
+		}
+
+		auto operator/=(double factor) -> euclidean_vector_view& {
+			detail::division_check(factor);
+			for (auto i = 0; i < dimensions_; ++i) {
+				(*this)[i] /= factor;
+			}
+			return *this;
+		}
+
+		[[nodiscard]] auto at(int index) const -> double& {
+			detail::view_index_check(index, dimensions_);
+			return (*this)[index];
+		}
+
+		[[nodiscard]] auto dimensions() const -> int {
+			return dimensions_;
+		}
+
+		[[nodiscard]] auto data() const -> double* {
+			return magnitudes_;
+		}
+
+		// Vectors evaluated from an expression that starts with a view use the default resource
+		[[nodiscard]] auto get_allocator() const -> euclidean_vector::allocator_type {
+			return {};
+		}
+
+	private:
+		double* magnitudes_ = nullptr;
+		int dimensions_ = 0;
+	};
+
+	// Only reads the magnitudes it refers to
+	class const_euclidean_vector_view : public vector_expression_base<const_euclidean_vector_view> {
+	public:
+		const_euclidean_vector_view() = default;
+
+		const_euclidean_vector_view(double const* magnitudes, int dimensions)
+		: magnitudes_{magnitudes}
+		, dimensions_{dimensions} {}
+
+		explicit const_euclidean_vector_view(std::span<double const> magnitudes)
+		: magnitudes_{magnitudes.data()}
+		, dimensions_{static_cast<int>(magnitudes.size())} {}
+
+		const_euclidean_vector_view(euclidean_vector_view view) // NOLINT(google-explicit-constructor)
+		: magnitudes_{view.data()}
+		, dimensions_{view.dimensions()} {}
+
+		// Only reads, so it does not invalidate <vector>'s cached norm. There is no mutable view of
+		// a euclidean_vector for that reason.
+		const_euclidean_vector_view(euclidean_vector const& vector) // NOLINT(google-explicit-constructor)
+		: magnitudes_{detail::magnitudes_of(vector)}
+		, dimensions_{vector.dimensions()} {}
+
+		auto operator[](int index) const -> double const& {
+			assert(index >= 0 && index < dimensions_);
+			return magnitudes_[static_cast<std::size_t>(index)];
+		}
+
+		[[nodiscard]] auto at(int index) const -> double {
+			detail::view_index_check(index, dimensions_);
+			return (*this)[index];
+		}
+
+		[[nodiscard]] auto dimensions() const -> int {
+			return dimensions_;
+		}
+
+		[[nodiscard]] auto data() const -> double const* {
+			return magnitudes_;
+		}
+
+		[[nodiscard]] auto get_allocator() const -> euclidean_vector::allocator_type {
+			return {};
+		}
+
+	private:
+		double const* magnitudes_ = nullptr;
+		int dimensions_ = 0;
+	};
+
+	// Utility functions
+
+	// The same comparison as euclidean_vector's, when either side is a view
+	template<vector_expression L, vector_expression R>
+	requires detail::euclidean_vector_view_type<L> or detail::euclidean_vector_view_type<R>
+	auto operator==(L const& lhs, R const& rhs) -> bool {
+		if (lhs.dimensions() != rhs.dimensions()) {
+			return false;
+		}
+		for (auto i = 0; i < lhs.dimensions(); ++i) {
+			if (not(std::fabs(lhs[i] - rhs[i]) < std::numeric_limits<double>::epsilon())) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template<vector_expression L, vector_expression R>
+	requires detail::euclidean_vector_view_type<L> or detail::euclidean_vector_view_type<R>
+	auto operator!=(L const& lhs, R const& rhs) -> bool {
+		return not(lhs == rhs);
+	}
+
+	template<typename V>
+	requires detail::euclidean_vector_view_type<V>
+	auto operator<<(std::ostream& os, V const& view) -> std::ostream& {
+		return detail::write_magnitudes(os, view.data(), view.dimensions());
+	}
+} // namespace comp6771
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_VIEW_HPP
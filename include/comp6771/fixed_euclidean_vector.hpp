@@ -0,0 +1,245 @@
+#ifndef COMP6771_FIXED_EUCLIDEAN_VECTOR_HPP
+#define COMP6771_FIXED_EUCLIDEAN_VECTOR_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+/*
+    A euclidean vector whose number of dimensions is part of its type.
+
+    Operations between vectors of different dimensions do not compile, so nothing is checked at
+    run time except for division by zero and indexing through at(). Everything is constexpr.
+    Conversions to and from comp6771::euclidean_vector are explicit, and converting from one
+    checks the dimensions.
+*/
+namespace comp6771 {
+	namespace detail {
+		// std::sqrt is not constexpr until C++26, so use Newton's method during constant evaluation
+		constexpr auto constexpr_sqrt(double x) -> double {
+			if (not std::is_constant_evaluated()) {
+				return std::sqrt(x);
+			}
+
+			if (x < 0 or x != x) {
+				return std::numeric_limits<double>::quiet_NaN();
+			}
+			if (x == 0 or x == std::numeric_limits<double>::infinity()) {
+				return x;
+			}
+
+			auto current = x;
+			auto previous = 0.0;
+			// Converges quadratically, the bound only guards against oscillating in the last bit
+			for (auto i = 0; i < 1024 and current != previous; ++i) {
+				previous = current;
+				current = 0.5 * (current + x / current);
+			}
+			return current;
+		}
+
+		constexpr auto constexpr_fabs(double x) -> double {
+			return x < 0 ? -x : x;
+		}
+	} // namespace detail
+
+	template<std::size_t N>
+	class fixed_euclidean_vector {
+	public:
+		// Constructors
+
+		// All magnitudes are 0.0
+		constexpr fixed_euclidean_vector() = default;
+
+		// Exactly one magnitude per dimension
+		template<std::convertible_to<double>... Magnitudes>
+		requires(sizeof...(Magnitudes) == N and N > 0)
+		constexpr fixed_euclidean_vector(Magnitudes... magnitudes) // NOLINT(google-explicit-constructor)
+		: magnitude_{static_cast<double>(magnitudes)...} {}
+
+		constexpr explicit fixed_euclidean_vector(std::array<double, N> const& magnitudes)
+		: magnitude_{magnitudes} {}
+
+		// Throws euclidean_vector_error if <ev> does not have N dimensions
+		explicit fixed_euclidean_vector(euclidean_vector const& ev) {
+			detail::dimensions_check(dimensions(), ev.dimensions());
+			for (auto i = std::size_t{0}; i < N; ++i) {
+				magnitude_[i] = ev[static_cast<int>(i)];
+			}
+		}
+
+		// Operator Overload
+		constexpr auto operator[](int index) -> double& {
+			return magnitude_[static_cast<std::size_t>(index)];
+		}
+
+		constexpr auto operator[](int index) const -> double const& {
+			return magnitude_[static_cast<std::size_t>(index)];
+		}
+
+		constexpr auto operator+() const -> fixed_euclidean_vector {
+			return *this;
+		}
+
+		constexpr auto operator-() const -> fixed_euclidean_vector {
+			auto result = *this;
+			for (auto& magnitude : result.magnitude_) {
+				magnitude = -magnitude;
+			}
+			return result;
+		}
+
+		constexpr auto operator+=(fixed_euclidean_vector const& other) -> fixed_euclidean_vector& {
+			for (auto i = std::size_t{0}; i < N; ++i) {
+				magnitude_[i] += other.magnitude_[i];
+			}
+			return *this;
+		}
+
+		constexpr auto operator-=(fixed_euclidean_vector const& other) -> fixed_euclidean_vector& {
+			for (auto i = std::size_t{0}; i < N; ++i) {
+				magnitude_[i] -= other.magnitude_[i];
+			}
+			return *this;
+		}
+
+		constexpr auto operator*=(double factor) -> fixed_euclidean_vector& {
+			for (auto& magnitude : magnitude_) {
+				magnitude *= factor;
+			}
+			return *this;
+		}
+
+		constexpr auto operator/=(double factor) -> fixed_euclidean_vector& {
+			if (factor == 0) {
+				throw euclidean_vector_error("Invalid vector division by 0");
+			}
+
+			for (auto& magnitude : magnitude_) {
+				magnitude /= factor;
+			}
+			return *this;
+		}
+
+		explicit operator euclidean_vector() const {
+			auto ev = euclidean_vector(dimensions());
+			for (auto i = 0; i < dimensions(); ++i) {
+				ev[i] = magnitude_[static_cast<std::size_t>(i)];
+			}
+			return ev;
+		}
+
+		constexpr explicit operator std::array<double, N>() const {
+			return magnitude_;
+		}
+
+		// Member functions
+		[[nodiscard]] constexpr auto at(int index) const -> double {
+			index_check(index);
+			return magnitude_[static_cast<std::size_t>(index)];
+		}
+
+		constexpr auto at(int index) -> double& {
+			index_check(index);
+			return magnitude_[static_cast<std::size_t>(index)];
+		}
+
+		[[nodiscard]] static constexpr auto dimensions() -> int {
+			return static_cast<int>(N);
+		}
+
+		// Friends
+		friend constexpr auto operator==(fixed_euclidean_vector const& first,
+		                                 fixed_euclidean_vector const& second) -> bool {
+			for (auto i = std::size_t{0}; i < N; ++i) {
+				if (detail::constexpr_fabs(first.magnitude_[i] - second.magnitude_[i])
+				    >= std::numeric_limits<double>::epsilon()) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		friend constexpr auto operator!=(fixed_euclidean_vector const& first,
+		                                 fixed_euclidean_vector const& second) -> bool {
+			return not(first == second);
+		}
+
+		friend constexpr auto operator+(fixed_euclidean_vector first,
+		                                fixed_euclidean_vector const& second)
+		   -> fixed_euclidean_vector {
+			return first += second;
+		}
+
+		friend constexpr auto operator-(fixed_euclidean_vector first,
+		                                fixed_euclidean_vector const& second)
+		   -> fixed_euclidean_vector {
+			return first -= second;
+		}
+
+		friend constexpr auto operator*(fixed_euclidean_vector ev, double factor)
+		   -> fixed_euclidean_vector {
+			return ev *= factor;
+		}
+
+		friend constexpr auto operator/(fixed_euclidean_vector ev, double factor)
+		   -> fixed_euclidean_vector {
+			return ev /= factor;
+		}
+
+		// Same format as euclidean_vector
+		friend auto operator<<(std::ostream& os, fixed_euclidean_vector const& ev) -> std::ostream& {
+			return os << static_cast<euclidean_vector>(ev);
+		}
+
+	private:
+		std::array<double, N> magnitude_ = {};
+
+		constexpr auto index_check(int index) const -> void {
+			if (index < 0 or index >= dimensions()) {
+				throw euclidean_vector_error("Index " + std::to_string(index)
+				                             + " is not valid for this euclidean_vector object");
+			}
+		}
+	};
+
+	template<std::convertible_to<double>... Magnitudes>
+	fixed_euclidean_vector(Magnitudes...) -> fixed_euclidean_vector<sizeof...(Magnitudes)>;
+
+	// Utility functions
+	template<std::size_t N>
+	constexpr auto dot(fixed_euclidean_vector<N> const& x, fixed_euclidean_vector<N> const& y)
+	   -> double {
+		auto dot_product = 0.0;
+		for (auto i = 0; i < static_cast<int>(N); ++i) {
+			dot_product += x[i] * y[i];
+		}
+		return dot_product;
+	}
+
+	template<std::size_t N>
+	constexpr auto euclidean_norm(fixed_euclidean_vector<N> const& v) -> double {
+		return detail::constexpr_sqrt(dot(v, v));
+	}
+
+	// A vector with no dimensions has no unit vector, so that does not compile
+	template<std::size_t N>
+	requires(N > 0)
+	constexpr auto unit(fixed_euclidean_vector<N> const& v) -> fixed_euclidean_vector<N> {
+		auto const norm = euclidean_norm(v);
+		if (norm == 0) {
+			throw euclidean_vector_error("euclidean_vector with zero euclidean normal does not have a "
+			                             "unit vector");
+		}
+
+		return v / norm;
+	}
+} // namespace comp6771
+
+#endif // COMP6771_FIXED_EUCLIDEAN_VECTOR_HPP
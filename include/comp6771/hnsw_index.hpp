@@ -0,0 +1,154 @@
+#ifndef COMP6771_HNSW_INDEX_HPP
+#define COMP6771_HNSW_INDEX_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+#include "comp6771/nearest_neighbours.hpp"
+
+#include <concepts>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+    Approximate k-nearest-neighbour search with a hierarchical navigable small world graph
+    (Malkov and Yashunin, 2016).
+
+    Each vector is a node linked to its nearest neighbours on layer 0 and, with exponentially
+    decreasing probability, on the layers above it. A search walks greedily down from the top
+    layer and then explores layer 0 with a beam of ef_search candidates, so it compares the query
+    with a small fraction of the vectors. Larger m, ef_construction and ef_search give better
+    recall at the cost of memory, insert time and search time respectively.
+
+    Searches may run concurrently with each other and with add(). An insert finds its neighbours
+    while sharing the graph with searches, and only holds it exclusively while linking.
+*/
+namespace comp6771 {
+	struct hnsw_parameters {
+		// Links per node on each layer above layer 0, which has twice as many
+		int m = 16;
+
+		// Candidates considered when linking a new node
+		int ef_construction = 200;
+
+		// Candidates considered by a search, raised to k if it is smaller
+		int ef_search = 50;
+
+		// Seeds the choice of layer for each node
+		std::uint_fast32_t seed = 100;
+	};
+
+	class hnsw_index {
+	public:
+		// Throws euclidean_vector_error if m is less than 2, or ef_construction or ef_search is
+		// less than 1
+		explicit hnsw_index(int dimensions, metric m = metric::l2, hnsw_parameters parameters = {});
+
+		// Moving is not thread safe
+		hnsw_index(hnsw_index&&) noexcept;
+		auto operator=(hnsw_index&&) -> hnsw_index&;
+
+		// Adds a vector and returns its index. Indices are given out in the order inserts finish.
+		// Throws euclidean_vector_error if <vector> does not have dimensions() dimensions
+		template<vector_expression E>
+		auto add(E const& vector) -> int {
+			detail::dimensions_check(dimensions(), vector.dimensions());
+			auto const magnitudes = static_cast<std::vector<double>>(vector);
+			return add(magnitudes.data());
+		}
+
+		[[nodiscard]] auto size() const -> int;
+		[[nodiscard]] auto dimensions() const -> int;
+		[[nodiscard]] auto distance_metric() const -> metric;
+		[[nodiscard]] auto parameters() const -> hnsw_parameters;
+
+		// Only changes later searches
+		auto set_ef_search(int ef_search) -> void;
+
+		// The approximately <k> nearest vectors to <query>, nearest first. Distances are the same as
+		// brute_force_index.
+		// Throws euclidean_vector_error if <query> does not have dimensions() dimensions or <k> is
+		// negative
+		template<vector_expression E>
+		[[nodiscard]] auto search(E const& query, int k) const -> std::vector<neighbour> {
+			detail::dimensions_check(dimensions(), query.dimensions());
+			if constexpr (std::convertible_to<E, const_euclidean_vector_view>) {
+				return search(const_euclidean_vector_view(query).data(), k);
+			}
+			else {
+				auto const magnitudes = static_cast<std::vector<double>>(query);
+				return search(magnitudes.data(), k);
+			}
+		}
+
+		// Writes the index to <path> in this host's byte order.
+		// Throws euclidean_vector_error if the file cannot be written
+		auto save(std::string const& path) const -> void;
+
+		// Throws euclidean_vector_error if the file cannot be read or was not written by save()
+		[[nodiscard]] static auto load(std::string const& path) -> hnsw_index;
+
+	private:
+		// One vector per node, and the links of each node on each of its layers
+		euclidean_vector_batch vectors_;
+		std::vector<double> squared_norms_;
+		std::vector<std::vector<std::vector<int>>> links_;
+
+		metric metric_;
+		hnsw_parameters parameters_;
+		double level_multiplier_;
+
+		int entry_point_ = -1;
+		int top_level_ = -1;
+
+		mutable std::shared_mutex graph_mutex_;
+		std::mutex random_mutex_;
+		std::mt19937 random_;
+
+		// A candidate node and its distance from the query
+		using candidate = std::pair<double, int>;
+
+		auto add(double const* magnitudes) -> int;
+		[[nodiscard]] auto search(double const* query, int k) const -> std::vector<neighbour>;
+
+		[[nodiscard]] auto random_level() -> int;
+		[[nodiscard]] auto max_links(int level) const -> std::size_t;
+
+		[[nodiscard]] auto distance(double const* query, double query_norm, int node) const -> double;
+		[[nodiscard]] auto distance(int x, int y) const -> double;
+
+		// Greedy search on <level> that keeps the <ef> nearest nodes, returned nearest first
+		[[nodiscard]] auto search_layer(double const* query,
+		                                double query_norm,
+		                                std::vector<candidate> const& entry_points,
+		                                std::size_t ef,
+		                                int level) const -> std::vector<candidate>;
+
+		// Walks down from the entry point to <level>, returning the nearest node on <level>
+		[[nodiscard]] auto descend(double const* query, double query_norm, int level) const
+		   -> candidate;
+
+		// Finds the neighbours of a node with <level> levels on each level from the lower of <level>
+		// and top_level_ down to <lowest>, and writes them to <neighbours>
+		auto find_neighbours(double const* magnitudes,
+		                     double query_norm,
+		                     int level,
+		                     int lowest,
+		                     std::vector<std::vector<int>>& neighbours) const -> void;
+
+		// Picks up to <count> of <candidates> (nearest first) that are nearer to the node than to
+		// each other, so links point in different directions
+		[[nodiscard]] auto select_neighbours(std::vector<candidate> const& candidates,
+		                                     std::size_t count) const -> std::vector<int>;
+
+		// Links <node> into <neighbour> on <level>, pruning <neighbour>'s links if needed
+		auto link(int neighbour, int node, int level) -> void;
+	};
+} // namespace comp6771
+
+#endif // COMP6771_HNSW_INDEX_HPP
@@ -0,0 +1,163 @@
+#ifndef COMP6771_INSTRUMENTATION_HPP
+#define COMP6771_INSTRUMENTATION_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+// Set to 1 by configuring with COMP6771_EUCLIDEAN_VECTOR_ENABLE_INSTRUMENTATION=On. Every
+// translation unit must agree, so it is only ever set by the build.
+#ifndef COMP6771_INSTRUMENTATION
+#define COMP6771_INSTRUMENTATION 0
+#endif
+
+/*
+    Opt-in counters and latency histograms for euclidean_vector's hot paths.
+
+    Each thread counts into its own block, so recording is a relaxed load and store with no
+    contention. take_snapshot() sums every thread's block, including threads that have exited.
+    When instrumentation is compiled out, recording compiles to nothing and snapshots are all 0.
+*/
+namespace comp6771::instrumentation {
+	inline constexpr bool enabled = COMP6771_INSTRUMENTATION != 0;
+
+	enum class counter {
+		copies, // deep copies made by copy construction or copy assignment
+		copied_bytes,
+		moves, // moves that took the other vector's storage
+		allocations, // calls to the memory resource, which skip vectors stored inline
+		allocated_bytes,
+		deallocations,
+		norm_cache_hits,
+		norm_cache_misses,
+	};
+	inline constexpr auto counter_count = std::size_t{8};
+
+	// Operations with a latency histogram. Each is timed from the start of its computation, after
+	// the result has been allocated.
+	enum class operation {
+		evaluate, // writing an expression into a euclidean_vector
+		arithmetic, // compound assignment and rvalue arithmetic
+		euclidean_norm, // norms that were computed rather than cached
+		dot,
+		unit,
+	};
+	inline constexpr auto operation_count = std::size_t{5};
+
+	// Bucket i counts latencies of less than 2^i ns, and at least 2^(i - 1) ns. The last bucket
+	// also counts everything longer, which is about 2 seconds.
+	inline constexpr auto histogram_buckets = std::size_t{32};
+
+	[[nodiscard]] auto name(counter c) -> std::string_view;
+	[[nodiscard]] auto name(operation op) -> std::string_view;
+
+	struct latency_histogram {
+		std::array<std::uint64_t, histogram_buckets> buckets{};
+		std::uint64_t total_nanoseconds = 0;
+
+		[[nodiscard]] auto count() const -> std::uint64_t;
+	};
+
+	struct snapshot {
+		std::array<std::uint64_t, counter_count> counters{};
+		std::array<latency_histogram, operation_count> latencies{};
+
+		[[nodiscard]] auto operator[](counter c) const -> std::uint64_t {
+			return counters[static_cast<std::size_t>(c)];
+		}
+
+		[[nodiscard]] auto operator[](operation op) const -> latency_histogram const& {
+			return latencies[static_cast<std::size_t>(op)];
+		}
+	};
+
+	// Everything counted on every thread since the last reset()
+	[[nodiscard]] auto take_snapshot() -> snapshot;
+
+	// Starts counting again from 0. Threads may keep recording while this runs.
+	auto reset() -> void;
+
+	// Writes <s> in the Prometheus text exposition format: one comp6771_euclidean_vector_<name>_total
+	// counter per counter, and a comp6771_euclidean_vector_latency_seconds histogram labelled by
+	// operation.
+	auto write_metrics(std::ostream& os, snapshot const& s) -> std::ostream&;
+
+	namespace detail {
+		// Only ever written by the thread that owns it, and read by take_snapshot()
+		struct thread_block {
+			std::array<std::atomic<std::uint64_t>, counter_count> counters{};
+			std::array<std::array<std::atomic<std::uint64_t>, histogram_buckets>, operation_count>
+			   buckets{};
+			std::array<std::atomic<std::uint64_t>, operation_count> total_nanoseconds{};
+		};
+
+		// Null until the thread first records something
+		extern constinit thread_local thread_block* current_block;
+
+		// Registers a block for this thread, returning null if one could not be allocated
+		auto register_thread() noexcept -> thread_block*;
+
+		inline auto local_block() noexcept -> thread_block* {
+			auto* const block = current_block;
+			return block != nullptr ? block : register_thread();
+		}
+
+		// Nothing else writes to <value>, so this does not need a read-modify-write
+		inline auto bump(std::atomic<std::uint64_t>& value, std::uint64_t n) noexcept -> void {
+			value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+		}
+	} // namespace detail
+
+	inline auto add(counter c, std::uint64_t n = 1) noexcept -> void {
+		if constexpr (enabled) {
+			if (auto* const block = detail::local_block(); block != nullptr) {
+				detail::bump(block->counters[static_cast<std::size_t>(c)], n);
+			}
+		}
+	}
+
+	inline auto record(operation op, std::chrono::nanoseconds latency) noexcept -> void {
+		if constexpr (enabled) {
+			if (auto* const block = detail::local_block(); block != nullptr) {
+				auto const nanoseconds = static_cast<std::uint64_t>(latency.count());
+				auto const bucket =
+				   std::min(static_cast<std::size_t>(std::bit_width(nanoseconds)), histogram_buckets - 1);
+				auto const i = static_cast<std::size_t>(op);
+				detail::bump(block->buckets[i][bucket], 1);
+				detail::bump(block->total_nanoseconds[i], nanoseconds);
+			}
+		}
+	}
+
+	// Records the time from construction to destruction as a latency of <op>
+	class scoped_timer {
+	public:
+		explicit scoped_timer(operation op) noexcept
+		: op_{op} {
+			if constexpr (enabled) {
+				start_ = std::chrono::steady_clock::now();
+			}
+		}
+
+		scoped_timer(scoped_timer const&) = delete;
+		auto operator=(scoped_timer const&) -> scoped_timer& = delete;
+
+		~scoped_timer() {
+			if constexpr (enabled) {
+				record(op_, std::chrono::steady_clock::now() - start_);
+			}
+		}
+
+	private:
+		operation op_;
+		std::chrono::steady_clock::time_point start_;
+	};
+} // namespace comp6771::instrumentation
+
+#endif // COMP6771_INSTRUMENTATION_HPP
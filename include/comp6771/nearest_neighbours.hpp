@@ -0,0 +1,163 @@
+#ifndef COMP6771_NEAREST_NEIGHBOURS_HPP
+#define COMP6771_NEAREST_NEIGHBOURS_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+#include "comp6771/thread_pool.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+/*
+    Exact k-nearest-neighbour search over many euclidean vectors.
+
+    Queries are scored in blocks against blocks of the database that fit in cache, so the database
+    is read from memory once per block of queries rather than once per query. Blocks are spread
+    over a thread_pool, and each query keeps only its best k candidates in a bounded heap.
+*/
+namespace comp6771 {
+	enum class metric {
+		// Euclidean distance
+		l2,
+		// Largest dot product first
+		inner_product,
+		// Smallest angle first
+		cosine,
+	};
+
+	[[nodiscard]] auto name(metric m) -> std::string_view;
+
+	struct neighbour {
+		// Position of the vector in the index
+		int index;
+
+		// Smaller is nearer for every metric: the euclidean distance for metric::l2, the negated
+		// dot product for metric::inner_product and 1 - cos(angle) for metric::cosine. Vectors
+		// with no magnitude are at a cosine distance of 1 from everything.
+		double distance;
+
+		friend auto operator==(neighbour const&, neighbour const&) -> bool = default;
+	};
+
+	namespace detail {
+		// The distance under <m> between vectors with squared norms <x_norm> and <y_norm> and dot
+		// product <dot>. The squared distance is returned for metric::l2, which orders vectors the
+		// same way but saves a square root. Expanding the squared distance this way cancels when the
+		// vectors are far from the origin, so it is only for dot products that are approximate anyway.
+		[[nodiscard]] auto metric_distance(metric m, double dot, double x_norm, double y_norm) -> double;
+
+		// The distance under <m> between <x> and <y>, which have squared norms <x_norm> and <y_norm>,
+		// as metric_distance returns it. The squared distance for metric::l2 sums the squared
+		// differences directly, so it is exact wherever the vectors are.
+		[[nodiscard]] auto exact_distance(metric m,
+		                                  double const* x,
+		                                  double x_norm,
+		                                  double const* y,
+		                                  double y_norm,
+		                                  std::size_t dimensions) -> double;
+
+		// Throws euclidean_vector_error if <k> is negative
+		auto k_check(int k) -> void;
+
+		[[nodiscard]] inline auto nearer(neighbour const& x, neighbour const& y) -> bool {
+			return x.distance < y.distance or (x.distance == y.distance and x.index < y.index);
+		}
+
+		// The <k> nearest candidates seen so far, with the furthest at the front
+		class bounded_heap {
+		public:
+			explicit bounded_heap(std::size_t k)
+			: k_{k} {
+				heap_.reserve(k);
+			}
+
+			auto push(neighbour const& candidate) -> void {
+				if (heap_.size() < k_) {
+					heap_.push_back(candidate);
+					std::push_heap(heap_.begin(), heap_.end(), nearer);
+				}
+				else if (k_ > 0 and nearer(candidate, heap_.front())) {
+					std::pop_heap(heap_.begin(), heap_.end(), nearer);
+					heap_.back() = candidate;
+					std::push_heap(heap_.begin(), heap_.end(), nearer);
+				}
+			}
+
+			[[nodiscard]] auto neighbours() const -> std::vector<neighbour> const& {
+				return heap_;
+			}
+
+		private:
+			std::size_t k_;
+			std::vector<neighbour> heap_;
+		};
+	} // namespace detail
+
+	// Every vector is compared with the query, so results are always exact
+	class brute_force_index {
+	public:
+		explicit brute_force_index(int dimensions, metric m = metric::l2);
+		explicit brute_force_index(euclidean_vector_batch vectors, metric m = metric::l2);
+
+		// Adds a vector to the end of the index and returns its index.
+		// Throws euclidean_vector_error if <vector> does not have dimensions() dimensions
+		template<vector_expression E>
+		auto add(E const& vector) -> int {
+			vectors_.push_back(vector);
+			squared_norms_.push_back(squared_norm(size() - 1));
+			return size() - 1;
+		}
+
+		auto reserve(int size) -> void;
+
+		[[nodiscard]] auto size() const -> int;
+		[[nodiscard]] auto dimensions() const -> int;
+		[[nodiscard]] auto distance_metric() const -> metric;
+		[[nodiscard]] auto vectors() const -> euclidean_vector_batch const&;
+
+		// The <k> nearest vectors to <query>, nearest first, ties broken by the smaller index.
+		// Returns every vector if there are fewer than <k>.
+		// Throws euclidean_vector_error if <query> does not have dimensions() dimensions or <k> is
+		// negative
+		[[nodiscard]] auto search(const_euclidean_vector_view query, int k) const
+		   -> std::vector<neighbour>;
+		[[nodiscard]] auto search(const_euclidean_vector_view query, int k, thread_pool& pool) const
+		   -> std::vector<neighbour>;
+
+		template<vector_expression E>
+		requires(not std::convertible_to<E, const_euclidean_vector_view>)
+		[[nodiscard]] auto search(E const& query, int k) const -> std::vector<neighbour> {
+			return search(query, k, default_thread_pool());
+		}
+
+		template<vector_expression E>
+		requires(not std::convertible_to<E, const_euclidean_vector_view>)
+		[[nodiscard]] auto search(E const& query, int k, thread_pool& pool) const
+		   -> std::vector<neighbour> {
+			auto const magnitudes = static_cast<std::vector<double>>(query);
+			return search(const_euclidean_vector_view(magnitudes.data(), query.dimensions()), k, pool);
+		}
+
+		// The <k> nearest vectors to each query, in the same order as <queries>
+		[[nodiscard]] auto search(euclidean_vector_batch const& queries, int k) const
+		   -> std::vector<std::vector<neighbour>>;
+		[[nodiscard]] auto search(euclidean_vector_batch const& queries, int k, thread_pool& pool) const
+		   -> std::vector<std::vector<neighbour>>;
+
+	private:
+		euclidean_vector_batch vectors_;
+		std::vector<double> squared_norms_;
+		metric metric_;
+
+		[[nodiscard]] auto squared_norm(int index) const -> double;
+
+		[[nodiscard]] auto search(double const* queries, int count, int k, thread_pool& pool) const
+		   -> std::vector<std::vector<neighbour>>;
+	};
+} // namespace comp6771
+
+#endif // COMP6771_NEAREST_NEIGHBOURS_HPP
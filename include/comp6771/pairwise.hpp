@@ -0,0 +1,79 @@
+#ifndef COMP6771_PAIRWISE_HPP
+#define COMP6771_PAIRWISE_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/thread_pool.hpp"
+
+#include <span>
+
+/*
+    Matrices of dot products, squared distances and cosine similarities between every vector of
+    <x> and every vector of <y>.
+
+    Vectors are packed into panels a cache block at a time, and each 4 x 8 tile of the matrix is
+    computed by kernels::dot_tile while it stays in registers, so every magnitude read from memory
+    is used for several products. Blocks of the matrix are spread over a thread_pool. Squared
+    distances are summed from the differences by kernels::squared_distance_tile the same way, so
+    they stay exact however far the vectors are from the origin. Cosine similarities are derived
+    from the dot products and the norms, which are read from each euclidean_vector's cache rather
+    than computed again.
+
+    When <x> and <y> are the same vectors, only the blocks on and above the diagonal are computed
+    and the rest are mirrored.
+
+    <result> is row-major: the entry for x[i] and y[j] is result[i * y.size() + j]. Each function
+    throws euclidean_vector_error if <result> does not have x.size() * y.size() elements, or the
+    vectors do not all have the same dimensions.
+*/
+namespace comp6771 {
+	// dot(x[i], y[j])
+	auto pairwise_dot(std::span<euclidean_vector const> x,
+	                  std::span<euclidean_vector const> y,
+	                  std::span<double> result) -> void;
+	auto pairwise_dot(std::span<euclidean_vector const> x,
+	                  std::span<euclidean_vector const> y,
+	                  std::span<double> result,
+	                  thread_pool& pool) -> void;
+	auto pairwise_dot(euclidean_vector_batch const& x,
+	                  euclidean_vector_batch const& y,
+	                  std::span<double> result) -> void;
+	auto pairwise_dot(euclidean_vector_batch const& x,
+	                  euclidean_vector_batch const& y,
+	                  std::span<double> result,
+	                  thread_pool& pool) -> void;
+
+	// The squared euclidean distance between x[i] and y[j], which is 0 from a vector to itself
+	auto pairwise_squared_distance(std::span<euclidean_vector const> x,
+	                               std::span<euclidean_vector const> y,
+	                               std::span<double> result) -> void;
+	auto pairwise_squared_distance(std::span<euclidean_vector const> x,
+	                               std::span<euclidean_vector const> y,
+	                               std::span<double> result,
+	                               thread_pool& pool) -> void;
+	auto pairwise_squared_distance(euclidean_vector_batch const& x,
+	                               euclidean_vector_batch const& y,
+	                               std::span<double> result) -> void;
+	auto pairwise_squared_distance(euclidean_vector_batch const& x,
+	                               euclidean_vector_batch const& y,
+	                               std::span<double> result,
+	                               thread_pool& pool) -> void;
+
+	// The cosine of the angle between x[i] and y[j], or 0 if either has no magnitude
+	auto pairwise_cosine_similarity(std::span<euclidean_vector const> x,
+	                                std::span<euclidean_vector const> y,
+	                                std::span<double> result) -> void;
+	auto pairwise_cosine_similarity(std::span<euclidean_vector const> x,
+	                                std::span<euclidean_vector const> y,
+	                                std::span<double> result,
+	                                thread_pool& pool) -> void;
+	auto pairwise_cosine_similarity(euclidean_vector_batch const& x,
+	                                euclidean_vector_batch const& y,
+	                                std::span<double> result) -> void;
+	auto pairwise_cosine_similarity(euclidean_vector_batch const& x,
+	                                euclidean_vector_batch const& y,
+	                                std::span<double> result,
+	                                thread_pool& pool) -> void;
+} // namespace comp6771
+
+#endif // COMP6771_PAIRWISE_HPP
@@ -0,0 +1,224 @@
+#ifndef COMP6771_SHARED_EUCLIDEAN_VECTOR_HPP
+#define COMP6771_SHARED_EUCLIDEAN_VECTOR_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iosfwd>
+#include <memory_resource>
+
+/*
+    A euclidean vector whose copies share their magnitudes until one of them is changed, for code
+    that passes vectors by value and mostly reads them.
+
+    Copying is O(1): it only counts another reference to the magnitudes. The first change through
+    the mutable operator[], at() or a compound assignment copies the magnitudes if they are
+    shared, so a change is never seen through another vector. Only reading a magnitude through the
+    mutable operator[] or at() never copies them.
+
+    As with std::shared_ptr, different vectors that share magnitudes may be used from different
+    threads at once, since the reference count is atomic. One vector must not be used from two
+    threads at once if either changes it.
+*/
+namespace comp6771 {
+	class shared_euclidean_vector;
+
+	template<>
+	inline constexpr bool enable_vector_expression<shared_euclidean_vector> = true;
+
+	class shared_euclidean_vector : public vector_expression_base<shared_euclidean_vector> {
+	public:
+		// Magnitudes are allocated from this allocator's memory_resource, and copies share them, so
+		// the resource must outlive every copy
+		using allocator_type = euclidean_vector::allocator_type;
+
+		// Returned by the mutable operator[] and at(). Writing a magnitude through it copies the
+		// magnitudes first if they are shared, including with a copy made after it was returned.
+		class reference {
+		public:
+			reference(reference const&) = default;
+
+			operator double() const noexcept { // NOLINT(google-explicit-constructor)
+				return vector_->data()[index_];
+			}
+
+			auto operator=(double magnitude) -> reference& {
+				vector_->mutable_data()[index_] = magnitude;
+				return *this;
+			}
+
+			// Assigns the magnitude, as double& would
+			auto operator=(reference const& other) -> reference& {
+				return *this = static_cast<double>(other);
+			}
+
+			auto operator+=(double x) -> reference& {
+				return *this = static_cast<double>(*this) + x;
+			}
+
+			auto operator-=(double x) -> reference& {
+				return *this = static_cast<double>(*this) - x;
+			}
+
+			auto operator*=(double x) -> reference& {
+				return *this = static_cast<double>(*this) * x;
+			}
+
+			auto operator/=(double x) -> reference& {
+				return *this = static_cast<double>(*this) / x;
+			}
+
+		private:
+			friend class shared_euclidean_vector;
+
+			reference(shared_euclidean_vector& vector, int index) noexcept
+			: vector_{&vector}
+			, index_{index} {}
+
+			shared_euclidean_vector* vector_;
+			int index_;
+		};
+
+		// Constructors
+
+		// Like euclidean_vector, one dimension
+		shared_euclidean_vector();
+
+		explicit shared_euclidean_vector(int dimensions, allocator_type const& allocator = {});
+		shared_euclidean_vector(int dimensions, double magnitude, allocator_type const& allocator = {});
+		shared_euclidean_vector(std::initializer_list<double> magnitudes,
+		                        allocator_type const& allocator = {});
+
+		// Evaluates a euclidean_vector, view or expression into new magnitudes
+		template<vector_expression E>
+		explicit shared_euclidean_vector(E const& expression)
+		: shared_euclidean_vector(expression, expression.get_allocator()) {}
+
+		template<vector_expression E>
+		shared_euclidean_vector(E const& expression, allocator_type const& allocator)
+		: shared_euclidean_vector(expression.dimensions(), allocator) {
+			auto* const magnitudes = mutable_data();
+			detail::for_each_chunk(static_cast<std::size_t>(dimensions_),
+			                       [&](std::size_t first, std::size_t last) {
+				                       for (auto i = first; i < last; ++i) {
+					                       magnitudes[i] = expression[static_cast<int>(i)];
+				                       }
+			                       });
+		}
+
+		// Shares the magnitudes of <other>
+		shared_euclidean_vector(shared_euclidean_vector const& other) noexcept;
+		shared_euclidean_vector(shared_euclidean_vector&& other) noexcept;
+
+		~shared_euclidean_vector();
+
+		// Operator Overload
+		auto operator=(shared_euclidean_vector const&) noexcept -> shared_euclidean_vector&;
+		auto operator=(shared_euclidean_vector&&) noexcept -> shared_euclidean_vector&;
+
+		auto operator[](int index) const -> double const& {
+			assert(index >= 0 && index < dimensions_);
+			return data()[index];
+		}
+
+		auto operator[](int index) -> reference {
+			assert(index >= 0 && index < dimensions_);
+			return reference(*this, index);
+		}
+
+		// A copy, which shares the magnitudes
+		auto operator+() const -> shared_euclidean_vector;
+
+		auto operator+=(shared_euclidean_vector const&) -> shared_euclidean_vector&;
+		auto operator-=(shared_euclidean_vector const&) -> shared_euclidean_vector&;
+		auto operator*=(double) -> shared_euclidean_vector&;
+		auto operator/=(double) -> shared_euclidean_vector&;
+
+		template<vector_expression E>
+		auto operator+=(E const& expression) -> shared_euclidean_vector&;
+
+		template<vector_expression E>
+		auto operator-=(E const& expression) -> shared_euclidean_vector&;
+
+		// Member functions
+		[[nodiscard]] auto at(int) const -> double;
+		auto at(int) -> reference;
+		[[nodiscard]] auto dimensions() const -> int;
+		[[nodiscard]] auto get_allocator() const -> allocator_type;
+
+		[[nodiscard]] auto data() const -> double const* {
+			return block_ == nullptr ? nullptr : block_->magnitudes();
+		}
+
+		// Whether another vector shares these magnitudes
+		[[nodiscard]] auto is_shared() const -> bool;
+
+		// Friends
+		friend auto operator==(shared_euclidean_vector const&, shared_euclidean_vector const&) -> bool;
+		friend auto operator!=(shared_euclidean_vector const&, shared_euclidean_vector const&) -> bool;
+		friend auto operator<<(std::ostream&, shared_euclidean_vector const&) -> std::ostream&;
+
+	private:
+		// The reference count, followed by the magnitudes
+		struct shared_block {
+			std::atomic<std::size_t> references;
+
+			[[nodiscard]] auto magnitudes() -> double* {
+				return reinterpret_cast<double*>(this + 1);
+			}
+		};
+
+		std::pmr::memory_resource* resource_;
+
+		// nullptr when there are no dimensions
+		shared_block* block_;
+		int dimensions_;
+
+		[[nodiscard]] static auto block_size(int dimensions) -> std::size_t;
+
+		// Gives up this vector's reference, freeing the block if it was the last one
+		auto release() noexcept -> void;
+
+		// Copies the magnitudes if they are shared, then returns them
+		[[nodiscard]] auto mutable_data() -> double*;
+	};
+
+	template<vector_expression E>
+	auto shared_euclidean_vector::operator+=(E const& expression) -> shared_euclidean_vector& {
+		detail::dimensions_check(dimensions(), expression.dimensions());
+
+		// An expression holds its own reference, so it still reads the magnitudes as they were
+		auto* const magnitudes = mutable_data();
+		detail::for_each_chunk(static_cast<std::size_t>(dimensions_),
+		                       [&](std::size_t first, std::size_t last) {
+			                       for (auto i = first; i < last; ++i) {
+				                       magnitudes[i] += expression[static_cast<int>(i)];
+			                       }
+		                       });
+		return *this;
+	}
+
+	template<vector_expression E>
+	auto shared_euclidean_vector::operator-=(E const& expression) -> shared_euclidean_vector& {
+		detail::dimensions_check(dimensions(), expression.dimensions());
+
+		auto* const magnitudes = mutable_data();
+		detail::for_each_chunk(static_cast<std::size_t>(dimensions_),
+		                       [&](std::size_t first, std::size_t last) {
+			                       for (auto i = first; i < last; ++i) {
+				                       magnitudes[i] -= expression[static_cast<int>(i)];
+			                       }
+		                       });
+		return *this;
+	}
+
+	// Utility functions
+
+	// A new vector, <v> is unchanged
+	auto unit(shared_euclidean_vector const& v) -> shared_euclidean_vector;
+} // namespace comp6771
+
+#endif // COMP6771_SHARED_EUCLIDEAN_VECTOR_HPP
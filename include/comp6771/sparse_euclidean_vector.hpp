@@ -0,0 +1,115 @@
+#ifndef COMP6771_SPARSE_EUCLIDEAN_VECTOR_HPP
+#define COMP6771_SPARSE_EUCLIDEAN_VECTOR_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+
+#include <initializer_list>
+#include <span>
+#include <utility>
+#include <vector>
+
+/*
+    A euclidean vector of many dimensions that stores only its non-zero magnitudes, as an array of
+    indices in increasing order and an array of the magnitudes at those indices.
+
+    Every operation costs time in the number of non-zero magnitudes rather than the number of
+    dimensions. Operations that make a magnitude zero drop it, so the vector stays sparse.
+    Conversions to and from comp6771::euclidean_vector are explicit.
+*/
+namespace comp6771 {
+	class sparse_euclidean_vector {
+	public:
+		// Constructors
+
+		// Like euclidean_vector, one dimension
+		sparse_euclidean_vector();
+
+		// Every magnitude is 0.0
+		explicit sparse_euclidean_vector(int dimensions);
+
+		// The magnitude at indices[i] is magnitudes[i], in any order. Throws euclidean_vector_error
+		// if there are not as many magnitudes as indices, or an index is repeated or not valid
+		sparse_euclidean_vector(int dimensions, std::vector<int> indices, std::vector<double> magnitudes);
+
+		// From {index, magnitude} pairs, with the same checks
+		sparse_euclidean_vector(int dimensions, std::initializer_list<std::pair<int, double>> magnitudes);
+
+		// The non-zero magnitudes of <v>
+		explicit sparse_euclidean_vector(const_euclidean_vector_view v);
+
+		// Operator Overload
+
+		// Read only, as assigning to a magnitude that is not stored would insert it
+		[[nodiscard]] auto operator[](int index) const -> double;
+
+		auto operator+() const -> sparse_euclidean_vector;
+		auto operator-() const -> sparse_euclidean_vector;
+
+		auto operator+=(sparse_euclidean_vector const&) -> sparse_euclidean_vector&;
+		auto operator-=(sparse_euclidean_vector const&) -> sparse_euclidean_vector&;
+		auto operator*=(double) -> sparse_euclidean_vector&;
+		auto operator/=(double) -> sparse_euclidean_vector&;
+
+		explicit operator euclidean_vector() const;
+
+		// Member functions
+		[[nodiscard]] auto at(int) const -> double;
+		[[nodiscard]] auto dimensions() const -> int;
+
+		// Number of magnitudes stored
+		[[nodiscard]] auto non_zeros() const -> int;
+
+		// In increasing order
+		[[nodiscard]] auto indices() const -> std::span<int const>;
+		[[nodiscard]] auto magnitudes() const -> std::span<double const>;
+
+		// Friends
+		friend auto operator==(sparse_euclidean_vector const&, sparse_euclidean_vector const&) -> bool;
+		friend auto operator!=(sparse_euclidean_vector const&, sparse_euclidean_vector const&) -> bool;
+
+	private:
+		int dimensions_;
+		std::vector<int> indices_;
+		std::vector<double> magnitudes_;
+
+		// Helper functions
+
+		// Sorts the magnitudes by index, checks the indices and drops zeros
+		auto normalise() -> void;
+
+		auto drop_zeros() -> void;
+
+		// *this = *this + sign * other
+		auto merge(sparse_euclidean_vector const& other, double sign) -> void;
+	};
+
+	// Utility functions
+	auto operator+(sparse_euclidean_vector const& x, sparse_euclidean_vector const& y)
+	   -> sparse_euclidean_vector;
+	auto operator-(sparse_euclidean_vector const& x, sparse_euclidean_vector const& y)
+	   -> sparse_euclidean_vector;
+	auto operator*(sparse_euclidean_vector v, double factor) -> sparse_euclidean_vector;
+	auto operator*(double factor, sparse_euclidean_vector v) -> sparse_euclidean_vector;
+	auto operator/(sparse_euclidean_vector v, double factor) -> sparse_euclidean_vector;
+
+	// Adding a sparse vector to a dense one gives a dense one
+	auto operator+(const_euclidean_vector_view x, sparse_euclidean_vector const& y) -> euclidean_vector;
+	auto operator+(sparse_euclidean_vector const& x, const_euclidean_vector_view y) -> euclidean_vector;
+	auto operator-(const_euclidean_vector_view x, sparse_euclidean_vector const& y) -> euclidean_vector;
+	auto operator-(sparse_euclidean_vector const& x, const_euclidean_vector_view y) -> euclidean_vector;
+
+	auto euclidean_norm(sparse_euclidean_vector const& v) -> double;
+
+	// Throws euclidean_vector_error if <v> has no unit vector
+	auto unit(sparse_euclidean_vector const& v) -> sparse_euclidean_vector;
+
+	// Merges the two index arrays, galloping through the longer one when the other is much shorter
+	auto dot(sparse_euclidean_vector const& x, sparse_euclidean_vector const& y) -> double;
+
+	// Gathers the magnitudes of the dense vector at the indices of the sparse one
+	auto dot(sparse_euclidean_vector const& x, const_euclidean_vector_view y) -> double;
+	auto dot(const_euclidean_vector_view x, sparse_euclidean_vector const& y) -> double;
+} // namespace comp6771
+
+#endif // COMP6771_SPARSE_EUCLIDEAN_VECTOR_HPP
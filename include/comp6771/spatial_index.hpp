@@ -0,0 +1,141 @@
+#ifndef COMP6771_SPATIAL_INDEX_HPP
+#define COMP6771_SPATIAL_INDEX_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+#include "comp6771/nearest_neighbours.hpp"
+#include "comp6771/thread_pool.hpp"
+
+#include <concepts>
+#include <ranges>
+#include <vector>
+
+/*
+    Exact euclidean nearest-neighbour and radius search with a space partitioning tree, for
+    vectors of few dimensions (up to about 16) where a tree prunes most of the vectors.
+
+    Each node splits its vectors in half at the median of the dimension with the widest spread.
+    A kd_tree bounds the two halves by the split plane, and a ball_tree by the smallest ball
+    around its centroid, which prunes better once there are more than a handful of dimensions.
+
+    The tree is stored flat: nodes are in depth-first order in one array, and the vectors are
+    reordered so that every node covers a contiguous range of them. Subtrees are built in
+    parallel.
+*/
+namespace comp6771 {
+	enum class spatial_partitioning { kd_tree, ball_tree };
+
+	class spatial_index {
+	public:
+		explicit spatial_index(euclidean_vector_batch const& vectors,
+		                       spatial_partitioning partitioning = spatial_partitioning::kd_tree);
+		spatial_index(euclidean_vector_batch const& vectors,
+		              spatial_partitioning partitioning,
+		              thread_pool& pool);
+
+		// Throws euclidean_vector_error if the vectors do not all have the same dimensions
+		template<std::ranges::input_range R>
+		requires vector_expression<std::ranges::range_value_t<R>>
+		explicit spatial_index(R const& vectors,
+		                       spatial_partitioning partitioning = spatial_partitioning::kd_tree)
+		: spatial_index(to_batch(vectors), partitioning) {}
+
+		[[nodiscard]] auto size() const -> int;
+		[[nodiscard]] auto dimensions() const -> int;
+		[[nodiscard]] auto partitioning() const -> spatial_partitioning;
+
+		// Neighbours are in the same form as from brute_force_index with metric::l2, with indices
+		// into the vectors the index was built from.
+
+		// Throws euclidean_vector_error if <query> does not have dimensions() dimensions or the
+		// index is empty
+		template<vector_expression E>
+		[[nodiscard]] auto nearest(E const& query) const -> neighbour {
+			auto const result = search(query, 1);
+			if (result.empty()) {
+				throw euclidean_vector_error("spatial_index is empty");
+			}
+			return result.front();
+		}
+
+		// The <k> nearest vectors to <query>, nearest first, ties broken by the smaller index.
+		// Throws euclidean_vector_error if <query> does not have dimensions() dimensions or <k> is
+		// negative
+		template<vector_expression E>
+		[[nodiscard]] auto search(E const& query, int k) const -> std::vector<neighbour> {
+			detail::dimensions_check(dimensions(), query.dimensions());
+			auto const magnitudes = static_cast<std::vector<double>>(query);
+			return search(magnitudes.data(), k);
+		}
+
+		// Every vector within <radius> of <query>, nearest first.
+		// Throws euclidean_vector_error if <query> does not have dimensions() dimensions or
+		// <radius> is negative
+		template<vector_expression E>
+		[[nodiscard]] auto radius_search(E const& query, double radius) const
+		   -> std::vector<neighbour> {
+			detail::dimensions_check(dimensions(), query.dimensions());
+			auto const magnitudes = static_cast<std::vector<double>>(query);
+			return radius_search(magnitudes.data(), radius);
+		}
+
+	private:
+		struct tree_node {
+			// The node covers vectors [begin, end) in tree order
+			int begin;
+			int end;
+
+			// The left child follows its parent, -1 for leaves
+			int right;
+
+			int split_dimension;
+			double split_value;
+
+			// ball_tree only, the ball around centres_[this node]
+			double radius;
+		};
+
+		spatial_partitioning partitioning_;
+		int leaf_size_;
+		std::vector<tree_node> nodes_;
+
+		// The vectors in tree order, and where each came from
+		euclidean_vector_batch vectors_;
+		std::vector<int> indices_;
+
+		// ball_tree only, one row per node
+		euclidean_vector_batch centres_;
+
+		template<std::ranges::input_range R>
+		static auto to_batch(R const& vectors) -> euclidean_vector_batch {
+			auto const first = std::ranges::begin(vectors);
+			auto batch =
+			   euclidean_vector_batch(first == std::ranges::end(vectors) ? 0 : (*first).dimensions());
+			for (auto const& vector : vectors) {
+				batch.push_back(vector);
+			}
+			return batch;
+		}
+
+		// Number of nodes in a subtree of <count> vectors
+		[[nodiscard]] auto subtree_nodes(int count) const -> int;
+
+		// Builds the subtree under <node>, whose begin and end are already set, partitioning <order>
+		auto build(euclidean_vector_batch const& vectors,
+		           std::vector<int>& order,
+		           int node,
+		           thread_pool& pool) -> void;
+
+		[[nodiscard]] auto search(double const* query, int k) const -> std::vector<neighbour>;
+		[[nodiscard]] auto radius_search(double const* query, double radius) const
+		   -> std::vector<neighbour>;
+
+		// Calls <visit>(begin, end) for each leaf that may hold a vector nearer than <bound>(),
+		// the squared distance that is still of interest, nearest leaves first
+		template<typename Bound, typename Visit>
+		auto for_each_leaf(double const* query, Bound bound, Visit visit) const -> void;
+	};
+} // namespace comp6771
+
+#endif // COMP6771_SPATIAL_INDEX_HPP
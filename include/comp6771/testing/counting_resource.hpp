@@ -0,0 +1,48 @@
+#ifndef COMP6771_TESTING_COUNTING_RESOURCE_HPP
+#define COMP6771_TESTING_COUNTING_RESOURCE_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+/*
+    A memory resource that counts what is allocated from it, for the tests and tools that check
+    which operations allocate.
+*/
+namespace comp6771::testing {
+	// Counts allocations and deallocations before passing them on to <upstream>
+	class counting_resource : public std::pmr::memory_resource {
+	public:
+		explicit counting_resource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+		: upstream_{upstream} {}
+
+		[[nodiscard]] auto allocations() const -> long {
+			return allocations_;
+		}
+
+		[[nodiscard]] auto deallocations() const -> long {
+			return deallocations_;
+		}
+
+	private:
+		std::pmr::memory_resource* upstream_;
+		long allocations_ = 0;
+		long deallocations_ = 0;
+
+		auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override {
+			++allocations_;
+			return upstream_->allocate(bytes, alignment);
+		}
+
+		auto do_deallocate(void* p, std::size_t bytes, std::size_t alignment) -> void override {
+			++deallocations_;
+			upstream_->deallocate(p, bytes, alignment);
+		}
+
+		[[nodiscard]] auto do_is_equal(std::pmr::memory_resource const& other) const noexcept
+		   -> bool override {
+			return this == &other;
+		}
+	};
+} // namespace comp6771::testing
+
+#endif // COMP6771_TESTING_COUNTING_RESOURCE_HPP
@@ -0,0 +1,30 @@
+#ifndef COMP6771_TESTING_RANDOM_BATCH_HPP
+#define COMP6771_TESTING_RANDOM_BATCH_HPP
+
+#include "comp6771/euclidean_vector_batch.hpp"
+
+#include <algorithm>
+#include <random>
+
+/*
+    Reproducible random data for the tests and the recall tools.
+*/
+namespace comp6771::testing {
+	// <size> vectors of <dimensions> magnitudes drawn from <distribution>, the same for each <seed>
+	template<typename Distribution = std::uniform_real_distribution<double>>
+	[[nodiscard]] auto random_batch(int size,
+	                                int dimensions,
+	                                unsigned seed,
+	                                Distribution distribution = Distribution(-1, 1))
+	   -> euclidean_vector_batch {
+		auto engine = std::mt19937(seed);
+
+		auto batch = euclidean_vector_batch(size, dimensions, 0.0);
+		std::generate(batch.data(), batch.data() + size * dimensions, [&] {
+			return distribution(engine);
+		});
+		return batch;
+	}
+} // namespace comp6771::testing
+
+#endif // COMP6771_TESTING_RANDOM_BATCH_HPP
@@ -0,0 +1,52 @@
+#ifndef COMP6771_THREAD_POOL_HPP
+#define COMP6771_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/*
+    A fixed set of worker threads that is started once and reused, so that parallel work does not
+    pay for starting threads every time.
+*/
+namespace comp6771 {
+	class thread_pool {
+	public:
+		// Starts <threads> workers, or one per hardware thread if <threads> is 0
+		explicit thread_pool(int threads = 0);
+
+		thread_pool(thread_pool const&) = delete;
+		thread_pool(thread_pool&&) = delete;
+		auto operator=(thread_pool const&) -> thread_pool& = delete;
+		auto operator=(thread_pool&&) -> thread_pool& = delete;
+
+		// Waits for queued work to finish
+		~thread_pool();
+
+		// Number of workers
+		[[nodiscard]] auto size() const -> int;
+
+		// Calls <body>(i) for every i in [0, count) and returns once every call has returned. The
+		// calling thread takes part, so calling this from inside <body> does not deadlock. If any
+		// call throws, the remaining indices are skipped and the first exception is rethrown.
+		auto parallel_for(std::size_t count, std::function<void(std::size_t)> const& body) -> void;
+
+	private:
+		std::vector<std::thread> workers_;
+		std::queue<std::function<void()>> tasks_;
+		std::mutex mutex_;
+		std::condition_variable ready_;
+		bool stopping_ = false;
+
+		auto run() -> void;
+	};
+
+	// Shared by everything that does not take a thread_pool, started on first use
+	[[nodiscard]] auto default_thread_pool() -> thread_pool&;
+} // namespace comp6771
+
+#endif // COMP6771_THREAD_POOL_HPP
@@ -0,0 +1,133 @@
+#ifndef COMP6771_VECTOR_FILE_HPP
+#define COMP6771_VECTOR_FILE_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+    A binary file of many vectors of the same dimension, which is mapped into memory rather than
+    parsed, so opening a file of any size only reads its header.
+
+    The file is a 64 byte header followed by the rows, each padded to a multiple of 64 bytes so
+    that every row starts on a cache line. The header holds, in this host's byte order:
+
+        magic       8 bytes   "C6771EVF"
+        version     uint32    1
+        byte order  uint32    0x01020304, to detect files written on a host of the other order
+        dtype       uint32    vector_file_dtype
+        alignment   uint32    64
+        dimensions  uint64
+        rows        uint64
+        row stride  uint64    bytes from the start of one row to the start of the next
+        data offset uint64    bytes from the start of the file to the first row
+        reserved    8 bytes
+
+    The mapping is read only and shared, so processes that map the same file share its pages in
+    the page cache.
+*/
+namespace comp6771 {
+	enum class vector_file_dtype : std::uint32_t { float64 = 1 };
+
+	// Writes vectors one at a time, so files larger than memory can be written.
+	// The header is written by close(), which the destructor calls if it has not been called.
+	class vector_file_writer {
+	public:
+		// Throws euclidean_vector_error if <path> cannot be opened for writing
+		vector_file_writer(std::string const& path, int dimensions);
+
+		vector_file_writer(vector_file_writer const&) = delete;
+		auto operator=(vector_file_writer const&) -> vector_file_writer& = delete;
+
+		~vector_file_writer();
+
+		// Throws euclidean_vector_error if <expression> does not have dimensions() dimensions or
+		// cannot be written
+		template<vector_expression E>
+		auto push_back(E const& expression) -> void {
+			detail::dimensions_check(dimensions_, expression.dimensions());
+			for (auto i = 0; i < dimensions_; ++i) {
+				row_[static_cast<std::size_t>(i)] = expression[i];
+			}
+			write_row();
+		}
+
+		[[nodiscard]] auto size() const -> int;
+		[[nodiscard]] auto dimensions() const -> int;
+
+		// Throws euclidean_vector_error if the file cannot be written
+		auto close() -> void;
+
+	private:
+		std::string path_;
+		std::ofstream out_;
+		int dimensions_;
+		int size_ = 0;
+
+		// One row, with its padding
+		std::vector<double> row_;
+
+		auto write_row() -> void;
+	};
+
+	// Throws euclidean_vector_error if <path> cannot be written
+	auto write_vector_file(std::string const& path, euclidean_vector_batch const& vectors) -> void;
+
+	// How rows are about to be read, passed on to the kernel to tune read ahead
+	enum class access_pattern { normal, sequential, random, will_need };
+
+	// A read only mapping of a file written by vector_file_writer. Rows are views into the
+	// mapping, which remain valid for as long as the mapped_vector_file is not destroyed or
+	// assigned to.
+	class mapped_vector_file {
+	public:
+		// Throws euclidean_vector_error if <path> cannot be mapped or is not a vector file this
+		// host can read
+		explicit mapped_vector_file(std::string const& path);
+
+		mapped_vector_file(mapped_vector_file const&) = delete;
+		mapped_vector_file(mapped_vector_file&&) noexcept;
+
+		auto operator=(mapped_vector_file const&) -> mapped_vector_file& = delete;
+		auto operator=(mapped_vector_file&&) noexcept -> mapped_vector_file&;
+
+		~mapped_vector_file();
+
+		auto operator[](int index) const -> const_euclidean_vector_view {
+			assert(index >= 0 && index < size_);
+			return {rows_ + static_cast<std::size_t>(index) * stride_, dimensions_};
+		}
+
+		// Throws euclidean_vector_error if <index> is not a valid row
+		[[nodiscard]] auto at(int index) const -> const_euclidean_vector_view;
+
+		// Number of vectors
+		[[nodiscard]] auto size() const -> int;
+		[[nodiscard]] auto empty() const -> bool;
+		[[nodiscard]] auto dimensions() const -> int;
+
+		// Doubles from the start of one row to the start of the next
+		[[nodiscard]] auto stride() const -> std::size_t;
+
+		auto advise(access_pattern pattern) const -> void;
+
+	private:
+		void* mapping_ = nullptr;
+		std::size_t mapping_size_ = 0;
+		double const* rows_ = nullptr;
+		std::size_t stride_ = 0;
+		int size_ = 0;
+		int dimensions_ = 0;
+
+		auto unmap() noexcept -> void;
+	};
+} // namespace comp6771
+
+#endif // COMP6771_VECTOR_FILE_HPP
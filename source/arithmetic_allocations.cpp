@@ -0,0 +1,109 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Counts the allocations and measures the time of arithmetic on euclidean_vectors, with the
+// operands held in variables and with a temporary operand whose storage is reused.
+//
+// Usage: arithmetic_allocations [--dimensions D] [--iterations N]
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/testing/counting_resource.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+	using comp6771::testing::counting_resource;
+
+	struct options {
+		int dimensions = 1024;
+		int iterations = 100'000;
+	};
+
+	auto parse(int argc, char** argv) -> options {
+		auto result = options();
+		auto const args = std::vector<std::string>(argv + 1, argv + argc);
+		for (auto i = std::size_t{0}; i + 1 < args.size(); i += 2) {
+			auto const& flag = args[i];
+			auto const& value = args[i + 1];
+			if (flag == "--dimensions") {
+				result.dimensions = std::stoi(value);
+			}
+			else if (flag == "--iterations") {
+				result.iterations = std::stoi(value);
+			}
+			else {
+				throw comp6771::euclidean_vector_error("Unknown option " + flag);
+			}
+		}
+		return result;
+	}
+
+	struct scenario {
+		char const* name;
+
+		// Returns one magnitude of the result, so that the work cannot be skipped
+		std::function<double()> run;
+	};
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+	try {
+		auto const opts = parse(argc, argv);
+
+		auto resource = counting_resource();
+		auto const a = comp6771::euclidean_vector(opts.dimensions, 1.0, &resource);
+		auto const b = comp6771::euclidean_vector(opts.dimensions, 2.0, &resource);
+		auto const c = comp6771::euclidean_vector(opts.dimensions, 3.0, &resource);
+
+		// Stands in for any function that returns a new vector
+		auto const make = [&] { return comp6771::euclidean_vector(a, &resource); };
+
+		auto const scenarios = std::vector<scenario>{
+		   {"(a + b) * 2 - c",
+		    [&]() -> double { return comp6771::euclidean_vector((a + b) * 2 - c)[0]; }},
+		   {"t = make(); (t + b) * 2 - c",
+		    [&]() -> double {
+			    auto const t = make();
+			    return comp6771::euclidean_vector((t + b) * 2 - c)[0];
+		    }},
+		   {"(make() + b) * 2 - c", [&]() -> double { return ((make() + b) * 2 - c)[0]; }},
+		   {"t = make(); unit(t)",
+		    [&]() -> double {
+			    auto const t = make();
+			    return comp6771::unit(t)[0];
+		    }},
+		   {"unit(make())", [&]() -> double { return comp6771::unit(make())[0]; }},
+		   {"t = make(); -t / 2",
+		    [&]() -> double {
+			    auto const t = make();
+			    return comp6771::euclidean_vector(-t / 2)[0];
+		    }},
+		   {"-make() / 2", [&]() -> double { return (-make() / 2)[0]; }},
+		};
+
+		std::printf("%30s %18s %14s %10s\n", "expression", "allocations/iter", "time (ns)", "checksum");
+		for (auto const& [name, run] : scenarios) {
+			auto const allocations = resource.allocations();
+			auto checksum = 0.0;
+			auto const start = std::chrono::steady_clock::now();
+			for (auto i = 0; i < opts.iterations; ++i) {
+				checksum += run();
+			}
+			auto const elapsed =
+			   std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+			std::printf("%30s %18.2f %14.1f %10.0f\n",
+			            name,
+			            static_cast<double>(resource.allocations() - allocations) / opts.iterations,
+			            elapsed / opts.iterations,
+			            checksum);
+		}
+	} catch (std::exception const& e) {
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+}
@@ -0,0 +1,470 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include "comp6771/compressed_index.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include "comp6771/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		// Vectors scored per task when scanning
+		constexpr auto scan_block = std::size_t{16384};
+
+		auto parameters_check(pq_parameters const& parameters) -> void {
+			if (parameters.subspaces < 1) {
+				throw euclidean_vector_error("Invalid pq_parameters subspaces "
+				                             + std::to_string(parameters.subspaces));
+			}
+			if (parameters.centroids < 1 or parameters.centroids > 256) {
+				throw euclidean_vector_error("Invalid pq_parameters centroids "
+				                             + std::to_string(parameters.centroids));
+			}
+			if (parameters.iterations < 0) {
+				throw euclidean_vector_error("Invalid pq_parameters iterations "
+				                             + std::to_string(parameters.iterations));
+			}
+			if (parameters.training_size < 1) {
+				throw euclidean_vector_error("Invalid pq_parameters training_size "
+				                             + std::to_string(parameters.training_size));
+			}
+		}
+
+		auto squared_distance(double const* x, double const* y, std::size_t size) -> double {
+			auto sum = 0.0;
+			for (auto i = std::size_t{0}; i < size; ++i) {
+				sum += (x[i] - y[i]) * (x[i] - y[i]);
+			}
+			return sum;
+		}
+	} // namespace
+
+	auto name(compression c) -> std::string_view {
+		switch (c) {
+		case compression::float32: return "float32";
+		case compression::float16: return "float16";
+		case compression::bfloat16: return "bfloat16";
+		case compression::int8: return "int8";
+		case compression::product_quantization: return "product_quantization";
+		}
+		return "unknown";
+	}
+
+	// Constructors
+	compressed_index::compressed_index(euclidean_vector_batch const& vectors,
+	                                   compression mode,
+	                                   metric m,
+	                                   pq_parameters parameters)
+	: mode_{mode}
+	, metric_{m}
+	, size_{vectors.size()}
+	, dimensions_{vectors.dimensions()} {
+		if (mode_ == compression::product_quantization) {
+			parameters_check(parameters);
+			train(vectors, parameters);
+		}
+		compress(vectors);
+	}
+
+	// Member functions
+	auto compressed_index::size() const -> int {
+		return size_;
+	}
+
+	auto compressed_index::dimensions() const -> int {
+		return dimensions_;
+	}
+
+	auto compressed_index::mode() const -> compression {
+		return mode_;
+	}
+
+	auto compressed_index::distance_metric() const -> metric {
+		return metric_;
+	}
+
+	auto compressed_index::bytes_per_vector() const -> std::size_t {
+		auto const dimensions = static_cast<std::size_t>(dimensions_);
+		auto const norm = sizeof(float);
+		switch (mode_) {
+		case compression::float32: return dimensions * sizeof(float) + norm;
+		case compression::float16:
+		case compression::bfloat16: return dimensions * sizeof(std::uint16_t) + norm;
+		case compression::int8: return dimensions * sizeof(std::int8_t) + sizeof(float) + norm;
+		case compression::product_quantization: return subspaces() * sizeof(std::uint8_t) + norm;
+		}
+		return 0;
+	}
+
+	auto compressed_index::decompress(int index) const -> euclidean_vector {
+		if (index < 0 or index >= size_) {
+			throw euclidean_vector_error("Index " + std::to_string(index)
+			                             + " is not valid for this compressed_index object");
+		}
+
+		auto const dimensions = static_cast<std::size_t>(dimensions_);
+		auto const first = static_cast<std::size_t>(index) * dimensions;
+		auto magnitudes = std::vector<double>(dimensions);
+		switch (mode_) {
+		case compression::float32:
+			std::copy_n(floats_.data() + first, dimensions, magnitudes.begin());
+			break;
+		case compression::float16:
+			for (auto i = std::size_t{0}; i < dimensions; ++i) {
+				magnitudes[i] = kernels::from_float16(halves_[first + i]);
+			}
+			break;
+		case compression::bfloat16:
+			for (auto i = std::size_t{0}; i < dimensions; ++i) {
+				magnitudes[i] = kernels::from_bfloat16(halves_[first + i]);
+			}
+			break;
+		case compression::int8:
+			for (auto i = std::size_t{0}; i < dimensions; ++i) {
+				magnitudes[i] = scales_[static_cast<std::size_t>(index)] * bytes_[first + i];
+			}
+			break;
+		case compression::product_quantization:
+			for (auto s = std::size_t{0}; s < subspaces(); ++s) {
+				auto const begin = static_cast<std::size_t>(subspace_offsets_[s]);
+				auto const end = static_cast<std::size_t>(subspace_offsets_[s + 1]);
+				auto const* const c = centroid(s, codes_[static_cast<std::size_t>(index) * subspaces() + s]);
+				std::copy(c, c + (end - begin), magnitudes.begin() + static_cast<std::ptrdiff_t>(begin));
+			}
+			break;
+		}
+		return euclidean_vector(magnitudes.begin(), magnitudes.end());
+	}
+
+	// Helper functions
+	auto compressed_index::compress(euclidean_vector_batch const& vectors) -> void {
+		auto const dimensions = static_cast<std::size_t>(dimensions_);
+		auto const total = static_cast<std::size_t>(size_) * dimensions;
+		auto const* const magnitudes = vectors.data();
+
+		switch (mode_) {
+		case compression::float32: floats_.resize(total); break;
+		case compression::float16:
+		case compression::bfloat16: halves_.resize(total); break;
+		case compression::int8:
+			bytes_.resize(total);
+			scales_.resize(static_cast<std::size_t>(size_));
+			break;
+		case compression::product_quantization:
+			codes_.resize(static_cast<std::size_t>(size_) * subspaces());
+			break;
+		}
+
+		// The squared norm of each centroid, so that a quantised vector's is the sum of its codes'
+		auto const centroid_count = static_cast<std::size_t>(centroid_count_);
+		auto centroid_norms = std::vector<double>();
+		if (mode_ == compression::product_quantization) {
+			centroid_norms.resize(subspaces() * centroid_count);
+			for (auto s = std::size_t{0}; s < subspaces(); ++s) {
+				auto const width = static_cast<std::size_t>(subspace_offsets_[s + 1] - subspace_offsets_[s]);
+				for (auto c = std::size_t{0}; c < centroid_count; ++c) {
+					centroid_norms[s * centroid_count + c] = kernels::sum_of_squares(centroid(s, c), width);
+				}
+			}
+		}
+
+		// Norms of the vectors as stored, so that distances are consistent with the dot products.
+		// Each is found from the stored magnitudes as soon as they are encoded.
+		squared_norms_.resize(static_cast<std::size_t>(size_));
+		default_thread_pool().parallel_for(
+		   (static_cast<std::size_t>(size_) + scan_block - 1) / scan_block,
+		   [&](std::size_t const block) {
+			   auto const last = std::min((block + 1) * scan_block, static_cast<std::size_t>(size_));
+			   for (auto v = block * scan_block; v < last; ++v) {
+				   auto const first = v * dimensions;
+				   auto const* const vector = magnitudes + first;
+				   auto squared_norm = 0.0;
+
+				   switch (mode_) {
+				   case compression::float32:
+					   kernels::convert(vector, floats_.data() + first, dimensions);
+					   squared_norm = kernels::sum_of_squares(floats_.data() + first, dimensions);
+					   break;
+				   case compression::float16:
+					   for (auto i = std::size_t{0}; i < dimensions; ++i) {
+						   halves_[first + i] = kernels::to_float16(static_cast<float>(vector[i]));
+						   auto const stored = static_cast<double>(kernels::from_float16(halves_[first + i]));
+						   squared_norm += stored * stored;
+					   }
+					   break;
+				   case compression::bfloat16:
+					   for (auto i = std::size_t{0}; i < dimensions; ++i) {
+						   halves_[first + i] = kernels::to_bfloat16(static_cast<float>(vector[i]));
+						   auto const stored = static_cast<double>(kernels::from_bfloat16(halves_[first + i]));
+						   squared_norm += stored * stored;
+					   }
+					   break;
+				   case compression::int8: {
+					   auto const largest =
+					      std::accumulate(vector, vector + dimensions, 0.0, [](double x, double y) {
+						      return std::max(x, std::abs(y));
+					      });
+					   auto const scale = static_cast<float>(largest / 127);
+					   scales_[v] = scale;
+					   for (auto i = std::size_t{0}; i < dimensions; ++i) {
+						   auto const code = scale == 0 ? 0.0 : std::round(vector[i] / static_cast<double>(scale));
+						   bytes_[first + i] = static_cast<std::int8_t>(std::clamp(code, -127.0, 127.0));
+						   // As decompress() widens it
+						   auto const stored = static_cast<double>(scale * bytes_[first + i]);
+						   squared_norm += stored * stored;
+					   }
+					   break;
+				   }
+				   case compression::product_quantization:
+					   for (auto s = std::size_t{0}; s < subspaces(); ++s) {
+						   auto const begin = static_cast<std::size_t>(subspace_offsets_[s]);
+						   auto const width = static_cast<std::size_t>(subspace_offsets_[s + 1]) - begin;
+						   auto const* const sub = vector + begin;
+
+						   auto best = std::size_t{0};
+						   auto best_distance = std::numeric_limits<double>::infinity();
+						   for (auto c = std::size_t{0}; c < centroid_count; ++c) {
+							   auto const distance = squared_distance(sub, centroid(s, c), width);
+							   if (distance < best_distance) {
+								   best = c;
+								   best_distance = distance;
+							   }
+						   }
+						   codes_[v * subspaces() + s] = static_cast<std::uint8_t>(best);
+						   squared_norm += centroid_norms[s * centroid_count + best];
+					   }
+					   break;
+				   }
+				   squared_norms_[v] = static_cast<float>(squared_norm);
+			   }
+		   });
+	}
+
+	auto compressed_index::train(euclidean_vector_batch const& vectors,
+	                             pq_parameters const& parameters) -> void {
+		auto const dimensions = static_cast<std::size_t>(dimensions_);
+		auto const subspace_count = std::max(std::min(parameters.subspaces, dimensions_), 1);
+		subspace_offsets_.resize(static_cast<std::size_t>(subspace_count) + 1);
+		for (auto s = 0; s <= subspace_count; ++s) {
+			subspace_offsets_[static_cast<std::size_t>(s)] = s * dimensions_ / subspace_count;
+		}
+
+		// Train on a random sample, whose first centroid_count_ rows are the initial centroids
+		auto sample = std::vector<int>(static_cast<std::size_t>(size_));
+		std::iota(sample.begin(), sample.end(), 0);
+		auto random = std::mt19937(parameters.seed);
+		std::shuffle(sample.begin(), sample.end(), random);
+		sample.resize(std::min(sample.size(), static_cast<std::size_t>(parameters.training_size)));
+
+		centroid_count_ = std::min(parameters.centroids, static_cast<int>(sample.size()));
+		auto const centroid_count = static_cast<std::size_t>(centroid_count_);
+		centroids_.resize(dimensions * centroid_count);
+
+		default_thread_pool().parallel_for(subspaces(), [&](std::size_t const s) {
+			auto const begin = static_cast<std::size_t>(subspace_offsets_[s]);
+			auto const width = static_cast<std::size_t>(subspace_offsets_[s + 1]) - begin;
+			auto* const centroids = centroids_.data() + begin * centroid_count;
+			auto const sub = [&](std::size_t const i) {
+				return vectors.data() + static_cast<std::size_t>(sample[i]) * dimensions + begin;
+			};
+
+			for (auto c = std::size_t{0}; c < centroid_count; ++c) {
+				std::copy(sub(c), sub(c) + width, centroids + c * width);
+			}
+
+			// Lloyd's algorithm. Centroids that lose all their vectors stay where they are.
+			auto sums = std::vector<double>(centroid_count * width);
+			auto counts = std::vector<int>(centroid_count);
+			for (auto iteration = 0; iteration < parameters.iterations; ++iteration) {
+				std::fill(sums.begin(), sums.end(), 0.0);
+				std::fill(counts.begin(), counts.end(), 0);
+
+				for (auto i = std::size_t{0}; i < sample.size(); ++i) {
+					auto best = std::size_t{0};
+					auto best_distance = std::numeric_limits<double>::infinity();
+					for (auto c = std::size_t{0}; c < centroid_count; ++c) {
+						auto const distance = squared_distance(sub(i), centroids + c * width, width);
+						if (distance < best_distance) {
+							best = c;
+							best_distance = distance;
+						}
+					}
+					++counts[best];
+					auto* const sum = sums.data() + best * width;
+					std::transform(sub(i), sub(i) + width, sum, sum, std::plus<>());
+				}
+
+				for (auto c = std::size_t{0}; c < centroid_count; ++c) {
+					if (counts[c] > 0) {
+						for (auto j = std::size_t{0}; j < width; ++j) {
+							centroids[c * width + j] = sums[c * width + j] / counts[c];
+						}
+					}
+				}
+			}
+		});
+	}
+
+	auto compressed_index::subspaces() const -> std::size_t {
+		return subspace_offsets_.empty() ? 0 : subspace_offsets_.size() - 1;
+	}
+
+	auto compressed_index::centroid(std::size_t s, std::size_t c) const -> double const* {
+		auto const begin = static_cast<std::size_t>(subspace_offsets_[s]);
+		auto const width = static_cast<std::size_t>(subspace_offsets_[s + 1]) - begin;
+		return centroids_.data() + begin * static_cast<std::size_t>(centroid_count_) + c * width;
+	}
+
+	auto compressed_index::dot(double const* query, int index) const -> double {
+		if (index < 0 or index >= size_) {
+			throw euclidean_vector_error("Index " + std::to_string(index)
+			                             + " is not valid for this compressed_index object");
+		}
+
+		auto const table =
+		   mode_ == compression::product_quantization ? dot_table(query) : std::vector<double>();
+		auto const v = static_cast<std::size_t>(index);
+		auto result = 0.0;
+		for_each_dot(query, table, v, v + 1, [&result](std::size_t, double const dot) { result = dot; });
+		return result;
+	}
+
+	template<typename F>
+	auto compressed_index::for_each_dot(double const* query,
+	                                    std::vector<double> const& table,
+	                                    std::size_t first,
+	                                    std::size_t last,
+	                                    F f) const -> void {
+		auto const dimensions = static_cast<std::size_t>(dimensions_);
+
+		switch (mode_) {
+		case compression::float32:
+			for (auto v = first; v < last; ++v) {
+				f(v, kernels::dot(query, floats_.data() + v * dimensions, dimensions));
+			}
+			break;
+		case compression::float16:
+			for (auto v = first; v < last; ++v) {
+				f(v, kernels::dot_float16(query, halves_.data() + v * dimensions, dimensions));
+			}
+			break;
+		case compression::bfloat16:
+			for (auto v = first; v < last; ++v) {
+				f(v, kernels::dot_bfloat16(query, halves_.data() + v * dimensions, dimensions));
+			}
+			break;
+		case compression::int8:
+			for (auto v = first; v < last; ++v) {
+				auto const dot = kernels::dot(query, bytes_.data() + v * dimensions, dimensions);
+				f(v, static_cast<double>(scales_[v]) * dot);
+			}
+			break;
+		case compression::product_quantization: {
+			auto const centroid_count = static_cast<std::size_t>(centroid_count_);
+			for (auto v = first; v < last; ++v) {
+				auto const* const codes = codes_.data() + v * subspaces();
+				auto dot = 0.0;
+				for (auto s = std::size_t{0}; s < subspaces(); ++s) {
+					dot += table[s * centroid_count + codes[s]];
+				}
+				f(v, dot);
+			}
+			break;
+		}
+		}
+	}
+
+	auto compressed_index::dot_table(double const* query) const -> std::vector<double> {
+		auto const centroid_count = static_cast<std::size_t>(centroid_count_);
+		auto table = std::vector<double>(subspaces() * centroid_count);
+		for (auto s = std::size_t{0}; s < subspaces(); ++s) {
+			auto const begin = static_cast<std::size_t>(subspace_offsets_[s]);
+			auto const width = static_cast<std::size_t>(subspace_offsets_[s + 1]) - begin;
+			for (auto c = std::size_t{0}; c < centroid_count; ++c) {
+				table[s * centroid_count + c] = kernels::dot(query + begin, centroid(s, c), width);
+			}
+		}
+		return table;
+	}
+
+	auto compressed_index::search(double const* query, int k) const -> std::vector<neighbour> {
+		detail::k_check(k);
+
+		auto const query_norm = kernels::sum_of_squares(query, static_cast<std::size_t>(dimensions_));
+		auto const size = static_cast<std::size_t>(size_);
+		auto const nearest = std::min(static_cast<std::size_t>(k), size);
+		auto const blocks = (size + scan_block - 1) / scan_block;
+
+		// Product quantization scores every vector from one table per query
+		auto const table =
+		   mode_ == compression::product_quantization ? dot_table(query) : std::vector<double>();
+
+		auto heaps = std::vector<detail::bounded_heap>(blocks, detail::bounded_heap(nearest));
+		default_thread_pool().parallel_for(blocks, [&](std::size_t const block) {
+			auto const first = block * scan_block;
+			auto const last = std::min(first + scan_block, size);
+			for_each_dot(query, table, first, last, [&](std::size_t const v, double const dot) {
+				auto const distance = detail::metric_distance(metric_, dot, query_norm, squared_norms_[v]);
+				heaps[block].push({static_cast<int>(v), distance});
+			});
+		});
+
+		auto result = std::vector<neighbour>();
+		for (auto const& heap : heaps) {
+			result.insert(result.end(), heap.neighbours().begin(), heap.neighbours().end());
+		}
+		std::sort(result.begin(), result.end(), detail::nearer);
+		result.resize(nearest);
+		if (metric_ == metric::l2) {
+			for (auto& n : result) {
+				n.distance = std::sqrt(n.distance);
+			}
+		}
+		return result;
+	}
+
+	auto compressed_index::rerank(double const* query,
+	                              int k,
+	                              euclidean_vector_batch const& originals,
+	                              int candidates) const -> std::vector<neighbour> {
+		detail::k_check(k);
+		detail::dimensions_check(dimensions_, originals.dimensions());
+		if (originals.size() != size_) {
+			throw euclidean_vector_error("Sizes of LHS(" + std::to_string(size_) + ") and RHS("
+			                             + std::to_string(originals.size()) + ") do not match");
+		}
+
+		auto const dimensions = static_cast<std::size_t>(dimensions_);
+		auto const query_norm = kernels::sum_of_squares(query, dimensions);
+
+		auto result = search(query, std::max(candidates, k));
+		for (auto& n : result) {
+			auto const* const original = originals[n.index].data();
+			n.distance = detail::exact_distance(metric_,
+			                                    query,
+			                                    query_norm,
+			                                    original,
+			                                    kernels::sum_of_squares(original, dimensions),
+			                                    dimensions);
+		}
+
+		std::sort(result.begin(), result.end(), detail::nearer);
+		result.resize(std::min(result.size(), static_cast<std::size_t>(k)));
+		if (metric_ == metric::l2) {
+			for (auto& n : result) {
+				n.distance = std::sqrt(n.distance);
+			}
+		}
+		return result;
+	}
+} // namespace comp6771
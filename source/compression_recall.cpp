@@ -0,0 +1,149 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Measures the memory, recall and latency of each compressed_index mode against
+// brute_force_index on random data.
+//
+// Usage: compression_recall [--size N] [--dimensions D] [--queries Q] [--k K]
+//                           [--candidates C] [--subspaces S] [--metric l2|inner_product|cosine]
+#include "comp6771/compressed_index.hpp"
+#include "comp6771/nearest_neighbours.hpp"
+#include "comp6771/testing/random_batch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+	struct options {
+		int size = 100'000;
+		int dimensions = 64;
+		int queries = 200;
+		int k = 10;
+		int candidates = 100;
+		comp6771::metric metric = comp6771::metric::l2;
+		comp6771::pq_parameters parameters = {};
+	};
+
+	auto parse_metric(std::string_view value) -> comp6771::metric {
+		for (auto const m :
+		     {comp6771::metric::l2, comp6771::metric::inner_product, comp6771::metric::cosine}) {
+			if (comp6771::name(m) == value) {
+				return m;
+			}
+		}
+		throw comp6771::euclidean_vector_error("Unknown metric " + std::string(value));
+	}
+
+	auto parse(int argc, char** argv) -> options {
+		auto result = options();
+		auto const args = std::vector<std::string>(argv + 1, argv + argc);
+		for (auto i = std::size_t{0}; i + 1 < args.size(); i += 2) {
+			auto const& flag = args[i];
+			auto const& value = args[i + 1];
+			if (flag == "--size") {
+				result.size = std::stoi(value);
+			}
+			else if (flag == "--dimensions") {
+				result.dimensions = std::stoi(value);
+			}
+			else if (flag == "--queries") {
+				result.queries = std::stoi(value);
+			}
+			else if (flag == "--k") {
+				result.k = std::stoi(value);
+			}
+			else if (flag == "--candidates") {
+				result.candidates = std::stoi(value);
+			}
+			else if (flag == "--subspaces") {
+				result.parameters.subspaces = std::stoi(value);
+			}
+			else if (flag == "--metric") {
+				result.metric = parse_metric(value);
+			}
+			else {
+				throw comp6771::euclidean_vector_error("Unknown option " + flag);
+			}
+		}
+		return result;
+	}
+
+	using comp6771::testing::random_batch;
+
+	auto recall(std::vector<comp6771::neighbour> const& found,
+	            std::vector<comp6771::neighbour> const& exact) -> int {
+		return static_cast<int>(std::count_if(exact.begin(), exact.end(), [&found](auto const& e) {
+			return std::any_of(found.begin(), found.end(), [&e](auto const& f) {
+				return f.index == e.index;
+			});
+		}));
+	}
+
+	auto elapsed_us(std::chrono::steady_clock::time_point start) -> double {
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+		   .count();
+	}
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+	try {
+		auto const opts = parse(argc, argv);
+		auto const normal = std::normal_distribution<double>(0, 1);
+		auto const vectors = random_batch(opts.size, opts.dimensions, 1, normal);
+		auto const queries = random_batch(opts.queries, opts.dimensions, 2, normal);
+
+		auto const exact = comp6771::brute_force_index(vectors, opts.metric).search(queries, opts.k);
+		auto const full_bytes = sizeof(double) * static_cast<std::size_t>(opts.dimensions);
+
+		std::printf("%22s %8s %8s %10s %10s %12s %12s\n",
+		            "mode",
+		            "bytes",
+		            "ratio",
+		            "recall",
+		            "reranked",
+		            "scan (us)",
+		            "rerank (us)");
+		for (auto const mode : {comp6771::compression::float32,
+		                        comp6771::compression::float16,
+		                        comp6771::compression::bfloat16,
+		                        comp6771::compression::int8,
+		                        comp6771::compression::product_quantization}) {
+			auto const index = comp6771::compressed_index(vectors, mode, opts.metric, opts.parameters);
+
+			auto found = 0;
+			auto found_reranked = 0;
+			auto scan = 0.0;
+			auto rerank = 0.0;
+			for (auto q = 0; q < queries.size(); ++q) {
+				auto const& truth = exact[static_cast<std::size_t>(q)];
+
+				auto start = std::chrono::steady_clock::now();
+				found += recall(index.search(queries[q], opts.k), truth);
+				scan += elapsed_us(start);
+
+				start = std::chrono::steady_clock::now();
+				found_reranked += recall(index.search(queries[q], opts.k, vectors, opts.candidates), truth);
+				rerank += elapsed_us(start);
+			}
+
+			auto const total = static_cast<double>(opts.queries * opts.k);
+			std::printf("%22s %8zu %7.1fx %10.4f %10.4f %12.1f %12.1f\n",
+			            std::string(comp6771::name(mode)).c_str(),
+			            index.bytes_per_vector(),
+			            static_cast<double>(full_bytes) / static_cast<double>(index.bytes_per_vector()),
+			            found / total,
+			            found_reranked / total,
+			            scan / opts.queries,
+			            rerank / opts.queries);
+		}
+	} catch (std::exception const& e) {
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+}
@@ -2,177 +2,330 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 //
 #include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include "comp6771/instrumentation.hpp"
+#include "comp6771/thread_pool.hpp"
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <charconv>
 #include <cmath>
 #include <cstddef>
 #include <cstdlib>
 #include <ctime>
 #include <functional>
-#include <iostream>
+#include <istream>
 #include <iterator>
 #include <limits>
 #include <memory>
 #include <numeric>
-#include <sstream>
+#include <ostream>
+#include <span>
 #include <string>
 #include <system_error>
 #include <utility>
 
-#include <experimental/iterator>
-
 namespace comp6771 {
-	// Constructors
-	euclidean_vector::euclidean_vector()
-	: euclidean_vector(1, 0) {}
+	namespace {
+		// 8 MiB of magnitudes, where the work of a reduction outweighs waking the pool
+		auto parallel_threshold_ = std::atomic<std::size_t>{std::size_t{1} << 20U};
+
+		// The element-wise kernel behind each operation of merge and scale
+		template<magnitude_type T>
+		auto apply(std::plus<>, T* x, T const* y, std::size_t size) -> void {
+			kernels::add(x, y, size);
+		}
 
-	euclidean_vector::euclidean_vector(int dimensions)
-	: euclidean_vector(dimensions, 0) {}
+		template<magnitude_type T>
+		auto apply(std::minus<>, T* x, T const* y, std::size_t size) -> void {
+			kernels::subtract(x, y, size);
+		}
 
-	euclidean_vector::euclidean_vector(int dimensions, double magnitude)
-	// NOLINTNEXTLINE(modernize-avoid-c-arrays)
-	: magnitude_{std::make_unique<double[]>(static_cast<std::size_t>(dimensions))}
+		template<magnitude_type T>
+		auto apply(std::multiplies<>, T* x, T factor, std::size_t size) -> void {
+			kernels::multiply(x, factor, size);
+		}
+
+		template<magnitude_type T>
+		auto apply(std::divides<>, T* x, T factor, std::size_t size) -> void {
+			kernels::divide(x, factor, size);
+		}
+	} // namespace
+
+	auto parallel_threshold() -> std::size_t {
+		return parallel_threshold_.load(std::memory_order_relaxed);
+	}
+
+	auto set_parallel_threshold(std::size_t dimensions) -> void {
+		parallel_threshold_.store(dimensions, std::memory_order_relaxed);
+	}
+
+	// Constructors
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector()
+	: basic_euclidean_vector(1, 0) {}
+
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(allocator_type const& allocator)
+	: basic_euclidean_vector(1, 0, allocator) {}
+
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(int dimensions)
+	: basic_euclidean_vector(dimensions, 0) {}
+
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(int dimensions, allocator_type const& allocator)
+	: basic_euclidean_vector(dimensions, 0, allocator) {}
+
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(int dimensions, T magnitude)
+	: basic_euclidean_vector(dimensions, magnitude, allocator_type{}) {}
+
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(int dimensions,
+	                                                  T magnitude,
+	                                                  allocator_type const& allocator)
+	: resource_{allocator.resource()}
+	, magnitude_{allocate(static_cast<std::size_t>(dimensions))}
+	, small_magnitude_{}
 	, dimensions_{static_cast<std::size_t>(dimensions)}
-	, cached_norm_{-1} {
-		std::fill(magnitude_.get(), magnitude_.get() + dimensions_, magnitude);
+	, squared_norm_{-1}
+	, squared_norm_error_{0} {
+		std::fill(data(), data() + dimensions_, magnitude);
 	}
 
-	euclidean_vector::euclidean_vector(std::vector<double>::const_iterator begin,
-	                                   std::vector<double>::const_iterator end)
-	: euclidean_vector(static_cast<int>(std::distance(begin, end))) {
-		std::copy(begin, end, magnitude_.get());
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(typename std::vector<T>::const_iterator begin,
+	                                                  typename std::vector<T>::const_iterator end)
+	: basic_euclidean_vector(begin, end, allocator_type{}) {}
+
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(typename std::vector<T>::const_iterator begin,
+	                                                  typename std::vector<T>::const_iterator end,
+	                                                  allocator_type const& allocator)
+	: basic_euclidean_vector(static_cast<int>(std::distance(begin, end)), allocator) {
+		std::copy(begin, end, data());
 	}
 
 	// For an empty initializer list, the default constructor is called.
-	euclidean_vector::euclidean_vector(std::initializer_list<double> list)
-	: euclidean_vector(static_cast<int>(list.size())) {
-		std::copy(list.begin(), list.end(), magnitude_.get());
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(std::initializer_list<T> list)
+	: basic_euclidean_vector(list, allocator_type{}) {}
+
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(std::initializer_list<T> list,
+	                                                  allocator_type const& allocator)
+	: basic_euclidean_vector(static_cast<int>(list.size()), allocator) {
+		std::copy(list.begin(), list.end(), data());
+	}
+
+	template<magnitude_type T>
+	template<magnitude_type U>
+	requires(not std::same_as<U, T>)
+	basic_euclidean_vector<T>::basic_euclidean_vector(basic_euclidean_vector<U> const& other,
+	                                                  allocator_type const& allocator)
+	: basic_euclidean_vector(other.dimensions(), allocator) {
+		auto* const magnitudes = data();
+		auto const* const others = other.data();
+		detail::for_each_chunk(dimensions_, [&](std::size_t first, std::size_t last) {
+			kernels::convert(others + first, magnitudes + first, last - first);
+		});
 	}
 
 	// Copy Constructor
-	euclidean_vector::euclidean_vector(euclidean_vector const& original)
-	: euclidean_vector(original.dimensions()) {
-		std::copy(original.magnitude_.get(),
-		          original.magnitude_.get() + original.dimensions_,
-		          magnitude_.get());
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(basic_euclidean_vector const& original)
+	: basic_euclidean_vector(original, allocator_type{}) {}
+
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(basic_euclidean_vector const& original,
+	                                                  allocator_type const& allocator)
+	: basic_euclidean_vector(original.dimensions(), allocator) {
+		instrumentation::add(instrumentation::counter::copies);
+		instrumentation::add(instrumentation::counter::copied_bytes, dimensions_ * sizeof(T));
+		std::copy(original.data(), original.data() + original.dimensions_, data());
 
-		cached_norm_ = original.cached_norm_;
+		set_squared_norm(original.squared_norm(), original.squared_norm_error_);
 	}
 
 	// Move Constructor
-	euclidean_vector::euclidean_vector(euclidean_vector&& other) noexcept
-	: magnitude_{std::exchange(other.magnitude_, nullptr)}
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(basic_euclidean_vector&& other) noexcept
+	: resource_{other.resource_}
+	, magnitude_{std::exchange(other.magnitude_, nullptr)}
+	, small_magnitude_{other.small_magnitude_}
 	, dimensions_{std::exchange(other.dimensions_, 0)}
-	, cached_norm_{std::exchange(other.cached_norm_, -1)} {}
+	, squared_norm_{other.squared_norm()}
+	, squared_norm_error_{other.squared_norm_error_} {
+		other.invalidate_squared_norm();
+		instrumentation::add(instrumentation::counter::moves);
+	}
+
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(basic_euclidean_vector&& other,
+	                                                  allocator_type const& allocator)
+	: basic_euclidean_vector(allocator.resource()->is_equal(*other.resource_)
+	                            ? basic_euclidean_vector(std::move(other))
+	                            : basic_euclidean_vector(other, allocator)) {}
+
+	// Destructor
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::~basic_euclidean_vector() {
+		deallocate();
+	}
 
 	// Operator Overload
-	auto euclidean_vector::operator=(euclidean_vector const& original) -> euclidean_vector& {
-		auto other = euclidean_vector(original);
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::operator=(basic_euclidean_vector const& original)
+	   -> basic_euclidean_vector& {
+		// Reuse the existing storage rather than going back to the memory resource
+		if (dimensions_ == original.dimensions_) {
+			instrumentation::add(instrumentation::counter::copies);
+			instrumentation::add(instrumentation::counter::copied_bytes, dimensions_ * sizeof(T));
+			std::copy(original.data(), original.data() + original.dimensions_, data());
+			set_squared_norm(original.squared_norm(), original.squared_norm_error_);
+			return *this;
+		}
+
+		auto other = basic_euclidean_vector(original, get_allocator());
 		swap(*this, other);
 		return *this;
 	}
 
-	auto euclidean_vector::operator=(euclidean_vector&& other) noexcept -> euclidean_vector& {
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::operator=(basic_euclidean_vector&& other)
+	   -> basic_euclidean_vector& {
 		// Avoid self assignment
 		if (this == std::addressof(other)) {
 			return *this;
 		}
 
+		if (not resource_->is_equal(*other.resource_)) {
+			return *this = static_cast<basic_euclidean_vector const&>(other);
+		}
+
+		instrumentation::add(instrumentation::counter::moves);
 		swap(*this, other);
 
 		// Reset the moved from object
-		other.magnitude_.reset();
+		other.deallocate();
 		other.dimensions_ = 0;
-		other.cached_norm_ = -1;
+		other.invalidate_squared_norm();
 
 		return *this;
 	}
 
-	auto euclidean_vector::operator[](int const& index) -> double& {
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::operator[](int const& index) -> reference {
 		assert(index >= 0 && index < dimensions());
-		invalidate_cached_norm();
 
-		return magnitude_[static_cast<std::size_t>(index)];
+		return reference(*this, data()[static_cast<std::size_t>(index)]);
 	}
 
-	auto euclidean_vector::operator[](int const& index) const -> const double& {
-		assert(index >= 0 && index < dimensions());
-
-		return magnitude_[static_cast<std::size_t>(index)];
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::operator+() const& -> basic_euclidean_vector {
+		return basic_euclidean_vector(*this, get_allocator());
 	}
 
-	auto euclidean_vector::operator+() const -> euclidean_vector {
-		return *this;
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::operator-() const&
+	   -> vector_unary_expression<std::negate<>, basic_euclidean_vector> {
+		return vector_unary_expression<std::negate<>, basic_euclidean_vector>(*this);
 	}
 
-	auto euclidean_vector::operator-() const -> euclidean_vector {
-		auto copy = euclidean_vector(*this);
-
-		std::transform(copy.magnitude_.get(),
-		               copy.magnitude_.get() + copy.dimensions_,
-		               copy.magnitude_.get(),
-		               std::negate<>());
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::operator+() && -> basic_euclidean_vector {
+		return std::move(*this);
+	}
 
-		return copy;
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::operator-() && -> basic_euclidean_vector {
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::arithmetic);
+		scale(*this, -1, std::multiplies<>());
+		return std::move(*this);
 	}
 
-	auto euclidean_vector::operator+=(euclidean_vector const& other) -> euclidean_vector& {
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::operator+=(basic_euclidean_vector const& other)
+	   -> basic_euclidean_vector& {
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::arithmetic);
 		merge(*this, other, std::plus<>());
-		invalidate_cached_norm();
 		return *this;
 	}
 
-	auto euclidean_vector::operator-=(euclidean_vector const& other) -> euclidean_vector& {
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::operator-=(basic_euclidean_vector const& other)
+	   -> basic_euclidean_vector& {
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::arithmetic);
 		merge(*this, other, std::minus<>());
-		invalidate_cached_norm();
 		return *this;
 	}
 
-	auto euclidean_vector::operator*=(double factor) -> euclidean_vector& {
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::operator*=(double factor) -> basic_euclidean_vector& {
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::arithmetic);
 		scale(*this, factor, std::multiplies<>());
-		invalidate_cached_norm();
 		return *this;
 	}
 
-	auto euclidean_vector::operator/=(double factor) -> euclidean_vector& {
-		if (factor == 0) {
-			throw euclidean_vector_error("Invalid vector division by 0");
-		}
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::operator/=(double factor) -> basic_euclidean_vector& {
+		detail::division_check(factor);
 
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::arithmetic);
 		scale(*this, factor, std::divides<>());
-		invalidate_cached_norm();
 		return *this;
 	}
 
-	euclidean_vector::operator std::vector<double>() const {
-		return std::vector<double>(magnitude_.get(), magnitude_.get() + dimensions_);
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::operator std::vector<T>() const {
+		return std::vector<T>(data(), data() + dimensions_);
 	}
 
-	euclidean_vector::operator std::list<double>() const {
-		return std::list<double>(magnitude_.get(), magnitude_.get() + dimensions_);
+	template<magnitude_type T>
+	basic_euclidean_vector<T>::operator std::list<T>() const {
+		return std::list<T>(data(), data() + dimensions_);
 	}
 
 	// Member functions
-	[[nodiscard]] auto euclidean_vector::at(int index) const -> double {
-		euclidean_vector::index_check(*this, index);
+	template<magnitude_type T>
+	[[nodiscard]] auto basic_euclidean_vector<T>::at(int index) const -> T {
+		basic_euclidean_vector::index_check(*this, index);
 
-		return magnitude_[static_cast<std::size_t>(index)];
+		return data()[static_cast<std::size_t>(index)];
 	}
 
-	auto euclidean_vector::at(int index) -> double& {
-		euclidean_vector::index_check(*this, index);
-		invalidate_cached_norm();
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::at(int index) -> reference {
+		basic_euclidean_vector::index_check(*this, index);
 
-		return magnitude_[static_cast<std::size_t>(index)];
+		return reference(*this, data()[static_cast<std::size_t>(index)]);
 	}
 
-	[[nodiscard]] auto euclidean_vector::dimensions() const -> int {
+	template<magnitude_type T>
+	[[nodiscard]] auto basic_euclidean_vector<T>::dimensions() const -> int {
 		return static_cast<int>(dimensions_);
 	}
 
+	template<magnitude_type T>
+	[[nodiscard]] auto basic_euclidean_vector<T>::get_allocator() const -> allocator_type {
+		return allocator_type(resource_);
+	}
+
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::freeze_norm() -> double {
+		// A squared norm that has been updated may have drifted, so it is computed again
+		if (squared_norm() < 0 or squared_norm_error_ != 0) {
+			set_squared_norm(detail::sum_of_squares(data(), dimensions_), 0);
+		}
+		return std::sqrt(squared_norm());
+	}
+
 	// Friends
-	auto operator==(euclidean_vector const& first, euclidean_vector const& second) -> bool {
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::equal(basic_euclidean_vector const& first,
+	                                      basic_euclidean_vector const& second) -> bool {
 		// Identity check
 		if (std::addressof(first) == std::addressof(second)) {
 			return true;
@@ -182,151 +335,493 @@ namespace comp6771 {
 			return false;
 		}
 
-		return std::equal(first.magnitude_.get(),
-		                  first.magnitude_.get() + first.dimensions_,
-		                  second.magnitude_.get(),
-		                  second.magnitude_.get() + second.dimensions_,
-		                  [](double const& f, double const& s) {
-			                  return std::fabs(f - s) < std::numeric_limits<double>::epsilon();
+		return std::equal(first.data(),
+		                  first.data() + first.dimensions_,
+		                  second.data(),
+		                  second.data() + second.dimensions_,
+		                  [](T const& f, T const& s) {
+			                  return std::fabs(f - s) < std::numeric_limits<T>::epsilon();
 		                  });
 	}
 
-	auto operator!=(euclidean_vector const& first, euclidean_vector const& second) -> bool {
-		return not(first == second);
-	}
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::read(std::istream& is, basic_euclidean_vector& ev)
+	   -> std::istream& {
+		auto text = std::string();
+		if ((is >> std::ws).peek() != '[' or not std::getline(is, text, ']') or is.eof()) {
+			is.setstate(std::ios_base::failbit);
+			return is;
+		}
+		text.push_back(']');
 
-	auto operator+(euclidean_vector const& first, euclidean_vector const& second) -> euclidean_vector {
-		auto first_copy = euclidean_vector(first);
-		first_copy += second;
-		return first_copy;
+		if (from_chars(text.data(), text.data() + text.size(), ev).ptr != text.data() + text.size()) {
+			is.setstate(std::ios_base::failbit);
+		}
+		return is;
 	}
 
-	auto operator-(euclidean_vector const& first, euclidean_vector const& second) -> euclidean_vector {
-		auto first_copy = euclidean_vector(first);
-		first_copy -= second;
-		return first_copy;
+	// Helper functions
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::index_check(basic_euclidean_vector const& ev, int index) -> void {
+		if (index < 0 or index >= ev.dimensions()) {
+			throw euclidean_vector_error("Index " + std::to_string(index)
+			                             + " is not valid for this euclidean_vector object");
+		}
 	}
 
-	auto operator*(euclidean_vector const& ev, double factor) -> euclidean_vector {
-		auto ev_copy = euclidean_vector(ev);
-		ev_copy *= factor;
-		return ev_copy;
+	template<magnitude_type T>
+	auto basic_euclidean_vector<T>::dimensions_check(basic_euclidean_vector const& first,
+	                                                 basic_euclidean_vector const& second) -> void {
+		detail::dimensions_check(first.dimensions(), second.dimensions());
 	}
 
-	auto operator/(euclidean_vector const& ev, double factor) -> euclidean_vector {
-		auto ev_copy = euclidean_vector(ev);
-		ev_copy /= factor;
-		return ev_copy;
+	auto detail::dimensions_check(int lhs, int rhs) -> void {
+		if (lhs != rhs) {
+			throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(lhs) + ") and RHS("
+			                             + std::to_string(rhs) + ") do not match");
+		}
 	}
 
-	auto operator<<(std::ostream& os, euclidean_vector const& ev) -> std::ostream& {
-		auto oss = std::ostringstream{};
-		oss << '[';
-
-		std::copy(ev.magnitude_.get(),
-		          ev.magnitude_.get() + ev.dimensions_,
-		          std::experimental::make_ostream_joiner(oss, " "));
-
-		oss << "]";
+	auto detail::division_check(double factor) -> void {
+		if (factor == 0) {
+			throw euclidean_vector_error("Invalid vector division by 0");
+		}
+	}
 
-		os << oss.str();
+	template<magnitude_type T>
+	auto detail::scalar_cast(double factor) -> T {
+		auto const rounded = static_cast<T>(factor);
+		if (std::isfinite(factor) and (std::isinf(rounded) or (rounded == 0 and factor != 0))) {
+			throw euclidean_vector_error("Invalid vector scale by a factor out of range");
+		}
+		return rounded;
+	}
+
+	template<magnitude_type T>
+	auto detail::write_magnitudes(std::ostream& os, T const* magnitudes, int dimensions)
+	   -> std::ostream& {
+		// Formatted a buffer at a time with std::to_chars, so nothing is allocated and the locale
+		// does not change the output. The longest magnitude is 13 characters, as in -1.23457e-308.
+		constexpr auto longest = std::ptrdiff_t{13};
+		auto buffer = std::array<char, 1024>{};
+		auto* const end = buffer.data() + buffer.size();
+		auto* out = buffer.data();
+
+		// A field width applies to the whole vector, which has to be formatted first to pad it
+		auto text = std::string();
+		auto const flush = [&] {
+			if (os.width() == 0) {
+				os.write(buffer.data(), out - buffer.data());
+			}
+			else {
+				text.append(buffer.data(), out);
+			}
+			out = buffer.data();
+		};
+
+		*out++ = '[';
+		for (auto i = 0; i < dimensions; ++i) {
+			if (end - out <= longest + 2) {
+				flush();
+			}
+			if (i > 0) {
+				*out++ = ' ';
+			}
+			out = std::to_chars(out, end, magnitudes[i], std::chars_format::general, text_precision).ptr;
+		}
+		*out++ = ']';
+		flush();
 
+		if (os.width() != 0) {
+			os << text;
+		}
 		return os;
 	}
 
-	// Helper functions
-	auto euclidean_vector::index_check(euclidean_vector const& ev, int index) -> void {
-		if (index < 0 or index >= ev.dimensions()) {
-			throw euclidean_vector_error("Index " + std::to_string(index)
-			                             + " is not valid for this euclidean_vector object");
+	template<magnitude_type T>
+	auto detail::parse_magnitudes(char const* first, char const* last, std::vector<T>& magnitudes)
+	   -> std::from_chars_result {
+		auto const size = magnitudes.size();
+		auto const failed = [&](std::errc const ec) {
+			magnitudes.resize(size);
+			return std::from_chars_result{first, ec};
+		};
+		auto const skip_whitespace = [last](char const* p) {
+			while (p != last and (*p == ' ' or (*p >= '\t' and *p <= '\r'))) {
+				++p;
+			}
+			return p;
+		};
+
+		if (first == last or *first != '[') {
+			return failed(std::errc::invalid_argument);
+		}
+
+		auto const* p = skip_whitespace(first + 1);
+		while (p != last and *p != ']') {
+			auto magnitude = T{0};
+			auto const result = std::from_chars(p, last, magnitude);
+			if (result.ec != std::errc{}) {
+				return failed(result.ec);
+			}
+
+			// Magnitudes are separated by whitespace
+			p = skip_whitespace(result.ptr);
+			if (p == result.ptr and p != last and *p != ']') {
+				return failed(std::errc::invalid_argument);
+			}
+			magnitudes.push_back(magnitude);
 		}
-	}
 
-	auto euclidean_vector::dimensions_check(euclidean_vector const& first,
-	                                        euclidean_vector const& second) -> void {
-		if (first.dimensions() != second.dimensions()) {
-			throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(first.dimensions())
-			                             + ") and RHS(" + std::to_string(second.dimensions())
-			                             + ") do not match");
+		if (p == last) {
+			return failed(std::errc::invalid_argument);
 		}
+		return {p + 1, std::errc{}};
 	}
 
-	// Merge <other> into <subject> using <func>
-	auto euclidean_vector::merge(euclidean_vector const& subject,
-	                             euclidean_vector const& other,
-	                             std::function<double(double, double)> const& func) -> void {
-		// Error Checking
-		euclidean_vector::dimensions_check(subject, other);
+	auto detail::parallel_chunks(
+	   std::size_t size,
+	   std::function<void(std::size_t, std::size_t, std::size_t)> const& body) -> void {
+		auto const chunks = (size + parallel_chunk - 1) / parallel_chunk;
+		default_thread_pool().parallel_for(chunks, [&](std::size_t const chunk) {
+			auto const first = chunk * parallel_chunk;
+			body(chunk, first, std::min(first + parallel_chunk, size));
+		});
+	}
 
-		// Perform mutation
-		std::transform(subject.magnitude_.get(),
-		               subject.magnitude_.get() + subject.dimensions_,
-		               other.magnitude_.get(),
-		               subject.magnitude_.get(),
-		               func);
+	auto detail::dot(double const* x, double const* y, std::size_t size) -> double {
+		return reduce_chunks(size, [x, y](std::size_t first, std::size_t last) {
+			return kernels::dot(x + first, y + first, last - first);
+		});
 	}
 
-	// Scale <this> by <factor> using <func>
-	auto euclidean_vector::scale(euclidean_vector const& ev,
-	                             double const& factor,
-	                             std::function<double(double, double)> const& func) -> void {
-		// Perform mutation
-		std::transform(ev.magnitude_.get(),
-		               ev.magnitude_.get() + ev.dimensions_,
-		               ev.magnitude_.get(),
-		               [&](double const& i) { return func(i, factor); });
+	auto detail::dot(float const* x, float const* y, std::size_t size) -> double {
+		return reduce_chunks(size, [x, y](std::size_t first, std::size_t last) {
+			return kernels::dot(x + first, y + first, last - first);
+		});
 	}
 
-	// Utility Functions
-	auto euclidean_norm(euclidean_vector const& v) -> double {
-		if (v.cached_norm_ != -1) {
-			return v.cached_norm_;
-		}
+	auto detail::dot(double const* x, float const* y, std::size_t size) -> double {
+		return reduce_chunks(size, [x, y](std::size_t first, std::size_t last) {
+			return kernels::dot(x + first, y + first, last - first);
+		});
+	}
 
-		auto dot_product = std::inner_product(v.magnitude_.get(),
-		                                      v.magnitude_.get() + v.dimensions_,
-		                                      v.magnitude_.get(),
-		                                      0.0);
+	auto detail::dot(float const* x, double const* y, std::size_t size) -> double {
+		return dot(y, x, size);
+	}
 
-		auto norm = std::sqrt(dot_product);
-		v.cached_norm_ = norm;
+	auto detail::sum_of_squares(double const* x, std::size_t size) -> double {
+		return reduce_chunks(size, [x](std::size_t first, std::size_t last) {
+			return kernels::sum_of_squares(x + first, last - first);
+		});
+	}
 
-		return norm;
+	auto detail::sum_of_squares(float const* x, std::size_t size) -> double {
+		return reduce_chunks(size, [x](std::size_t first, std::size_t last) {
+			return kernels::sum_of_squares(x + first, last - first);
+		});
 	}
 
-	auto unit(euclidean_vector const& v) -> euclidean_vector {
-		if (v.dimensions() == 0) {
+	auto detail::unit_check(int dimensions, double norm) -> void {
+		if (dimensions == 0) {
 			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a unit "
 			                             "vector");
 		}
-
-		auto norm = euclidean_norm(v);
 		if (norm == 0) {
 			throw euclidean_vector_error("euclidean_vector with zero euclidean normal does not have a "
 			                             "unit vector");
 		}
+	}
+
+	// Merge <other> into <subject> using <func>
+	// <func> selects the dispatched kernel, so the loop runs the widest instruction set the host
+	// supports rather than only the one the library was compiled for.
+	template<magnitude_type T>
+	template<typename BinaryOperation>
+	auto basic_euclidean_vector<T>::merge(basic_euclidean_vector& subject,
+	                                      basic_euclidean_vector const& other,
+	                                      BinaryOperation func) -> void {
+		// Error Checking
+		basic_euclidean_vector::dimensions_check(subject, other);
+
+		// Perform mutation
+		auto* const magnitudes = subject.data();
+		auto const* const others = other.data();
+		subject.update_magnitudes([&](std::size_t first, std::size_t last) {
+			apply(func, magnitudes + first, others + first, last - first);
+		});
+	}
+
+	// Scale <ev> by <factor> using <func>, and its squared norm by the square of <factor>
+	// <factor> is rounded to T first, so that float vectors are scaled in float, and must fit in T
+	template<magnitude_type T>
+	template<typename BinaryOperation>
+	auto basic_euclidean_vector<T>::scale(basic_euclidean_vector& ev,
+	                                      double factor,
+	                                      BinaryOperation func) -> void {
+		// Perform mutation
+		auto* const magnitudes = ev.data();
+		auto const rounded = detail::scalar_cast<T>(factor);
+		detail::for_each_chunk(ev.dimensions_, [&](std::size_t first, std::size_t last) {
+			apply(func, magnitudes + first, rounded, last - first);
+		});
+
+		if (ev.squared_norm() < 0) {
+			return;
+		}
+
+		auto const ratio = func(1.0, static_cast<double>(rounded));
+		auto const squared_norm = ev.squared_norm() * ratio * ratio;
+		auto error = ev.squared_norm_error_ * ratio * ratio;
+
+		// Scaling by a power of two is exact, otherwise each magnitude is rounded to T
+		auto exponent = 0;
+		if (std::fabs(std::frexp(rounded, &exponent)) != T{0.5}) {
+			error += (std::numeric_limits<T>::epsilon() + 2 * std::numeric_limits<double>::epsilon())
+			         * squared_norm;
+		}
+		// Unless the magnitudes have overflowed or become subnormal
+		if (not std::isnormal(squared_norm)) {
+			ev.invalidate_squared_norm();
+			return;
+		}
+		ev.accept_squared_norm(squared_norm, error);
+	}
+
+	// Utility Functions
+	template<magnitude_type T>
+	auto euclidean_norm(basic_euclidean_vector<T> const& v) -> double {
+		return std::sqrt(squared_euclidean_norm(v));
+	}
+
+	template<magnitude_type T>
+	auto squared_euclidean_norm(basic_euclidean_vector<T> const& v) -> double {
+		if (auto const squared_norm = v.squared_norm(); squared_norm >= 0) {
+			instrumentation::add(instrumentation::counter::norm_cache_hits);
+			return squared_norm;
+		}
+
+		instrumentation::add(instrumentation::counter::norm_cache_misses);
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::euclidean_norm);
+		auto const squared_norm = detail::sum_of_squares(v.data(), v.dimensions_);
+		// squared_norm_error_ is already 0, as the squared norm was discarded
+		v.squared_norm_.store(squared_norm, std::memory_order_relaxed);
+
+		return squared_norm;
+	}
+
+	template<magnitude_type T>
+	auto operator+(basic_euclidean_vector<T>&& lhs, basic_euclidean_vector<T>&& rhs)
+	   -> basic_euclidean_vector<T> {
+		lhs += rhs;
+		return std::move(lhs);
+	}
+
+	template<magnitude_type T>
+	auto operator-(basic_euclidean_vector<T>&& lhs, basic_euclidean_vector<T>&& rhs)
+	   -> basic_euclidean_vector<T> {
+		lhs -= rhs;
+		return std::move(lhs);
+	}
+
+	template<magnitude_type T>
+	auto operator*(basic_euclidean_vector<T>&& ev, double factor) -> basic_euclidean_vector<T> {
+		ev *= factor;
+		return std::move(ev);
+	}
+
+	template<magnitude_type T>
+	auto operator/(basic_euclidean_vector<T>&& ev, double factor) -> basic_euclidean_vector<T> {
+		ev /= factor;
+		return std::move(ev);
+	}
+
+	template<magnitude_type T>
+	auto unit(basic_euclidean_vector<T>&& v) -> basic_euclidean_vector<T> {
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::unit);
+		auto norm = v.dimensions() == 0 ? 0.0 : euclidean_norm(v);
+		detail::unit_check(v.dimensions(), norm);
+
+		v /= norm;
+		return std::move(v);
+	}
 
-		auto v_copy = euclidean_vector(v);
+	template<magnitude_type T>
+	auto unit(basic_euclidean_vector<T> const& v) -> basic_euclidean_vector<T> {
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::unit);
+		auto norm = v.dimensions() == 0 ? 0.0 : euclidean_norm(v);
+		detail::unit_check(v.dimensions(), norm);
+
+		auto v_copy = basic_euclidean_vector<T>(v, v.get_allocator());
 		v_copy /= norm;
 
 		return v_copy;
 	}
 
-	auto dot(euclidean_vector const& x, euclidean_vector const& y) -> double {
-		if (x.dimensions() != y.dimensions()) {
-			throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(x.dimensions())
-			                             + ") and RHS(" + std::to_string(y.dimensions())
-			                             + ") do not match");
-		}
+	template<magnitude_type T>
+	auto dot(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y) -> double {
+		detail::dimensions_check(x.dimensions(), y.dimensions());
+
+		auto const timer = instrumentation::scoped_timer(instrumentation::operation::dot);
 
 		// Dot product of two 0-dimension vectors yield 0
 		if (x.dimensions() == 0) {
 			return 0;
 		}
 
-		auto dot_product = std::inner_product(&(x[0]), &(x[0]) + x.dimensions(), &(y[0]), 0.0);
+		auto dot_product =
+		   detail::dot(&(x[0]), &(y[0]), static_cast<std::size_t>(x.dimensions()));
 
 		return dot_product;
 	}
 
+	template<magnitude_type T>
+	auto distance(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y) -> double {
+		return std::sqrt(squared_distance(x, y));
+	}
+
+	template<magnitude_type T>
+	auto squared_distance(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y)
+	   -> double {
+		detail::dimensions_check(x.dimensions(), y.dimensions());
+		return kernels::squared_distance(detail::magnitudes_of(x),
+		                                 detail::magnitudes_of(y),
+		                                 static_cast<std::size_t>(x.dimensions()));
+	}
+
+	template<magnitude_type T>
+	auto cosine_similarity(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y)
+	   -> double {
+		detail::dimensions_check(x.dimensions(), y.dimensions());
+
+		auto const size = static_cast<std::size_t>(x.dimensions());
+		auto products = kernels::dot_products{0, x.squared_norm(), y.squared_norm()};
+		if (products.xx >= 0 and products.yy >= 0) {
+			products.xy = kernels::dot(x.data(), y.data(), size);
+		}
+		else {
+			// Not cached, since the cache must hold what euclidean_norm would compute
+			products = kernels::dot_and_squares(x.data(), y.data(), size);
+		}
+
+		auto const norms = std::sqrt(products.xx) * std::sqrt(products.yy);
+		return norms == 0 ? 0.0 : std::clamp(products.xy / norms, -1.0, 1.0);
+	}
+
+	template<magnitude_type T>
+	auto manhattan(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y) -> double {
+		detail::dimensions_check(x.dimensions(), y.dimensions());
+		return kernels::manhattan(detail::magnitudes_of(x),
+		                          detail::magnitudes_of(y),
+		                          static_cast<std::size_t>(x.dimensions()));
+	}
+
+	template<magnitude_type T>
+	auto chebyshev(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y) -> double {
+		detail::dimensions_check(x.dimensions(), y.dimensions());
+		return kernels::chebyshev(detail::magnitudes_of(x),
+		                          detail::magnitudes_of(y),
+		                          static_cast<std::size_t>(x.dimensions()));
+	}
+
+	namespace {
+		template<magnitude_type T>
+		auto freeze_each_norm(std::span<basic_euclidean_vector<T>> vectors) -> void {
+			default_thread_pool().parallel_for(vectors.size(), [vectors](std::size_t const i) {
+				vectors[i].freeze_norm();
+			});
+		}
+	} // namespace
+
+	auto freeze_norms(std::span<basic_euclidean_vector<float>> vectors) -> void {
+		freeze_each_norm(vectors);
+	}
+
+	auto freeze_norms(std::span<basic_euclidean_vector<double>> vectors) -> void {
+		freeze_each_norm(vectors);
+	}
+
+	template<magnitude_type T>
+	auto from_chars(char const* first, char const* last, basic_euclidean_vector<T>& v)
+	   -> std::from_chars_result {
+		auto magnitudes = std::vector<T>();
+		auto const result = detail::parse_magnitudes(first, last, magnitudes);
+		if (result.ec == std::errc{}) {
+			v = basic_euclidean_vector<T>(magnitudes.cbegin(), magnitudes.cend(), v.get_allocator());
+		}
+		return result;
+	}
+
+	// Explicit instantiations for each magnitude_type
+	template class basic_euclidean_vector<float>;
+	template class basic_euclidean_vector<double>;
+
+	template basic_euclidean_vector<float>::basic_euclidean_vector(
+	   basic_euclidean_vector<double> const&,
+	   allocator_type const&);
+	template basic_euclidean_vector<double>::basic_euclidean_vector(
+	   basic_euclidean_vector<float> const&,
+	   allocator_type const&);
+
+	template auto detail::scalar_cast<float>(double) -> float;
+	template auto detail::scalar_cast<double>(double) -> double;
+	template auto detail::write_magnitudes(std::ostream&, float const*, int) -> std::ostream&;
+	template auto detail::write_magnitudes(std::ostream&, double const*, int) -> std::ostream&;
+	template auto detail::parse_magnitudes(char const*, char const*, std::vector<float>&)
+	   -> std::from_chars_result;
+	template auto detail::parse_magnitudes(char const*, char const*, std::vector<double>&)
+	   -> std::from_chars_result;
+
+	template auto euclidean_norm(basic_euclidean_vector<float> const&) -> double;
+	template auto euclidean_norm(basic_euclidean_vector<double> const&) -> double;
+	template auto squared_euclidean_norm(basic_euclidean_vector<float> const&) -> double;
+	template auto squared_euclidean_norm(basic_euclidean_vector<double> const&) -> double;
+	template auto unit(basic_euclidean_vector<float> const&) -> basic_euclidean_vector<float>;
+	template auto unit(basic_euclidean_vector<double> const&) -> basic_euclidean_vector<double>;
+	template auto unit(basic_euclidean_vector<float>&&) -> basic_euclidean_vector<float>;
+	template auto unit(basic_euclidean_vector<double>&&) -> basic_euclidean_vector<double>;
+	template auto dot(basic_euclidean_vector<float> const&, basic_euclidean_vector<float> const&)
+	   -> double;
+	template auto dot(basic_euclidean_vector<double> const&, basic_euclidean_vector<double> const&)
+	   -> double;
+	template auto distance(basic_euclidean_vector<float> const&,
+	                       basic_euclidean_vector<float> const&) -> double;
+	template auto distance(basic_euclidean_vector<double> const&,
+	                       basic_euclidean_vector<double> const&) -> double;
+	template auto squared_distance(basic_euclidean_vector<float> const&,
+	                               basic_euclidean_vector<float> const&) -> double;
+	template auto squared_distance(basic_euclidean_vector<double> const&,
+	                               basic_euclidean_vector<double> const&) -> double;
+	template auto cosine_similarity(basic_euclidean_vector<float> const&,
+	                                basic_euclidean_vector<float> const&) -> double;
+	template auto cosine_similarity(basic_euclidean_vector<double> const&,
+	                                basic_euclidean_vector<double> const&) -> double;
+	template auto manhattan(basic_euclidean_vector<float> const&,
+	                        basic_euclidean_vector<float> const&) -> double;
+	template auto manhattan(basic_euclidean_vector<double> const&,
+	                        basic_euclidean_vector<double> const&) -> double;
+	template auto chebyshev(basic_euclidean_vector<float> const&,
+	                        basic_euclidean_vector<float> const&) -> double;
+	template auto chebyshev(basic_euclidean_vector<double> const&,
+	                        basic_euclidean_vector<double> const&) -> double;
+	template auto from_chars(char const*, char const*, basic_euclidean_vector<float>&)
+	   -> std::from_chars_result;
+	template auto from_chars(char const*, char const*, basic_euclidean_vector<double>&)
+	   -> std::from_chars_result;
+
+	template auto operator+(basic_euclidean_vector<float>&&, basic_euclidean_vector<float>&&)
+	   -> basic_euclidean_vector<float>;
+	template auto operator+(basic_euclidean_vector<double>&&, basic_euclidean_vector<double>&&)
+	   -> basic_euclidean_vector<double>;
+	template auto operator-(basic_euclidean_vector<float>&&, basic_euclidean_vector<float>&&)
+	   -> basic_euclidean_vector<float>;
+	template auto operator-(basic_euclidean_vector<double>&&, basic_euclidean_vector<double>&&)
+	   -> basic_euclidean_vector<double>;
+	template auto operator*(basic_euclidean_vector<float>&&, double) -> basic_euclidean_vector<float>;
+	template auto operator*(basic_euclidean_vector<double>&&, double)
+	   -> basic_euclidean_vector<double>;
+	template auto operator/(basic_euclidean_vector<float>&&, double) -> basic_euclidean_vector<float>;
+	template auto operator/(basic_euclidean_vector<double>&&, double)
+	   -> basic_euclidean_vector<double>;
 } // namespace comp6771
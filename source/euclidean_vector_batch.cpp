@@ -0,0 +1,403 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		// Check if the number of vectors in two batches match, throw exception if not
+		auto sizes_check(int lhs, int rhs) -> void {
+			if (lhs != rhs) {
+				throw euclidean_vector_error("Sizes of LHS(" + std::to_string(lhs) + ") and RHS("
+				                             + std::to_string(rhs) + ") do not match");
+			}
+		}
+
+		// Texts are split into pieces of about this many bytes to be parsed in parallel
+		constexpr auto parse_piece = std::size_t{1} << 20U;
+	} // namespace
+
+	// Constructors
+	euclidean_vector_batch::euclidean_vector_batch(int dimensions, allocator_type const& allocator)
+	: resource_{allocator.resource()}
+	, magnitudes_{nullptr}
+	, size_{0}
+	, capacity_{0}
+	, dimensions_{static_cast<std::size_t>(dimensions)} {}
+
+	euclidean_vector_batch::euclidean_vector_batch(int size,
+	                                               int dimensions,
+	                                               double magnitude,
+	                                               allocator_type const& allocator)
+	: euclidean_vector_batch(dimensions, allocator) {
+		reserve(size);
+		size_ = static_cast<std::size_t>(size);
+		std::fill(magnitudes_, magnitudes_ + size_ * dimensions_, magnitude);
+	}
+
+	euclidean_vector_batch::euclidean_vector_batch(euclidean_vector_batch const& original)
+	: euclidean_vector_batch(original.dimensions()) {
+		reserve(original.size());
+		size_ = original.size_;
+		std::copy(original.magnitudes_, original.magnitudes_ + size_ * dimensions_, magnitudes_);
+	}
+
+	euclidean_vector_batch::euclidean_vector_batch(euclidean_vector_batch&& other) noexcept
+	: resource_{other.resource_}
+	, magnitudes_{std::exchange(other.magnitudes_, nullptr)}
+	, size_{std::exchange(other.size_, 0)}
+	, capacity_{std::exchange(other.capacity_, 0)}
+	, dimensions_{other.dimensions_} {}
+
+	euclidean_vector_batch::~euclidean_vector_batch() {
+		deallocate();
+	}
+
+	// Operator Overload
+	auto euclidean_vector_batch::operator=(euclidean_vector_batch const& original)
+	   -> euclidean_vector_batch& {
+		if (this == std::addressof(original)) {
+			return *this;
+		}
+
+		// Reuse the existing buffer if it is big enough
+		if (dimensions_ != original.dimensions_ or capacity_ < original.size_) {
+			deallocate();
+			size_ = 0;
+			dimensions_ = original.dimensions_;
+			reallocate(original.size_);
+		}
+
+		size_ = original.size_;
+		std::copy(original.magnitudes_, original.magnitudes_ + size_ * dimensions_, magnitudes_);
+		return *this;
+	}
+
+	auto euclidean_vector_batch::operator=(euclidean_vector_batch&& other) -> euclidean_vector_batch& {
+		if (this == std::addressof(other)) {
+			return *this;
+		}
+
+		// Like euclidean_vector, the memory resource never changes after construction
+		if (not resource_->is_equal(*other.resource_)) {
+			return *this = static_cast<euclidean_vector_batch const&>(other);
+		}
+
+		deallocate();
+		magnitudes_ = std::exchange(other.magnitudes_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+		capacity_ = std::exchange(other.capacity_, 0);
+		dimensions_ = other.dimensions_;
+		return *this;
+	}
+
+	auto euclidean_vector_batch::operator[](int index) -> euclidean_vector_view {
+		assert(index >= 0 && index < size());
+		return euclidean_vector_view(row(static_cast<std::size_t>(index)), dimensions());
+	}
+
+	auto euclidean_vector_batch::operator[](int index) const -> const_euclidean_vector_view {
+		assert(index >= 0 && index < size());
+		return const_euclidean_vector_view(row(static_cast<std::size_t>(index)), dimensions());
+	}
+
+	auto euclidean_vector_batch::operator+=(euclidean_vector_batch const& other)
+	   -> euclidean_vector_batch& {
+		size_check(*this, other);
+		detail::for_each_chunk(size_ * dimensions_, [&](std::size_t first, std::size_t last) {
+			kernels::add(magnitudes_ + first, other.magnitudes_ + first, last - first);
+		});
+		return *this;
+	}
+
+	auto euclidean_vector_batch::operator-=(euclidean_vector_batch const& other)
+	   -> euclidean_vector_batch& {
+		size_check(*this, other);
+		detail::for_each_chunk(size_ * dimensions_, [&](std::size_t first, std::size_t last) {
+			kernels::subtract(magnitudes_ + first, other.magnitudes_ + first, last - first);
+		});
+		return *this;
+	}
+
+	auto euclidean_vector_batch::operator*=(double factor) -> euclidean_vector_batch& {
+		detail::for_each_chunk(size_ * dimensions_, [&](std::size_t first, std::size_t last) {
+			kernels::multiply(magnitudes_ + first, factor, last - first);
+		});
+		return *this;
+	}
+
+	auto euclidean_vector_batch::operator/=(double factor) -> euclidean_vector_batch& {
+		detail::division_check(factor);
+		detail::for_each_chunk(size_ * dimensions_, [&](std::size_t first, std::size_t last) {
+			kernels::divide(magnitudes_ + first, factor, last - first);
+		});
+		return *this;
+	}
+
+	// Member functions
+	auto euclidean_vector_batch::at(int index) -> euclidean_vector_view {
+		index_check(index);
+		return (*this)[index];
+	}
+
+	auto euclidean_vector_batch::at(int index) const -> const_euclidean_vector_view {
+		index_check(index);
+		return (*this)[index];
+	}
+
+	auto euclidean_vector_batch::size() const -> int {
+		return static_cast<int>(size_);
+	}
+
+	auto euclidean_vector_batch::empty() const -> bool {
+		return size_ == 0;
+	}
+
+	auto euclidean_vector_batch::capacity() const -> int {
+		return static_cast<int>(capacity_);
+	}
+
+	auto euclidean_vector_batch::dimensions() const -> int {
+		return static_cast<int>(dimensions_);
+	}
+
+	auto euclidean_vector_batch::data() -> double* {
+		return magnitudes_;
+	}
+
+	auto euclidean_vector_batch::data() const -> double const* {
+		return magnitudes_;
+	}
+
+	auto euclidean_vector_batch::get_allocator() const -> allocator_type {
+		return allocator_type(resource_);
+	}
+
+	auto euclidean_vector_batch::reserve(int capacity) -> void {
+		if (static_cast<std::size_t>(capacity) > capacity_) {
+			reallocate(static_cast<std::size_t>(capacity));
+		}
+	}
+
+	auto euclidean_vector_batch::resize(int size) -> void {
+		auto const new_size = static_cast<std::size_t>(size);
+		reserve(size);
+		if (new_size > size_) {
+			std::fill(row(size_), row(new_size), 0.0);
+		}
+		size_ = new_size;
+	}
+
+	auto euclidean_vector_batch::clear() -> void {
+		size_ = 0;
+	}
+
+	// Helper functions
+	auto euclidean_vector_batch::row(std::size_t index) -> double* {
+		return magnitudes_ + index * dimensions_;
+	}
+
+	auto euclidean_vector_batch::row(std::size_t index) const -> double const* {
+		return magnitudes_ + index * dimensions_;
+	}
+
+	auto euclidean_vector_batch::reallocate(std::size_t capacity) -> void {
+		auto const bytes = capacity * dimensions_ * sizeof(double);
+		auto* const magnitudes =
+		   bytes == 0 ? nullptr : static_cast<double*>(resource_->allocate(bytes, alignment));
+
+		std::copy(magnitudes_, magnitudes_ + size_ * dimensions_, magnitudes);
+		deallocate();
+
+		magnitudes_ = magnitudes;
+		capacity_ = capacity;
+	}
+
+	auto euclidean_vector_batch::deallocate() noexcept -> void {
+		if (magnitudes_ != nullptr) {
+			resource_->deallocate(magnitudes_, capacity_ * dimensions_ * sizeof(double), alignment);
+			magnitudes_ = nullptr;
+			capacity_ = 0;
+		}
+	}
+
+	auto euclidean_vector_batch::grow() -> void {
+		reallocate(std::max(capacity_ * 2, std::size_t{8}));
+	}
+
+	auto euclidean_vector_batch::index_check(int index) const -> void {
+		if (index < 0 or index >= size()) {
+			throw euclidean_vector_error("Index " + std::to_string(index)
+			                             + " is not valid for this euclidean_vector_batch object");
+		}
+	}
+
+	auto euclidean_vector_batch::size_check(euclidean_vector_batch const& first,
+	                                        euclidean_vector_batch const& second) -> void {
+		detail::dimensions_check(first.dimensions(), second.dimensions());
+		sizes_check(first.size(), second.size());
+	}
+
+	auto euclidean_vector_batch::broadcast_add(std::vector<double> const& magnitudes, double sign)
+	   -> void {
+		detail::dimensions_check(dimensions(), static_cast<int>(magnitudes.size()));
+		for (auto i = std::size_t{0}; i < size_; ++i) {
+			auto* const current = row(i);
+			for (auto j = std::size_t{0}; j < dimensions_; ++j) {
+				current[j] += sign * magnitudes[j];
+			}
+		}
+	}
+
+	// Utility functions
+	auto dot(euclidean_vector_batch const& x, euclidean_vector_batch const& y) -> std::vector<double> {
+		detail::dimensions_check(x.dimensions(), y.dimensions());
+		sizes_check(x.size(), y.size());
+
+		auto const dimensions = static_cast<std::size_t>(x.dimensions());
+		auto result = std::vector<double>(static_cast<std::size_t>(x.size()));
+		for (auto i = std::size_t{0}; i < result.size(); ++i) {
+			result[i] = kernels::dot(x.data() + i * dimensions, y.data() + i * dimensions, dimensions);
+		}
+		return result;
+	}
+
+	auto dot(euclidean_vector_batch const& x, const_euclidean_vector_view y) -> std::vector<double> {
+		detail::dimensions_check(x.dimensions(), y.dimensions());
+
+		auto const dimensions = static_cast<std::size_t>(x.dimensions());
+		auto result = std::vector<double>(static_cast<std::size_t>(x.size()));
+		for (auto i = std::size_t{0}; i < result.size(); ++i) {
+			result[i] = kernels::dot(x.data() + i * dimensions, y.data(), dimensions);
+		}
+		return result;
+	}
+
+	auto euclidean_norm(euclidean_vector_batch const& batch) -> std::vector<double> {
+		auto const dimensions = static_cast<std::size_t>(batch.dimensions());
+		auto result = std::vector<double>(static_cast<std::size_t>(batch.size()));
+		for (auto i = std::size_t{0}; i < result.size(); ++i) {
+			result[i] = std::sqrt(kernels::sum_of_squares(batch.data() + i * dimensions, dimensions));
+		}
+		return result;
+	}
+
+	auto unit(euclidean_vector_batch const& batch) -> euclidean_vector_batch {
+		if (batch.dimensions() == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a unit "
+			                             "vector");
+		}
+
+		auto const norms = euclidean_norm(batch);
+		if (std::find(norms.begin(), norms.end(), 0.0) != norms.end()) {
+			throw euclidean_vector_error("euclidean_vector with zero euclidean normal does not have a "
+			                             "unit vector");
+		}
+
+		// Like unit(euclidean_vector), the result uses the resource of <batch>
+		auto result = euclidean_vector_batch(batch.size(), batch.dimensions(), 0.0, batch.get_allocator());
+		for (auto i = 0; i < result.size(); ++i) {
+			auto const norm = norms[static_cast<std::size_t>(i)];
+			std::transform(batch[i].data(),
+			               batch[i].data() + batch.dimensions(),
+			               result[i].data(),
+			               [norm](double const magnitude) { return magnitude / norm; });
+		}
+		return result;
+	}
+
+	auto parse_vectors(std::string_view text) -> euclidean_vector_batch {
+		return parse_vectors(text, default_thread_pool());
+	}
+
+	auto parse_vectors(std::string_view text, thread_pool& pool) -> euclidean_vector_batch {
+		struct piece {
+			std::vector<double> magnitudes;
+			int size = 0;
+			int dimensions = 0;
+
+			// Where the first vector that could not be read starts, and its dimensions if it was
+			// only the wrong size
+			std::size_t error = std::string_view::npos;
+			int error_dimensions = -1;
+		};
+
+		// Pieces start at a '[', which only ever starts a vector
+		auto const wanted =
+		   std::min(text.size() / parse_piece + 1, static_cast<std::size_t>(pool.size()) * 4);
+		auto starts = std::vector<std::size_t>{0};
+		for (auto i = std::size_t{1}; i < wanted; ++i) {
+			auto const start = text.find('[', std::max(i * text.size() / wanted, starts.back() + 1));
+			if (start == std::string_view::npos) {
+				break;
+			}
+			starts.push_back(start);
+		}
+		starts.push_back(text.size());
+
+		auto pieces = std::vector<piece>(starts.size() - 1);
+		pool.parallel_for(pieces.size(), [&](std::size_t const i) {
+			auto& current = pieces[i];
+			auto const* first = text.data() + starts[i];
+			auto const* const last = text.data() + starts[i + 1];
+			while (true) {
+				while (first != last and (*first == ' ' or (*first >= '\t' and *first <= '\r'))) {
+					++first;
+				}
+				if (first == last) {
+					return;
+				}
+
+				auto const previous = current.magnitudes.size();
+				auto const result = detail::parse_magnitudes(first, last, current.magnitudes);
+				auto const dimensions = static_cast<int>(current.magnitudes.size() - previous);
+				if (result.ec != std::errc{} or (current.size > 0 and dimensions != current.dimensions)) {
+					current.error = static_cast<std::size_t>(first - text.data());
+					current.error_dimensions = result.ec == std::errc{} ? dimensions : -1;
+					return;
+				}
+				current.dimensions = dimensions;
+				++current.size;
+				first = result.ptr;
+			}
+		});
+
+		// Errors are reported for the first vector in the text that is wrong
+		auto size = 0;
+		auto dimensions = -1;
+		for (auto const& current : pieces) {
+			if (current.size > 0) {
+				detail::dimensions_check(dimensions == -1 ? current.dimensions : dimensions,
+				                         current.dimensions);
+				dimensions = current.dimensions;
+				size += current.size;
+			}
+			if (current.error != std::string_view::npos) {
+				if (current.error_dimensions != -1) {
+					detail::dimensions_check(dimensions, current.error_dimensions);
+				}
+				throw euclidean_vector_error("Text at offset " + std::to_string(current.error)
+				                             + " is not a valid euclidean_vector");
+			}
+		}
+
+		auto batch = euclidean_vector_batch(size, std::max(dimensions, 0), 0.0);
+		auto* out = batch.data();
+		for (auto const& current : pieces) {
+			out = std::copy(current.magnitudes.begin(), current.magnitudes.end(), out);
+		}
+		return batch;
+	}
+} // namespace comp6771
@@ -0,0 +1,1614 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include "comp6771/euclidean_vector.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__x86_64__) and defined(__GNUC__)
+#define COMP6771_KERNELS_X86 1
+#else
+#define COMP6771_KERNELS_X86 0
+#endif
+
+#if COMP6771_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace comp6771::kernels {
+	namespace {
+		// <Accumulators> independent partial sums, <Fused> uses fma for each step. <decode> turns
+		// each stored magnitude of <y> into a double. This is compiled once per target below, and
+		// the compiler vectorises it for that target.
+		template<std::size_t Accumulators,
+		         bool Fused,
+		         typename X,
+		         typename T,
+		         typename Decode = std::identity>
+		[[gnu::always_inline]] inline auto
+		dot_impl(X const* x, T const* y, std::size_t size, Decode decode = {}) -> double {
+			auto partial = std::array<double, Accumulators>{};
+
+			auto i = std::size_t{0};
+			for (; i + Accumulators <= size; i += Accumulators) {
+				for (auto j = std::size_t{0}; j < Accumulators; ++j) {
+					auto const x_j = static_cast<double>(x[i + j]);
+					auto const y_j = static_cast<double>(decode(y[i + j]));
+					if constexpr (Fused) {
+						partial[j] = std::fma(x_j, y_j, partial[j]);
+					}
+					else {
+						partial[j] += x_j * y_j;
+					}
+				}
+			}
+
+			auto result = 0.0;
+			for (; i < size; ++i) {
+				result += static_cast<double>(x[i]) * static_cast<double>(decode(y[i]));
+			}
+			for (auto const p : partial) {
+				result += p;
+			}
+
+			return result;
+		}
+
+		// Distances between magnitudes, folded with <step> and the partial results combined with
+		// <combine>. Both start from 0.
+		struct squared_difference {
+			static auto step(double partial, double x, double y) -> double {
+				auto const difference = x - y;
+				return partial + difference * difference;
+			}
+
+			static auto combine(double first, double second) -> double {
+				return first + second;
+			}
+		};
+
+		struct absolute_difference {
+			static auto step(double partial, double x, double y) -> double {
+				return partial + std::fabs(x - y);
+			}
+
+			static auto combine(double first, double second) -> double {
+				return first + second;
+			}
+		};
+
+		// Written as a comparison rather than std::max, which the compiler only vectorises this way
+		struct largest_difference {
+			static auto step(double partial, double x, double y) -> double {
+				return combine(partial, std::fabs(x - y));
+			}
+
+			static auto combine(double first, double second) -> double {
+				return second > first ? second : first;
+			}
+		};
+
+		// Like dot_impl, with <Accumulators> independent partial results
+		template<std::size_t Accumulators, typename Distance, typename T>
+		[[gnu::always_inline]] inline auto distance_impl(T const* x, T const* y, std::size_t size)
+		   -> double {
+			auto partial = std::array<double, Accumulators>{};
+
+			auto i = std::size_t{0};
+			for (; i + Accumulators <= size; i += Accumulators) {
+				for (auto j = std::size_t{0}; j < Accumulators; ++j) {
+					partial[j] = Distance::step(partial[j],
+					                            static_cast<double>(x[i + j]),
+					                            static_cast<double>(y[i + j]));
+				}
+			}
+
+			auto result = 0.0;
+			for (; i < size; ++i) {
+				result =
+				   Distance::step(result, static_cast<double>(x[i]), static_cast<double>(y[i]));
+			}
+			for (auto const p : partial) {
+				result = Distance::combine(result, p);
+			}
+			return result;
+		}
+
+		// Like dot_impl, for three dot products at once
+		template<std::size_t Accumulators, bool Fused, typename T>
+		[[gnu::always_inline]] inline auto
+		dot_and_squares_impl(T const* x, T const* y, std::size_t size) -> dot_products {
+			auto xy = std::array<double, Accumulators>{};
+			auto xx = std::array<double, Accumulators>{};
+			auto yy = std::array<double, Accumulators>{};
+
+			auto i = std::size_t{0};
+			for (; i + Accumulators <= size; i += Accumulators) {
+				for (auto j = std::size_t{0}; j < Accumulators; ++j) {
+					auto const x_j = static_cast<double>(x[i + j]);
+					auto const y_j = static_cast<double>(y[i + j]);
+					if constexpr (Fused) {
+						xy[j] = std::fma(x_j, y_j, xy[j]);
+						xx[j] = std::fma(x_j, x_j, xx[j]);
+						yy[j] = std::fma(y_j, y_j, yy[j]);
+					}
+					else {
+						xy[j] += x_j * y_j;
+						xx[j] += x_j * x_j;
+						yy[j] += y_j * y_j;
+					}
+				}
+			}
+
+			auto result = dot_products{0, 0, 0};
+			for (; i < size; ++i) {
+				auto const x_i = static_cast<double>(x[i]);
+				auto const y_i = static_cast<double>(y[i]);
+				result.xy += x_i * y_i;
+				result.xx += x_i * x_i;
+				result.yy += y_i * y_i;
+			}
+			for (auto j = std::size_t{0}; j < Accumulators; ++j) {
+				result.xy += xy[j];
+				result.xx += xx[j];
+				result.yy += yy[j];
+			}
+			return result;
+		}
+
+		// Moves the exponent and mantissa into place and rebiases the exponent, so that only
+		// infinities, NaNs and subnormals need more work
+		auto decode_float16(std::uint16_t half) -> float {
+			constexpr auto exponent_mask = 0x7c00U << 13U;
+			auto bits = (half & 0x7fffU) << 13U;
+			auto const exponent = bits & exponent_mask;
+
+			bits += (127U - 15U) << 23U;
+			if (exponent == exponent_mask) {
+				bits += (128U - 16U) << 23U;
+			}
+			else if (exponent == 0) {
+				bits += 1U << 23U;
+				bits = std::bit_cast<std::uint32_t>(std::bit_cast<float>(bits)
+				                                    - std::bit_cast<float>(113U << 23U));
+			}
+			return std::bit_cast<float>(bits | ((half & 0x8000U) << 16U));
+		}
+
+		auto decode_bfloat16(std::uint16_t bfloat) -> float {
+			return std::bit_cast<float>(static_cast<std::uint32_t>(bfloat) << 16U);
+		}
+
+		template<typename T, typename X = double>
+		using dot_kernel = auto (*)(X const*, T const*, std::size_t) -> double;
+
+		template<typename From, typename To>
+		using convert_kernel = auto (*)(From const*, To*, std::size_t) -> void;
+
+		// x[0] * y[indices[0]] + x[1] * y[indices[1]] + ...
+		using gather_kernel = auto (*)(double const*, int const*, std::size_t, double const*) -> double;
+
+		template<typename T>
+		using dot_products_kernel = auto (*)(T const*, T const*, std::size_t) -> dot_products;
+
+		// Packed vectors of <a> and <b>, <depth> and the tile written, as for dot_tile
+		using tile_kernel = auto (*)(double const*, double const*, std::size_t, double*) -> void;
+
+		// x[i] = op(x[i], y[i]) and x[i] = op(x[i], factor)
+		template<typename T>
+		using merge_kernel = auto (*)(T*, T const*, std::size_t) -> void;
+
+		template<typename T>
+		using scale_kernel = auto (*)(T*, T, std::size_t) -> void;
+
+		// One kernel per instruction set
+		template<typename Kernel>
+		struct kernel_set {
+			Kernel scalar;
+			Kernel avx2;
+			Kernel avx512;
+		};
+
+		template<typename T, typename Decode = std::identity>
+		auto dot_scalar(double const* x, T const* y, std::size_t size) -> double {
+			return dot_impl<4, false>(x, y, size, Decode{});
+		}
+
+		auto dot_float_scalar(float const* x, float const* y, std::size_t size) -> double {
+			return dot_impl<4, false>(x, y, size);
+		}
+
+		template<typename From, typename To>
+		auto convert_scalar(From const* from, To* to, std::size_t size) -> void {
+			std::transform(from, from + size, to, [](From const m) { return static_cast<To>(m); });
+		}
+
+		// <Operation> is std::plus<>, std::minus<>, std::multiplies<> or std::divides<>
+		template<typename Operation, typename T>
+		auto merge_scalar(T* x, T const* y, std::size_t size) -> void {
+			std::transform(x, x + size, y, x, Operation{});
+		}
+
+		template<typename Operation, typename T>
+		auto scale_scalar(T* x, T factor, std::size_t size) -> void {
+			std::transform(x, x + size, x, [factor](T const m) { return Operation{}(m, factor); });
+		}
+
+		// The magnitudes before the first one of <x> aligned to <alignment>, at most <size>
+		template<typename T>
+		auto unaligned_prefix(T const* x, std::size_t alignment, std::size_t size) -> std::size_t {
+			auto const misalignment = reinterpret_cast<std::uintptr_t>(x) % alignment;
+			auto const prefix = misalignment == 0 ? 0 : (alignment - misalignment) / sizeof(T);
+			return std::min(prefix, size);
+		}
+
+		template<std::size_t Accumulators>
+		[[gnu::always_inline]] inline auto
+		dot_gather_impl(double const* x, int const* indices, std::size_t size, double const* y)
+		   -> double {
+			auto partial = std::array<double, Accumulators>{};
+
+			auto i = std::size_t{0};
+			for (; i + Accumulators <= size; i += Accumulators) {
+				for (auto j = std::size_t{0}; j < Accumulators; ++j) {
+					partial[j] += x[i + j] * y[indices[i + j]];
+				}
+			}
+
+			auto result = 0.0;
+			for (; i < size; ++i) {
+				result += x[i] * y[indices[i]];
+			}
+			for (auto const p : partial) {
+				result += p;
+			}
+			return result;
+		}
+
+		auto dot_gather_scalar(double const* x, int const* indices, std::size_t size, double const* y)
+		   -> double {
+			return dot_gather_impl<4>(x, indices, size, y);
+		}
+
+		auto dot_tile_scalar(double const* a, double const* b, std::size_t depth, double* tile)
+		   -> void {
+			auto sums = std::array<double, tile_rows * tile_columns>{};
+			for (auto k = std::size_t{0}; k < depth; ++k) {
+				for (auto i = std::size_t{0}; i < tile_rows; ++i) {
+					for (auto j = std::size_t{0}; j < tile_columns; ++j) {
+						sums[i * tile_columns + j] += a[k * tile_rows + i] * b[k * tile_columns + j];
+					}
+				}
+			}
+			std::copy(sums.begin(), sums.end(), tile);
+		}
+
+		auto squared_distance_tile_scalar(double const* a, double const* b, std::size_t depth, double* tile)
+		   -> void {
+			auto sums = std::array<double, tile_rows * tile_columns>{};
+			for (auto k = std::size_t{0}; k < depth; ++k) {
+				for (auto i = std::size_t{0}; i < tile_rows; ++i) {
+					for (auto j = std::size_t{0}; j < tile_columns; ++j) {
+						auto const difference = a[k * tile_rows + i] - b[k * tile_columns + j];
+						sums[i * tile_columns + j] += difference * difference;
+					}
+				}
+			}
+			std::copy(sums.begin(), sums.end(), tile);
+		}
+
+		template<typename Distance, typename T>
+		auto distance_scalar(T const* x, T const* y, std::size_t size) -> double {
+			return distance_impl<4, Distance>(x, y, size);
+		}
+
+		template<typename T>
+		auto dot_and_squares_scalar(T const* x, T const* y, std::size_t size) -> dot_products {
+			return dot_and_squares_impl<4, false>(x, y, size);
+		}
+
+		struct float16_decoder {
+			auto operator()(std::uint16_t half) const -> float {
+				return decode_float16(half);
+			}
+		};
+
+		struct bfloat16_decoder {
+			auto operator()(std::uint16_t bfloat) const -> float {
+				return decode_bfloat16(bfloat);
+			}
+		};
+
+#if COMP6771_KERNELS_X86
+		[[gnu::target("avx2,fma")]] auto dot_avx2(double const* x, double const* y, std::size_t size)
+		   -> double {
+			return dot_impl<16, true>(x, y, size);
+		}
+
+		[[gnu::target("avx512f,prefer-vector-width=512")]] auto
+		dot_avx512(double const* x, double const* y, std::size_t size) -> double {
+			return dot_impl<32, true>(x, y, size);
+		}
+
+		// The compiler does not vectorise widening narrow types to double well, so these widen
+		// four magnitudes at a time explicitly
+		struct load_double {
+			[[gnu::target("avx2,fma,f16c"), gnu::always_inline]] auto operator()(double const* x) const
+			   -> __m256d {
+				return _mm256_loadu_pd(x);
+			}
+		};
+
+		struct load_float {
+			[[gnu::target("avx2,fma,f16c"), gnu::always_inline]] auto operator()(float const* y) const
+			   -> __m256d {
+				return _mm256_cvtps_pd(_mm_loadu_ps(y));
+			}
+		};
+
+		struct load_int8 {
+			[[gnu::target("avx2,fma,f16c"), gnu::always_inline]] auto
+			operator()(std::int8_t const* y) const -> __m256d {
+				auto bytes = 0;
+				std::memcpy(&bytes, y, sizeof(bytes));
+				return _mm256_cvtepi32_pd(_mm_cvtepi8_epi32(_mm_cvtsi32_si128(bytes)));
+			}
+		};
+
+		struct load_float16 {
+			[[gnu::target("avx2,fma,f16c"), gnu::always_inline]] auto
+			operator()(std::uint16_t const* y) const -> __m256d {
+				return _mm256_cvtps_pd(_mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(y))));
+			}
+		};
+
+		struct load_bfloat16 {
+			[[gnu::target("avx2,fma,f16c"), gnu::always_inline]] auto
+			operator()(std::uint16_t const* y) const -> __m256d {
+				auto const halves = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(y)));
+				return _mm256_cvtps_pd(_mm_castsi128_ps(_mm_slli_epi32(halves, 16)));
+			}
+		};
+
+		template<typename X, typename T, typename LoadX, typename Load, typename Decode = std::identity>
+		[[gnu::target("avx2,fma,f16c")]] auto
+		dot_widened_avx2(X const* x, T const* y, std::size_t size) -> double {
+			auto const load_x = LoadX{};
+			auto const load = Load{};
+			auto partial_0 = _mm256_setzero_pd();
+			auto partial_1 = _mm256_setzero_pd();
+			auto partial_2 = _mm256_setzero_pd();
+			auto partial_3 = _mm256_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + 16 <= size; i += 16) {
+				partial_0 = _mm256_fmadd_pd(load_x(x + i), load(y + i), partial_0);
+				partial_1 = _mm256_fmadd_pd(load_x(x + i + 4), load(y + i + 4), partial_1);
+				partial_2 = _mm256_fmadd_pd(load_x(x + i + 8), load(y + i + 8), partial_2);
+				partial_3 = _mm256_fmadd_pd(load_x(x + i + 12), load(y + i + 12), partial_3);
+			}
+
+			auto sums = std::array<double, 4>{};
+			_mm256_storeu_pd(sums.data(),
+			                 _mm256_add_pd(_mm256_add_pd(partial_0, partial_1),
+			                               _mm256_add_pd(partial_2, partial_3)));
+
+			auto result = sums[0] + sums[1] + sums[2] + sums[3];
+			for (; i < size; ++i) {
+				result += static_cast<double>(x[i]) * static_cast<double>(Decode{}(y[i]));
+			}
+			return result;
+		}
+
+		// The compiler does not vectorise a running maximum for AVX2, so this keeps four explicitly
+		template<typename T, typename Load>
+		[[gnu::target("avx2,fma,f16c")]] auto
+		chebyshev_avx2(T const* x, T const* y, std::size_t size) -> double {
+			auto const load = Load{};
+			auto const magnitude = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fff'ffff'ffff'ffff));
+			auto partial_0 = _mm256_setzero_pd();
+			auto partial_1 = _mm256_setzero_pd();
+			auto partial_2 = _mm256_setzero_pd();
+			auto partial_3 = _mm256_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + 16 <= size; i += 16) {
+				partial_0 = _mm256_max_pd(
+				   partial_0,
+				   _mm256_and_pd(_mm256_sub_pd(load(x + i), load(y + i)), magnitude));
+				partial_1 = _mm256_max_pd(
+				   partial_1,
+				   _mm256_and_pd(_mm256_sub_pd(load(x + i + 4), load(y + i + 4)), magnitude));
+				partial_2 = _mm256_max_pd(
+				   partial_2,
+				   _mm256_and_pd(_mm256_sub_pd(load(x + i + 8), load(y + i + 8)), magnitude));
+				partial_3 = _mm256_max_pd(
+				   partial_3,
+				   _mm256_and_pd(_mm256_sub_pd(load(x + i + 12), load(y + i + 12)), magnitude));
+			}
+
+			auto largest = std::array<double, 4>{};
+			_mm256_storeu_pd(largest.data(),
+			                 _mm256_max_pd(_mm256_max_pd(partial_0, partial_1),
+			                               _mm256_max_pd(partial_2, partial_3)));
+
+			auto result = 0.0;
+			for (auto const l : largest) {
+				result = largest_difference::combine(result, l);
+			}
+			for (; i < size; ++i) {
+				result =
+				   largest_difference::step(result, static_cast<double>(x[i]), static_cast<double>(y[i]));
+			}
+			return result;
+		}
+
+		// AVX-512 widens eight floats at a time, twice as many as AVX2
+		[[gnu::target("avx512f")]] auto
+		dot_float_avx512(float const* x, float const* y, std::size_t size) -> double {
+			auto partial_0 = _mm512_setzero_pd();
+			auto partial_1 = _mm512_setzero_pd();
+			auto partial_2 = _mm512_setzero_pd();
+			auto partial_3 = _mm512_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + 32 <= size; i += 32) {
+				partial_0 = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(x + i)),
+				                            _mm512_cvtps_pd(_mm256_loadu_ps(y + i)),
+				                            partial_0);
+				partial_1 = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(x + i + 8)),
+				                            _mm512_cvtps_pd(_mm256_loadu_ps(y + i + 8)),
+				                            partial_1);
+				partial_2 = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(x + i + 16)),
+				                            _mm512_cvtps_pd(_mm256_loadu_ps(y + i + 16)),
+				                            partial_2);
+				partial_3 = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(x + i + 24)),
+				                            _mm512_cvtps_pd(_mm256_loadu_ps(y + i + 24)),
+				                            partial_3);
+			}
+
+			auto result = _mm512_reduce_add_pd(
+			   _mm512_add_pd(_mm512_add_pd(partial_0, partial_1), _mm512_add_pd(partial_2, partial_3)));
+			for (; i < size; ++i) {
+				result += static_cast<double>(x[i]) * static_cast<double>(y[i]);
+			}
+			return result;
+		}
+
+		[[gnu::target("avx2,fma,f16c")]] auto
+		narrow_avx2(double const* from, float* to, std::size_t size) -> void {
+			auto i = std::size_t{0};
+			for (; i + 8 <= size; i += 8) {
+				_mm_storeu_ps(to + i, _mm256_cvtpd_ps(_mm256_loadu_pd(from + i)));
+				_mm_storeu_ps(to + i + 4, _mm256_cvtpd_ps(_mm256_loadu_pd(from + i + 4)));
+			}
+			for (; i < size; ++i) {
+				to[i] = static_cast<float>(from[i]);
+			}
+		}
+
+		[[gnu::target("avx2,fma,f16c")]] auto
+		widen_avx2(float const* from, double* to, std::size_t size) -> void {
+			auto i = std::size_t{0};
+			for (; i + 8 <= size; i += 8) {
+				_mm256_storeu_pd(to + i, _mm256_cvtps_pd(_mm_loadu_ps(from + i)));
+				_mm256_storeu_pd(to + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(from + i + 4)));
+			}
+			for (; i < size; ++i) {
+				to[i] = static_cast<double>(from[i]);
+			}
+		}
+
+		[[gnu::target("avx512f")]] auto
+		narrow_avx512(double const* from, float* to, std::size_t size) -> void {
+			auto i = std::size_t{0};
+			for (; i + 8 <= size; i += 8) {
+				_mm256_storeu_ps(to + i, _mm512_cvtpd_ps(_mm512_loadu_pd(from + i)));
+			}
+			for (; i < size; ++i) {
+				to[i] = static_cast<float>(from[i]);
+			}
+		}
+
+		[[gnu::target("avx512f")]] auto
+		widen_avx512(float const* from, double* to, std::size_t size) -> void {
+			auto i = std::size_t{0};
+			for (; i + 8 <= size; i += 8) {
+				_mm512_storeu_pd(to + i, _mm512_cvtps_pd(_mm256_loadu_ps(from + i)));
+			}
+			for (; i < size; ++i) {
+				to[i] = static_cast<double>(from[i]);
+			}
+		}
+
+		struct gather_avx2 {
+			[[gnu::target("avx2,fma"), gnu::always_inline]] auto
+			operator()(double const* y, int const* indices) const -> __m256d {
+				auto const offsets = _mm_loadu_si128(reinterpret_cast<__m128i const*>(indices));
+				return _mm256_i32gather_pd(y, offsets, 8);
+			}
+		};
+
+		// Each gather loads from scattered cache lines, so several are kept in flight
+		[[gnu::target("avx2,fma")]] auto
+		dot_gather_avx2(double const* x, int const* indices, std::size_t size, double const* y)
+		   -> double {
+			auto const gather = gather_avx2{};
+			auto partial_0 = _mm256_setzero_pd();
+			auto partial_1 = _mm256_setzero_pd();
+			auto partial_2 = _mm256_setzero_pd();
+			auto partial_3 = _mm256_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + 16 <= size; i += 16) {
+				partial_0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), gather(y, indices + i), partial_0);
+				partial_1 =
+				   _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), gather(y, indices + i + 4), partial_1);
+				partial_2 =
+				   _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8), gather(y, indices + i + 8), partial_2);
+				partial_3 =
+				   _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12), gather(y, indices + i + 12), partial_3);
+			}
+
+			auto sums = std::array<double, 4>{};
+			_mm256_storeu_pd(sums.data(),
+			                 _mm256_add_pd(_mm256_add_pd(partial_0, partial_1),
+			                               _mm256_add_pd(partial_2, partial_3)));
+
+			auto result = sums[0] + sums[1] + sums[2] + sums[3];
+			for (; i < size; ++i) {
+				result += x[i] * y[indices[i]];
+			}
+			return result;
+		}
+
+		// Each row of the tile is two vectors of four, so the eight accumulators hide the latency of
+		// fma. Each magnitude of <a> is broadcast and used for a whole row.
+		[[gnu::target("avx2,fma")]] auto
+		dot_tile_avx2(double const* a, double const* b, std::size_t depth, double* tile) -> void {
+			auto row_0_left = _mm256_setzero_pd();
+			auto row_0_right = _mm256_setzero_pd();
+			auto row_1_left = _mm256_setzero_pd();
+			auto row_1_right = _mm256_setzero_pd();
+			auto row_2_left = _mm256_setzero_pd();
+			auto row_2_right = _mm256_setzero_pd();
+			auto row_3_left = _mm256_setzero_pd();
+			auto row_3_right = _mm256_setzero_pd();
+
+			for (auto k = std::size_t{0}; k < depth; ++k, a += tile_rows, b += tile_columns) {
+				auto const left = _mm256_loadu_pd(b);
+				auto const right = _mm256_loadu_pd(b + 4);
+
+				auto a_i = _mm256_broadcast_sd(a);
+				row_0_left = _mm256_fmadd_pd(a_i, left, row_0_left);
+				row_0_right = _mm256_fmadd_pd(a_i, right, row_0_right);
+				a_i = _mm256_broadcast_sd(a + 1);
+				row_1_left = _mm256_fmadd_pd(a_i, left, row_1_left);
+				row_1_right = _mm256_fmadd_pd(a_i, right, row_1_right);
+				a_i = _mm256_broadcast_sd(a + 2);
+				row_2_left = _mm256_fmadd_pd(a_i, left, row_2_left);
+				row_2_right = _mm256_fmadd_pd(a_i, right, row_2_right);
+				a_i = _mm256_broadcast_sd(a + 3);
+				row_3_left = _mm256_fmadd_pd(a_i, left, row_3_left);
+				row_3_right = _mm256_fmadd_pd(a_i, right, row_3_right);
+			}
+
+			_mm256_storeu_pd(tile, row_0_left);
+			_mm256_storeu_pd(tile + 4, row_0_right);
+			_mm256_storeu_pd(tile + 8, row_1_left);
+			_mm256_storeu_pd(tile + 12, row_1_right);
+			_mm256_storeu_pd(tile + 16, row_2_left);
+			_mm256_storeu_pd(tile + 20, row_2_right);
+			_mm256_storeu_pd(tile + 24, row_3_left);
+			_mm256_storeu_pd(tile + 28, row_3_right);
+		}
+
+		// As dot_tile_avx2, with a subtraction before each fma
+		[[gnu::target("avx2,fma")]] auto
+		squared_distance_tile_avx2(double const* a, double const* b, std::size_t depth, double* tile)
+		   -> void {
+			auto row_0_left = _mm256_setzero_pd();
+			auto row_0_right = _mm256_setzero_pd();
+			auto row_1_left = _mm256_setzero_pd();
+			auto row_1_right = _mm256_setzero_pd();
+			auto row_2_left = _mm256_setzero_pd();
+			auto row_2_right = _mm256_setzero_pd();
+			auto row_3_left = _mm256_setzero_pd();
+			auto row_3_right = _mm256_setzero_pd();
+
+			for (auto k = std::size_t{0}; k < depth; ++k, a += tile_rows, b += tile_columns) {
+				auto const left = _mm256_loadu_pd(b);
+				auto const right = _mm256_loadu_pd(b + 4);
+
+				auto a_i = _mm256_broadcast_sd(a);
+				auto difference = _mm256_sub_pd(a_i, left);
+				row_0_left = _mm256_fmadd_pd(difference, difference, row_0_left);
+				difference = _mm256_sub_pd(a_i, right);
+				row_0_right = _mm256_fmadd_pd(difference, difference, row_0_right);
+				a_i = _mm256_broadcast_sd(a + 1);
+				difference = _mm256_sub_pd(a_i, left);
+				row_1_left = _mm256_fmadd_pd(difference, difference, row_1_left);
+				difference = _mm256_sub_pd(a_i, right);
+				row_1_right = _mm256_fmadd_pd(difference, difference, row_1_right);
+				a_i = _mm256_broadcast_sd(a + 2);
+				difference = _mm256_sub_pd(a_i, left);
+				row_2_left = _mm256_fmadd_pd(difference, difference, row_2_left);
+				difference = _mm256_sub_pd(a_i, right);
+				row_2_right = _mm256_fmadd_pd(difference, difference, row_2_right);
+				a_i = _mm256_broadcast_sd(a + 3);
+				difference = _mm256_sub_pd(a_i, left);
+				row_3_left = _mm256_fmadd_pd(difference, difference, row_3_left);
+				difference = _mm256_sub_pd(a_i, right);
+				row_3_right = _mm256_fmadd_pd(difference, difference, row_3_right);
+			}
+
+			_mm256_storeu_pd(tile, row_0_left);
+			_mm256_storeu_pd(tile + 4, row_0_right);
+			_mm256_storeu_pd(tile + 8, row_1_left);
+			_mm256_storeu_pd(tile + 12, row_1_right);
+			_mm256_storeu_pd(tile + 16, row_2_left);
+			_mm256_storeu_pd(tile + 20, row_2_right);
+			_mm256_storeu_pd(tile + 24, row_3_left);
+			_mm256_storeu_pd(tile + 28, row_3_right);
+		}
+
+		// A row of the tile is a single vector, so even and odd magnitudes are summed separately to
+		// keep eight accumulators
+		[[gnu::target("avx512f")]] auto
+		dot_tile_avx512(double const* a, double const* b, std::size_t depth, double* tile) -> void {
+			auto row_0_even = _mm512_setzero_pd();
+			auto row_0_odd = _mm512_setzero_pd();
+			auto row_1_even = _mm512_setzero_pd();
+			auto row_1_odd = _mm512_setzero_pd();
+			auto row_2_even = _mm512_setzero_pd();
+			auto row_2_odd = _mm512_setzero_pd();
+			auto row_3_even = _mm512_setzero_pd();
+			auto row_3_odd = _mm512_setzero_pd();
+
+			auto k = std::size_t{0};
+			for (; k + 2 <= depth; k += 2, a += 2 * tile_rows, b += 2 * tile_columns) {
+				auto const even = _mm512_loadu_pd(b);
+				auto const odd = _mm512_loadu_pd(b + tile_columns);
+				row_0_even = _mm512_fmadd_pd(_mm512_set1_pd(a[0]), even, row_0_even);
+				row_1_even = _mm512_fmadd_pd(_mm512_set1_pd(a[1]), even, row_1_even);
+				row_2_even = _mm512_fmadd_pd(_mm512_set1_pd(a[2]), even, row_2_even);
+				row_3_even = _mm512_fmadd_pd(_mm512_set1_pd(a[3]), even, row_3_even);
+				row_0_odd = _mm512_fmadd_pd(_mm512_set1_pd(a[4]), odd, row_0_odd);
+				row_1_odd = _mm512_fmadd_pd(_mm512_set1_pd(a[5]), odd, row_1_odd);
+				row_2_odd = _mm512_fmadd_pd(_mm512_set1_pd(a[6]), odd, row_2_odd);
+				row_3_odd = _mm512_fmadd_pd(_mm512_set1_pd(a[7]), odd, row_3_odd);
+			}
+			if (k < depth) {
+				auto const even = _mm512_loadu_pd(b);
+				row_0_even = _mm512_fmadd_pd(_mm512_set1_pd(a[0]), even, row_0_even);
+				row_1_even = _mm512_fmadd_pd(_mm512_set1_pd(a[1]), even, row_1_even);
+				row_2_even = _mm512_fmadd_pd(_mm512_set1_pd(a[2]), even, row_2_even);
+				row_3_even = _mm512_fmadd_pd(_mm512_set1_pd(a[3]), even, row_3_even);
+			}
+
+			_mm512_storeu_pd(tile, _mm512_add_pd(row_0_even, row_0_odd));
+			_mm512_storeu_pd(tile + 8, _mm512_add_pd(row_1_even, row_1_odd));
+			_mm512_storeu_pd(tile + 16, _mm512_add_pd(row_2_even, row_2_odd));
+			_mm512_storeu_pd(tile + 24, _mm512_add_pd(row_3_even, row_3_odd));
+		}
+
+		// As dot_tile_avx512, with a subtraction before each fma
+		[[gnu::target("avx512f")]] auto
+		squared_distance_tile_avx512(double const* a, double const* b, std::size_t depth, double* tile)
+		   -> void {
+			auto row_0_even = _mm512_setzero_pd();
+			auto row_0_odd = _mm512_setzero_pd();
+			auto row_1_even = _mm512_setzero_pd();
+			auto row_1_odd = _mm512_setzero_pd();
+			auto row_2_even = _mm512_setzero_pd();
+			auto row_2_odd = _mm512_setzero_pd();
+			auto row_3_even = _mm512_setzero_pd();
+			auto row_3_odd = _mm512_setzero_pd();
+
+			auto k = std::size_t{0};
+			for (; k + 2 <= depth; k += 2, a += 2 * tile_rows, b += 2 * tile_columns) {
+				auto const even = _mm512_loadu_pd(b);
+				auto const odd = _mm512_loadu_pd(b + tile_columns);
+				auto difference = _mm512_sub_pd(_mm512_set1_pd(a[0]), even);
+				row_0_even = _mm512_fmadd_pd(difference, difference, row_0_even);
+				difference = _mm512_sub_pd(_mm512_set1_pd(a[1]), even);
+				row_1_even = _mm512_fmadd_pd(difference, difference, row_1_even);
+				difference = _mm512_sub_pd(_mm512_set1_pd(a[2]), even);
+				row_2_even = _mm512_fmadd_pd(difference, difference, row_2_even);
+				difference = _mm512_sub_pd(_mm512_set1_pd(a[3]), even);
+				row_3_even = _mm512_fmadd_pd(difference, difference, row_3_even);
+				difference = _mm512_sub_pd(_mm512_set1_pd(a[4]), odd);
+				row_0_odd = _mm512_fmadd_pd(difference, difference, row_0_odd);
+				difference = _mm512_sub_pd(_mm512_set1_pd(a[5]), odd);
+				row_1_odd = _mm512_fmadd_pd(difference, difference, row_1_odd);
+				difference = _mm512_sub_pd(_mm512_set1_pd(a[6]), odd);
+				row_2_odd = _mm512_fmadd_pd(difference, difference, row_2_odd);
+				difference = _mm512_sub_pd(_mm512_set1_pd(a[7]), odd);
+				row_3_odd = _mm512_fmadd_pd(difference, difference, row_3_odd);
+			}
+			if (k < depth) {
+				auto const even = _mm512_loadu_pd(b);
+				auto difference = _mm512_sub_pd(_mm512_set1_pd(a[0]), even);
+				row_0_even = _mm512_fmadd_pd(difference, difference, row_0_even);
+				difference = _mm512_sub_pd(_mm512_set1_pd(a[1]), even);
+				row_1_even = _mm512_fmadd_pd(difference, difference, row_1_even);
+				difference = _mm512_sub_pd(_mm512_set1_pd(a[2]), even);
+				row_2_even = _mm512_fmadd_pd(difference, difference, row_2_even);
+				difference = _mm512_sub_pd(_mm512_set1_pd(a[3]), even);
+				row_3_even = _mm512_fmadd_pd(difference, difference, row_3_even);
+			}
+
+			_mm512_storeu_pd(tile, _mm512_add_pd(row_0_even, row_0_odd));
+			_mm512_storeu_pd(tile + 8, _mm512_add_pd(row_1_even, row_1_odd));
+			_mm512_storeu_pd(tile + 16, _mm512_add_pd(row_2_even, row_2_odd));
+			_mm512_storeu_pd(tile + 24, _mm512_add_pd(row_3_even, row_3_odd));
+		}
+
+		// The vectors of <T> that the element-wise kernels work on, the arithmetic of each
+		// <Operation> on them, and masks selecting the first <count> lanes of a vector
+		template<typename T>
+		struct avx2_lanes;
+
+		template<>
+		struct avx2_lanes<double> {
+			static constexpr auto width = std::size_t{4};
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto load(double const* x)
+			   -> __m256d {
+				return _mm256_loadu_pd(x);
+			}
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto load_aligned(double const* x)
+			   -> __m256d {
+				return _mm256_load_pd(x);
+			}
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto
+			store_aligned(double* x, __m256d value) -> void {
+				_mm256_store_pd(x, value);
+			}
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto broadcast(double value)
+			   -> __m256d {
+				return _mm256_set1_pd(value);
+			}
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto mask(std::size_t count)
+			   -> __m256i {
+				return _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(count)),
+				                          _mm256_setr_epi64x(0, 1, 2, 3));
+			}
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto
+			masked_load(double const* x, __m256i mask) -> __m256d {
+				return _mm256_maskload_pd(x, mask);
+			}
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto
+			masked_store(double* x, __m256i mask, __m256d value) -> void {
+				_mm256_maskstore_pd(x, mask, value);
+			}
+
+			template<typename Operation>
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto apply(__m256d x, __m256d y)
+			   -> __m256d {
+				if constexpr (std::same_as<Operation, std::plus<>>) {
+					return _mm256_add_pd(x, y);
+				}
+				else if constexpr (std::same_as<Operation, std::minus<>>) {
+					return _mm256_sub_pd(x, y);
+				}
+				else if constexpr (std::same_as<Operation, std::multiplies<>>) {
+					return _mm256_mul_pd(x, y);
+				}
+				else {
+					return _mm256_div_pd(x, y);
+				}
+			}
+		};
+
+		template<>
+		struct avx2_lanes<float> {
+			static constexpr auto width = std::size_t{8};
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto load(float const* x) -> __m256 {
+				return _mm256_loadu_ps(x);
+			}
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto load_aligned(float const* x)
+			   -> __m256 {
+				return _mm256_load_ps(x);
+			}
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto
+			store_aligned(float* x, __m256 value) -> void {
+				_mm256_store_ps(x, value);
+			}
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto broadcast(float value)
+			   -> __m256 {
+				return _mm256_set1_ps(value);
+			}
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto mask(std::size_t count)
+			   -> __m256i {
+				return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(count)),
+				                          _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+			}
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto
+			masked_load(float const* x, __m256i mask) -> __m256 {
+				return _mm256_maskload_ps(x, mask);
+			}
+
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto
+			masked_store(float* x, __m256i mask, __m256 value) -> void {
+				_mm256_maskstore_ps(x, mask, value);
+			}
+
+			template<typename Operation>
+			[[gnu::target("avx2,fma"), gnu::always_inline]] static auto apply(__m256 x, __m256 y)
+			   -> __m256 {
+				if constexpr (std::same_as<Operation, std::plus<>>) {
+					return _mm256_add_ps(x, y);
+				}
+				else if constexpr (std::same_as<Operation, std::minus<>>) {
+					return _mm256_sub_ps(x, y);
+				}
+				else if constexpr (std::same_as<Operation, std::multiplies<>>) {
+					return _mm256_mul_ps(x, y);
+				}
+				else {
+					return _mm256_div_ps(x, y);
+				}
+			}
+		};
+
+		template<typename T>
+		struct avx512_lanes;
+
+		template<>
+		struct avx512_lanes<double> {
+			static constexpr auto width = std::size_t{8};
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto load(double const* x) -> __m512d {
+				return _mm512_loadu_pd(x);
+			}
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto load_aligned(double const* x)
+			   -> __m512d {
+				return _mm512_load_pd(x);
+			}
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto
+			store_aligned(double* x, __m512d value) -> void {
+				_mm512_store_pd(x, value);
+			}
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto broadcast(double value)
+			   -> __m512d {
+				return _mm512_set1_pd(value);
+			}
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto mask(std::size_t count)
+			   -> __mmask8 {
+				return static_cast<__mmask8>((1U << count) - 1U);
+			}
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto
+			masked_load(double const* x, __mmask8 mask) -> __m512d {
+				return _mm512_maskz_loadu_pd(mask, x);
+			}
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto
+			masked_store(double* x, __mmask8 mask, __m512d value) -> void {
+				_mm512_mask_storeu_pd(x, mask, value);
+			}
+
+			template<typename Operation>
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto apply(__m512d x, __m512d y)
+			   -> __m512d {
+				if constexpr (std::same_as<Operation, std::plus<>>) {
+					return _mm512_add_pd(x, y);
+				}
+				else if constexpr (std::same_as<Operation, std::minus<>>) {
+					return _mm512_sub_pd(x, y);
+				}
+				else if constexpr (std::same_as<Operation, std::multiplies<>>) {
+					return _mm512_mul_pd(x, y);
+				}
+				else {
+					return _mm512_div_pd(x, y);
+				}
+			}
+		};
+
+		template<>
+		struct avx512_lanes<float> {
+			static constexpr auto width = std::size_t{16};
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto load(float const* x) -> __m512 {
+				return _mm512_loadu_ps(x);
+			}
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto load_aligned(float const* x)
+			   -> __m512 {
+				return _mm512_load_ps(x);
+			}
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto
+			store_aligned(float* x, __m512 value) -> void {
+				_mm512_store_ps(x, value);
+			}
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto broadcast(float value)
+			   -> __m512 {
+				return _mm512_set1_ps(value);
+			}
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto mask(std::size_t count)
+			   -> __mmask16 {
+				return static_cast<__mmask16>((1U << count) - 1U);
+			}
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto
+			masked_load(float const* x, __mmask16 mask) -> __m512 {
+				return _mm512_maskz_loadu_ps(mask, x);
+			}
+
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto
+			masked_store(float* x, __mmask16 mask, __m512 value) -> void {
+				_mm512_mask_storeu_ps(x, mask, value);
+			}
+
+			template<typename Operation>
+			[[gnu::target("avx512f"), gnu::always_inline]] static auto apply(__m512 x, __m512 y)
+			   -> __m512 {
+				if constexpr (std::same_as<Operation, std::plus<>>) {
+					return _mm512_add_ps(x, y);
+				}
+				else if constexpr (std::same_as<Operation, std::minus<>>) {
+					return _mm512_sub_ps(x, y);
+				}
+				else if constexpr (std::same_as<Operation, std::multiplies<>>) {
+					return _mm512_mul_ps(x, y);
+				}
+				else {
+					return _mm512_div_ps(x, y);
+				}
+			}
+		};
+
+		// The magnitudes of <x> before its first aligned vector are done one at a time, so that no
+		// load or store of <x> in the main loop splits a cache line, and the last partial vector is
+		// masked. The same code is compiled once per instruction set.
+		template<typename Operation, typename T>
+		[[gnu::target("avx2,fma")]] auto merge_avx2(T* x, T const* y, std::size_t size) -> void {
+			using lanes = avx2_lanes<T>;
+			auto i = unaligned_prefix(x, sizeof(T) * lanes::width, size);
+			merge_scalar<Operation>(x, y, i);
+			for (; i + lanes::width <= size; i += lanes::width) {
+				lanes::store_aligned(x + i,
+				                     lanes::template apply<Operation>(lanes::load_aligned(x + i),
+				                                                      lanes::load(y + i)));
+			}
+			if (i < size) {
+				auto const mask = lanes::mask(size - i);
+				lanes::masked_store(x + i,
+				                    mask,
+				                    lanes::template apply<Operation>(lanes::masked_load(x + i, mask),
+				                                                     lanes::masked_load(y + i, mask)));
+			}
+		}
+
+		template<typename Operation, typename T>
+		[[gnu::target("avx2,fma")]] auto scale_avx2(T* x, T factor, std::size_t size) -> void {
+			using lanes = avx2_lanes<T>;
+			auto i = unaligned_prefix(x, sizeof(T) * lanes::width, size);
+			scale_scalar<Operation>(x, factor, i);
+			auto const factors = lanes::broadcast(factor);
+			for (; i + lanes::width <= size; i += lanes::width) {
+				lanes::store_aligned(
+				   x + i,
+				   lanes::template apply<Operation>(lanes::load_aligned(x + i), factors));
+			}
+			if (i < size) {
+				auto const mask = lanes::mask(size - i);
+				lanes::masked_store(
+				   x + i,
+				   mask,
+				   lanes::template apply<Operation>(lanes::masked_load(x + i, mask), factors));
+			}
+		}
+
+		template<typename Operation, typename T>
+		[[gnu::target("avx512f")]] auto merge_avx512(T* x, T const* y, std::size_t size) -> void {
+			using lanes = avx512_lanes<T>;
+			auto i = unaligned_prefix(x, sizeof(T) * lanes::width, size);
+			merge_scalar<Operation>(x, y, i);
+			for (; i + lanes::width <= size; i += lanes::width) {
+				lanes::store_aligned(x + i,
+				                     lanes::template apply<Operation>(lanes::load_aligned(x + i),
+				                                                      lanes::load(y + i)));
+			}
+			if (i < size) {
+				auto const mask = lanes::mask(size - i);
+				lanes::masked_store(x + i,
+				                    mask,
+				                    lanes::template apply<Operation>(lanes::masked_load(x + i, mask),
+				                                                     lanes::masked_load(y + i, mask)));
+			}
+		}
+
+		template<typename Operation, typename T>
+		[[gnu::target("avx512f")]] auto scale_avx512(T* x, T factor, std::size_t size) -> void {
+			using lanes = avx512_lanes<T>;
+			auto i = unaligned_prefix(x, sizeof(T) * lanes::width, size);
+			scale_scalar<Operation>(x, factor, i);
+			auto const factors = lanes::broadcast(factor);
+			for (; i + lanes::width <= size; i += lanes::width) {
+				lanes::store_aligned(
+				   x + i,
+				   lanes::template apply<Operation>(lanes::load_aligned(x + i), factors));
+			}
+			if (i < size) {
+				auto const mask = lanes::mask(size - i);
+				lanes::masked_store(
+				   x + i,
+				   mask,
+				   lanes::template apply<Operation>(lanes::masked_load(x + i, mask), factors));
+			}
+		}
+
+		template<typename Distance, typename T>
+		[[gnu::target("avx2,fma")]] auto distance_avx2(T const* x, T const* y, std::size_t size)
+		   -> double {
+			return distance_impl<16, Distance>(x, y, size);
+		}
+
+		template<typename Distance, typename T>
+		[[gnu::target("avx512f,prefer-vector-width=512")]] auto
+		distance_avx512(T const* x, T const* y, std::size_t size) -> double {
+			return distance_impl<32, Distance>(x, y, size);
+		}
+
+		// Three sums share each load, so fewer accumulators each are enough
+		template<typename T>
+		[[gnu::target("avx2,fma")]] auto
+		dot_and_squares_avx2(T const* x, T const* y, std::size_t size) -> dot_products {
+			return dot_and_squares_impl<8, true>(x, y, size);
+		}
+
+		template<typename T>
+		[[gnu::target("avx512f,prefer-vector-width=512")]] auto
+		dot_and_squares_avx512(T const* x, T const* y, std::size_t size) -> dot_products {
+			return dot_and_squares_impl<16, true>(x, y, size);
+		}
+
+		template<typename Distance, typename T>
+		constexpr auto distance_kernels = kernel_set<dot_kernel<T, T>>{
+		   distance_scalar<Distance, T>,
+		   distance_avx2<Distance, T>,
+		   distance_avx512<Distance, T>};
+
+		template<typename T>
+		constexpr auto chebyshev_kernels = kernel_set<dot_kernel<T, T>>{
+		   distance_scalar<largest_difference, T>,
+		   chebyshev_avx2<T, std::conditional_t<std::same_as<T, float>, load_float, load_double>>,
+		   distance_avx512<largest_difference, T>};
+
+		template<typename T>
+		constexpr auto dot_and_squares_kernels =
+		   kernel_set<dot_products_kernel<T>>{dot_and_squares_scalar<T>,
+		                                      dot_and_squares_avx2<T>,
+		                                      dot_and_squares_avx512<T>};
+
+		constexpr auto double_kernels =
+		   kernel_set<dot_kernel<double>>{dot_scalar<double>, dot_avx2, dot_avx512};
+		constexpr auto tile_kernels =
+		   kernel_set<tile_kernel>{dot_tile_scalar, dot_tile_avx2, dot_tile_avx512};
+		constexpr auto squared_distance_tile_kernels =
+		   kernel_set<tile_kernel>{squared_distance_tile_scalar,
+		                           squared_distance_tile_avx2,
+		                           squared_distance_tile_avx512};
+		// Memory latency is the bottleneck, which 512-bit gathers do not help with
+		constexpr auto gather_kernels =
+		   kernel_set<gather_kernel>{dot_gather_scalar, dot_gather_avx2, dot_gather_avx2};
+
+		// Widening is the bottleneck, which 512-bit vectors do not help with
+		template<typename T, typename Load, typename Decode = std::identity>
+		constexpr auto widened_kernels() -> kernel_set<dot_kernel<T>> {
+			return {dot_scalar<T, Decode>,
+			        dot_widened_avx2<double, T, load_double, Load, Decode>,
+			        dot_widened_avx2<double, T, load_double, Load, Decode>};
+		}
+
+		constexpr auto float_float_kernels = kernel_set<dot_kernel<float, float>>{
+		   dot_float_scalar,
+		   dot_widened_avx2<float, float, load_float, load_float>,
+		   dot_float_avx512};
+		constexpr auto narrow_kernels = kernel_set<convert_kernel<double, float>>{
+		   convert_scalar<double, float>,
+		   narrow_avx2,
+		   narrow_avx512};
+		constexpr auto widen_kernels = kernel_set<convert_kernel<float, double>>{
+		   convert_scalar<float, double>,
+		   widen_avx2,
+		   widen_avx512};
+
+		template<typename Operation, typename T>
+		constexpr auto merge_kernels = kernel_set<merge_kernel<T>>{merge_scalar<Operation, T>,
+		                                                           merge_avx2<Operation, T>,
+		                                                           merge_avx512<Operation, T>};
+
+		template<typename Operation, typename T>
+		constexpr auto scale_kernels = kernel_set<scale_kernel<T>>{scale_scalar<Operation, T>,
+		                                                           scale_avx2<Operation, T>,
+		                                                           scale_avx512<Operation, T>};
+
+		constexpr auto float_kernels = widened_kernels<float, load_float>();
+		constexpr auto int8_kernels = widened_kernels<std::int8_t, load_int8>();
+		constexpr auto float16_kernels =
+		   widened_kernels<std::uint16_t, load_float16, float16_decoder>();
+		constexpr auto bfloat16_kernels =
+		   widened_kernels<std::uint16_t, load_bfloat16, bfloat16_decoder>();
+#else
+		template<typename Kernel>
+		constexpr auto scalar_only(Kernel kernel) -> kernel_set<Kernel> {
+			return {kernel, kernel, kernel};
+		}
+
+		constexpr auto double_kernels = scalar_only<dot_kernel<double>>(dot_scalar<double>);
+		constexpr auto gather_kernels = scalar_only<gather_kernel>(dot_gather_scalar);
+		constexpr auto tile_kernels = scalar_only<tile_kernel>(dot_tile_scalar);
+		constexpr auto squared_distance_tile_kernels =
+		   scalar_only<tile_kernel>(squared_distance_tile_scalar);
+
+		template<typename Distance, typename T>
+		constexpr auto distance_kernels =
+		   scalar_only<dot_kernel<T, T>>(distance_scalar<Distance, T>);
+
+		template<typename T>
+		constexpr auto chebyshev_kernels = distance_kernels<largest_difference, T>;
+
+		template<typename T>
+		constexpr auto dot_and_squares_kernels =
+		   scalar_only<dot_products_kernel<T>>(dot_and_squares_scalar<T>);
+		constexpr auto float_kernels = scalar_only<dot_kernel<float>>(dot_scalar<float>);
+		constexpr auto int8_kernels = scalar_only<dot_kernel<std::int8_t>>(dot_scalar<std::int8_t>);
+		constexpr auto float16_kernels =
+		   scalar_only<dot_kernel<std::uint16_t>>(dot_scalar<std::uint16_t, float16_decoder>);
+		constexpr auto bfloat16_kernels =
+		   scalar_only<dot_kernel<std::uint16_t>>(dot_scalar<std::uint16_t, bfloat16_decoder>);
+		constexpr auto float_float_kernels = scalar_only<dot_kernel<float, float>>(dot_float_scalar);
+		constexpr auto narrow_kernels =
+		   scalar_only<convert_kernel<double, float>>(convert_scalar<double, float>);
+		constexpr auto widen_kernels =
+		   scalar_only<convert_kernel<float, double>>(convert_scalar<float, double>);
+
+		template<typename Operation, typename T>
+		constexpr auto merge_kernels = scalar_only<merge_kernel<T>>(merge_scalar<Operation, T>);
+
+		template<typename Operation, typename T>
+		constexpr auto scale_kernels = scalar_only<scale_kernel<T>>(scale_scalar<Operation, T>);
+#endif
+
+		auto host_supports(instruction_set isa) -> bool {
+			switch (isa) {
+			case instruction_set::scalar: return true;
+#if COMP6771_KERNELS_X86
+			case instruction_set::avx2:
+				__builtin_cpu_init();
+				return __builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma")
+				       and __builtin_cpu_supports("f16c");
+			case instruction_set::avx512:
+				__builtin_cpu_init();
+				return __builtin_cpu_supports("avx512f") and host_supports(instruction_set::avx2);
+#else
+			case instruction_set::avx2:
+			case instruction_set::avx512: return false;
+#endif
+			}
+			return false;
+		}
+
+		template<typename Kernel>
+		auto kernel_for(kernel_set<Kernel> const& kernels, instruction_set isa) -> Kernel {
+			switch (isa) {
+			case instruction_set::scalar: return kernels.scalar;
+			case instruction_set::avx2: return kernels.avx2;
+			case instruction_set::avx512: return kernels.avx512;
+			}
+			return kernels.scalar;
+		}
+
+		// Picks the widest supported instruction set once, on first use
+		auto best_instruction_set() -> instruction_set {
+			static auto const isa = [] {
+				for (auto const candidate : {instruction_set::avx512, instruction_set::avx2}) {
+					if (host_supports(candidate)) {
+						return candidate;
+					}
+				}
+				return instruction_set::scalar;
+			}();
+			return isa;
+		}
+
+		template<typename Kernel>
+		auto checked_kernel_for(kernel_set<Kernel> const& kernels, instruction_set isa) -> Kernel {
+			if (not host_supports(isa)) {
+				throw euclidean_vector_error("Instruction set " + std::string(name(isa))
+				                             + " is not supported on this host");
+			}
+			return kernel_for(kernels, isa);
+		}
+	} // namespace
+
+	auto selected_instruction_set() -> instruction_set {
+		return best_instruction_set();
+	}
+
+	auto is_supported(instruction_set isa) -> bool {
+		return host_supports(isa);
+	}
+
+	auto name(instruction_set isa) -> std::string_view {
+		switch (isa) {
+		case instruction_set::scalar: return "scalar";
+		case instruction_set::avx2: return "avx2";
+		case instruction_set::avx512: return "avx512";
+		}
+		return "unknown";
+	}
+
+	auto dot(double const* x, double const* y, std::size_t size) -> double {
+		static auto const kernel = kernel_for(double_kernels, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto sum_of_squares(double const* x, std::size_t size) -> double {
+		return dot(x, x, size);
+	}
+
+	auto dot(instruction_set isa, double const* x, double const* y, std::size_t size) -> double {
+		return checked_kernel_for(double_kernels, isa)(x, y, size);
+	}
+
+	auto sum_of_squares(instruction_set isa, double const* x, std::size_t size) -> double {
+		return dot(isa, x, x, size);
+	}
+
+	auto dot(float const* x, float const* y, std::size_t size) -> double {
+		static auto const kernel = kernel_for(float_float_kernels, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto sum_of_squares(float const* x, std::size_t size) -> double {
+		return dot(x, x, size);
+	}
+
+	auto dot(instruction_set isa, float const* x, float const* y, std::size_t size) -> double {
+		return checked_kernel_for(float_float_kernels, isa)(x, y, size);
+	}
+
+	auto sum_of_squares(instruction_set isa, float const* x, std::size_t size) -> double {
+		return dot(isa, x, x, size);
+	}
+
+	auto convert(double const* from, float* to, std::size_t size) -> void {
+		static auto const kernel = kernel_for(narrow_kernels, best_instruction_set());
+		kernel(from, to, size);
+	}
+
+	auto convert(float const* from, double* to, std::size_t size) -> void {
+		static auto const kernel = kernel_for(widen_kernels, best_instruction_set());
+		kernel(from, to, size);
+	}
+
+	auto convert(instruction_set isa, double const* from, float* to, std::size_t size) -> void {
+		checked_kernel_for(narrow_kernels, isa)(from, to, size);
+	}
+
+	auto convert(instruction_set isa, float const* from, double* to, std::size_t size) -> void {
+		checked_kernel_for(widen_kernels, isa)(from, to, size);
+	}
+
+	auto add(double* x, double const* y, std::size_t size) -> void {
+		static auto const kernel = kernel_for(merge_kernels<std::plus<>, double>, best_instruction_set());
+		kernel(x, y, size);
+	}
+
+	auto subtract(double* x, double const* y, std::size_t size) -> void {
+		static auto const kernel = kernel_for(merge_kernels<std::minus<>, double>, best_instruction_set());
+		kernel(x, y, size);
+	}
+
+	auto multiply(double* x, double factor, std::size_t size) -> void {
+		static auto const kernel = kernel_for(scale_kernels<std::multiplies<>, double>, best_instruction_set());
+		kernel(x, factor, size);
+	}
+
+	auto divide(double* x, double factor, std::size_t size) -> void {
+		static auto const kernel = kernel_for(scale_kernels<std::divides<>, double>, best_instruction_set());
+		kernel(x, factor, size);
+	}
+
+	auto add(float* x, float const* y, std::size_t size) -> void {
+		static auto const kernel = kernel_for(merge_kernels<std::plus<>, float>, best_instruction_set());
+		kernel(x, y, size);
+	}
+
+	auto subtract(float* x, float const* y, std::size_t size) -> void {
+		static auto const kernel = kernel_for(merge_kernels<std::minus<>, float>, best_instruction_set());
+		kernel(x, y, size);
+	}
+
+	auto multiply(float* x, float factor, std::size_t size) -> void {
+		static auto const kernel = kernel_for(scale_kernels<std::multiplies<>, float>, best_instruction_set());
+		kernel(x, factor, size);
+	}
+
+	auto divide(float* x, float factor, std::size_t size) -> void {
+		static auto const kernel = kernel_for(scale_kernels<std::divides<>, float>, best_instruction_set());
+		kernel(x, factor, size);
+	}
+
+	auto add(instruction_set isa, double* x, double const* y, std::size_t size) -> void {
+		checked_kernel_for(merge_kernels<std::plus<>, double>, isa)(x, y, size);
+	}
+
+	auto subtract(instruction_set isa, double* x, double const* y, std::size_t size) -> void {
+		checked_kernel_for(merge_kernels<std::minus<>, double>, isa)(x, y, size);
+	}
+
+	auto multiply(instruction_set isa, double* x, double factor, std::size_t size) -> void {
+		checked_kernel_for(scale_kernels<std::multiplies<>, double>, isa)(x, factor, size);
+	}
+
+	auto divide(instruction_set isa, double* x, double factor, std::size_t size) -> void {
+		checked_kernel_for(scale_kernels<std::divides<>, double>, isa)(x, factor, size);
+	}
+
+	auto add(instruction_set isa, float* x, float const* y, std::size_t size) -> void {
+		checked_kernel_for(merge_kernels<std::plus<>, float>, isa)(x, y, size);
+	}
+
+	auto subtract(instruction_set isa, float* x, float const* y, std::size_t size) -> void {
+		checked_kernel_for(merge_kernels<std::minus<>, float>, isa)(x, y, size);
+	}
+
+	auto multiply(instruction_set isa, float* x, float factor, std::size_t size) -> void {
+		checked_kernel_for(scale_kernels<std::multiplies<>, float>, isa)(x, factor, size);
+	}
+
+	auto divide(instruction_set isa, float* x, float factor, std::size_t size) -> void {
+		checked_kernel_for(scale_kernels<std::divides<>, float>, isa)(x, factor, size);
+	}
+
+	auto dot_gather(double const* x, int const* indices, std::size_t size, double const* y) -> double {
+		static auto const kernel = kernel_for(gather_kernels, best_instruction_set());
+		return kernel(x, indices, size, y);
+	}
+
+	auto dot_gather(instruction_set isa,
+	                double const* x,
+	                int const* indices,
+	                std::size_t size,
+	                double const* y) -> double {
+		return checked_kernel_for(gather_kernels, isa)(x, indices, size, y);
+	}
+
+	auto squared_distance(double const* x, double const* y, std::size_t size) -> double {
+		static auto const kernel =
+		   kernel_for(distance_kernels<squared_difference, double>, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto squared_distance(float const* x, float const* y, std::size_t size) -> double {
+		static auto const kernel =
+		   kernel_for(distance_kernels<squared_difference, float>, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto manhattan(double const* x, double const* y, std::size_t size) -> double {
+		static auto const kernel =
+		   kernel_for(distance_kernels<absolute_difference, double>, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto manhattan(float const* x, float const* y, std::size_t size) -> double {
+		static auto const kernel =
+		   kernel_for(distance_kernels<absolute_difference, float>, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto chebyshev(double const* x, double const* y, std::size_t size) -> double {
+		static auto const kernel = kernel_for(chebyshev_kernels<double>, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto chebyshev(float const* x, float const* y, std::size_t size) -> double {
+		static auto const kernel = kernel_for(chebyshev_kernels<float>, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto squared_distance(instruction_set isa, double const* x, double const* y, std::size_t size)
+	   -> double {
+		return checked_kernel_for(distance_kernels<squared_difference, double>, isa)(x, y, size);
+	}
+
+	auto squared_distance(instruction_set isa, float const* x, float const* y, std::size_t size)
+	   -> double {
+		return checked_kernel_for(distance_kernels<squared_difference, float>, isa)(x, y, size);
+	}
+
+	auto manhattan(instruction_set isa, double const* x, double const* y, std::size_t size)
+	   -> double {
+		return checked_kernel_for(distance_kernels<absolute_difference, double>, isa)(x, y, size);
+	}
+
+	auto manhattan(instruction_set isa, float const* x, float const* y, std::size_t size) -> double {
+		return checked_kernel_for(distance_kernels<absolute_difference, float>, isa)(x, y, size);
+	}
+
+	auto chebyshev(instruction_set isa, double const* x, double const* y, std::size_t size)
+	   -> double {
+		return checked_kernel_for(chebyshev_kernels<double>, isa)(x, y, size);
+	}
+
+	auto chebyshev(instruction_set isa, float const* x, float const* y, std::size_t size) -> double {
+		return checked_kernel_for(chebyshev_kernels<float>, isa)(x, y, size);
+	}
+
+	auto dot_and_squares(double const* x, double const* y, std::size_t size) -> dot_products {
+		static auto const kernel =
+		   kernel_for(dot_and_squares_kernels<double>, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto dot_and_squares(float const* x, float const* y, std::size_t size) -> dot_products {
+		static auto const kernel =
+		   kernel_for(dot_and_squares_kernels<float>, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto dot_and_squares(instruction_set isa, double const* x, double const* y, std::size_t size)
+	   -> dot_products {
+		return checked_kernel_for(dot_and_squares_kernels<double>, isa)(x, y, size);
+	}
+
+	auto dot_and_squares(instruction_set isa, float const* x, float const* y, std::size_t size)
+	   -> dot_products {
+		return checked_kernel_for(dot_and_squares_kernels<float>, isa)(x, y, size);
+	}
+
+	auto dot_tile(double const* a, double const* b, std::size_t depth, double* tile) -> void {
+		static auto const kernel = kernel_for(tile_kernels, best_instruction_set());
+		kernel(a, b, depth, tile);
+	}
+
+	auto dot_tile(instruction_set isa, double const* a, double const* b, std::size_t depth, double* tile)
+	   -> void {
+		checked_kernel_for(tile_kernels, isa)(a, b, depth, tile);
+	}
+
+	auto squared_distance_tile(double const* a, double const* b, std::size_t depth, double* tile)
+	   -> void {
+		static auto const kernel = kernel_for(squared_distance_tile_kernels, best_instruction_set());
+		kernel(a, b, depth, tile);
+	}
+
+	auto squared_distance_tile(instruction_set isa,
+	                           double const* a,
+	                           double const* b,
+	                           std::size_t depth,
+	                           double* tile) -> void {
+		checked_kernel_for(squared_distance_tile_kernels, isa)(a, b, depth, tile);
+	}
+
+	auto dot(double const* x, float const* y, std::size_t size) -> double {
+		static auto const kernel = kernel_for(float_kernels, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto dot(double const* x, std::int8_t const* y, std::size_t size) -> double {
+		static auto const kernel = kernel_for(int8_kernels, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto dot_float16(double const* x, std::uint16_t const* y, std::size_t size) -> double {
+		static auto const kernel = kernel_for(float16_kernels, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto dot_bfloat16(double const* x, std::uint16_t const* y, std::size_t size) -> double {
+		static auto const kernel = kernel_for(bfloat16_kernels, best_instruction_set());
+		return kernel(x, y, size);
+	}
+
+	auto dot(instruction_set isa, double const* x, float const* y, std::size_t size) -> double {
+		return checked_kernel_for(float_kernels, isa)(x, y, size);
+	}
+
+	auto dot(instruction_set isa, double const* x, std::int8_t const* y, std::size_t size)
+	   -> double {
+		return checked_kernel_for(int8_kernels, isa)(x, y, size);
+	}
+
+	auto dot_float16(instruction_set isa, double const* x, std::uint16_t const* y, std::size_t size)
+	   -> double {
+		return checked_kernel_for(float16_kernels, isa)(x, y, size);
+	}
+
+	auto dot_bfloat16(instruction_set isa, double const* x, std::uint16_t const* y, std::size_t size)
+	   -> double {
+		return checked_kernel_for(bfloat16_kernels, isa)(x, y, size);
+	}
+
+	auto to_float16(float value) -> std::uint16_t {
+		auto const bits = std::bit_cast<std::uint32_t>(value);
+		auto const sign = (bits >> 16U) & 0x8000U;
+		auto const biased = static_cast<int>((bits >> 23U) & 0xffU);
+		auto mantissa = bits & 0x7fffffU;
+
+		if (biased == 0xff) {
+			return static_cast<std::uint16_t>(sign | 0x7c00U | (mantissa != 0 ? 0x200U : 0U));
+		}
+
+		auto const exponent = biased - 127 + 15;
+		if (exponent >= 31) {
+			return static_cast<std::uint16_t>(sign | 0x7c00U);
+		}
+		if (exponent <= 0) {
+			if (exponent < -10) {
+				return static_cast<std::uint16_t>(sign);
+			}
+			// Subnormal, with the implicit leading 1 made explicit
+			mantissa |= 0x800000U;
+			auto const shift = static_cast<unsigned>(14 - exponent);
+			auto half = mantissa >> shift;
+			auto const remainder = mantissa & ((1U << shift) - 1);
+			auto const halfway = 1U << (shift - 1);
+			if (remainder > halfway or (remainder == halfway and (half & 1U) != 0)) {
+				++half;
+			}
+			return static_cast<std::uint16_t>(sign | half);
+		}
+
+		// Rounding up may carry into the exponent, which is still correct
+		auto half = sign | (static_cast<std::uint32_t>(exponent) << 10U) | (mantissa >> 13U);
+		auto const remainder = mantissa & 0x1fffU;
+		if (remainder > 0x1000U or (remainder == 0x1000U and (half & 1U) != 0)) {
+			++half;
+		}
+		return static_cast<std::uint16_t>(half);
+	}
+
+	auto from_float16(std::uint16_t half) -> float {
+		return decode_float16(half);
+	}
+
+	auto to_bfloat16(float value) -> std::uint16_t {
+		auto const bits = std::bit_cast<std::uint32_t>(value);
+		if (std::isnan(value)) {
+			return static_cast<std::uint16_t>((bits >> 16U) | 0x40U);
+		}
+		return static_cast<std::uint16_t>((bits + 0x7fffU + ((bits >> 16U) & 1U)) >> 16U);
+	}
+
+	auto from_bfloat16(std::uint16_t bfloat) -> float {
+		return decode_bfloat16(bfloat);
+	}
+} // namespace comp6771::kernels
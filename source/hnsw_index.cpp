@@ -0,0 +1,499 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include "comp6771/hnsw_index.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		constexpr auto file_magic = std::array<char, 8>{'C', '6', '7', '7', '1', 'H', 'N', 'W'};
+		constexpr auto file_version = std::uint32_t{1};
+
+		// random_level draws from 1 - u with u in [0, 1), so no node has more than
+		// -log2(2^-53) = 53 levels even when m is 2
+		constexpr auto max_levels = 64;
+
+		auto parameters_check(hnsw_parameters const& parameters) -> void {
+			if (parameters.m < 2) {
+				throw euclidean_vector_error("Invalid hnsw_index m " + std::to_string(parameters.m));
+			}
+			if (parameters.ef_construction < 1) {
+				throw euclidean_vector_error("Invalid hnsw_index ef_construction "
+				                             + std::to_string(parameters.ef_construction));
+			}
+			if (parameters.ef_search < 1) {
+				throw euclidean_vector_error("Invalid hnsw_index ef_search "
+				                             + std::to_string(parameters.ef_search));
+			}
+		}
+
+		// Marks the nodes a search has visited. Clearing is O(1): each search uses a new epoch,
+		// and a node has been visited if its mark is the current epoch.
+		class visited_set {
+		public:
+			auto reset(std::size_t size) -> void {
+				if (marks_.size() < size) {
+					marks_.resize(size);
+				}
+				if (++epoch_ == 0) {
+					std::fill(marks_.begin(), marks_.end(), 0);
+					epoch_ = 1;
+				}
+			}
+
+			// Returns whether <node> had already been visited
+			auto visit(int node) -> bool {
+				auto& mark = marks_[static_cast<std::size_t>(node)];
+				return std::exchange(mark, epoch_) == epoch_;
+			}
+
+		private:
+			std::vector<std::uint32_t> marks_;
+			std::uint32_t epoch_ = 0;
+		};
+
+		template<typename T>
+		auto write(std::ofstream& out, T const& value) -> void {
+			out.write(reinterpret_cast<char const*>(&value), sizeof(T));
+		}
+
+		template<typename T>
+		auto read(std::ifstream& in) -> T {
+			auto value = T{};
+			in.read(reinterpret_cast<char*>(&value), sizeof(T));
+			return value;
+		}
+
+		auto file_check(bool good, std::string const& path) -> void {
+			if (not good) {
+				throw euclidean_vector_error("Cannot read hnsw_index from " + path);
+			}
+		}
+
+		// The bytes between the read position of <in> and the end of the file
+		auto remaining_bytes(std::ifstream& in) -> std::uintmax_t {
+			auto const position = in.tellg();
+			in.seekg(0, std::ios::end);
+			auto const end = in.tellg();
+			in.seekg(position);
+			return position < 0 or end < position ? 0 : static_cast<std::uintmax_t>(end - position);
+		}
+	} // namespace
+
+	// Constructors
+	hnsw_index::hnsw_index(int dimensions, metric m, hnsw_parameters parameters)
+	: vectors_(dimensions)
+	, metric_{m}
+	, parameters_{parameters}
+	, level_multiplier_{0}
+	, random_(parameters.seed) {
+		parameters_check(parameters_);
+		level_multiplier_ = 1 / std::log(static_cast<double>(parameters_.m));
+	}
+
+	hnsw_index::hnsw_index(hnsw_index&& other) noexcept
+	: vectors_(std::move(other.vectors_))
+	, squared_norms_(std::move(other.squared_norms_))
+	, links_(std::move(other.links_))
+	, metric_{other.metric_}
+	, parameters_{other.parameters_}
+	, level_multiplier_{other.level_multiplier_}
+	, entry_point_{std::exchange(other.entry_point_, -1)}
+	, top_level_{std::exchange(other.top_level_, -1)}
+	, random_(std::move(other.random_)) {}
+
+	auto hnsw_index::operator=(hnsw_index&& other) -> hnsw_index& {
+		vectors_ = std::move(other.vectors_);
+		squared_norms_ = std::move(other.squared_norms_);
+		links_ = std::move(other.links_);
+		metric_ = other.metric_;
+		parameters_ = other.parameters_;
+		level_multiplier_ = other.level_multiplier_;
+		entry_point_ = std::exchange(other.entry_point_, -1);
+		top_level_ = std::exchange(other.top_level_, -1);
+		random_ = std::move(other.random_);
+		return *this;
+	}
+
+	// Member functions
+	auto hnsw_index::size() const -> int {
+		auto const lock = std::shared_lock(graph_mutex_);
+		return vectors_.size();
+	}
+
+	auto hnsw_index::dimensions() const -> int {
+		return vectors_.dimensions();
+	}
+
+	auto hnsw_index::distance_metric() const -> metric {
+		return metric_;
+	}
+
+	auto hnsw_index::parameters() const -> hnsw_parameters {
+		auto const lock = std::shared_lock(graph_mutex_);
+		return parameters_;
+	}
+
+	auto hnsw_index::set_ef_search(int ef_search) -> void {
+		auto const lock = std::unique_lock(graph_mutex_);
+		auto parameters = parameters_;
+		parameters.ef_search = ef_search;
+		parameters_check(parameters);
+		parameters_ = parameters;
+	}
+
+	auto hnsw_index::save(std::string const& path) const -> void {
+		auto const lock = std::shared_lock(graph_mutex_);
+		auto out = std::ofstream(path, std::ios::binary);
+		if (not out) {
+			throw euclidean_vector_error("Cannot write hnsw_index to " + path);
+		}
+
+		out.write(file_magic.data(), file_magic.size());
+		write(out, file_version);
+		write(out, static_cast<std::int32_t>(dimensions()));
+		write(out, static_cast<std::int32_t>(metric_));
+		write(out, static_cast<std::int32_t>(parameters_.m));
+		write(out, static_cast<std::int32_t>(parameters_.ef_construction));
+		write(out, static_cast<std::int32_t>(parameters_.ef_search));
+		write(out, static_cast<std::uint64_t>(parameters_.seed));
+		write(out, static_cast<std::int32_t>(vectors_.size()));
+		write(out, static_cast<std::int32_t>(entry_point_));
+		write(out, static_cast<std::int32_t>(top_level_));
+
+		out.write(reinterpret_cast<char const*>(vectors_.data()),
+		          static_cast<std::streamsize>(sizeof(double)
+		                                       * static_cast<std::size_t>(vectors_.size())
+		                                       * static_cast<std::size_t>(dimensions())));
+
+		for (auto const& levels : links_) {
+			write(out, static_cast<std::int32_t>(levels.size()));
+			for (auto const& links : levels) {
+				write(out, static_cast<std::int32_t>(links.size()));
+				out.write(reinterpret_cast<char const*>(links.data()),
+				          static_cast<std::streamsize>(sizeof(int) * links.size()));
+			}
+		}
+
+		if (not out) {
+			throw euclidean_vector_error("Cannot write hnsw_index to " + path);
+		}
+	}
+
+	auto hnsw_index::load(std::string const& path) -> hnsw_index {
+		auto in = std::ifstream(path, std::ios::binary);
+		file_check(static_cast<bool>(in), path);
+
+		auto magic = std::array<char, 8>{};
+		in.read(magic.data(), magic.size());
+		file_check(in and magic == file_magic and read<std::uint32_t>(in) == file_version, path);
+
+		auto const dimensions = read<std::int32_t>(in);
+		auto const metric_value = read<std::int32_t>(in);
+		file_check(metric_value >= static_cast<std::int32_t>(metric::l2)
+		              and metric_value <= static_cast<std::int32_t>(metric::cosine),
+		           path);
+		auto const m = static_cast<metric>(metric_value);
+		auto parameters = hnsw_parameters();
+		parameters.m = read<std::int32_t>(in);
+		parameters.ef_construction = read<std::int32_t>(in);
+		parameters.ef_search = read<std::int32_t>(in);
+		parameters.seed = static_cast<std::uint_fast32_t>(read<std::uint64_t>(in));
+		auto const size = read<std::int32_t>(in);
+		file_check(in and dimensions >= 0 and size >= 0, path);
+
+		auto index = hnsw_index(dimensions, m, parameters);
+		index.entry_point_ = read<std::int32_t>(in);
+		index.top_level_ = read<std::int32_t>(in);
+		file_check(in and index.top_level_ >= -1 and index.top_level_ < max_levels, path);
+
+		// Each node stores its magnitudes, its level count and at least one link count, so a
+		// corrupt size is rejected before anything is allocated for it
+		auto const node_bytes =
+		   sizeof(double) * static_cast<std::uintmax_t>(dimensions) + 2 * sizeof(std::int32_t);
+		file_check(static_cast<std::uintmax_t>(size) <= remaining_bytes(in) / node_bytes, path);
+
+		index.vectors_.resize(size);
+		in.read(reinterpret_cast<char*>(index.vectors_.data()),
+		        static_cast<std::streamsize>(sizeof(double) * static_cast<std::size_t>(size)
+		                                     * static_cast<std::size_t>(dimensions)));
+
+		index.links_.resize(static_cast<std::size_t>(size));
+		for (auto& levels : index.links_) {
+			auto const level_count = read<std::int32_t>(in);
+			file_check(in and level_count > 0 and level_count <= index.top_level_ + 1, path);
+			levels.resize(static_cast<std::size_t>(level_count));
+			for (auto& links : levels) {
+				auto const link_count = read<std::int32_t>(in);
+				file_check(in and link_count >= 0 and link_count <= size, path);
+				links.resize(static_cast<std::size_t>(link_count));
+				in.read(reinterpret_cast<char*>(links.data()),
+				        static_cast<std::streamsize>(sizeof(int) * links.size()));
+				file_check(in
+				              and std::all_of(links.begin(),
+				                              links.end(),
+				                              [size](int const node) { return node >= 0 and node < size; }),
+				           path);
+			}
+		}
+		file_check(in and index.entry_point_ >= (size == 0 ? -1 : 0) and index.entry_point_ < size, path);
+
+		// Searches walk down from the entry point's top level, and only follow links on a level to
+		// nodes that are on it
+		auto const entry_levels =
+		   size == 0 ? 0 : index.links_[static_cast<std::size_t>(index.entry_point_)].size();
+		file_check(index.top_level_ == static_cast<int>(entry_levels) - 1, path);
+		for (auto const& levels : index.links_) {
+			for (auto l = std::size_t{0}; l < levels.size(); ++l) {
+				for (auto const node : levels[l]) {
+					file_check(index.links_[static_cast<std::size_t>(node)].size() > l, path);
+				}
+			}
+		}
+
+		index.squared_norms_.resize(static_cast<std::size_t>(size));
+		for (auto i = 0; i < size; ++i) {
+			index.squared_norms_[static_cast<std::size_t>(i)] =
+			   kernels::sum_of_squares(index.vectors_[i].data(), static_cast<std::size_t>(dimensions));
+		}
+		return index;
+	}
+
+	// Helper functions
+	auto hnsw_index::add(double const* magnitudes) -> int {
+		auto const query_norm =
+		   kernels::sum_of_squares(magnitudes, static_cast<std::size_t>(dimensions()));
+		auto const level = random_level();
+
+		// Find the neighbours on each layer while searches carry on
+		auto neighbours = std::vector<std::vector<int>>(static_cast<std::size_t>(level) + 1);
+		auto searched_level = -1;
+		{
+			auto const lock = std::shared_lock(graph_mutex_);
+			if (entry_point_ != -1) {
+				find_neighbours(magnitudes, query_norm, level, 0, neighbours);
+				searched_level = std::min(level, top_level_);
+			}
+		}
+
+		auto const lock = std::unique_lock(graph_mutex_);
+
+		// Another insert raised the top level (or made the graph non-empty) since the search above,
+		// so the levels it added have not been searched. Without links on them, nothing could reach
+		// this node there.
+		if (entry_point_ != -1 and std::min(level, top_level_) > searched_level) {
+			find_neighbours(magnitudes, query_norm, level, searched_level + 1, neighbours);
+		}
+
+		auto const node = vectors_.size();
+		vectors_.push_back(const_euclidean_vector_view(magnitudes, dimensions()));
+		squared_norms_.push_back(query_norm);
+		links_.emplace_back(neighbours);
+
+		for (auto l = std::size_t{0}; l < neighbours.size(); ++l) {
+			for (auto const neighbour : neighbours[l]) {
+				link(neighbour, node, static_cast<int>(l));
+			}
+		}
+
+		if (entry_point_ == -1 or level > top_level_) {
+			entry_point_ = node;
+			top_level_ = level;
+		}
+		return node;
+	}
+
+	auto hnsw_index::search(double const* query, int k) const -> std::vector<neighbour> {
+		detail::k_check(k);
+
+		auto const query_norm = kernels::sum_of_squares(query, static_cast<std::size_t>(dimensions()));
+
+		auto const lock = std::shared_lock(graph_mutex_);
+		if (entry_point_ == -1 or k == 0) {
+			return {};
+		}
+
+		auto const ef = static_cast<std::size_t>(std::max(parameters_.ef_search, k));
+		auto const candidates = search_layer(query, query_norm, {descend(query, query_norm, 0)}, ef, 0);
+
+		auto result = std::vector<neighbour>();
+		for (auto i = std::size_t{0}; i < std::min(candidates.size(), static_cast<std::size_t>(k)); ++i) {
+			auto const [distance, node] = candidates[i];
+			result.push_back({node, metric_ == metric::l2 ? std::sqrt(distance) : distance});
+		}
+		return result;
+	}
+
+	auto hnsw_index::random_level() -> int {
+		auto const lock = std::scoped_lock(random_mutex_);
+		auto uniform = std::uniform_real_distribution<double>(0, 1);
+		auto const u = 1 - uniform(random_);
+		return static_cast<int>(std::floor(-std::log(u) * level_multiplier_));
+	}
+
+	auto hnsw_index::max_links(int level) const -> std::size_t {
+		return static_cast<std::size_t>(level == 0 ? 2 * parameters_.m : parameters_.m);
+	}
+
+	auto hnsw_index::distance(double const* query, double query_norm, int node) const -> double {
+		return detail::exact_distance(metric_,
+		                              query,
+		                              query_norm,
+		                              vectors_[node].data(),
+		                              squared_norms_[static_cast<std::size_t>(node)],
+		                              static_cast<std::size_t>(dimensions()));
+	}
+
+	auto hnsw_index::distance(int x, int y) const -> double {
+		return distance(vectors_[x].data(), squared_norms_[static_cast<std::size_t>(x)], y);
+	}
+
+	auto hnsw_index::search_layer(double const* query,
+	                              double query_norm,
+	                              std::vector<candidate> const& entry_points,
+	                              std::size_t ef,
+	                              int level) const -> std::vector<candidate> {
+		thread_local auto visited = visited_set();
+		visited.reset(static_cast<std::size_t>(vectors_.size()));
+
+		// Nearest unexplored candidate on top, and the furthest of the ef nearest found on top
+		auto to_explore = std::priority_queue<candidate, std::vector<candidate>, std::greater<>>();
+		auto nearest = std::priority_queue<candidate>();
+		for (auto const& entry : entry_points) {
+			if (not visited.visit(entry.second)) {
+				to_explore.push(entry);
+				nearest.push(entry);
+			}
+		}
+		while (nearest.size() > ef) {
+			nearest.pop();
+		}
+
+		while (not to_explore.empty()) {
+			auto const [distance_explored, node] = to_explore.top();
+			if (distance_explored > nearest.top().first and nearest.size() >= ef) {
+				break;
+			}
+			to_explore.pop();
+
+			auto const& levels = links_[static_cast<std::size_t>(node)];
+			if (static_cast<std::size_t>(level) >= levels.size()) {
+				continue;
+			}
+			for (auto const next : levels[static_cast<std::size_t>(level)]) {
+				if (visited.visit(next)) {
+					continue;
+				}
+				auto const d = distance(query, query_norm, next);
+				if (nearest.size() < ef or d < nearest.top().first) {
+					to_explore.emplace(d, next);
+					nearest.emplace(d, next);
+					if (nearest.size() > ef) {
+						nearest.pop();
+					}
+				}
+			}
+		}
+
+		auto result = std::vector<candidate>(nearest.size());
+		for (auto i = result.size(); i > 0; --i) {
+			result[i - 1] = nearest.top();
+			nearest.pop();
+		}
+		return result;
+	}
+
+	auto hnsw_index::descend(double const* query, double query_norm, int level) const -> candidate {
+		auto current = candidate(distance(query, query_norm, entry_point_), entry_point_);
+		for (auto l = top_level_; l > level; --l) {
+			for (auto changed = true; changed;) {
+				changed = false;
+				auto const& levels = links_[static_cast<std::size_t>(current.second)];
+				for (auto const next : levels[static_cast<std::size_t>(l)]) {
+					auto const d = distance(query, query_norm, next);
+					if (d < current.first) {
+						current = {d, next};
+						changed = true;
+					}
+				}
+			}
+		}
+		return current;
+	}
+
+	auto hnsw_index::find_neighbours(double const* magnitudes,
+	                                 double query_norm,
+	                                 int level,
+	                                 int lowest,
+	                                 std::vector<std::vector<int>>& neighbours) const -> void {
+		auto entry_points = std::vector<candidate>{descend(magnitudes, query_norm, level)};
+		for (auto l = std::min(level, top_level_); l >= lowest; --l) {
+			auto candidates = search_layer(magnitudes,
+			                               query_norm,
+			                               entry_points,
+			                               static_cast<std::size_t>(parameters_.ef_construction),
+			                               l);
+			neighbours[static_cast<std::size_t>(l)] =
+			   select_neighbours(candidates, static_cast<std::size_t>(parameters_.m));
+			entry_points = std::move(candidates);
+		}
+	}
+
+	auto hnsw_index::select_neighbours(std::vector<candidate> const& candidates,
+	                                   std::size_t count) const -> std::vector<int> {
+		auto selected = std::vector<int>();
+		for (auto const& [d, node] : candidates) {
+			if (selected.size() == count) {
+				break;
+			}
+			auto const diverse = std::none_of(selected.begin(), selected.end(), [&](int const other) {
+				return distance(node, other) < d;
+			});
+			if (diverse) {
+				selected.push_back(node);
+			}
+		}
+
+		// Fill any remaining links with the nearest candidates that were skipped
+		for (auto const& [d, node] : candidates) {
+			if (selected.size() == count) {
+				break;
+			}
+			if (std::find(selected.begin(), selected.end(), node) == selected.end()) {
+				selected.push_back(node);
+			}
+		}
+		return selected;
+	}
+
+	auto hnsw_index::link(int neighbour, int node, int level) -> void {
+		auto& links = links_[static_cast<std::size_t>(neighbour)][static_cast<std::size_t>(level)];
+		if (std::find(links.begin(), links.end(), node) != links.end()) {
+			return;
+		}
+		links.push_back(node);
+
+		if (links.size() > max_links(level)) {
+			auto candidates = std::vector<candidate>();
+			for (auto const other : links) {
+				candidates.emplace_back(distance(neighbour, other), other);
+			}
+			std::sort(candidates.begin(), candidates.end());
+			links = select_neighbours(candidates, max_links(level));
+		}
+	}
+} // namespace comp6771
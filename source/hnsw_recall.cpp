@@ -0,0 +1,170 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Measures the recall and latency of hnsw_index against brute_force_index on random data, to
+// choose m, ef_construction and ef_search for a latency target.
+//
+// Usage: hnsw_recall [--size N] [--dimensions D] [--queries Q] [--k K] [--m M]
+//                    [--ef-construction E] [--ef-search E1,E2,...] [--metric l2|inner_product|cosine]
+//                    [--index PATH]
+//
+// If --index names an existing file it is loaded instead of being built, otherwise the built index
+// is saved there.
+#include "comp6771/hnsw_index.hpp"
+#include "comp6771/nearest_neighbours.hpp"
+#include "comp6771/testing/random_batch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+	struct options {
+		int size = 100'000;
+		int dimensions = 64;
+		int queries = 1'000;
+		int k = 10;
+		comp6771::metric metric = comp6771::metric::l2;
+		comp6771::hnsw_parameters parameters = {};
+		std::vector<int> ef_search = {10, 20, 40, 80, 160, 320};
+		std::string index_path;
+	};
+
+	auto parse_metric(std::string_view value) -> comp6771::metric {
+		for (auto const m :
+		     {comp6771::metric::l2, comp6771::metric::inner_product, comp6771::metric::cosine}) {
+			if (comp6771::name(m) == value) {
+				return m;
+			}
+		}
+		throw comp6771::euclidean_vector_error("Unknown metric " + std::string(value));
+	}
+
+	auto parse_list(std::string const& value) -> std::vector<int> {
+		auto result = std::vector<int>();
+		auto stream = std::istringstream(value);
+		for (auto item = std::string(); std::getline(stream, item, ',');) {
+			result.push_back(std::stoi(item));
+		}
+		return result;
+	}
+
+	auto parse(int argc, char** argv) -> options {
+		auto result = options();
+		auto const args = std::vector<std::string>(argv + 1, argv + argc);
+		for (auto i = std::size_t{0}; i + 1 < args.size(); i += 2) {
+			auto const& flag = args[i];
+			auto const& value = args[i + 1];
+			if (flag == "--size") {
+				result.size = std::stoi(value);
+			}
+			else if (flag == "--dimensions") {
+				result.dimensions = std::stoi(value);
+			}
+			else if (flag == "--queries") {
+				result.queries = std::stoi(value);
+			}
+			else if (flag == "--k") {
+				result.k = std::stoi(value);
+			}
+			else if (flag == "--m") {
+				result.parameters.m = std::stoi(value);
+			}
+			else if (flag == "--ef-construction") {
+				result.parameters.ef_construction = std::stoi(value);
+			}
+			else if (flag == "--ef-search") {
+				result.ef_search = parse_list(value);
+			}
+			else if (flag == "--metric") {
+				result.metric = parse_metric(value);
+			}
+			else if (flag == "--index") {
+				result.index_path = value;
+			}
+			else {
+				throw comp6771::euclidean_vector_error("Unknown option " + flag);
+			}
+		}
+		return result;
+	}
+
+	using comp6771::testing::random_batch;
+
+	auto elapsed_ms(std::chrono::steady_clock::time_point start) -> double {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+		   .count();
+	}
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+	try {
+		auto const opts = parse(argc, argv);
+		auto const normal = std::normal_distribution<double>(0, 1);
+		auto const vectors = random_batch(opts.size, opts.dimensions, 1, normal);
+		auto const queries = random_batch(opts.queries, opts.dimensions, 2, normal);
+
+		auto start = std::chrono::steady_clock::now();
+		auto index = comp6771::hnsw_index(opts.dimensions, opts.metric, opts.parameters);
+		if (not opts.index_path.empty() and std::filesystem::exists(opts.index_path)) {
+			index = comp6771::hnsw_index::load(opts.index_path);
+			std::printf("loaded %s in %.1f ms\n", opts.index_path.c_str(), elapsed_ms(start));
+		}
+		else {
+			for (auto i = 0; i < vectors.size(); ++i) {
+				index.add(vectors[i]);
+			}
+			std::printf("built %d vectors in %.1f ms\n", index.size(), elapsed_ms(start));
+			if (not opts.index_path.empty()) {
+				index.save(opts.index_path);
+			}
+		}
+
+		start = std::chrono::steady_clock::now();
+		auto const exact = comp6771::brute_force_index(vectors, opts.metric).search(queries, opts.k);
+		std::printf("exact search of %d queries in %.1f ms\n\n", opts.queries, elapsed_ms(start));
+
+		std::printf("%10s %10s %12s %12s %12s\n", "ef_search", "recall", "mean (us)", "p50 (us)", "p99 (us)");
+		for (auto const ef_search : opts.ef_search) {
+			index.set_ef_search(ef_search);
+
+			auto found = 0;
+			auto latencies = std::vector<double>();
+			for (auto q = 0; q < queries.size(); ++q) {
+				auto const query_start = std::chrono::steady_clock::now();
+				auto const result = index.search(queries[q], opts.k);
+				latencies.push_back(elapsed_ms(query_start) * 1000);
+
+				for (auto const& n : exact[static_cast<std::size_t>(q)]) {
+					found += std::any_of(result.begin(), result.end(), [&n](auto const& r) {
+						return r.index == n.index;
+					});
+				}
+			}
+
+			std::sort(latencies.begin(), latencies.end());
+			auto const mean = std::accumulate(latencies.begin(), latencies.end(), 0.0)
+			                  / static_cast<double>(latencies.size());
+			auto const percentile = [&latencies](double p) {
+				return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))];
+			};
+			std::printf("%10d %10.4f %12.1f %12.1f %12.1f\n",
+			            ef_search,
+			            static_cast<double>(found) / (opts.queries * opts.k),
+			            mean,
+			            percentile(0.5),
+			            percentile(0.99));
+		}
+	} catch (std::exception const& e) {
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+}
@@ -0,0 +1,218 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include "comp6771/instrumentation.hpp"
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace comp6771::instrumentation {
+	namespace {
+		constexpr auto counter_names = std::array<std::string_view, counter_count>{
+		   "copies",
+		   "copied_bytes",
+		   "moves",
+		   "allocations",
+		   "allocated_bytes",
+		   "deallocations",
+		   "norm_cache_hits",
+		   "norm_cache_misses",
+		};
+
+		constexpr auto operation_names = std::array<std::string_view, operation_count>{
+		   "evaluate",
+		   "arithmetic",
+		   "euclidean_norm",
+		   "dot",
+		   "unit",
+		};
+
+		struct registry {
+			std::mutex mutex;
+			std::vector<detail::thread_block*> live;
+			// Everything counted by threads that have exited
+			snapshot retired;
+			// Everything counted before the last reset()
+			snapshot baseline;
+		};
+
+		auto the_registry() -> registry& {
+			static auto r = registry();
+			return r;
+		}
+
+		auto accumulate(snapshot& s, detail::thread_block const& block) -> void {
+			for (auto c = std::size_t{0}; c < counter_count; ++c) {
+				s.counters[c] += block.counters[c].load(std::memory_order_relaxed);
+			}
+			for (auto op = std::size_t{0}; op < operation_count; ++op) {
+				for (auto b = std::size_t{0}; b < histogram_buckets; ++b) {
+					s.latencies[op].buckets[b] += block.buckets[op][b].load(std::memory_order_relaxed);
+				}
+				s.latencies[op].total_nanoseconds +=
+				   block.total_nanoseconds[op].load(std::memory_order_relaxed);
+			}
+		}
+
+		// Callers must hold the registry's mutex
+		auto totals(registry& r) -> snapshot {
+			auto s = r.retired;
+			for (auto const* const block : r.live) {
+				accumulate(s, *block);
+			}
+			return s;
+		}
+
+		// Set once this thread's block has been retired, so that thread_local destructors that run
+		// later do not register it again
+		constinit thread_local bool thread_exited = false;
+
+		// Folds this thread's block into the retired totals when the thread exits
+		struct thread_guard {
+			thread_guard() = default;
+			thread_guard(thread_guard const&) = delete;
+			auto operator=(thread_guard const&) -> thread_guard& = delete;
+
+			~thread_guard() {
+				auto* const block = std::exchange(detail::current_block, nullptr);
+				thread_exited = true;
+
+				auto& r = the_registry();
+				auto const lock = std::scoped_lock(r.mutex);
+				accumulate(r.retired, *block);
+				std::erase(r.live, block);
+				delete block;
+			}
+		};
+
+		// Writes <value> the same way regardless of the stream's locale and precision
+		auto write_number(std::ostream& os, double value) -> void {
+			auto buffer = std::array<char, 32>{};
+			auto const result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+			os.write(buffer.data(), result.ptr - buffer.data());
+		}
+	} // namespace
+
+	constinit thread_local detail::thread_block* detail::current_block = nullptr;
+
+	auto detail::register_thread() noexcept -> thread_block* {
+		if (thread_exited) {
+			return nullptr;
+		}
+
+		auto* const block = new (std::nothrow) thread_block();
+		if (block == nullptr) {
+			return nullptr;
+		}
+
+		try {
+			auto& r = the_registry();
+			{
+				auto const lock = std::scoped_lock(r.mutex);
+				r.live.push_back(block);
+			}
+			current_block = block;
+			thread_local auto const guard = thread_guard();
+		} catch (...) {
+			// Recording is best effort, so this thread goes uncounted
+			auto& r = the_registry();
+			auto const lock = std::scoped_lock(r.mutex);
+			std::erase(r.live, block);
+			current_block = nullptr;
+			delete block;
+			return nullptr;
+		}
+		return block;
+	}
+
+	auto name(counter c) -> std::string_view {
+		return counter_names[static_cast<std::size_t>(c)];
+	}
+
+	auto name(operation op) -> std::string_view {
+		return operation_names[static_cast<std::size_t>(op)];
+	}
+
+	auto latency_histogram::count() const -> std::uint64_t {
+		auto total = std::uint64_t{0};
+		for (auto const bucket : buckets) {
+			total += bucket;
+		}
+		return total;
+	}
+
+	auto take_snapshot() -> snapshot {
+		if constexpr (not enabled) {
+			return snapshot();
+		}
+
+		auto& r = the_registry();
+		auto const lock = std::scoped_lock(r.mutex);
+		auto s = totals(r);
+
+		// Nothing is ever subtracted from a block, so every total is at least its baseline
+		for (auto c = std::size_t{0}; c < counter_count; ++c) {
+			s.counters[c] -= r.baseline.counters[c];
+		}
+		for (auto op = std::size_t{0}; op < operation_count; ++op) {
+			for (auto b = std::size_t{0}; b < histogram_buckets; ++b) {
+				s.latencies[op].buckets[b] -= r.baseline.latencies[op].buckets[b];
+			}
+			s.latencies[op].total_nanoseconds -= r.baseline.latencies[op].total_nanoseconds;
+		}
+		return s;
+	}
+
+	auto reset() -> void {
+		if constexpr (enabled) {
+			auto& r = the_registry();
+			auto const lock = std::scoped_lock(r.mutex);
+			r.baseline = totals(r);
+		}
+	}
+
+	auto write_metrics(std::ostream& os, snapshot const& s) -> std::ostream& {
+		constexpr auto prefix = std::string_view("comp6771_euclidean_vector_");
+
+		for (auto c = std::size_t{0}; c < counter_count; ++c) {
+			os << "# TYPE " << prefix << counter_names[c] << "_total counter\n";
+			os << prefix << counter_names[c] << "_total " << s.counters[c] << '\n';
+		}
+
+		os << "# TYPE " << prefix << "latency_seconds histogram\n";
+		for (auto op = std::size_t{0}; op < operation_count; ++op) {
+			auto const& histogram = s.latencies[op];
+			auto const label = operation_names[op];
+
+			// Prometheus buckets are cumulative, and the last one is unbounded
+			auto cumulative = std::uint64_t{0};
+			for (auto b = std::size_t{0}; b < histogram_buckets; ++b) {
+				cumulative += histogram.buckets[b];
+				os << prefix << "latency_seconds_bucket{operation=\"" << label << "\",le=\"";
+				if (b + 1 < histogram_buckets) {
+					write_number(os, std::ldexp(1e-9, static_cast<int>(b)));
+				}
+				else {
+					os << "+Inf";
+				}
+				os << "\"} " << cumulative << '\n';
+			}
+
+			os << prefix << "latency_seconds_sum{operation=\"" << label << "\"} ";
+			write_number(os, static_cast<double>(histogram.total_nanoseconds) * 1e-9);
+			os << '\n';
+			os << prefix << "latency_seconds_count{operation=\"" << label << "\"} " << cumulative
+			   << '\n';
+		}
+		return os;
+	}
+} // namespace comp6771::instrumentation
@@ -0,0 +1,202 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include "comp6771/nearest_neighbours.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		// Queries scored together against each block of the database
+		constexpr auto query_block = std::size_t{8};
+
+		// Bytes of the database scored per block, about the size of a per-core L2 cache
+		constexpr auto database_block_bytes = std::size_t{256} * 1024;
+
+		// Splitting the database between threads is not worth it below this many vectors
+		constexpr auto minimum_rows_per_task = std::size_t{1024};
+	} // namespace
+
+	auto detail::k_check(int k) -> void {
+		if (k < 0) {
+			throw euclidean_vector_error("Invalid number of neighbours " + std::to_string(k));
+		}
+	}
+
+	auto detail::metric_distance(metric m, double dot, double x_norm, double y_norm) -> double {
+		switch (m) {
+		case metric::l2: return std::max(x_norm + y_norm - 2 * dot, 0.0);
+		case metric::inner_product: return -dot;
+		case metric::cosine: {
+			auto const norms = std::sqrt(x_norm * y_norm);
+			return norms == 0 ? 1.0 : 1.0 - dot / norms;
+		}
+		}
+		return dot;
+	}
+
+	auto detail::exact_distance(metric m,
+	                            double const* x,
+	                            double x_norm,
+	                            double const* y,
+	                            double y_norm,
+	                            std::size_t dimensions) -> double {
+		if (m == metric::l2) {
+			return kernels::squared_distance(x, y, dimensions);
+		}
+		return metric_distance(m, kernels::dot(x, y, dimensions), x_norm, y_norm);
+	}
+
+	auto name(metric m) -> std::string_view {
+		switch (m) {
+		case metric::l2: return "l2";
+		case metric::inner_product: return "inner_product";
+		case metric::cosine: return "cosine";
+		}
+		return "unknown";
+	}
+
+	// Constructors
+	brute_force_index::brute_force_index(int dimensions, metric m)
+	: vectors_(dimensions)
+	, metric_{m} {}
+
+	brute_force_index::brute_force_index(euclidean_vector_batch vectors, metric m)
+	: vectors_(std::move(vectors))
+	, metric_{m} {
+		squared_norms_.reserve(static_cast<std::size_t>(size()));
+		for (auto i = 0; i < size(); ++i) {
+			squared_norms_.push_back(squared_norm(i));
+		}
+	}
+
+	// Member functions
+	auto brute_force_index::reserve(int size) -> void {
+		vectors_.reserve(size);
+		squared_norms_.reserve(static_cast<std::size_t>(size));
+	}
+
+	auto brute_force_index::size() const -> int {
+		return vectors_.size();
+	}
+
+	auto brute_force_index::dimensions() const -> int {
+		return vectors_.dimensions();
+	}
+
+	auto brute_force_index::distance_metric() const -> metric {
+		return metric_;
+	}
+
+	auto brute_force_index::vectors() const -> euclidean_vector_batch const& {
+		return vectors_;
+	}
+
+	auto brute_force_index::search(const_euclidean_vector_view query, int k) const
+	   -> std::vector<neighbour> {
+		return search(query, k, default_thread_pool());
+	}
+
+	auto brute_force_index::search(const_euclidean_vector_view query, int k, thread_pool& pool) const
+	   -> std::vector<neighbour> {
+		detail::dimensions_check(dimensions(), query.dimensions());
+		return std::move(search(query.data(), 1, k, pool).front());
+	}
+
+	auto brute_force_index::search(euclidean_vector_batch const& queries, int k) const
+	   -> std::vector<std::vector<neighbour>> {
+		return search(queries, k, default_thread_pool());
+	}
+
+	auto brute_force_index::search(euclidean_vector_batch const& queries, int k, thread_pool& pool) const
+	   -> std::vector<std::vector<neighbour>> {
+		detail::dimensions_check(dimensions(), queries.dimensions());
+		return search(queries.data(), queries.size(), k, pool);
+	}
+
+	// Helper functions
+	auto brute_force_index::squared_norm(int index) const -> double {
+		return kernels::sum_of_squares(vectors_[index].data(), static_cast<std::size_t>(dimensions()));
+	}
+
+	auto brute_force_index::search(double const* queries, int count, int k, thread_pool& pool) const
+	   -> std::vector<std::vector<neighbour>> {
+		detail::k_check(k);
+
+		auto const dimensions = static_cast<std::size_t>(this->dimensions());
+		auto const queries_size = static_cast<std::size_t>(count);
+		auto const rows = static_cast<std::size_t>(size());
+		auto const nearest = std::min(static_cast<std::size_t>(k), rows);
+
+		auto query_norms = std::vector<double>(queries_size);
+		for (auto q = std::size_t{0}; q < queries_size; ++q) {
+			query_norms[q] = kernels::sum_of_squares(queries + q * dimensions, dimensions);
+		}
+
+		// Each task scores one block of queries against one chunk of the database. The database is
+		// only split when there are too few query blocks to keep every thread busy.
+		auto const query_blocks = (queries_size + query_block - 1) / query_block;
+		auto const wanted_chunks = (static_cast<std::size_t>(pool.size()) + query_blocks - 1)
+		                           / std::max(query_blocks, std::size_t{1});
+		auto const chunks = std::max(std::min(wanted_chunks, rows / minimum_rows_per_task), std::size_t{1});
+		auto const chunk_rows = (rows + chunks - 1) / chunks;
+		auto const block_rows =
+		   std::max(database_block_bytes / std::max(dimensions * sizeof(double), std::size_t{1}),
+		            std::size_t{16});
+
+		// partial[task][query in block] holds the nearest neighbours found by that task
+		auto partial = std::vector<std::vector<detail::bounded_heap>>(query_blocks * chunks);
+
+		pool.parallel_for(query_blocks * chunks, [&](std::size_t const task) {
+			auto const first_query = (task / chunks) * query_block;
+			auto const block_queries = std::min(query_block, queries_size - first_query);
+			auto const first_row = (task % chunks) * chunk_rows;
+			auto const last_row = std::min(first_row + chunk_rows, rows);
+
+			auto& heaps = partial[task];
+			heaps.assign(block_queries, detail::bounded_heap(nearest));
+
+			for (auto block = first_row; block < last_row; block += block_rows) {
+				auto const block_end = std::min(block + block_rows, last_row);
+				for (auto q = std::size_t{0}; q < block_queries; ++q) {
+					auto const* const query = queries + (first_query + q) * dimensions;
+					auto const query_norm = query_norms[first_query + q];
+					for (auto row = block; row < block_end; ++row) {
+						auto const distance = detail::exact_distance(metric_,
+						                                             query,
+						                                             query_norm,
+						                                             vectors_.data() + row * dimensions,
+						                                             squared_norms_[row],
+						                                             dimensions);
+						heaps[q].push({static_cast<int>(row), distance});
+					}
+				}
+			}
+		});
+
+		auto result = std::vector<std::vector<neighbour>>(queries_size);
+		for (auto q = std::size_t{0}; q < queries_size; ++q) {
+			auto& neighbours = result[q];
+			for (auto chunk = std::size_t{0}; chunk < chunks; ++chunk) {
+				auto const& found = partial[(q / query_block) * chunks + chunk][q % query_block].neighbours();
+				neighbours.insert(neighbours.end(), found.begin(), found.end());
+			}
+
+			std::sort(neighbours.begin(), neighbours.end(), detail::nearer);
+			neighbours.resize(nearest);
+			if (metric_ == metric::l2) {
+				for (auto& n : neighbours) {
+					n.distance = std::sqrt(n.distance);
+				}
+			}
+		}
+		return result;
+	}
+} // namespace comp6771
@@ -0,0 +1,351 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include "comp6771/pairwise.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		using kernels::tile_columns;
+		using kernels::tile_rows;
+
+		enum class matrix { dot, squared_distance, cosine_similarity };
+
+		// Vectors from each side in a block of the matrix, a multiple of both tile sizes
+		constexpr auto block_vectors = std::size_t{128};
+
+		// Magnitudes of each vector packed at a time. A packed block of one side is then 128 KiB,
+		// which stays in a per-core L2 cache while every tile of the block reads it.
+		constexpr auto block_depth = std::size_t{128};
+
+		// One side of the matrix
+		struct operand {
+			std::vector<double const*> vectors;
+			// Only filled in for cosine similarities
+			std::vector<double> squared_norms;
+		};
+
+		auto size_check(std::size_t x, std::size_t y, std::span<double> result) -> void {
+			if (result.size() != x * y) {
+				throw euclidean_vector_error("Size of result(" + std::to_string(result.size())
+				                             + ") does not match LHS(" + std::to_string(x)
+				                             + ") times RHS(" + std::to_string(y) + ")");
+			}
+		}
+
+		// Copies magnitudes [first, first + depth) of each vector into panels of <width> vectors, so
+		// that magnitude k of vector i of a panel is at panel[k * width + i]. The last panel is
+		// padded with 0.
+		auto pack(std::span<double const* const> vectors,
+		          std::size_t first,
+		          std::size_t depth,
+		          std::size_t width,
+		          double* packed) -> void {
+			for (auto panel = std::size_t{0}; panel < vectors.size(); panel += width) {
+				auto const count = std::min(width, vectors.size() - panel);
+				for (auto i = std::size_t{0}; i < width; ++i) {
+					if (i < count) {
+						auto const* const magnitudes = vectors[panel + i] + first;
+						for (auto k = std::size_t{0}; k < depth; ++k) {
+							packed[k * width + i] = magnitudes[k];
+						}
+					}
+					else {
+						for (auto k = std::size_t{0}; k < depth; ++k) {
+							packed[k * width + i] = 0;
+						}
+					}
+				}
+				packed += width * depth;
+			}
+		}
+
+		auto cosine_similarity(double dot, double x_norm, double y_norm) -> double {
+			auto const norms = std::sqrt(x_norm * y_norm);
+			return norms == 0 ? 0.0 : std::clamp(dot / norms, -1.0, 1.0);
+		}
+
+		class pairwise_matrix {
+		public:
+			pairwise_matrix(matrix m,
+			                operand const& x,
+			                operand const& y,
+			                std::size_t dimensions,
+			                bool symmetric,
+			                std::span<double> result)
+			: matrix_{m}
+			, x_{x}
+			, y_{y}
+			, dimensions_{dimensions}
+			, symmetric_{symmetric}
+			, result_{result} {}
+
+			auto compute(thread_pool& pool) const -> void {
+				auto const x_blocks = (x_.vectors.size() + block_vectors - 1) / block_vectors;
+				auto const y_blocks = (y_.vectors.size() + block_vectors - 1) / block_vectors;
+
+				auto blocks = std::vector<std::pair<std::size_t, std::size_t>>();
+				for (auto i = std::size_t{0}; i < x_blocks; ++i) {
+					for (auto j = symmetric_ ? i : 0; j < y_blocks; ++j) {
+						blocks.emplace_back(i * block_vectors, j * block_vectors);
+					}
+				}
+
+				pool.parallel_for(blocks.size(), [&](std::size_t const b) {
+					compute_block(blocks[b].first, blocks[b].second);
+				});
+			}
+
+		private:
+			matrix matrix_;
+			operand const& x_;
+			operand const& y_;
+			std::size_t dimensions_;
+			bool symmetric_;
+			std::span<double> result_;
+
+			[[nodiscard]] auto at(std::size_t i, std::size_t j) const -> double& {
+				return result_[i * y_.vectors.size() + j];
+			}
+
+			// Computes the block of the matrix starting at x[first_x] and y[first_y], then mirrors
+			// it below the diagonal if the matrix is symmetric
+			auto compute_block(std::size_t first_x, std::size_t first_y) const -> void {
+				auto const x = std::span(x_.vectors).subspan(first_x).first(
+				   std::min(block_vectors, x_.vectors.size() - first_x));
+				auto const y = std::span(y_.vectors).subspan(first_y).first(
+				   std::min(block_vectors, y_.vectors.size() - first_y));
+				auto const diagonal = symmetric_ and first_x == first_y;
+
+				auto packed_x = std::vector<double>(block_vectors * block_depth);
+				auto packed_y = std::vector<double>(block_vectors * block_depth);
+				auto tile = std::array<double, tile_rows * tile_columns>{};
+
+				for (auto i = std::size_t{0}; i < x.size(); ++i) {
+					std::fill_n(&at(first_x + i, first_y), y.size(), 0.0);
+				}
+
+				for (auto k = std::size_t{0}; k < dimensions_; k += block_depth) {
+					auto const depth = std::min(block_depth, dimensions_ - k);
+					pack(x, k, depth, tile_rows, packed_x.data());
+					pack(y, k, depth, tile_columns, packed_y.data());
+
+					// Each panel of <y> is read by every tile in its column while it is in L1
+					for (auto j = std::size_t{0}; j < y.size(); j += tile_columns) {
+						auto const* const panel_y = packed_y.data() + j * depth;
+						for (auto i = std::size_t{0}; i < x.size(); i += tile_rows) {
+							// Mirrored from above the diagonal instead
+							if (diagonal and j + tile_columns <= i) {
+								continue;
+							}
+
+							if (matrix_ == matrix::squared_distance) {
+								kernels::squared_distance_tile(packed_x.data() + i * depth,
+								                               panel_y,
+								                               depth,
+								                               tile.data());
+							}
+							else {
+								kernels::dot_tile(packed_x.data() + i * depth, panel_y, depth, tile.data());
+							}
+							for (auto r = std::size_t{0}; r < std::min(tile_rows, x.size() - i); ++r) {
+								for (auto c = std::size_t{0}; c < std::min(tile_columns, y.size() - j); ++c) {
+									at(first_x + i + r, first_y + j + c) += tile[r * tile_columns + c];
+								}
+							}
+						}
+					}
+				}
+
+				for (auto i = first_x; i < first_x + x.size(); ++i) {
+					for (auto j = first_y; j < first_y + y.size(); ++j) {
+						if (diagonal and j < i) {
+							continue;
+						}
+
+						// Dot products and squared distances are already finished
+						auto& entry = at(i, j);
+						if (matrix_ == matrix::cosine_similarity) {
+							// Exactly 1 for a vector with itself, where the rounding would show
+							entry = diagonal and i == j
+							           ? (x_.squared_norms[i] == 0 ? 0.0 : 1.0)
+							           : cosine_similarity(entry, x_.squared_norms[i], y_.squared_norms[j]);
+						}
+
+						if (symmetric_ and i != j) {
+							at(j, i) = entry;
+						}
+					}
+				}
+			}
+		};
+
+		auto vectors_of(std::span<euclidean_vector const> vectors, matrix m) -> operand {
+			auto result = operand();
+			result.vectors.reserve(vectors.size());
+			for (auto const& v : vectors) {
+				result.vectors.push_back(detail::magnitudes_of(v));
+			}
+			// Read from each vector's cache, or frozen beforehand
+			if (m == matrix::cosine_similarity) {
+				result.squared_norms.reserve(vectors.size());
+				for (auto const& v : vectors) {
+					result.squared_norms.push_back(squared_euclidean_norm(v));
+				}
+			}
+			return result;
+		}
+
+		auto vectors_of(euclidean_vector_batch const& batch, matrix m) -> operand {
+			auto const dimensions = static_cast<std::size_t>(batch.dimensions());
+			auto result = operand();
+			result.vectors.reserve(static_cast<std::size_t>(batch.size()));
+			for (auto i = 0; i < batch.size(); ++i) {
+				result.vectors.push_back(batch.data() + static_cast<std::size_t>(i) * dimensions);
+			}
+			if (m == matrix::cosine_similarity) {
+				result.squared_norms.reserve(result.vectors.size());
+				for (auto const* const v : result.vectors) {
+					result.squared_norms.push_back(kernels::sum_of_squares(v, dimensions));
+				}
+			}
+			return result;
+		}
+
+		auto pairwise(matrix m,
+		              std::span<euclidean_vector const> x,
+		              std::span<euclidean_vector const> y,
+		              std::span<double> result,
+		              thread_pool& pool) -> void {
+			size_check(x.size(), y.size(), result);
+			if (x.empty() or y.empty()) {
+				return;
+			}
+
+			auto const dimensions = x.front().dimensions();
+			for (auto const& v : x) {
+				detail::dimensions_check(dimensions, v.dimensions());
+			}
+			for (auto const& v : y) {
+				detail::dimensions_check(dimensions, v.dimensions());
+			}
+
+			auto const symmetric = x.data() == y.data() and x.size() == y.size();
+			auto const x_vectors = vectors_of(x, m);
+			auto const y_vectors = symmetric ? operand() : vectors_of(y, m);
+			pairwise_matrix(m,
+			                x_vectors,
+			                symmetric ? x_vectors : y_vectors,
+			                static_cast<std::size_t>(dimensions),
+			                symmetric,
+			                result)
+			   .compute(pool);
+		}
+
+		auto pairwise(matrix m,
+		              euclidean_vector_batch const& x,
+		              euclidean_vector_batch const& y,
+		              std::span<double> result,
+		              thread_pool& pool) -> void {
+			size_check(static_cast<std::size_t>(x.size()), static_cast<std::size_t>(y.size()), result);
+			detail::dimensions_check(x.dimensions(), y.dimensions());
+
+			auto const symmetric = x.data() == y.data() and x.size() == y.size();
+			auto const x_vectors = vectors_of(x, m);
+			auto const y_vectors = symmetric ? operand() : vectors_of(y, m);
+			pairwise_matrix(m,
+			                x_vectors,
+			                symmetric ? x_vectors : y_vectors,
+			                static_cast<std::size_t>(x.dimensions()),
+			                symmetric,
+			                result)
+			   .compute(pool);
+		}
+	} // namespace
+
+	auto pairwise_dot(std::span<euclidean_vector const> x,
+	                  std::span<euclidean_vector const> y,
+	                  std::span<double> result) -> void {
+		pairwise(matrix::dot, x, y, result, default_thread_pool());
+	}
+
+	auto pairwise_dot(std::span<euclidean_vector const> x,
+	                  std::span<euclidean_vector const> y,
+	                  std::span<double> result,
+	                  thread_pool& pool) -> void {
+		pairwise(matrix::dot, x, y, result, pool);
+	}
+
+	auto pairwise_dot(euclidean_vector_batch const& x,
+	                  euclidean_vector_batch const& y,
+	                  std::span<double> result) -> void {
+		pairwise(matrix::dot, x, y, result, default_thread_pool());
+	}
+
+	auto pairwise_dot(euclidean_vector_batch const& x,
+	                  euclidean_vector_batch const& y,
+	                  std::span<double> result,
+	                  thread_pool& pool) -> void {
+		pairwise(matrix::dot, x, y, result, pool);
+	}
+
+	auto pairwise_squared_distance(std::span<euclidean_vector const> x,
+	                               std::span<euclidean_vector const> y,
+	                               std::span<double> result) -> void {
+		pairwise(matrix::squared_distance, x, y, result, default_thread_pool());
+	}
+
+	auto pairwise_squared_distance(std::span<euclidean_vector const> x,
+	                               std::span<euclidean_vector const> y,
+	                               std::span<double> result,
+	                               thread_pool& pool) -> void {
+		pairwise(matrix::squared_distance, x, y, result, pool);
+	}
+
+	auto pairwise_squared_distance(euclidean_vector_batch const& x,
+	                               euclidean_vector_batch const& y,
+	                               std::span<double> result) -> void {
+		pairwise(matrix::squared_distance, x, y, result, default_thread_pool());
+	}
+
+	auto pairwise_squared_distance(euclidean_vector_batch const& x,
+	                               euclidean_vector_batch const& y,
+	                               std::span<double> result,
+	                               thread_pool& pool) -> void {
+		pairwise(matrix::squared_distance, x, y, result, pool);
+	}
+
+	auto pairwise_cosine_similarity(std::span<euclidean_vector const> x,
+	                                std::span<euclidean_vector const> y,
+	                                std::span<double> result) -> void {
+		pairwise(matrix::cosine_similarity, x, y, result, default_thread_pool());
+	}
+
+	auto pairwise_cosine_similarity(std::span<euclidean_vector const> x,
+	                                std::span<euclidean_vector const> y,
+	                                std::span<double> result,
+	                                thread_pool& pool) -> void {
+		pairwise(matrix::cosine_similarity, x, y, result, pool);
+	}
+
+	auto pairwise_cosine_similarity(euclidean_vector_batch const& x,
+	                                euclidean_vector_batch const& y,
+	                                std::span<double> result) -> void {
+		pairwise(matrix::cosine_similarity, x, y, result, default_thread_pool());
+	}
+
+	auto pairwise_cosine_similarity(euclidean_vector_batch const& x,
+	                                euclidean_vector_batch const& y,
+	                                std::span<double> result,
+	                                thread_pool& pool) -> void {
+		pairwise(matrix::cosine_similarity, x, y, result, pool);
+	}
+} // namespace comp6771
@@ -0,0 +1,226 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include "comp6771/shared_euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace comp6771 {
+	// Constructors
+	shared_euclidean_vector::shared_euclidean_vector()
+	: shared_euclidean_vector(1) {}
+
+	shared_euclidean_vector::shared_euclidean_vector(int dimensions, allocator_type const& allocator)
+	: resource_{allocator.resource()}
+	, block_{nullptr}
+	, dimensions_{dimensions} {
+		if (dimensions_ > 0) {
+			auto* const memory = resource_->allocate(block_size(dimensions_), alignof(shared_block));
+			block_ = ::new (memory) shared_block{1};
+			std::fill_n(block_->magnitudes(), dimensions_, 0.0);
+		}
+	}
+
+	shared_euclidean_vector::shared_euclidean_vector(int dimensions,
+	                                                 double magnitude,
+	                                                 allocator_type const& allocator)
+	: shared_euclidean_vector(dimensions, allocator) {
+		std::fill_n(mutable_data(), dimensions_, magnitude);
+	}
+
+	shared_euclidean_vector::shared_euclidean_vector(std::initializer_list<double> magnitudes,
+	                                                 allocator_type const& allocator)
+	: shared_euclidean_vector(static_cast<int>(magnitudes.size()), allocator) {
+		std::copy(magnitudes.begin(), magnitudes.end(), mutable_data());
+	}
+
+	shared_euclidean_vector::shared_euclidean_vector(shared_euclidean_vector const& other) noexcept
+	: resource_{other.resource_}
+	, block_{other.block_}
+	, dimensions_{other.dimensions_} {
+		if (block_ != nullptr) {
+			block_->references.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	shared_euclidean_vector::shared_euclidean_vector(shared_euclidean_vector&& other) noexcept
+	: resource_{other.resource_}
+	, block_{std::exchange(other.block_, nullptr)}
+	, dimensions_{std::exchange(other.dimensions_, 0)} {}
+
+	shared_euclidean_vector::~shared_euclidean_vector() {
+		release();
+	}
+
+	// Operator Overload
+	auto shared_euclidean_vector::operator=(shared_euclidean_vector const& other) noexcept
+	   -> shared_euclidean_vector& {
+		auto copy = other;
+		return *this = std::move(copy);
+	}
+
+	auto shared_euclidean_vector::operator=(shared_euclidean_vector&& other) noexcept
+	   -> shared_euclidean_vector& {
+		if (this != &other) {
+			release();
+			resource_ = other.resource_;
+			block_ = std::exchange(other.block_, nullptr);
+			dimensions_ = std::exchange(other.dimensions_, 0);
+		}
+		return *this;
+	}
+
+	auto shared_euclidean_vector::operator+() const -> shared_euclidean_vector {
+		return *this;
+	}
+
+	auto shared_euclidean_vector::operator+=(shared_euclidean_vector const& other)
+	   -> shared_euclidean_vector& {
+		detail::dimensions_check(dimensions_, other.dimensions_);
+
+		// If <other> shared these magnitudes, it keeps the originals
+		auto* const magnitudes = mutable_data();
+		auto const* const source = other.data();
+		detail::for_each_chunk(static_cast<std::size_t>(dimensions_),
+		                       [&](std::size_t first, std::size_t last) {
+			                       for (auto i = first; i < last; ++i) {
+				                       magnitudes[i] += source[i];
+			                       }
+		                       });
+		return *this;
+	}
+
+	auto shared_euclidean_vector::operator-=(shared_euclidean_vector const& other)
+	   -> shared_euclidean_vector& {
+		detail::dimensions_check(dimensions_, other.dimensions_);
+
+		auto* const magnitudes = mutable_data();
+		auto const* const source = other.data();
+		detail::for_each_chunk(static_cast<std::size_t>(dimensions_),
+		                       [&](std::size_t first, std::size_t last) {
+			                       for (auto i = first; i < last; ++i) {
+				                       magnitudes[i] -= source[i];
+			                       }
+		                       });
+		return *this;
+	}
+
+	auto shared_euclidean_vector::operator*=(double factor) -> shared_euclidean_vector& {
+		auto* const magnitudes = mutable_data();
+		detail::for_each_chunk(static_cast<std::size_t>(dimensions_),
+		                       [&](std::size_t first, std::size_t last) {
+			                       for (auto i = first; i < last; ++i) {
+				                       magnitudes[i] *= factor;
+			                       }
+		                       });
+		return *this;
+	}
+
+	auto shared_euclidean_vector::operator/=(double factor) -> shared_euclidean_vector& {
+		detail::division_check(factor);
+
+		auto* const magnitudes = mutable_data();
+		detail::for_each_chunk(static_cast<std::size_t>(dimensions_),
+		                       [&](std::size_t first, std::size_t last) {
+			                       for (auto i = first; i < last; ++i) {
+				                       magnitudes[i] /= factor;
+			                       }
+		                       });
+		return *this;
+	}
+
+	// Member functions
+	auto shared_euclidean_vector::at(int index) const -> double {
+		detail::view_index_check(index, dimensions_);
+		return (*this)[index];
+	}
+
+	auto shared_euclidean_vector::at(int index) -> reference {
+		detail::view_index_check(index, dimensions_);
+		return (*this)[index];
+	}
+
+	auto shared_euclidean_vector::dimensions() const -> int {
+		return dimensions_;
+	}
+
+	auto shared_euclidean_vector::get_allocator() const -> allocator_type {
+		return allocator_type(resource_);
+	}
+
+	auto shared_euclidean_vector::is_shared() const -> bool {
+		return block_ != nullptr and block_->references.load(std::memory_order_acquire) > 1;
+	}
+
+	// Friends
+	auto operator==(shared_euclidean_vector const& first, shared_euclidean_vector const& second)
+	   -> bool {
+		if (first.dimensions_ != second.dimensions_) {
+			return false;
+		}
+		if (first.block_ == second.block_) {
+			return true;
+		}
+		return std::equal(first.data(),
+		                  first.data() + first.dimensions_,
+		                  second.data(),
+		                  [](double const f, double const s) {
+			                  return std::fabs(f - s) < std::numeric_limits<double>::epsilon();
+		                  });
+	}
+
+	auto operator!=(shared_euclidean_vector const& first, shared_euclidean_vector const& second)
+	   -> bool {
+		return not(first == second);
+	}
+
+	auto operator<<(std::ostream& os, shared_euclidean_vector const& v) -> std::ostream& {
+		return detail::write_magnitudes(os, v.data(), v.dimensions());
+	}
+
+	// Helper functions
+	auto shared_euclidean_vector::block_size(int dimensions) -> std::size_t {
+		return sizeof(shared_block) + static_cast<std::size_t>(dimensions) * sizeof(double);
+	}
+
+	auto shared_euclidean_vector::release() noexcept -> void {
+		if (block_ == nullptr) {
+			return;
+		}
+		// The last owner must see every other owner's writes before it frees the block
+		if (block_->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			block_->~shared_block();
+			resource_->deallocate(block_, block_size(dimensions_), alignof(shared_block));
+		}
+		block_ = nullptr;
+	}
+
+	auto shared_euclidean_vector::mutable_data() -> double* {
+		if (block_ == nullptr) {
+			return nullptr;
+		}
+		// Acquire, so that everything an owner that has since released the block did with it
+		// happens before this vector changes it in place
+		if (block_->references.load(std::memory_order_acquire) > 1) {
+			auto copy = shared_euclidean_vector(dimensions_, get_allocator());
+			std::copy_n(data(), dimensions_, copy.block_->magnitudes());
+			*this = std::move(copy);
+		}
+		return block_->magnitudes();
+	}
+
+	// Utility functions
+	auto unit(shared_euclidean_vector const& v) -> shared_euclidean_vector {
+		auto const norm = euclidean_norm(v);
+		detail::unit_check(v.dimensions(), norm);
+		return shared_euclidean_vector(v / norm, v.get_allocator());
+	}
+} // namespace comp6771
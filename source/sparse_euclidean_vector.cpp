@@ -0,0 +1,393 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include "comp6771/sparse_euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		// Galloping beats a merge once one vector has this many times the non-zeros of the other
+		constexpr auto gallop_ratio = std::size_t{16};
+
+		// Steps through both index arrays at once, without branching on which is behind
+		auto merge_dot(int const* x_indices,
+		               double const* x,
+		               std::size_t x_size,
+		               int const* y_indices,
+		               double const* y,
+		               std::size_t y_size) -> double {
+			auto sum = 0.0;
+			auto i = std::size_t{0};
+			auto j = std::size_t{0};
+			while (i < x_size and j < y_size) {
+				auto const x_index = x_indices[i];
+				auto const y_index = y_indices[j];
+				if (x_index == y_index) {
+					sum += x[i] * y[j];
+				}
+				i += x_index <= y_index ? 1U : 0U;
+				j += y_index <= x_index ? 1U : 0U;
+			}
+			return sum;
+		}
+
+		// Finds each index of the shorter <x> in <y> by searching forward from where the last one
+		// was found in steps that double, then binary searching the last step
+		auto gallop_dot(int const* x_indices,
+		                double const* x,
+		                std::size_t x_size,
+		                int const* y_indices,
+		                double const* y,
+		                std::size_t y_size) -> double {
+			auto sum = 0.0;
+			auto const* first = y_indices;
+			auto const* const last = y_indices + y_size;
+			for (auto i = std::size_t{0}; i < x_size and first != last; ++i) {
+				auto const target = x_indices[i];
+				auto const remaining = last - first;
+				auto step = std::ptrdiff_t{1};
+				while (step < remaining and first[step] < target) {
+					step *= 2;
+				}
+				first = std::lower_bound(first + step / 2, first + std::min(step + 1, remaining), target);
+				if (first != last and *first == target) {
+					sum += x[i] * y[first - y_indices];
+				}
+			}
+			return sum;
+		}
+
+		auto index_check(int index, int dimensions) -> void {
+			if (index < 0 or index >= dimensions) {
+				throw euclidean_vector_error("Index " + std::to_string(index)
+				                             + " is not valid for this sparse_euclidean_vector object");
+			}
+		}
+
+		auto add_dense(const_euclidean_vector_view x, sparse_euclidean_vector const& y, double sign)
+		   -> euclidean_vector {
+			detail::dimensions_check(x.dimensions(), y.dimensions());
+			auto result = euclidean_vector(x);
+			auto const indices = y.indices();
+			auto const magnitudes = y.magnitudes();
+			for (auto i = std::size_t{0}; i < indices.size(); ++i) {
+				result[indices[i]] += sign * magnitudes[i];
+			}
+			return result;
+		}
+	} // namespace
+
+	// Constructors
+	sparse_euclidean_vector::sparse_euclidean_vector()
+	: sparse_euclidean_vector(1) {}
+
+	sparse_euclidean_vector::sparse_euclidean_vector(int dimensions)
+	: dimensions_{dimensions} {}
+
+	sparse_euclidean_vector::sparse_euclidean_vector(int dimensions,
+	                                                 std::vector<int> indices,
+	                                                 std::vector<double> magnitudes)
+	: dimensions_{dimensions}
+	, indices_(std::move(indices))
+	, magnitudes_(std::move(magnitudes)) {
+		if (indices_.size() != magnitudes_.size()) {
+			throw euclidean_vector_error("Numbers of indices(" + std::to_string(indices_.size())
+			                             + ") and magnitudes(" + std::to_string(magnitudes_.size())
+			                             + ") do not match");
+		}
+		normalise();
+	}
+
+	sparse_euclidean_vector::sparse_euclidean_vector(int dimensions,
+	                                                 std::initializer_list<std::pair<int, double>> magnitudes)
+	: dimensions_{dimensions} {
+		indices_.reserve(magnitudes.size());
+		magnitudes_.reserve(magnitudes.size());
+		for (auto const& [index, magnitude] : magnitudes) {
+			indices_.push_back(index);
+			magnitudes_.push_back(magnitude);
+		}
+		normalise();
+	}
+
+	sparse_euclidean_vector::sparse_euclidean_vector(const_euclidean_vector_view v)
+	: dimensions_{v.dimensions()} {
+		for (auto i = 0; i < v.dimensions(); ++i) {
+			if (v[i] != 0) {
+				indices_.push_back(i);
+				magnitudes_.push_back(v[i]);
+			}
+		}
+	}
+
+	// Operator Overload
+	auto sparse_euclidean_vector::operator[](int index) const -> double {
+		assert(index >= 0 && index < dimensions());
+		auto const found = std::lower_bound(indices_.begin(), indices_.end(), index);
+		if (found == indices_.end() or *found != index) {
+			return 0;
+		}
+		return magnitudes_[static_cast<std::size_t>(found - indices_.begin())];
+	}
+
+	auto sparse_euclidean_vector::operator+() const -> sparse_euclidean_vector {
+		return *this;
+	}
+
+	auto sparse_euclidean_vector::operator-() const -> sparse_euclidean_vector {
+		auto result = *this;
+		for (auto& magnitude : result.magnitudes_) {
+			magnitude = -magnitude;
+		}
+		return result;
+	}
+
+	auto sparse_euclidean_vector::operator+=(sparse_euclidean_vector const& other)
+	   -> sparse_euclidean_vector& {
+		merge(other, 1);
+		return *this;
+	}
+
+	auto sparse_euclidean_vector::operator-=(sparse_euclidean_vector const& other)
+	   -> sparse_euclidean_vector& {
+		merge(other, -1);
+		return *this;
+	}
+
+	auto sparse_euclidean_vector::operator*=(double factor) -> sparse_euclidean_vector& {
+		for (auto& magnitude : magnitudes_) {
+			magnitude *= factor;
+		}
+		drop_zeros();
+		return *this;
+	}
+
+	auto sparse_euclidean_vector::operator/=(double factor) -> sparse_euclidean_vector& {
+		detail::division_check(factor);
+		for (auto& magnitude : magnitudes_) {
+			magnitude /= factor;
+		}
+		drop_zeros();
+		return *this;
+	}
+
+	sparse_euclidean_vector::operator euclidean_vector() const {
+		auto result = euclidean_vector(dimensions_);
+		for (auto i = std::size_t{0}; i < indices_.size(); ++i) {
+			result[indices_[i]] = magnitudes_[i];
+		}
+		return result;
+	}
+
+	// Member functions
+	auto sparse_euclidean_vector::at(int index) const -> double {
+		index_check(index, dimensions_);
+		return (*this)[index];
+	}
+
+	auto sparse_euclidean_vector::dimensions() const -> int {
+		return dimensions_;
+	}
+
+	auto sparse_euclidean_vector::non_zeros() const -> int {
+		return static_cast<int>(indices_.size());
+	}
+
+	auto sparse_euclidean_vector::indices() const -> std::span<int const> {
+		return indices_;
+	}
+
+	auto sparse_euclidean_vector::magnitudes() const -> std::span<double const> {
+		return magnitudes_;
+	}
+
+	// Friends
+	// Same tolerance as euclidean_vector, where a magnitude stored in only one vector is compared
+	// with 0
+	auto operator==(sparse_euclidean_vector const& first, sparse_euclidean_vector const& second)
+	   -> bool {
+		if (first.dimensions_ != second.dimensions_) {
+			return false;
+		}
+
+		auto const equal = [](double const f, double const s) {
+			return std::fabs(f - s) < std::numeric_limits<double>::epsilon();
+		};
+		auto i = std::size_t{0};
+		auto j = std::size_t{0};
+		while (i < first.indices_.size() or j < second.indices_.size()) {
+			auto const f_index = i < first.indices_.size() ? first.indices_[i] : first.dimensions_;
+			auto const s_index = j < second.indices_.size() ? second.indices_[j] : second.dimensions_;
+			auto const f = f_index <= s_index ? first.magnitudes_[i] : 0.0;
+			auto const s = s_index <= f_index ? second.magnitudes_[j] : 0.0;
+			if (not equal(f, s)) {
+				return false;
+			}
+			i += f_index <= s_index ? 1U : 0U;
+			j += s_index <= f_index ? 1U : 0U;
+		}
+		return true;
+	}
+
+	auto operator!=(sparse_euclidean_vector const& first, sparse_euclidean_vector const& second)
+	   -> bool {
+		return not(first == second);
+	}
+
+	// Helper functions
+	auto sparse_euclidean_vector::normalise() -> void {
+		auto order = std::vector<std::size_t>(indices_.size());
+		std::iota(order.begin(), order.end(), std::size_t{0});
+		std::sort(order.begin(), order.end(), [this](std::size_t const x, std::size_t const y) {
+			return indices_[x] < indices_[y];
+		});
+
+		auto indices = std::vector<int>();
+		auto magnitudes = std::vector<double>();
+		indices.reserve(order.size());
+		magnitudes.reserve(order.size());
+		for (auto const i : order) {
+			index_check(indices_[i], dimensions_);
+			if (not indices.empty() and indices.back() == indices_[i]) {
+				throw euclidean_vector_error("Index " + std::to_string(indices_[i])
+				                             + " is given more than once");
+			}
+			indices.push_back(indices_[i]);
+			magnitudes.push_back(magnitudes_[i]);
+		}
+		indices_ = std::move(indices);
+		magnitudes_ = std::move(magnitudes);
+		drop_zeros();
+	}
+
+	auto sparse_euclidean_vector::drop_zeros() -> void {
+		auto kept = std::size_t{0};
+		for (auto i = std::size_t{0}; i < indices_.size(); ++i) {
+			if (magnitudes_[i] != 0) {
+				indices_[kept] = indices_[i];
+				magnitudes_[kept] = magnitudes_[i];
+				++kept;
+			}
+		}
+		indices_.resize(kept);
+		magnitudes_.resize(kept);
+	}
+
+	auto sparse_euclidean_vector::merge(sparse_euclidean_vector const& other, double sign) -> void {
+		detail::dimensions_check(dimensions_, other.dimensions_);
+
+		auto indices = std::vector<int>();
+		auto magnitudes = std::vector<double>();
+		indices.reserve(indices_.size() + other.indices_.size());
+		magnitudes.reserve(indices_.size() + other.indices_.size());
+
+		auto i = std::size_t{0};
+		auto j = std::size_t{0};
+		while (i < indices_.size() or j < other.indices_.size()) {
+			auto const x_index = i < indices_.size() ? indices_[i] : dimensions_;
+			auto const y_index = j < other.indices_.size() ? other.indices_[j] : dimensions_;
+			auto const x = x_index <= y_index ? magnitudes_[i] : 0.0;
+			auto const y = y_index <= x_index ? other.magnitudes_[j] : 0.0;
+			if (auto const sum = x + sign * y; sum != 0) {
+				indices.push_back(std::min(x_index, y_index));
+				magnitudes.push_back(sum);
+			}
+			i += x_index <= y_index ? 1U : 0U;
+			j += y_index <= x_index ? 1U : 0U;
+		}
+
+		indices_ = std::move(indices);
+		magnitudes_ = std::move(magnitudes);
+	}
+
+	// Utility functions
+	auto operator+(sparse_euclidean_vector const& x, sparse_euclidean_vector const& y)
+	   -> sparse_euclidean_vector {
+		auto result = x;
+		return result += y;
+	}
+
+	auto operator-(sparse_euclidean_vector const& x, sparse_euclidean_vector const& y)
+	   -> sparse_euclidean_vector {
+		auto result = x;
+		return result -= y;
+	}
+
+	auto operator*(sparse_euclidean_vector v, double factor) -> sparse_euclidean_vector {
+		return v *= factor;
+	}
+
+	auto operator*(double factor, sparse_euclidean_vector v) -> sparse_euclidean_vector {
+		return v *= factor;
+	}
+
+	auto operator/(sparse_euclidean_vector v, double factor) -> sparse_euclidean_vector {
+		return v /= factor;
+	}
+
+	auto operator+(const_euclidean_vector_view x, sparse_euclidean_vector const& y) -> euclidean_vector {
+		return add_dense(x, y, 1);
+	}
+
+	auto operator+(sparse_euclidean_vector const& x, const_euclidean_vector_view y) -> euclidean_vector {
+		return add_dense(y, x, 1);
+	}
+
+	auto operator-(const_euclidean_vector_view x, sparse_euclidean_vector const& y) -> euclidean_vector {
+		return add_dense(x, y, -1);
+	}
+
+	auto operator-(sparse_euclidean_vector const& x, const_euclidean_vector_view y) -> euclidean_vector {
+		return -add_dense(y, x, -1);
+	}
+
+	auto euclidean_norm(sparse_euclidean_vector const& v) -> double {
+		auto const magnitudes = v.magnitudes();
+		return std::sqrt(kernels::sum_of_squares(magnitudes.data(), magnitudes.size()));
+	}
+
+	auto unit(sparse_euclidean_vector const& v) -> sparse_euclidean_vector {
+		auto const norm = euclidean_norm(v);
+		detail::unit_check(v.dimensions(), norm);
+		return v / norm;
+	}
+
+	auto dot(sparse_euclidean_vector const& x, sparse_euclidean_vector const& y) -> double {
+		detail::dimensions_check(x.dimensions(), y.dimensions());
+
+		auto const* shorter = &x;
+		auto const* longer = &y;
+		if (shorter->non_zeros() > longer->non_zeros()) {
+			std::swap(shorter, longer);
+		}
+
+		auto const dot_product = shorter->magnitudes().size() * gallop_ratio < longer->magnitudes().size()
+		                            ? gallop_dot
+		                            : merge_dot;
+		return dot_product(shorter->indices().data(),
+		                   shorter->magnitudes().data(),
+		                   shorter->magnitudes().size(),
+		                   longer->indices().data(),
+		                   longer->magnitudes().data(),
+		                   longer->magnitudes().size());
+	}
+
+	auto dot(sparse_euclidean_vector const& x, const_euclidean_vector_view y) -> double {
+		detail::dimensions_check(x.dimensions(), y.dimensions());
+		auto const magnitudes = x.magnitudes();
+		return kernels::dot_gather(magnitudes.data(), x.indices().data(), magnitudes.size(), y.data());
+	}
+
+	auto dot(const_euclidean_vector_view x, sparse_euclidean_vector const& y) -> double {
+		return dot(y, x);
+	}
+} // namespace comp6771
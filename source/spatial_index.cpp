@@ -0,0 +1,318 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include "comp6771/spatial_index.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		constexpr auto leaf_size = 16;
+
+		// Subtrees with fewer vectors are built on the calling thread
+		constexpr auto parallel_build_threshold = 16 * 1024;
+
+		// Squared distance between <x> and <y>, giving up as soon as it is more than <bound>
+		auto squared_distance(double const* x, double const* y, std::size_t dimensions, double bound)
+		   -> double {
+			auto sum = 0.0;
+			for (auto i = std::size_t{0}; i < dimensions; ++i) {
+				auto const difference = x[i] - y[i];
+				sum += difference * difference;
+				if (sum > bound) {
+					break;
+				}
+			}
+			return sum;
+		}
+	} // namespace
+
+	// Constructors
+	spatial_index::spatial_index(euclidean_vector_batch const& vectors, spatial_partitioning partitioning)
+	: spatial_index(vectors, partitioning, default_thread_pool()) {}
+
+	spatial_index::spatial_index(euclidean_vector_batch const& vectors,
+	                             spatial_partitioning partitioning,
+	                             thread_pool& pool)
+	: partitioning_{partitioning}
+	, leaf_size_{vectors.dimensions() == 0 ? std::numeric_limits<int>::max() : leaf_size}
+	, vectors_(vectors.dimensions())
+	, centres_(vectors.dimensions()) {
+		auto order = std::vector<int>(static_cast<std::size_t>(vectors.size()));
+		std::iota(order.begin(), order.end(), 0);
+
+		if (not order.empty()) {
+			nodes_.resize(static_cast<std::size_t>(subtree_nodes(vectors.size())));
+			if (partitioning_ == spatial_partitioning::ball_tree) {
+				centres_.resize(static_cast<int>(nodes_.size()));
+			}
+
+			nodes_.front().begin = 0;
+			nodes_.front().end = vectors.size();
+			build(vectors, order, 0, pool);
+		}
+
+		vectors_.reserve(vectors.size());
+		for (auto const index : order) {
+			vectors_.push_back(vectors[index]);
+		}
+		indices_ = std::move(order);
+	}
+
+	// Member functions
+	auto spatial_index::size() const -> int {
+		return vectors_.size();
+	}
+
+	auto spatial_index::dimensions() const -> int {
+		return vectors_.dimensions();
+	}
+
+	auto spatial_index::partitioning() const -> spatial_partitioning {
+		return partitioning_;
+	}
+
+	// Helper functions
+	auto spatial_index::subtree_nodes(int count) const -> int {
+		if (count <= leaf_size_) {
+			return 1;
+		}
+		return 1 + subtree_nodes(count / 2) + subtree_nodes(count - count / 2);
+	}
+
+	auto spatial_index::build(euclidean_vector_batch const& vectors,
+	                          std::vector<int>& order,
+	                          int node,
+	                          thread_pool& pool) -> void {
+		auto& current = nodes_[static_cast<std::size_t>(node)];
+		auto const first = order.begin() + current.begin;
+		auto const last = order.begin() + current.end;
+		auto const dimensions = static_cast<std::size_t>(vectors.dimensions());
+
+		// Split the dimension with the widest spread
+		auto lowest = std::vector<double>(dimensions, std::numeric_limits<double>::infinity());
+		auto highest = std::vector<double>(dimensions, -std::numeric_limits<double>::infinity());
+		for (auto i = first; i != last; ++i) {
+			auto const* const vector = vectors[*i].data();
+			for (auto d = std::size_t{0}; d < dimensions; ++d) {
+				lowest[d] = std::min(lowest[d], vector[d]);
+				highest[d] = std::max(highest[d], vector[d]);
+			}
+		}
+
+		current.split_dimension = 0;
+		for (auto d = std::size_t{1}; d < dimensions; ++d) {
+			auto const widest = static_cast<std::size_t>(current.split_dimension);
+			if (highest[d] - lowest[d] > highest[widest] - lowest[widest]) {
+				current.split_dimension = static_cast<int>(d);
+			}
+		}
+
+		if (partitioning_ == spatial_partitioning::ball_tree) {
+			auto* const centre = centres_[node].data();
+			for (auto i = first; i != last; ++i) {
+				auto const* const vector = vectors[*i].data();
+				for (auto d = std::size_t{0}; d < dimensions; ++d) {
+					centre[d] += vector[d];
+				}
+			}
+			auto const count = static_cast<double>(last - first);
+			std::transform(centre, centre + dimensions, centre, [count](double const sum) {
+				return sum / count;
+			});
+
+			current.radius = 0;
+			for (auto i = first; i != last; ++i) {
+				auto const distance = squared_distance(centre,
+				                                       vectors[*i].data(),
+				                                       dimensions,
+				                                       std::numeric_limits<double>::infinity());
+				current.radius = std::max(current.radius, distance);
+			}
+			current.radius = std::sqrt(current.radius);
+		}
+
+		auto const count = current.end - current.begin;
+		if (count <= leaf_size_) {
+			current.right = -1;
+			return;
+		}
+
+		// Everything left of the median is no greater than it in the split dimension, and
+		// everything right of it is no less
+		auto const split = static_cast<std::size_t>(current.split_dimension);
+		auto const middle = first + count / 2;
+		std::nth_element(first, middle, last, [&vectors, split](int const x, int const y) {
+			return vectors[x][static_cast<int>(split)] < vectors[y][static_cast<int>(split)];
+		});
+		current.split_value = vectors[*middle][current.split_dimension];
+
+		auto const left = node + 1;
+		current.right = left + subtree_nodes(count / 2);
+		nodes_[static_cast<std::size_t>(left)].begin = current.begin;
+		nodes_[static_cast<std::size_t>(left)].end = current.begin + count / 2;
+		nodes_[static_cast<std::size_t>(current.right)].begin = current.begin + count / 2;
+		nodes_[static_cast<std::size_t>(current.right)].end = current.end;
+
+		auto const children = std::array<int, 2>{left, current.right};
+		if (count >= parallel_build_threshold) {
+			pool.parallel_for(2, [&](std::size_t const child) {
+				build(vectors, order, children[child], pool);
+			});
+		}
+		else {
+			build(vectors, order, left, pool);
+			build(vectors, order, current.right, pool);
+		}
+	}
+
+	auto spatial_index::search(double const* query, int k) const -> std::vector<neighbour> {
+		detail::k_check(k);
+
+		auto const dimensions = static_cast<std::size_t>(this->dimensions());
+		auto const wanted = static_cast<std::size_t>(k);
+
+		// The k nearest so far, furthest on top
+		auto nearest = std::priority_queue<std::pair<double, int>>();
+		auto const bound = [&nearest, wanted] {
+			return nearest.size() < wanted ? std::numeric_limits<double>::infinity() : nearest.top().first;
+		};
+
+		if (k > 0) {
+			for_each_leaf(query, bound, [&](int const begin, int const end) {
+				for (auto i = begin; i < end; ++i) {
+					auto const limit = bound();
+					auto const distance = squared_distance(query, vectors_[i].data(), dimensions, limit);
+					auto const candidate = std::pair(distance, indices_[static_cast<std::size_t>(i)]);
+					if (nearest.size() < wanted) {
+						nearest.push(candidate);
+					}
+					else if (candidate < nearest.top()) {
+						nearest.pop();
+						nearest.push(candidate);
+					}
+				}
+			});
+		}
+
+		auto result = std::vector<neighbour>(nearest.size());
+		for (auto i = result.size(); i > 0; --i) {
+			result[i - 1] = {nearest.top().second, std::sqrt(nearest.top().first)};
+			nearest.pop();
+		}
+		return result;
+	}
+
+	auto spatial_index::radius_search(double const* query, double radius) const
+	   -> std::vector<neighbour> {
+		if (not(radius >= 0)) {
+			throw euclidean_vector_error("Invalid radius " + std::to_string(radius));
+		}
+
+		auto const dimensions = static_cast<std::size_t>(this->dimensions());
+		auto const limit = radius * radius;
+
+		auto within = std::vector<std::pair<double, int>>();
+		for_each_leaf(
+		   query,
+		   [limit] { return limit; },
+		   [&](int const begin, int const end) {
+			   for (auto i = begin; i < end; ++i) {
+				   auto const distance = squared_distance(query, vectors_[i].data(), dimensions, limit);
+				   if (distance <= limit) {
+					   within.emplace_back(distance, indices_[static_cast<std::size_t>(i)]);
+				   }
+			   }
+		   });
+
+		std::sort(within.begin(), within.end());
+		auto result = std::vector<neighbour>();
+		result.reserve(within.size());
+		for (auto const& [distance, index] : within) {
+			result.push_back({index, std::sqrt(distance)});
+		}
+		return result;
+	}
+
+	template<typename Bound, typename Visit>
+	auto spatial_index::for_each_leaf(double const* query, Bound bound, Visit visit) const -> void {
+		if (nodes_.empty()) {
+			return;
+		}
+
+		auto const dimensions = static_cast<std::size_t>(this->dimensions());
+
+		if (partitioning_ == spatial_partitioning::kd_tree) {
+			// <offsets> is how far the query is outside the current cell in each dimension, so
+			// <lower> is the squared distance to the nearest point of the cell
+			auto offsets = std::vector<double>(dimensions);
+			auto const visit_node = [&](auto const& self, int node, double lower) -> void {
+				if (lower > bound()) {
+					return;
+				}
+
+				auto const& current = nodes_[static_cast<std::size_t>(node)];
+				if (current.right == -1) {
+					visit(current.begin, current.end);
+					return;
+				}
+
+				auto const split = static_cast<std::size_t>(current.split_dimension);
+				auto const difference = query[split] - current.split_value;
+				auto const nearer = difference <= 0 ? node + 1 : current.right;
+				auto const further = difference <= 0 ? current.right : node + 1;
+
+				self(self, nearer, lower);
+
+				auto const offset = offsets[split];
+				offsets[split] = difference;
+				self(self, further, lower - offset * offset + difference * difference);
+				offsets[split] = offset;
+			};
+			visit_node(visit_node, 0, 0.0);
+			return;
+		}
+
+		// Squared distance from the query to the nearest point of the ball around <node>
+		auto const ball_distance = [&](int node) {
+			auto const distance = std::sqrt(squared_distance(query,
+			                                                 centres_[node].data(),
+			                                                 dimensions,
+			                                                 std::numeric_limits<double>::infinity()));
+			auto const outside = std::max(distance - nodes_[static_cast<std::size_t>(node)].radius, 0.0);
+			return outside * outside;
+		};
+
+		auto const visit_node = [&](auto const& self, int node, double lower) -> void {
+			if (lower > bound()) {
+				return;
+			}
+
+			auto const& current = nodes_[static_cast<std::size_t>(node)];
+			if (current.right == -1) {
+				visit(current.begin, current.end);
+				return;
+			}
+
+			auto const left = ball_distance(node + 1);
+			auto const right = ball_distance(current.right);
+			if (left <= right) {
+				self(self, node + 1, left);
+				self(self, current.right, right);
+			}
+			else {
+				self(self, current.right, right);
+				self(self, node + 1, left);
+			}
+		};
+		visit_node(visit_node, 0, ball_distance(0));
+	}
+} // namespace comp6771
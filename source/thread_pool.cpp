@@ -0,0 +1,130 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include "comp6771/thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace comp6771 {
+	namespace {
+		// Shared between the caller of parallel_for and the workers helping it
+		struct parallel_for_state {
+			std::size_t count;
+			std::function<void(std::size_t)> const* body;
+			std::atomic<std::size_t> next = 0;
+
+			std::mutex mutex;
+			std::condition_variable finished;
+			int running = 0;
+			std::exception_ptr error;
+
+			// Claims indices until none are left. A worker that starts after the caller has
+			// returned claims nothing, so never touches <body>.
+			auto work() -> void {
+				for (auto i = next++; i < count; i = next++) {
+					try {
+						(*body)(i);
+					} catch (...) {
+						auto const lock = std::scoped_lock(mutex);
+						if (not error) {
+							error = std::current_exception();
+						}
+						next = count;
+					}
+				}
+			}
+		};
+	} // namespace
+
+	thread_pool::thread_pool(int threads) {
+		auto const size = threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency());
+		for (auto i = 0; i < std::max(size, 1); ++i) {
+			workers_.emplace_back([this] { run(); });
+		}
+	}
+
+	thread_pool::~thread_pool() {
+		{
+			auto const lock = std::scoped_lock(mutex_);
+			stopping_ = true;
+		}
+		ready_.notify_all();
+		for (auto& worker : workers_) {
+			worker.join();
+		}
+	}
+
+	auto thread_pool::size() const -> int {
+		return static_cast<int>(workers_.size());
+	}
+
+	auto thread_pool::parallel_for(std::size_t count, std::function<void(std::size_t)> const& body)
+	   -> void {
+		if (count == 0) {
+			return;
+		}
+
+		auto state = std::make_shared<parallel_for_state>();
+		state->count = count;
+		state->body = &body;
+
+		auto const helpers = std::min(count - 1, workers_.size());
+		if (helpers > 0) {
+			{
+				auto const queue_lock = std::scoped_lock(mutex_);
+				for (auto i = std::size_t{0}; i < helpers; ++i) {
+					tasks_.emplace([state] {
+						{
+							auto const lock = std::scoped_lock(state->mutex);
+							++state->running;
+						}
+						state->work();
+
+						auto const lock = std::scoped_lock(state->mutex);
+						if (--state->running == 0) {
+							state->finished.notify_all();
+						}
+					});
+				}
+			}
+			ready_.notify_all();
+		}
+
+		state->work();
+
+		auto lock = std::unique_lock(state->mutex);
+		state->finished.wait(lock, [&state] { return state->running == 0; });
+		if (state->error) {
+			std::rethrow_exception(state->error);
+		}
+	}
+
+	// Helper functions
+	auto thread_pool::run() -> void {
+		while (true) {
+			auto task = std::function<void()>();
+			{
+				auto lock = std::unique_lock(mutex_);
+				ready_.wait(lock, [this] { return stopping_ or not tasks_.empty(); });
+				if (tasks_.empty()) {
+					return;
+				}
+				task = std::move(tasks_.front());
+				tasks_.pop();
+			}
+			task();
+		}
+	}
+
+	auto default_thread_pool() -> thread_pool& {
+		static auto pool = thread_pool();
+		return pool;
+	}
+} // namespace comp6771
@@ -0,0 +1,271 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include "comp6771/vector_file.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace comp6771 {
+	namespace {
+		constexpr auto file_magic = std::array<char, 8>{'C', '6', '7', '7', '1', 'E', 'V', 'F'};
+		constexpr auto file_version = std::uint32_t{1};
+		constexpr auto file_byte_order = std::uint32_t{0x01020304};
+		constexpr auto row_alignment = std::uint32_t{64};
+
+		struct file_header {
+			std::array<char, 8> magic;
+			std::uint32_t version;
+			std::uint32_t byte_order;
+			std::uint32_t dtype;
+			std::uint32_t alignment;
+			std::uint64_t dimensions;
+			std::uint64_t rows;
+			std::uint64_t row_stride;
+			std::uint64_t data_offset;
+			std::array<char, 8> reserved;
+		};
+		static_assert(sizeof(file_header) == 64);
+
+		// Doubles per row, including the padding
+		auto padded_dimensions(std::size_t dimensions) -> std::size_t {
+			constexpr auto per_line = row_alignment / sizeof(double);
+			return (dimensions + per_line - 1) / per_line * per_line;
+		}
+
+		auto make_header(std::size_t dimensions, std::size_t rows) -> file_header {
+			auto header = file_header{};
+			header.magic = file_magic;
+			header.version = file_version;
+			header.byte_order = file_byte_order;
+			header.dtype = static_cast<std::uint32_t>(vector_file_dtype::float64);
+			header.alignment = row_alignment;
+			header.dimensions = dimensions;
+			header.rows = rows;
+			header.row_stride = padded_dimensions(dimensions) * sizeof(double);
+			header.data_offset = sizeof(file_header);
+			return header;
+		}
+
+		auto write_check(bool good, std::string const& path) -> void {
+			if (not good) {
+				throw euclidean_vector_error("Cannot write vector file " + path);
+			}
+		}
+
+		auto read_check(bool good, std::string const& path) -> void {
+			if (not good) {
+				throw euclidean_vector_error("Cannot read vector file " + path);
+			}
+		}
+
+		// Checks everything the reader relies on, so a truncated or foreign file is rejected
+		// rather than read out of bounds
+		auto header_check(file_header const& header, std::size_t file_size, std::string const& path)
+		   -> void {
+			read_check(header.magic == file_magic, path);
+			read_check(header.byte_order == file_byte_order, path);
+			if (header.version != file_version) {
+				throw euclidean_vector_error("Unsupported vector file version "
+				                             + std::to_string(header.version) + " in " + path);
+			}
+			read_check(header.dtype == static_cast<std::uint32_t>(vector_file_dtype::float64), path);
+
+			auto const int_max = static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+			read_check(header.dimensions <= int_max and header.rows <= int_max, path);
+			read_check(header.row_stride >= header.dimensions * sizeof(double)
+			              and header.row_stride % sizeof(double) == 0,
+			           path);
+			read_check(header.data_offset >= sizeof(file_header)
+			              and header.data_offset % alignof(double) == 0
+			              and header.data_offset <= file_size,
+			           path);
+			read_check(header.row_stride == 0
+			              or header.rows <= (file_size - header.data_offset) / header.row_stride,
+			           path);
+		}
+	} // namespace
+
+	// vector_file_writer
+	vector_file_writer::vector_file_writer(std::string const& path, int dimensions)
+	: path_{path}
+	, out_(path, std::ios::binary)
+	, dimensions_{dimensions}
+	, row_(padded_dimensions(static_cast<std::size_t>(dimensions))) {
+		write_check(static_cast<bool>(out_), path_);
+
+		// The row count is filled in by close()
+		auto const header = make_header(static_cast<std::size_t>(dimensions_), 0);
+		out_.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		write_check(static_cast<bool>(out_), path_);
+	}
+
+	vector_file_writer::~vector_file_writer() {
+		if (out_.is_open()) {
+			try {
+				close();
+			} catch (euclidean_vector_error const&) {
+				// Destructors cannot report errors; call close() to see them
+			}
+		}
+	}
+
+	auto vector_file_writer::size() const -> int {
+		return size_;
+	}
+
+	auto vector_file_writer::dimensions() const -> int {
+		return dimensions_;
+	}
+
+	auto vector_file_writer::close() -> void {
+		if (not out_.is_open()) {
+			return;
+		}
+
+		auto const header =
+		   make_header(static_cast<std::size_t>(dimensions_), static_cast<std::size_t>(size_));
+		out_.seekp(0);
+		out_.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		out_.close();
+		write_check(not out_.fail(), path_);
+	}
+
+	auto vector_file_writer::write_row() -> void {
+		out_.write(reinterpret_cast<char const*>(row_.data()),
+		           static_cast<std::streamsize>(row_.size() * sizeof(double)));
+		write_check(static_cast<bool>(out_), path_);
+		++size_;
+	}
+
+	auto write_vector_file(std::string const& path, euclidean_vector_batch const& vectors) -> void {
+		auto writer = vector_file_writer(path, vectors.dimensions());
+		for (auto i = 0; i < vectors.size(); ++i) {
+			writer.push_back(vectors[i]);
+		}
+		writer.close();
+	}
+
+	// mapped_vector_file
+	mapped_vector_file::mapped_vector_file(std::string const& path) {
+		auto const descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		read_check(descriptor != -1, path);
+
+		struct stat status = {};
+		auto const stat_result = ::fstat(descriptor, &status);
+		auto const file_size = static_cast<std::size_t>(status.st_size);
+		if (stat_result == -1 or file_size < sizeof(file_header)) {
+			::close(descriptor);
+			read_check(false, path);
+		}
+
+		// The mapping keeps the file open, so the descriptor is no longer needed
+		auto* const mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, descriptor, 0);
+		::close(descriptor);
+		read_check(mapping != MAP_FAILED, path);
+		mapping_ = mapping;
+		mapping_size_ = file_size;
+
+		auto header = file_header{};
+		std::memcpy(&header, mapping_, sizeof(header));
+		try {
+			header_check(header, file_size, path);
+		} catch (...) {
+			unmap();
+			throw;
+		}
+
+		rows_ = reinterpret_cast<double const*>(static_cast<char const*>(mapping_) + header.data_offset);
+		stride_ = static_cast<std::size_t>(header.row_stride / sizeof(double));
+		size_ = static_cast<int>(header.rows);
+		dimensions_ = static_cast<int>(header.dimensions);
+	}
+
+	mapped_vector_file::mapped_vector_file(mapped_vector_file&& other) noexcept
+	: mapping_{std::exchange(other.mapping_, nullptr)}
+	, mapping_size_{std::exchange(other.mapping_size_, 0)}
+	, rows_{std::exchange(other.rows_, nullptr)}
+	, stride_{std::exchange(other.stride_, 0)}
+	, size_{std::exchange(other.size_, 0)}
+	, dimensions_{std::exchange(other.dimensions_, 0)} {}
+
+	auto mapped_vector_file::operator=(mapped_vector_file&& other) noexcept -> mapped_vector_file& {
+		if (this != &other) {
+			unmap();
+			mapping_ = std::exchange(other.mapping_, nullptr);
+			mapping_size_ = std::exchange(other.mapping_size_, 0);
+			rows_ = std::exchange(other.rows_, nullptr);
+			stride_ = std::exchange(other.stride_, 0);
+			size_ = std::exchange(other.size_, 0);
+			dimensions_ = std::exchange(other.dimensions_, 0);
+		}
+		return *this;
+	}
+
+	mapped_vector_file::~mapped_vector_file() {
+		unmap();
+	}
+
+	// Member functions
+	auto mapped_vector_file::at(int index) const -> const_euclidean_vector_view {
+		if (index < 0 or index >= size_) {
+			throw euclidean_vector_error("Index " + std::to_string(index)
+			                             + " is not valid for this mapped_vector_file object");
+		}
+		return (*this)[index];
+	}
+
+	auto mapped_vector_file::size() const -> int {
+		return size_;
+	}
+
+	auto mapped_vector_file::empty() const -> bool {
+		return size_ == 0;
+	}
+
+	auto mapped_vector_file::dimensions() const -> int {
+		return dimensions_;
+	}
+
+	auto mapped_vector_file::stride() const -> std::size_t {
+		return stride_;
+	}
+
+	auto mapped_vector_file::advise(access_pattern pattern) const -> void {
+		if (mapping_ == nullptr) {
+			return;
+		}
+
+		auto const advice = [pattern] {
+			switch (pattern) {
+			case access_pattern::normal: return MADV_NORMAL;
+			case access_pattern::sequential: return MADV_SEQUENTIAL;
+			case access_pattern::random: return MADV_RANDOM;
+			case access_pattern::will_need: return MADV_WILLNEED;
+			}
+			return MADV_NORMAL;
+		}();
+		// Advice is only a hint, so failure is not an error
+		::madvise(mapping_, mapping_size_, advice);
+	}
+
+	// Helper functions
+	auto mapped_vector_file::unmap() noexcept -> void {
+		if (mapping_ != nullptr) {
+			::munmap(mapping_, mapping_size_);
+			mapping_ = nullptr;
+			mapping_size_ = 0;
+		}
+	}
+} // namespace comp6771
@@ -0,0 +1,261 @@
+#include "comp6771/compressed_index.hpp"
+#include "comp6771/testing/random_batch.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/*
+    Tests in this file test compressed_index, which searches vectors stored in fewer bytes.
+
+    These tests assume that brute_force_index and euclidean_vector_batch are correct.
+
+    Rational: Each mode loses a known amount of precision, so decompressed vectors are compared
+    with the originals within that bound, and search results with brute_force_index by recall.
+    Product quantization is exact when every vector is its own centroid, which checks the
+    lookup tables independently of the training. Reranking promises exact distances, so it is
+    also checked with vectors far from the origin, where expanding the distance would cancel.
+*/
+
+namespace {
+	using comp6771::testing::random_batch;
+
+	auto recall(std::vector<comp6771::neighbour> const& approximate,
+	            std::vector<comp6771::neighbour> const& exact) -> double {
+		auto found = 0;
+		for (auto const& n : exact) {
+			found += std::any_of(approximate.begin(), approximate.end(), [&n](auto const& a) {
+				return a.index == n.index;
+			});
+		}
+		return static_cast<double>(found) / static_cast<double>(exact.size());
+	}
+
+	// Largest difference between a magnitude and its stored value
+	auto largest_error(comp6771::compressed_index const& index,
+	                   comp6771::euclidean_vector_batch const& vectors) -> double {
+		auto error = 0.0;
+		for (auto v = 0; v < vectors.size(); ++v) {
+			auto const stored = index.decompress(v);
+			for (auto i = 0; i < vectors.dimensions(); ++i) {
+				error = std::max(error, std::abs(stored[i] - vectors[v][i]));
+			}
+		}
+		return error;
+	}
+} // namespace
+
+TEST_CASE("Compression Names") {
+	CHECK(comp6771::name(comp6771::compression::float32) == "float32");
+	CHECK(comp6771::name(comp6771::compression::float16) == "float16");
+	CHECK(comp6771::name(comp6771::compression::bfloat16) == "bfloat16");
+	CHECK(comp6771::name(comp6771::compression::int8) == "int8");
+	CHECK(comp6771::name(comp6771::compression::product_quantization) == "product_quantization");
+}
+
+TEST_CASE("Scalar Compression") {
+	auto const vectors = random_batch(300, 24, 1);
+
+	SECTION("float32") {
+		auto const index = comp6771::compressed_index(vectors, comp6771::compression::float32);
+		CHECK(index.size() == 300);
+		CHECK(index.dimensions() == 24);
+		CHECK(index.mode() == comp6771::compression::float32);
+		CHECK(index.bytes_per_vector() == 24 * 4 + 4);
+		CHECK(largest_error(index, vectors) < 1e-7);
+	}
+
+	SECTION("float16") {
+		auto const index = comp6771::compressed_index(vectors, comp6771::compression::float16);
+		CHECK(index.bytes_per_vector() == 24 * 2 + 4);
+		CHECK(largest_error(index, vectors) < 1.0 / 2048);
+	}
+
+	SECTION("bfloat16") {
+		auto const index = comp6771::compressed_index(vectors, comp6771::compression::bfloat16);
+		CHECK(index.bytes_per_vector() == 24 * 2 + 4);
+		CHECK(largest_error(index, vectors) < 1.0 / 256);
+	}
+
+	SECTION("int8") {
+		auto const index = comp6771::compressed_index(vectors, comp6771::compression::int8);
+		CHECK(index.bytes_per_vector() == 24 + 4 + 4);
+		CHECK(largest_error(index, vectors) < 1.0 / 254 + 1e-9);
+	}
+
+	SECTION("dot products are with the stored vector") {
+		auto const query = random_batch(1, 24, 2);
+		for (auto const mode : {comp6771::compression::float32,
+		                        comp6771::compression::float16,
+		                        comp6771::compression::bfloat16,
+		                        comp6771::compression::int8}) {
+			auto const index = comp6771::compressed_index(vectors, mode);
+			for (auto const v : {0, 150, 299}) {
+				CHECK(index.dot(query[0], v) == Approx(comp6771::dot(query[0], index.decompress(v))));
+			}
+		}
+	}
+
+	SECTION("Distances are to the stored vector") {
+		auto const query = random_batch(1, 24, 2);
+		for (auto const mode : {comp6771::compression::float32,
+		                        comp6771::compression::float16,
+		                        comp6771::compression::bfloat16,
+		                        comp6771::compression::int8}) {
+			auto const index = comp6771::compressed_index(vectors, mode);
+			for (auto const& n : index.search(query[0], 10)) {
+				auto const stored = index.decompress(n.index);
+				CHECK(n.distance == Approx(comp6771::euclidean_norm(query[0] - stored)));
+			}
+		}
+	}
+
+	SECTION("A zero vector stays zero in int8") {
+		auto const zeros = comp6771::euclidean_vector_batch(2, 5, 0.0);
+		auto const index = comp6771::compressed_index(zeros, comp6771::compression::int8);
+		CHECK(index.decompress(1) == comp6771::euclidean_vector(5, 0.0));
+	}
+}
+
+TEST_CASE("Product Quantization") {
+	SECTION("Exact when every vector is its own centroid") {
+		auto const vectors = random_batch(40, 12, 3);
+		auto const index = comp6771::compressed_index(vectors,
+		                                              comp6771::compression::product_quantization,
+		                                              comp6771::metric::l2,
+		                                              {.subspaces = 4, .centroids = 64});
+		CHECK(index.bytes_per_vector() == 4 + 4);
+		CHECK(largest_error(index, vectors) == 0);
+
+		auto const exact = comp6771::brute_force_index(vectors);
+		auto const query = random_batch(1, 12, 4);
+		auto const result = index.search(query[0], 5);
+		auto const expected = exact.search(query[0], 5);
+		REQUIRE(result.size() == 5);
+		for (auto i = std::size_t{0}; i < result.size(); ++i) {
+			CHECK(result[i].index == expected[i].index);
+			CHECK(result[i].distance == Approx(expected[i].distance));
+		}
+	}
+
+	SECTION("More subspaces than dimensions uses one per dimension") {
+		auto const vectors = random_batch(20, 3, 5);
+		auto const index = comp6771::compressed_index(vectors,
+		                                              comp6771::compression::product_quantization,
+		                                              comp6771::metric::l2,
+		                                              {.subspaces = 8});
+		CHECK(index.bytes_per_vector() == 3 + 4);
+	}
+
+	SECTION("Invalid parameters") {
+		auto const vectors = random_batch(20, 4, 6);
+		auto const pq = comp6771::compression::product_quantization;
+		CHECK_THROWS_MATCHES(
+		   comp6771::compressed_index(vectors, pq, comp6771::metric::l2, {.subspaces = 0}),
+		   comp6771::euclidean_vector_error,
+		   Catch::Matchers::Message("Invalid pq_parameters subspaces 0"));
+		CHECK_THROWS_MATCHES(
+		   comp6771::compressed_index(vectors, pq, comp6771::metric::l2, {.centroids = 257}),
+		   comp6771::euclidean_vector_error,
+		   Catch::Matchers::Message("Invalid pq_parameters centroids 257"));
+		CHECK_THROWS_MATCHES(
+		   comp6771::compressed_index(vectors, pq, comp6771::metric::l2, {.iterations = -1}),
+		   comp6771::euclidean_vector_error,
+		   Catch::Matchers::Message("Invalid pq_parameters iterations -1"));
+		CHECK_THROWS_MATCHES(
+		   comp6771::compressed_index(vectors, pq, comp6771::metric::l2, {.training_size = 0}),
+		   comp6771::euclidean_vector_error,
+		   Catch::Matchers::Message("Invalid pq_parameters training_size 0"));
+	}
+}
+
+TEST_CASE("Compressed Search Recall") {
+	auto const vectors = random_batch(2000, 32, 7);
+	auto const queries = random_batch(20, 32, 8);
+	auto const k = 10;
+
+	auto const m = GENERATE(comp6771::metric::l2, comp6771::metric::inner_product, comp6771::metric::cosine);
+	auto const exact = comp6771::brute_force_index(vectors, m);
+
+	auto const check_recall = [&](comp6771::compression mode, double raw, double reranked) {
+		auto const index = comp6771::compressed_index(vectors, mode, m, {.iterations = 8});
+		CHECK(index.distance_metric() == m);
+
+		auto raw_total = 0.0;
+		auto reranked_total = 0.0;
+		for (auto q = 0; q < queries.size(); ++q) {
+			auto const expected = exact.search(queries[q], k);
+			auto const found = index.search(queries[q], k);
+			REQUIRE(found.size() == k);
+			CHECK(std::is_sorted(found.begin(), found.end(), [](auto const& x, auto const& y) {
+				return x.distance < y.distance;
+			}));
+			raw_total += recall(found, expected);
+
+			auto const refined = index.search(queries[q], k, vectors, 100);
+			REQUIRE(refined.size() == k);
+			reranked_total += recall(refined, expected);
+			auto const original = exact.search(queries[q], vectors.size());
+			for (auto const& n : refined) {
+				auto const same = std::find_if(original.begin(), original.end(), [&n](auto const& o) {
+					return o.index == n.index;
+				});
+				CHECK(n.distance == Approx(same->distance));
+			}
+		}
+		CHECK(raw_total / queries.size() >= raw);
+		CHECK(reranked_total / queries.size() >= reranked);
+	};
+
+	SECTION("float32") {
+		check_recall(comp6771::compression::float32, 0.99, 0.99);
+	}
+
+	SECTION("float16") {
+		check_recall(comp6771::compression::float16, 0.95, 0.99);
+	}
+
+	SECTION("int8") {
+		check_recall(comp6771::compression::int8, 0.9, 0.99);
+	}
+
+	SECTION("product_quantization") {
+		check_recall(comp6771::compression::product_quantization, 0.4, 0.95);
+	}
+}
+
+TEST_CASE("Reranked Distances Far From The Origin") {
+	auto vectors = comp6771::euclidean_vector_batch(2);
+	vectors.push_back(comp6771::euclidean_vector{1e8 + 3, 1e8 + 4});
+	vectors.push_back(comp6771::euclidean_vector{1e8 + 1, 1e8});
+	auto const index = comp6771::compressed_index(vectors, comp6771::compression::float32);
+
+	auto const result = index.search(comp6771::euclidean_vector{1e8, 1e8}, 2, vectors, 2);
+
+	REQUIRE(result.size() == 2);
+	CHECK(result[0] == comp6771::neighbour{1, 1});
+	CHECK(result[1] == comp6771::neighbour{0, 5});
+}
+
+TEST_CASE("Compressed Index Exceptions") {
+	auto const vectors = random_batch(10, 4, 9);
+	auto const index = comp6771::compressed_index(vectors, comp6771::compression::int8);
+
+	CHECK_THROWS_MATCHES(index.search(comp6771::euclidean_vector{1, 2}, 3),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(4) and RHS(2) do not match"));
+	CHECK_THROWS_MATCHES(index.search(vectors[0], -1),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Invalid number of neighbours -1"));
+	CHECK_THROWS_MATCHES(index.decompress(10),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Index 10 is not valid for this compressed_index object"));
+	CHECK_THROWS_MATCHES(index.dot(vectors[0], -1),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Index -1 is not valid for this compressed_index object"));
+	CHECK_THROWS_MATCHES(index.search(vectors[0], 3, random_batch(9, 4, 10), 5),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Sizes of LHS(10) and RHS(9) do not match"));
+}
@@ -0,0 +1,155 @@
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/testing/counting_resource.hpp"
+
+#include <catch2/catch.hpp>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+/*
+    Tests in this file test that euclidean_vector allocates from the memory resource it is given,
+    and which memory resource copies, moves and arithmetic results end up with.
+
+    These tests assume that the constructors and casting to std::vector are correct.
+
+    Rational: The memory resource is only observable through get_allocator() and through what is
+    allocated from it, so each test checks both. Vectors of 4 dimensions or less do not allocate
+    at all, so the tests use 5 dimensions.
+*/
+
+namespace {
+	using comp6771::testing::counting_resource;
+
+	auto resource_of(comp6771::euclidean_vector const& ev) -> std::pmr::memory_resource* {
+		return ev.get_allocator().resource();
+	}
+} // namespace
+
+TEST_CASE("Allocator Constructors") {
+	auto arena = counting_resource();
+
+	SECTION("Defaults to the default memory resource") {
+		auto const ev = comp6771::euclidean_vector(5);
+		CHECK(resource_of(ev) == std::pmr::get_default_resource());
+	}
+
+	SECTION("Every constructor allocates from the given resource") {
+		auto const magnitudes = std::vector<double>{1, 2, 3, 4, 5};
+
+		{
+			auto const ev1 = comp6771::euclidean_vector(5, &arena);
+			auto const ev2 = comp6771::euclidean_vector(5, 1.5, &arena);
+			auto const ev3 = comp6771::euclidean_vector(magnitudes.begin(), magnitudes.end(), &arena);
+			auto const ev4 = comp6771::euclidean_vector({1, 2, 3, 4, 5}, &arena);
+
+			CHECK(arena.allocations() == 4);
+			CHECK(resource_of(ev1) == &arena);
+			CHECK(resource_of(ev4) == &arena);
+			CHECK_THAT(static_cast<std::vector<double>>(ev3), Catch::Approx(magnitudes));
+		}
+
+		CHECK(arena.deallocations() == 4);
+	}
+
+	SECTION("Small vectors do not allocate") {
+		auto const ev = comp6771::euclidean_vector({1, 2, 3, 4}, &arena);
+
+		CHECK(resource_of(ev) == &arena);
+		CHECK(arena.allocations() == 0);
+	}
+
+	SECTION("Monotonic arena") {
+		auto buffer = std::pmr::monotonic_buffer_resource();
+		auto const ev = comp6771::euclidean_vector(1000, 2.0, &buffer);
+
+		CHECK(comp6771::euclidean_norm(ev) == Approx(63.2455532034));
+	}
+}
+
+/*
+   Test cases follow the std::pmr containers:
+   - A copy uses the default resource unless one is given
+   - Assignment never changes the resource of the assigned to vector
+   - A move keeps the resource of the moved from vector
+*/
+TEST_CASE("Allocator Copy and Move") {
+	auto arena = counting_resource();
+	auto other_arena = counting_resource();
+	auto const exp = std::vector<double>{1, 2, 3, 4, 5};
+
+	auto ev = comp6771::euclidean_vector({1, 2, 3, 4, 5}, &arena);
+
+	SECTION("Copy constructor") {
+		auto const copy = ev;
+		auto const extended_copy = comp6771::euclidean_vector(ev, &other_arena);
+
+		CHECK(resource_of(copy) == std::pmr::get_default_resource());
+		CHECK(resource_of(extended_copy) == &other_arena);
+		CHECK_THAT(static_cast<std::vector<double>>(extended_copy), Catch::Approx(exp));
+	}
+
+	SECTION("Copy assignment") {
+		auto target = comp6771::euclidean_vector(7, &other_arena);
+		target = ev;
+
+		CHECK(resource_of(target) == &other_arena);
+		CHECK_THAT(static_cast<std::vector<double>>(target), Catch::Approx(exp));
+	}
+
+	SECTION("Move constructor") {
+		auto const moved = std::move(ev);
+
+		CHECK(resource_of(moved) == &arena);
+		CHECK(arena.allocations() == 1);
+	}
+
+	SECTION("Move assignment with a different resource copies") {
+		auto target = comp6771::euclidean_vector(7, &other_arena);
+		target = std::move(ev);
+
+		CHECK(resource_of(target) == &other_arena);
+		CHECK(other_arena.allocations() == 2);
+		CHECK_THAT(static_cast<std::vector<double>>(target), Catch::Approx(exp));
+	}
+
+	SECTION("Move assignment with the same resource does not allocate") {
+		auto target = comp6771::euclidean_vector(7, &arena);
+		target = std::move(ev);
+
+		CHECK(arena.allocations() == 2);
+		CHECK(arena.deallocations() == 1);
+		CHECK_THAT(static_cast<std::vector<double>>(target), Catch::Approx(exp));
+	}
+}
+
+TEST_CASE("Allocator Arithmetic Results") {
+	auto arena = counting_resource();
+
+	auto const in_arena = comp6771::euclidean_vector({1, 2, 3, 4, 5}, &arena);
+	auto const on_heap = comp6771::euclidean_vector{5, 4, 3, 2, 1};
+
+	SECTION("Results use the resource of the left operand") {
+		comp6771::euclidean_vector const left = in_arena + on_heap * 2;
+		comp6771::euclidean_vector const right = on_heap - in_arena;
+
+		CHECK(resource_of(left) == &arena);
+		CHECK(resource_of(right) == std::pmr::get_default_resource());
+		CHECK_THAT(static_cast<std::vector<double>>(left),
+		           Catch::Approx(std::vector<double>{11, 10, 9, 8, 7}));
+	}
+
+	SECTION("Unary plus and unit") {
+		CHECK(resource_of(+in_arena) == &arena);
+		CHECK(resource_of(comp6771::unit(in_arena)) == &arena);
+	}
+
+	SECTION("Containers pass their allocator on") {
+		auto vectors = std::pmr::vector<comp6771::euclidean_vector>(&arena);
+		vectors.emplace_back(5, 1.0);
+		vectors.emplace_back(6, 2.0);
+
+		CHECK(resource_of(vectors[0]) == &arena);
+		CHECK(resource_of(vectors[1]) == &arena);
+		CHECK(vectors[1].dimensions() == 6);
+	}
+}
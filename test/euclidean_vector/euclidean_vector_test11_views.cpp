@@ -0,0 +1,143 @@
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+#include "comp6771/testing/counting_resource.hpp"
+
+#include <array>
+#include <catch2/catch.hpp>
+#include <memory_resource>
+#include <span>
+#include <sstream>
+#include <vector>
+
+/*
+    Tests in this file test euclidean_vector_view and const_euclidean_vector_view over magnitudes
+    the library does not own.
+
+    These tests assume that euclidean_vector's constructors, operator<< and utility functions are
+    correct, and compare views with them.
+
+    Rational: Views must give the same results as euclidean_vector in every operation, and must
+    never copy. Copies of more than 4 magnitudes allocate from the default memory resource, so
+    each test counts allocations from it while it uses views of 5 magnitudes.
+*/
+
+namespace {
+	using comp6771::testing::counting_resource;
+
+	// Installs a counting_resource as the default resource for its lifetime
+	class counting_default_resource {
+	public:
+		counting_default_resource()
+		: previous_{std::pmr::set_default_resource(&counter_)} {}
+
+		counting_default_resource(counting_default_resource const&) = delete;
+		auto operator=(counting_default_resource const&) -> counting_default_resource& = delete;
+
+		~counting_default_resource() {
+			std::pmr::set_default_resource(previous_);
+		}
+
+		[[nodiscard]] auto allocations() const -> long {
+			return counter_.allocations();
+		}
+
+	private:
+		counting_resource counter_;
+		std::pmr::memory_resource* previous_;
+	};
+} // namespace
+
+TEST_CASE("Views Over Foreign Buffers") {
+	auto buffer = std::vector<double>{3, 4, 0, 0, 0};
+	auto const ev = comp6771::euclidean_vector(buffer.cbegin(), buffer.cend());
+
+	SECTION("Wrapping a std::vector") {
+		auto const view = comp6771::euclidean_vector_view(buffer);
+		auto const read_only = comp6771::const_euclidean_vector_view(std::span<double const>(buffer));
+
+		CHECK(view.dimensions() == 5);
+		CHECK(view.data() == buffer.data());
+		CHECK(read_only.data() == buffer.data());
+
+		view[4] = 12;
+		CHECK(buffer[4] == 12);
+		CHECK(read_only[4] == 12);
+	}
+
+	SECTION("A row of a larger matrix") {
+		auto matrix = std::array<double, 6>{1, 2, 3, 4, 5, 6};
+		auto row = comp6771::euclidean_vector_view(std::span(matrix).subspan(3, 3));
+		row *= 2;
+		CHECK(matrix == std::array<double, 6>{1, 2, 3, 8, 10, 12});
+	}
+
+	SECTION("Utilities do not copy") {
+		auto const view = comp6771::euclidean_vector_view(buffer);
+		auto const read_only = comp6771::const_euclidean_vector_view(view);
+
+		auto const counter = counting_default_resource();
+		CHECK(comp6771::euclidean_norm(view) == Approx(5));
+		CHECK(comp6771::euclidean_norm(read_only) == Approx(5));
+		CHECK(comp6771::dot(view, read_only) == Approx(25));
+		CHECK(comp6771::dot(view, ev) == Approx(25));
+		CHECK(comp6771::dot(ev, read_only) == Approx(25));
+		CHECK(view == ev);
+		CHECK(ev == read_only);
+		CHECK(view == read_only);
+		CHECK_FALSE(view != ev);
+		CHECK(counter.allocations() == 0);
+	}
+
+	SECTION("unit allocates only its result") {
+		auto const view = comp6771::euclidean_vector_view(buffer);
+
+		auto const counter = counting_default_resource();
+		auto const unit = comp6771::unit(view);
+		CHECK(counter.allocations() == 1);
+		CHECK(unit == comp6771::unit(ev));
+		CHECK(unit == comp6771::euclidean_vector{0.6, 0.8, 0, 0, 0});
+	}
+
+	SECTION("Printing") {
+		auto view_out = std::ostringstream();
+		auto ev_out = std::ostringstream();
+		view_out << comp6771::euclidean_vector_view(buffer) << ' '
+		         << comp6771::const_euclidean_vector_view(ev);
+		ev_out << ev << ' ' << ev;
+		CHECK(view_out.str() == ev_out.str());
+		CHECK(view_out.str() == "[3 4 0 0 0] [3 4 0 0 0]");
+	}
+
+	SECTION("Reading a euclidean_vector through a view") {
+		auto const view = comp6771::const_euclidean_vector_view(ev);
+		CHECK(view.dimensions() == 5);
+		CHECK(view[1] == 4);
+		CHECK(comp6771::euclidean_vector(view + ev) == ev * 2);
+		CHECK(comp6771::const_euclidean_vector_view(comp6771::euclidean_vector(0)).dimensions() == 0);
+	}
+
+	SECTION("Expressions of views") {
+		auto const view = comp6771::const_euclidean_vector_view(std::span<double const>(buffer));
+		CHECK(comp6771::euclidean_norm(view * 2) == Approx(10));
+		CHECK(comp6771::unit(view - ev * 2) == comp6771::unit(-ev));
+	}
+}
+
+TEST_CASE("View Exceptions") {
+	auto buffer = std::vector<double>{1, 2, 3};
+	auto zeros = std::vector<double>{0, 0};
+	auto const view = comp6771::const_euclidean_vector_view(std::span<double const>(buffer));
+
+	CHECK_THROWS_MATCHES(comp6771::dot(view, comp6771::euclidean_vector{1, 2}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not match"));
+	CHECK_THROWS_MATCHES(comp6771::unit(comp6771::euclidean_vector_view(zeros)),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("euclidean_vector with zero euclidean normal does "
+	                                              "not have a unit vector"));
+	CHECK_THROWS_MATCHES(comp6771::unit(comp6771::const_euclidean_vector_view()),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("euclidean_vector with no dimensions does not have "
+	                                              "a unit vector"));
+	CHECK(view != comp6771::euclidean_vector{1, 2});
+}
@@ -0,0 +1,159 @@
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/*
+    Tests in this file test that vectors above parallel_threshold() are split across threads.
+
+    These tests assume that the kernels and the serial operations are correct.
+
+    Rational: Parallel results must be exactly reproducible, so reductions are compared for
+    equality (not Approx) with the chunk by chunk sum computed on one thread, which is what they
+    must equal whatever the number of threads. Element-wise operations must be exactly the same
+    as the serial loop. The vectors have a few chunks and a partial last chunk.
+*/
+
+namespace {
+	// Sets the threshold for its lifetime
+	class threshold_guard {
+	public:
+		explicit threshold_guard(std::size_t threshold)
+		: previous_{comp6771::parallel_threshold()} {
+			comp6771::set_parallel_threshold(threshold);
+		}
+
+		threshold_guard(threshold_guard const&) = delete;
+		auto operator=(threshold_guard const&) -> threshold_guard& = delete;
+
+		~threshold_guard() {
+			comp6771::set_parallel_threshold(previous_);
+		}
+
+	private:
+		std::size_t previous_;
+	};
+
+	constexpr auto chunk = comp6771::detail::parallel_chunk;
+	constexpr auto size = 3 * chunk + 1000;
+
+	auto make_magnitudes(double seed) -> std::vector<double> {
+		auto magnitudes = std::vector<double>(size);
+		for (auto i = std::size_t{0}; i < size; ++i) {
+			magnitudes[i] = seed * static_cast<double>(i % 97) - static_cast<double>(i % 13) / 7;
+		}
+		return magnitudes;
+	}
+
+	auto chunked_dot(std::vector<double> const& x, std::vector<double> const& y) -> double {
+		auto sum = 0.0;
+		for (auto first = std::size_t{0}; first < x.size(); first += chunk) {
+			auto const count = std::min(chunk, x.size() - first);
+			sum += comp6771::kernels::dot(x.data() + first, y.data() + first, count);
+		}
+		return sum;
+	}
+} // namespace
+
+TEST_CASE("Parallel Threshold") {
+	auto const guard = threshold_guard(12345);
+	CHECK(comp6771::parallel_threshold() == 12345);
+	comp6771::set_parallel_threshold(0);
+	CHECK(comp6771::parallel_threshold() == 0);
+}
+
+TEST_CASE("Parallel Reductions Are Reproducible") {
+	auto const guard = threshold_guard(0);
+
+	auto const x = make_magnitudes(0.001);
+	auto const y = make_magnitudes(-0.002);
+	auto const ev_x = comp6771::euclidean_vector(x.begin(), x.end());
+	auto const ev_y = comp6771::euclidean_vector(y.begin(), y.end());
+	auto const view_x = comp6771::const_euclidean_vector_view(std::span<double const>(x));
+
+	auto const dot_exp = chunked_dot(x, y);
+	auto const norm_exp = std::sqrt(chunked_dot(x, x));
+
+	SECTION("dot") {
+		CHECK(comp6771::dot(ev_x, ev_y) == dot_exp);
+		CHECK(comp6771::dot(view_x, ev_y) == dot_exp);
+		for (auto repeat = 0; repeat < 5; ++repeat) {
+			CHECK(comp6771::dot(ev_x, ev_y) == dot_exp);
+		}
+	}
+
+	SECTION("euclidean_norm") {
+		CHECK(comp6771::euclidean_norm(ev_x) == norm_exp);
+		CHECK(comp6771::euclidean_norm(view_x) == norm_exp);
+	}
+
+	SECTION("Expressions are reduced chunk by chunk") {
+		auto const scaled = comp6771::dot(ev_x * 1.0, ev_y);
+		CHECK(scaled == Approx(dot_exp));
+		CHECK(comp6771::dot(ev_x * 1.0, ev_y) == scaled);
+		CHECK(comp6771::euclidean_norm(ev_x + ev_y) == Approx(std::sqrt(chunked_dot(x, x) + 2 * dot_exp
+		                                                                + chunked_dot(y, y))));
+	}
+
+	SECTION("Below the threshold nothing is split") {
+		comp6771::set_parallel_threshold(size + 1);
+		CHECK(comp6771::dot(ev_x, ev_y) == comp6771::kernels::dot(x.data(), y.data(), size));
+	}
+}
+
+TEST_CASE("Parallel Element-wise Operations") {
+	auto const guard = threshold_guard(0);
+
+	auto const x = make_magnitudes(0.25);
+	auto const y = make_magnitudes(-1.5);
+	auto const ev_y = comp6771::euclidean_vector(y.begin(), y.end());
+	auto ev = comp6771::euclidean_vector(x.begin(), x.end());
+
+	auto expected = x;
+	auto const check = [&] {
+		auto const actual = static_cast<std::vector<double>>(ev);
+		CHECK(std::equal(actual.begin(), actual.end(), expected.begin(), expected.end()));
+	};
+
+	SECTION("+= and -=") {
+		ev += ev_y;
+		std::transform(expected.begin(), expected.end(), y.begin(), expected.begin(), std::plus<>());
+		check();
+
+		ev -= ev_y * 2;
+		std::transform(expected.begin(), expected.end(), y.begin(), expected.begin(), [](double e, double m) {
+			return e - m * 2;
+		});
+		check();
+	}
+
+	SECTION("*= and /=") {
+		ev *= 3;
+		ev /= 7;
+		std::transform(expected.begin(), expected.end(), expected.begin(), [](double e) {
+			return e * 3 / 7;
+		});
+		check();
+	}
+
+	SECTION("Evaluating expressions") {
+		ev = ev + ev_y;
+		std::transform(expected.begin(), expected.end(), y.begin(), expected.begin(), std::plus<>());
+		check();
+
+		auto const negated = comp6771::euclidean_vector(-ev);
+		CHECK(negated == ev * -1);
+	}
+
+	SECTION("The cached norm is invalidated") {
+		auto const before = comp6771::euclidean_norm(ev);
+		ev *= 2;
+		CHECK(comp6771::euclidean_norm(ev) == Approx(before * 2));
+	}
+}
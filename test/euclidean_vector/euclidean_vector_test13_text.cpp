@@ -0,0 +1,242 @@
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/thread_pool.hpp"
+
+#include <array>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+/*
+    Tests in this file test writing vectors as text with to_chars and reading them back with
+    from_chars, operator>> and parse_vectors.
+
+    These tests assume that the constructors, operator[] and operator<< are correct.
+
+    Rational: to_chars must write exactly what operator<< writes, and must report a buffer that
+    is too small rather than overrun it, which is checked at every buffer size. Every reader must
+    read what operator<< writes, reject anything else without changing its destination, and
+    report where the text went wrong. parse_vectors is given a text large enough to be split into
+    several pieces, so vectors on either side of every split point are checked.
+*/
+
+namespace {
+	auto to_string(comp6771::euclidean_vector const& ev) -> std::string {
+		auto buffer = std::array<char, 256>{};
+		auto const result = comp6771::to_chars(buffer.data(), buffer.data() + buffer.size(), ev);
+		REQUIRE(result.ec == std::errc{});
+		return std::string(buffer.data(), result.ptr);
+	}
+
+	auto from_string(std::string_view text, comp6771::euclidean_vector& ev) -> std::from_chars_result {
+		return comp6771::from_chars(text.data(), text.data() + text.size(), ev);
+	}
+} // namespace
+
+TEST_CASE("to_chars Writes The Same As operator<<") {
+	auto const vectors = std::array{
+	   comp6771::euclidean_vector(0),
+	   comp6771::euclidean_vector{3, 5.7, 8.39, 7.29},
+	   comp6771::euclidean_vector{28.852914, -14.110132, -42.461567, 17.509216, 1e-300},
+	   comp6771::euclidean_vector{-std::numeric_limits<double>::max(),
+	                              std::numeric_limits<double>::infinity(),
+	                              -0.0,
+	                              123456789.0},
+	};
+
+	for (auto const& ev : vectors) {
+		auto oss = std::ostringstream{};
+		oss << ev;
+		CHECK(to_string(ev) == oss.str());
+	}
+
+	CHECK(to_string(comp6771::euclidean_vector{28.852914, -14.110132, -42.461567, 17.509216})
+	      == "[28.8529 -14.1101 -42.4616 17.5092]");
+
+	SECTION("Expressions are written without being evaluated into a vector") {
+		auto const x = comp6771::euclidean_vector{1, 2, 3};
+		auto buffer = std::array<char, 32>{};
+		auto const result = comp6771::to_chars(buffer.data(), buffer.data() + buffer.size(), x + x * 2);
+		REQUIRE(result.ec == std::errc{});
+		CHECK(std::string(buffer.data(), result.ptr) == "[3 6 9]");
+	}
+}
+
+TEST_CASE("to_chars Reports A Buffer That Is Too Small") {
+	auto const ev = comp6771::euclidean_vector{-1.5, 2.25, 1e10};
+	auto const expected = std::string("[-1.5 2.25 1e+10]");
+
+	auto buffer = std::string(expected.size() + 4, '#');
+	for (auto size = std::size_t{0}; size < expected.size(); ++size) {
+		auto const result = comp6771::to_chars(buffer.data(), buffer.data() + size, ev);
+		CHECK(result.ec == std::errc::value_too_large);
+		CHECK(result.ptr == buffer.data() + size);
+		CHECK(buffer[size] == '#');
+	}
+
+	auto const result = comp6771::to_chars(buffer.data(), buffer.data() + expected.size(), ev);
+	CHECK(result.ec == std::errc{});
+	CHECK(std::string(buffer.data(), result.ptr) == expected);
+}
+
+TEST_CASE("operator<< Pads To The Field Width") {
+	auto oss = std::ostringstream{};
+	oss << std::setw(9) << comp6771::euclidean_vector{1, 2} << '|' << comp6771::euclidean_vector{3};
+	CHECK(oss.str() == "    [1 2]|[3]");
+}
+
+TEST_CASE("operator<< Writes Long Vectors") {
+	auto const ev = comp6771::euclidean_vector(500, -1.23456789e-300);
+	auto oss = std::ostringstream{};
+	oss << ev;
+
+	auto expected = std::string("[");
+	for (auto i = 0; i < ev.dimensions(); ++i) {
+		expected += i == 0 ? "-1.23457e-300" : " -1.23457e-300";
+	}
+	expected += "]";
+	CHECK(oss.str() == expected);
+}
+
+TEST_CASE("from_chars Reads What operator<< Writes") {
+	auto ev = comp6771::euclidean_vector(0);
+
+	auto const text = std::string_view("[1 -2.5 3e+10 inf]tail");
+	auto const result = from_string(text, ev);
+	CHECK(result.ec == std::errc{});
+	CHECK(std::string_view(result.ptr) == "tail");
+	CHECK(ev.dimensions() == 4);
+	CHECK(ev[0] == 1);
+	CHECK(ev[1] == -2.5);
+	CHECK(ev[2] == 3e10);
+	CHECK(ev[3] == std::numeric_limits<double>::infinity());
+
+	SECTION("Empty vectors") {
+		CHECK(from_string("[]", ev).ec == std::errc{});
+		CHECK(ev.dimensions() == 0);
+	}
+
+	SECTION("Any whitespace inside the brackets") {
+		CHECK(from_string("[ \t1\n2  ]", ev).ec == std::errc{});
+		CHECK(ev == comp6771::euclidean_vector{1, 2});
+	}
+
+	SECTION("Shortest round trip text is read exactly") {
+		auto const exact = comp6771::euclidean_vector{0.1, 1.0 / 3, -2.718281828459045};
+		auto buffer = std::array<char, 128>{};
+		auto* out = buffer.data();
+		*out++ = '[';
+		for (auto i = 0; i < exact.dimensions(); ++i) {
+			out = std::to_chars(out, buffer.data() + buffer.size(), exact[i]).ptr;
+			*out++ = i + 1 == exact.dimensions() ? ']' : ' ';
+		}
+		REQUIRE(from_string(std::string_view(buffer.data(), out), ev).ec == std::errc{});
+		for (auto i = 0; i < exact.dimensions(); ++i) {
+			CHECK(ev[i] == exact[i]);
+		}
+	}
+}
+
+TEST_CASE("from_chars Rejects Anything Else") {
+	auto const original = comp6771::euclidean_vector{7, 8};
+	auto ev = original;
+
+	for (auto const text : {"", " [1]", "1 2", "[1 2", "[1,2]", "[1 2]]x", "[1.2.3]", "[a]", "[1[2]"}) {
+		auto const view = std::string_view(text);
+		auto const result = from_string(view, ev);
+		if (view == "[1 2]]x") {
+			CHECK(result.ec == std::errc{});
+			CHECK(std::string_view(result.ptr) == "]x");
+			ev = original;
+			continue;
+		}
+		CHECK(result.ec == std::errc::invalid_argument);
+		CHECK(result.ptr == view.data());
+		CHECK(ev == original);
+	}
+
+	CHECK(from_string("[1 1e999]", ev).ec == std::errc::result_out_of_range);
+	CHECK(ev == original);
+}
+
+TEST_CASE("operator>> Reads What operator<< Writes") {
+	auto const x = comp6771::euclidean_vector{3, 5.7, 8.39, 7.29};
+	auto const y = comp6771::euclidean_vector(0);
+
+	auto ss = std::stringstream{};
+	ss << x << "\n  " << y << ' ' << x;
+
+	auto ev = comp6771::euclidean_vector(1);
+	CHECK(ss >> ev);
+	CHECK(ev == x);
+	CHECK(ss >> ev);
+	CHECK(ev.dimensions() == 0);
+	CHECK(ss >> ev);
+	CHECK(ev == x);
+
+	CHECK_FALSE(ss >> ev);
+	CHECK(ev == x);
+
+	SECTION("Invalid text sets failbit") {
+		for (auto const text : {"[1 2", "(1 2)", "[1,2]"}) {
+			auto is = std::istringstream(text);
+			CHECK_FALSE(is >> ev);
+			CHECK(ev == x);
+		}
+	}
+}
+
+TEST_CASE("parse_vectors Reads Many Vectors") {
+	auto text = std::string();
+	auto expected = std::vector<comp6771::euclidean_vector>();
+	for (auto i = 0; i < 100000; ++i) {
+		auto const ev = comp6771::euclidean_vector{static_cast<double>(i),
+		                                           -0.5 * i,
+		                                           std::sqrt(static_cast<double>(i)),
+		                                           1e-3 / (i + 1)};
+		text += to_string(ev);
+		text += i % 7 == 0 ? "\n" : " ";
+		expected.push_back(ev);
+	}
+	REQUIRE(text.size() > 2 * (std::size_t{1} << 20U));
+
+	auto pool = comp6771::thread_pool(4);
+	auto const batch = comp6771::parse_vectors(text, pool);
+	REQUIRE(batch.size() == static_cast<int>(expected.size()));
+	REQUIRE(batch.dimensions() == 4);
+	for (auto i = 0; i < batch.size(); ++i) {
+		auto oss = std::ostringstream{};
+		oss << batch[i];
+		REQUIRE(oss.str() == to_string(expected[static_cast<std::size_t>(i)]));
+	}
+
+	SECTION("The first error in the text is reported") {
+		text[text.size() - 10] = ',';
+		text.insert(text.find('[', std::size_t{1} << 20U), "[1 2 3] ");
+		CHECK_THROWS_MATCHES(comp6771::parse_vectors(text, pool),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(4) and RHS(3) do not match"));
+	}
+}
+
+TEST_CASE("parse_vectors Edge Cases") {
+	auto const empty = comp6771::parse_vectors(" \n\t");
+	CHECK(empty.empty());
+	CHECK(empty.dimensions() == 0);
+
+	auto const batch = comp6771::parse_vectors("[1 2] [3 4]\n");
+	REQUIRE(batch.size() == 2);
+	CHECK(batch[1][0] == 3);
+
+	CHECK_THROWS_MATCHES(comp6771::parse_vectors("[1 2]\n[3 4] x"),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Text at offset 12 is not a valid euclidean_vector"));
+	CHECK_THROWS_MATCHES(comp6771::parse_vectors("[1 2] [3]"),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(2) and RHS(1) do not match"));
+}
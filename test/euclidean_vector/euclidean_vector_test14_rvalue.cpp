@@ -0,0 +1,105 @@
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/testing/counting_resource.hpp"
+
+#include <catch2/catch.hpp>
+#include <utility>
+
+/*
+    Tests in this file test that arithmetic on a temporary euclidean_vector reuses its storage.
+
+    These tests assume that the constructors, the compound assignment operators and operator== are
+    correct.
+
+    Rational: Reusing storage is only observable through what is allocated, so each test counts
+    allocations from a memory resource, and checks the result against the same arithmetic on
+    vectors that are not temporaries. Vectors of 4 dimensions or less do not allocate at all, so
+    the tests use 5 dimensions.
+*/
+
+namespace {
+	using comp6771::testing::counting_resource;
+} // namespace
+
+TEST_CASE("Arithmetic On Temporaries Reuses Their Storage") {
+	auto resource = counting_resource();
+	auto const a = comp6771::euclidean_vector({1, 2, 3, 4, 5}, &resource);
+	auto const b = comp6771::euclidean_vector({5, 4, 3, 2, 1}, &resource);
+	auto const c = comp6771::euclidean_vector({-1, 0, 1, 0, -1}, &resource);
+	auto const temporary = [&] { return comp6771::euclidean_vector(a, &resource); };
+	auto const before = resource.allocations();
+
+	SECTION("A temporary on the left") {
+		auto const sum = temporary() + b;
+		auto const difference = temporary() - b;
+		auto const product = temporary() * 2;
+		auto const quotient = temporary() / 2;
+		CHECK(resource.allocations() == before + 4);
+
+		CHECK(sum == comp6771::euclidean_vector(a + b));
+		CHECK(difference == comp6771::euclidean_vector(a - b));
+		CHECK(product == comp6771::euclidean_vector(a * 2));
+		CHECK(quotient == comp6771::euclidean_vector(a / 2));
+		CHECK(sum.get_allocator().resource() == &resource);
+	}
+
+	SECTION("A temporary on the right") {
+		auto const sum = b + temporary();
+		auto const difference = b - temporary();
+		auto const from_expression = (b * 2) - temporary();
+		CHECK(resource.allocations() == before + 3);
+
+		CHECK(sum == comp6771::euclidean_vector(b + a));
+		CHECK(difference == comp6771::euclidean_vector(b - a));
+		CHECK(from_expression == comp6771::euclidean_vector(b * 2 - a));
+	}
+
+	SECTION("Temporaries on both sides") {
+		auto const sum = temporary() + temporary();
+		auto const difference = temporary() - temporary();
+		CHECK(resource.allocations() == before + 4);
+		CHECK(sum == comp6771::euclidean_vector(a * 2));
+		CHECK(difference == comp6771::euclidean_vector(a - a));
+	}
+
+	SECTION("A chain allocates once") {
+		auto const result = ((temporary() + b) * 2 - c) / 4;
+		CHECK(resource.allocations() == before + 1);
+		CHECK(result == comp6771::euclidean_vector(((a + b) * 2 - c) / 4));
+	}
+
+	SECTION("Unary operators and unit") {
+		auto const negated = -temporary();
+		auto const plus = +temporary();
+		auto const normalised = comp6771::unit(temporary());
+		CHECK(resource.allocations() == before + 3);
+
+		CHECK(negated == comp6771::euclidean_vector(-a));
+		CHECK(plus == a);
+		CHECK(normalised == comp6771::unit(a));
+	}
+
+	SECTION("Moved vectors") {
+		auto x = comp6771::euclidean_vector(a, &resource);
+		auto const* const storage = &std::as_const(x)[0];
+		auto const result = std::move(x) + b;
+		CHECK(&result[0] == storage);
+		CHECK(resource.allocations() == before + 1);
+	}
+
+	SECTION("Errors are the same as for other operands") {
+		auto const short_vector = comp6771::euclidean_vector(3);
+		CHECK_THROWS_MATCHES(temporary() + short_vector,
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(5) and RHS(3) do not match"));
+		CHECK_THROWS_MATCHES(short_vector - temporary(),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(5) do not match"));
+		CHECK_THROWS_MATCHES(temporary() / 0,
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid vector division by 0"));
+		CHECK_THROWS_MATCHES(comp6771::unit(comp6771::euclidean_vector(5, 0.0)),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("euclidean_vector with zero euclidean normal "
+		                                              "does not have a unit vector"));
+	}
+}
@@ -0,0 +1,182 @@
+#include "comp6771/euclidean_vector.hpp"
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <concepts>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+    Tests in this file test basic_euclidean_vector<float>, and mixing it with euclidean_vector.
+
+    These tests assume that euclidean_vector is correct, as every test checks a float vector
+    against the same operation on doubles.
+
+    Rational: float vectors share their implementation with euclidean_vector, so these tests focus
+    on what the element type changes: the type of each magnitude and expression, reductions that
+    accumulate in double rather than float, explicit conversions that round each magnitude, and
+    mixed expressions that widen to double.
+*/
+
+using float_vector = comp6771::basic_euclidean_vector<float>;
+
+TEST_CASE("Element Types") {
+	SECTION("euclidean_vector holds doubles") {
+		STATIC_REQUIRE(std::same_as<comp6771::euclidean_vector, comp6771::basic_euclidean_vector<double>>);
+		STATIC_REQUIRE(std::same_as<comp6771::euclidean_vector::value_type, double>);
+	}
+
+	SECTION("Expressions of floats are evaluated in float") {
+		auto const a = float_vector{1, 2, 3};
+		STATIC_REQUIRE(std::same_as<decltype(a[0]), float const&>);
+		STATIC_REQUIRE(std::same_as<decltype((a + a)[0]), float>);
+		STATIC_REQUIRE(std::same_as<decltype((a * 2)[0]), float>);
+		STATIC_REQUIRE(std::same_as<decltype((-a)[0]), float>);
+	}
+
+	SECTION("Mixed expressions are evaluated in double") {
+		auto const a = float_vector{1, 2, 3};
+		auto const b = comp6771::euclidean_vector{1, 2, 3};
+		STATIC_REQUIRE(std::same_as<decltype((a + b)[0]), double>);
+		STATIC_REQUIRE(std::same_as<decltype((b - a * 2)[0]), double>);
+	}
+
+	SECTION("Converting between element types is explicit") {
+		STATIC_REQUIRE(std::is_constructible_v<float_vector, comp6771::euclidean_vector>);
+		STATIC_REQUIRE(not std::is_convertible_v<comp6771::euclidean_vector, float_vector>);
+		STATIC_REQUIRE(not std::is_convertible_v<float_vector, comp6771::euclidean_vector>);
+	}
+}
+
+TEST_CASE("Float Vectors") {
+	auto a = float_vector{1.5F, -2.0F, 0.25F};
+	auto const b = float_vector{0.5F, 4.0F, -0.25F};
+
+	SECTION("Construction") {
+		CHECK(float_vector().dimensions() == 1);
+		CHECK(float_vector(3, 2.5F) == float_vector{2.5F, 2.5F, 2.5F});
+
+		auto const magnitudes = std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8, 9};
+		auto const v = float_vector(magnitudes.begin(), magnitudes.end());
+		CHECK(static_cast<std::vector<float>>(v) == magnitudes);
+	}
+
+	SECTION("Arithmetic") {
+		CHECK(float_vector(a + b) == float_vector{2, 2, 0});
+		CHECK(float_vector(a - b) == float_vector{1, -6, 0.5F});
+		CHECK(float_vector(a * 2) == float_vector{3, -4, 0.5F});
+		CHECK(float_vector(a / 2) == float_vector{0.75F, -1, 0.125F});
+		CHECK(float_vector(-a) == float_vector{-1.5F, 2, -0.25F});
+
+		a += b;
+		CHECK(a == float_vector{2, 2, 0});
+		CHECK_THROWS_WITH(a /= 0, "Invalid vector division by 0");
+		CHECK_THROWS_WITH(a += float_vector(2), "Dimensions of LHS(3) and RHS(2) do not match");
+	}
+
+	SECTION("Factors out of float's range") {
+		// Rounding 1e-50 to float gives 0, and 1e39 gives infinity, so scaling by either would
+		// replace each magnitude rather than round it
+		auto const out_of_range = "Invalid vector scale by a factor out of range";
+		auto v = float_vector{0, 1};
+		CHECK_THROWS_WITH(v /= 1e-50, out_of_range);
+		CHECK_THROWS_WITH(v *= 1e39, out_of_range);
+		CHECK_THROWS_WITH(v *= 1e-50, out_of_range);
+		CHECK_THROWS_WITH(v / 1e39, out_of_range);
+		CHECK_THROWS_WITH(v * 1e39, out_of_range);
+		CHECK(v == float_vector{0, 1});
+
+		auto const doubles = comp6771::euclidean_vector{0, 1};
+		CHECK(comp6771::euclidean_vector(doubles / 1e-50) == comp6771::euclidean_vector{0, 1e50});
+
+		// Infinity is not out of range, it is the same factor in float as in double
+		CHECK(float_vector(v / std::numeric_limits<double>::infinity()) == float_vector{0, 0});
+	}
+
+	SECTION("Temporaries") {
+		auto const sum = float_vector(a) + b;
+		STATIC_REQUIRE(std::same_as<decltype(sum), float_vector const>);
+		CHECK(sum == float_vector{2, 2, 0});
+		CHECK(unit(float_vector{3, 4}) == float_vector{0.6F, 0.8F});
+	}
+
+	SECTION("Members") {
+		CHECK(a.at(1) == -2.0F);
+		CHECK_THROWS_WITH(a.at(3), "Index 3 is not valid for this euclidean_vector object");
+	}
+
+	SECTION("Text") {
+		auto os = std::ostringstream();
+		os << a;
+		CHECK(os.str() == "[1.5 -2 0.25]");
+
+		auto is = std::istringstream("[0.1 2 -3]");
+		auto v = float_vector();
+		is >> v;
+		REQUIRE(is);
+		CHECK(v == float_vector{0.1F, 2, -3});
+	}
+}
+
+TEST_CASE("Float Reductions Accumulate In Double") {
+	// 1 + 2^-12 is exact in float, but its square needs 25 bits of mantissa
+	auto const magnitude = 1.0F + std::ldexp(1.0F, -12);
+	auto const square = 1.0 + std::ldexp(1.0, -11) + std::ldexp(1.0, -24);
+	auto const v = float_vector(1000, magnitude);
+
+	SECTION("dot") {
+		CHECK(comp6771::dot(v, v) == 1000 * square);
+	}
+
+	SECTION("euclidean_norm") {
+		CHECK(comp6771::euclidean_norm(v) == std::sqrt(1000 * square));
+	}
+
+	SECTION("Expressions") {
+		CHECK(comp6771::euclidean_norm(v * 1) == std::sqrt(1000 * square));
+		CHECK(comp6771::dot(v * 1, v) == 1000 * square);
+	}
+
+	SECTION("Mixed precision") {
+		auto const w = comp6771::euclidean_vector(1000, 2.0);
+		CHECK(comp6771::dot(v, w) == 2000 * static_cast<double>(magnitude));
+		CHECK(comp6771::dot(w, v) == 2000 * static_cast<double>(magnitude));
+	}
+}
+
+TEST_CASE("Converting Between Element Types") {
+	auto const size = GENERATE(0, 3, 100);
+	auto doubles = comp6771::euclidean_vector(size);
+	for (auto i = 0; i < size; ++i) {
+		doubles[i] = 1.0 / (i + 3);
+	}
+
+	SECTION("Rounds each magnitude to float") {
+		auto const floats = float_vector(doubles);
+		REQUIRE(floats.dimensions() == size);
+		for (auto i = 0; i < size; ++i) {
+			CHECK(floats[i] == static_cast<float>(doubles[i]));
+		}
+	}
+
+	SECTION("Widening is exact") {
+		auto const floats = float_vector(doubles);
+		auto const widened = comp6771::euclidean_vector(floats);
+		for (auto i = 0; i < size; ++i) {
+			CHECK(widened[i] == static_cast<double>(floats[i]));
+		}
+	}
+
+	SECTION("Mixed expressions convert explicitly") {
+		auto const floats = float_vector(doubles);
+		auto const sum = comp6771::euclidean_vector(doubles + floats);
+		auto const rounded = float_vector(doubles + floats);
+		for (auto i = 0; i < size; ++i) {
+			CHECK(sum[i] == doubles[i] + static_cast<double>(floats[i]));
+			CHECK(rounded[i] == static_cast<float>(sum[i]));
+		}
+	}
+}
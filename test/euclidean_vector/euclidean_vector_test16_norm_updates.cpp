@@ -0,0 +1,178 @@
+#include "comp6771/euclidean_vector.hpp"
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/*
+    Tests in this file test that euclidean_norm stays correct as a vector changes after its norm
+    has been computed, through the reference returned by the mutable operator[] and at(), scaling,
+    and compound assignment.
+
+    These tests assume that the constructors and the const operator[] are correct.
+
+    Rational: The squared norm is updated rather than computed again, so every test compares it
+    against a norm computed from scratch. Updates round, so the test for drift makes many of them,
+    including ones that cancel almost all of the norm, where rounding matters most.
+*/
+
+namespace {
+	template<typename T>
+	auto exact_norm(comp6771::basic_euclidean_vector<T> const& v) -> double {
+		auto const magnitudes = static_cast<std::vector<T>>(v);
+		auto sum_of_squares = 0.0;
+		for (auto const magnitude : magnitudes) {
+			sum_of_squares += static_cast<double>(magnitude) * static_cast<double>(magnitude);
+		}
+		return std::sqrt(sum_of_squares);
+	}
+
+	auto make_vector(int dimensions) -> comp6771::euclidean_vector {
+		auto v = comp6771::euclidean_vector(dimensions);
+		for (auto i = 0; i < dimensions; ++i) {
+			v[i] = 0.25 * (i % 7) - 1;
+		}
+		return v;
+	}
+} // namespace
+
+TEST_CASE("Writing Through A Reference") {
+	auto v = comp6771::euclidean_vector{3, 4, 12};
+	REQUIRE(comp6771::euclidean_norm(v) == 13);
+
+	SECTION("References behave like the magnitude") {
+		STATIC_REQUIRE(std::same_as<decltype(v[0]), comp6771::euclidean_vector::reference>);
+		STATIC_REQUIRE(std::same_as<decltype(v.at(0)), comp6771::euclidean_vector::reference>);
+
+		auto r = v[1];
+		r = 5;
+		CHECK(v[1] == 5);
+		CHECK(static_cast<double>(r) == 5);
+
+		v[0] = v[2];
+		CHECK(v[0] == 12);
+		CHECK(v[2] == 12);
+	}
+
+	SECTION("Assignment") {
+		v[2] = 0;
+		CHECK(comp6771::euclidean_norm(v) == 5);
+		v.at(0) = 0;
+		v.at(1) = 0;
+		CHECK(comp6771::euclidean_norm(v) == 0);
+		v[1] = -2;
+		CHECK(comp6771::euclidean_norm(v) == 2);
+	}
+
+	SECTION("Compound assignment") {
+		v[0] += 1;
+		v[1] -= 1;
+		v[2] *= 2;
+		CHECK(comp6771::euclidean_norm(v) == std::sqrt(16 + 9 + 576));
+		v[2] /= 4;
+		CHECK(comp6771::euclidean_norm(v) == std::sqrt(16 + 9 + 36));
+	}
+
+	SECTION("Float vectors") {
+		auto f = comp6771::basic_euclidean_vector<float>{3, 4};
+		REQUIRE(comp6771::euclidean_norm(f) == 5);
+		f[0] = 0.1F;
+		CHECK(comp6771::euclidean_norm(f) == Approx(exact_norm(f)).epsilon(1e-12));
+	}
+}
+
+TEST_CASE("Scaling") {
+	auto const dimensions = GENERATE(3, 100, 5000);
+	auto v = make_vector(dimensions);
+	auto const before = comp6771::euclidean_norm(v);
+
+	SECTION("By a power of two is exact") {
+		v *= -4;
+		CHECK(comp6771::euclidean_norm(v) == 4 * before);
+		v /= 8;
+		CHECK(comp6771::euclidean_norm(v) == before / 2);
+		v = -std::move(v);
+		CHECK(comp6771::euclidean_norm(v) == before / 2);
+	}
+
+	SECTION("By anything else") {
+		v *= 3.7;
+		CHECK(comp6771::euclidean_norm(v) == Approx(exact_norm(v)).epsilon(1e-12));
+		v /= 0.3;
+		CHECK(comp6771::euclidean_norm(v) == Approx(exact_norm(v)).epsilon(1e-12));
+	}
+
+	SECTION("By zero") {
+		v *= 0;
+		CHECK(comp6771::euclidean_norm(v) == 0);
+		v[0] = 2;
+		CHECK(comp6771::euclidean_norm(v) == 2);
+	}
+
+	SECTION("Float vectors round each magnitude") {
+		auto f = comp6771::basic_euclidean_vector<float>(v);
+		REQUIRE(comp6771::euclidean_norm(f) == Approx(before).epsilon(1e-6));
+		f *= 3.7;
+		CHECK(comp6771::euclidean_norm(f) == Approx(exact_norm(f)).epsilon(1e-12));
+	}
+}
+
+TEST_CASE("Compound Assignment Keeps The Norm") {
+	auto const dimensions = GENERATE(3, 100, 5000);
+	auto v = make_vector(dimensions);
+	auto const w = make_vector(dimensions) * 0.5;
+	REQUIRE(comp6771::euclidean_norm(v) == Approx(exact_norm(v)));
+
+	SECTION("Vectors") {
+		auto const u = comp6771::euclidean_vector(w);
+		v += u;
+		CHECK(comp6771::euclidean_norm(v) == Approx(exact_norm(v)).epsilon(1e-14));
+		v -= u;
+		v -= u;
+		CHECK(comp6771::euclidean_norm(v) == Approx(exact_norm(v)).epsilon(1e-14));
+	}
+
+	SECTION("Expressions") {
+		v += w;
+		CHECK(comp6771::euclidean_norm(v) == Approx(exact_norm(v)).epsilon(1e-14));
+		v -= w * 3;
+		CHECK(comp6771::euclidean_norm(v) == Approx(exact_norm(v)).epsilon(1e-14));
+	}
+
+	SECTION("Vectors whose norm is not kept") {
+		auto x = make_vector(dimensions);
+		x += w;
+		CHECK(comp6771::euclidean_norm(x) == Approx(exact_norm(x)).epsilon(1e-14));
+	}
+}
+
+TEST_CASE("Drift Is Bounded") {
+	SECTION("Cancelling almost all of the norm") {
+		auto v = comp6771::euclidean_vector{1e10, 1, 1};
+		REQUIRE(comp6771::euclidean_norm(v) == 1e10);
+		v[0] = 0;
+		CHECK(comp6771::euclidean_norm(v) == std::sqrt(2.0));
+	}
+
+	SECTION("Many updates") {
+		auto v = make_vector(64);
+		REQUIRE(comp6771::euclidean_norm(v) == Approx(exact_norm(v)));
+
+		auto engine = std::mt19937(6771);
+		auto index = std::uniform_int_distribution<int>(0, v.dimensions() - 1);
+		auto exponent = std::uniform_int_distribution<int>(-20, 20);
+		auto mantissa = std::uniform_real_distribution<double>(-1, 1);
+		for (auto i = 0; i < 20'000; ++i) {
+			v[index(engine)] = std::ldexp(mantissa(engine), exponent(engine));
+			auto const exact = exact_norm(v);
+			auto const norm = comp6771::euclidean_norm(v);
+			if (std::fabs(norm - exact) > 1e-10 * exact) {
+				FAIL("After " << i + 1 << " updates, the norm is " << norm << " rather than " << exact);
+			}
+		}
+	}
+}
@@ -0,0 +1,124 @@
+#include "comp6771/euclidean_vector.hpp"
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/*
+    Tests in this file test reading the norm of a const euclidean_vector from several threads at
+    once, and freezing norms before vectors are shared.
+
+    These tests assume that the constructors, operator[] and euclidean_norm are correct on one
+    thread.
+
+    Rational: A race on the norm cache does not fail on its own, so these tests are meant to be run
+    under ThreadSanitizer as well; without it they check that every thread reads the same norm.
+    Freezing has to give exactly the norm a fresh vector would compute, even after updates that
+    may have drifted.
+*/
+
+namespace {
+	constexpr auto threads = 8;
+
+	auto make_vector(int dimensions, double seed) -> comp6771::euclidean_vector {
+		auto v = comp6771::euclidean_vector(dimensions);
+		for (auto i = 0; i < dimensions; ++i) {
+			v[i] = seed * (i % 11) - 2;
+		}
+		return v;
+	}
+
+	// The norm of a vector with the same magnitudes, computed from scratch
+	auto fresh_norm(comp6771::euclidean_vector const& v) -> double {
+		return comp6771::euclidean_norm(comp6771::euclidean_vector(v * 1));
+	}
+
+	// Calls <body>(thread) on <threads> threads at once
+	template<typename F>
+	auto on_threads(F body) -> void {
+		auto workers = std::vector<std::thread>();
+		for (auto t = 0; t < threads; ++t) {
+			workers.emplace_back(body, t);
+		}
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+} // namespace
+
+TEST_CASE("Concurrent Readers") {
+	auto const dimensions = GENERATE(3, 1000);
+	auto const v = make_vector(dimensions, 0.5);
+	auto const expected = fresh_norm(v);
+
+	auto norms = std::vector<double>(threads);
+	on_threads([&](int const t) {
+		for (auto i = 0; i < 100; ++i) {
+			norms[static_cast<std::size_t>(t)] = comp6771::euclidean_norm(v);
+		}
+	});
+
+	for (auto const norm : norms) {
+		CHECK(norm == expected);
+	}
+	CHECK(comp6771::euclidean_norm(v) == expected);
+}
+
+TEST_CASE("Freezing Norms") {
+	SECTION("freeze_norm computes the norm exactly") {
+		auto v = make_vector(1000, 0.5);
+		CHECK(v.freeze_norm() == fresh_norm(v));
+		CHECK(comp6771::euclidean_norm(v) == fresh_norm(v));
+	}
+
+	SECTION("Updated norms are computed again") {
+		auto v = make_vector(1000, 0.5);
+		REQUIRE(comp6771::euclidean_norm(v) == fresh_norm(v));
+		for (auto i = 0; i < 100; ++i) {
+			v[i] = 0.1 * i;
+		}
+		v *= 1.1;
+		CHECK(v.freeze_norm() == fresh_norm(v));
+	}
+
+	SECTION("Copies keep a frozen norm") {
+		auto v = make_vector(1000, 0.5);
+		v.freeze_norm();
+		auto const copy = v;
+		CHECK(comp6771::euclidean_norm(copy) == fresh_norm(v));
+	}
+
+	SECTION("A shared dataset") {
+		auto dataset = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < 100; ++i) {
+			dataset.push_back(make_vector(50 + i, 0.01 * i));
+		}
+		comp6771::freeze_norms(dataset);
+
+		auto const& shared = dataset;
+		auto mismatches = std::vector<int>(threads);
+		on_threads([&](int const t) {
+			for (auto const& v : shared) {
+				if (comp6771::euclidean_norm(v) != fresh_norm(v)) {
+					++mismatches[static_cast<std::size_t>(t)];
+				}
+			}
+		});
+
+		for (auto const m : mismatches) {
+			CHECK(m == 0);
+		}
+	}
+
+	SECTION("Float vectors") {
+		auto dataset = std::vector<comp6771::basic_euclidean_vector<float>>(
+		   10,
+		   comp6771::basic_euclidean_vector<float>{3, 4});
+		comp6771::freeze_norms(dataset);
+		for (auto const& v : dataset) {
+			CHECK(comp6771::euclidean_norm(v) == 5);
+		}
+	}
+}
@@ -0,0 +1,109 @@
+#include "comp6771/euclidean_vector.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/*
+    Tests in this file test distance, squared_distance, cosine_similarity, manhattan and
+    chebyshev, which compare two vectors in a single pass.
+
+    These tests assume that the constructors, subtraction, dot and euclidean_norm are correct.
+
+    Rational: Each function replaces an expression built from the other operations, so each is
+    compared with that expression. Sizes are chosen to cover vectors stored inline, the tail after
+    the last full set of accumulators, and vectors long enough to be split between threads by the
+    expressions they replace. cosine_similarity takes a shorter path when both norms are cached,
+    so both paths are checked.
+*/
+
+namespace {
+	template<typename T>
+	auto make_vector(int dimensions, double seed) -> comp6771::basic_euclidean_vector<T> {
+		auto v = comp6771::basic_euclidean_vector<T>(dimensions);
+		for (auto i = 0; i < dimensions; ++i) {
+			v[i] = static_cast<T>(seed * (i % 13) - 3);
+		}
+		return v;
+	}
+
+	template<typename T>
+	auto differences(comp6771::basic_euclidean_vector<T> const& x,
+	                 comp6771::basic_euclidean_vector<T> const& y) -> std::vector<double> {
+		auto result = std::vector<double>();
+		for (auto i = 0; i < x.dimensions(); ++i) {
+			result.push_back(std::fabs(static_cast<double>(x[i]) - static_cast<double>(y[i])));
+		}
+		return result;
+	}
+} // namespace
+
+TEMPLATE_TEST_CASE("Fused Distances", "", double, float) {
+	auto const dimensions = GENERATE(0, 3, 100, 5000, 200'000);
+	auto const x = make_vector<TestType>(dimensions, 0.5);
+	auto const y = make_vector<TestType>(dimensions, -0.25);
+	auto const d = differences(x, y);
+
+	SECTION("distance and squared_distance") {
+		auto const expected = comp6771::euclidean_norm(x - y);
+		CHECK(comp6771::distance(x, y) == Approx(expected).epsilon(1e-12));
+		CHECK(comp6771::squared_distance(x, y) == Approx(expected * expected).epsilon(1e-12));
+		CHECK(comp6771::distance(x, x) == 0);
+	}
+
+	SECTION("manhattan") {
+		auto expected = 0.0;
+		for (auto const difference : d) {
+			expected += difference;
+		}
+		CHECK(comp6771::manhattan(x, y) == Approx(expected).epsilon(1e-12));
+		CHECK(comp6771::manhattan(x, x) == 0);
+	}
+
+	SECTION("chebyshev") {
+		auto const expected = d.empty() ? 0.0 : *std::max_element(d.begin(), d.end());
+		CHECK(comp6771::chebyshev(x, y) == expected);
+		CHECK(comp6771::chebyshev(y, x) == expected);
+	}
+
+	SECTION("cosine_similarity") {
+		auto const norms = comp6771::euclidean_norm(x) * comp6771::euclidean_norm(y);
+		auto const expected = norms == 0 ? 0 : comp6771::dot(x, y) / norms;
+
+		// euclidean_norm above has cached both norms
+		CHECK(comp6771::cosine_similarity(x, y) == Approx(expected).epsilon(1e-12));
+
+		auto const uncached_x = comp6771::basic_euclidean_vector<TestType>(x * 1);
+		auto const uncached_y = comp6771::basic_euclidean_vector<TestType>(y * 1);
+		CHECK(comp6771::cosine_similarity(uncached_x, uncached_y) == Approx(expected).epsilon(1e-12));
+	}
+}
+
+TEST_CASE("Cosine Similarity Bounds") {
+	auto const x = comp6771::euclidean_vector{0.1, 0.2, 0.3};
+
+	CHECK(comp6771::cosine_similarity(x, x) == Approx(1));
+	CHECK(comp6771::cosine_similarity(x, comp6771::euclidean_vector(x * 3)) <= 1);
+	CHECK(comp6771::cosine_similarity(x, comp6771::euclidean_vector(-x)) >= -1);
+	CHECK(comp6771::cosine_similarity(comp6771::euclidean_vector{1, 0}, comp6771::euclidean_vector{0, 2})
+	      == 0);
+
+	SECTION("Vectors with no magnitude") {
+		auto const zero = comp6771::euclidean_vector(3);
+		CHECK(comp6771::cosine_similarity(x, zero) == 0);
+		CHECK(comp6771::cosine_similarity(zero, zero) == 0);
+	}
+}
+
+TEST_CASE("Distances Check Dimensions") {
+	auto const x = comp6771::euclidean_vector(3);
+	auto const y = comp6771::euclidean_vector(4);
+
+	CHECK_THROWS_WITH(comp6771::distance(x, y), "Dimensions of LHS(3) and RHS(4) do not match");
+	CHECK_THROWS_AS(comp6771::squared_distance(x, y), comp6771::euclidean_vector_error);
+	CHECK_THROWS_AS(comp6771::cosine_similarity(x, y), comp6771::euclidean_vector_error);
+	CHECK_THROWS_AS(comp6771::manhattan(x, y), comp6771::euclidean_vector_error);
+	CHECK_THROWS_AS(comp6771::chebyshev(x, y), comp6771::euclidean_vector_error);
+}
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <catch2/catch.hpp>
 
+#include <cmath>
 #include <vector>
 
 /*
@@ -37,6 +38,16 @@ TEST_CASE("Norm") {
 			CHECK(comp6771::euclidean_norm(ev) == Approx(615.55509836407));
 		}
 	}
+
+	SECTION("Squared norm is exact, whether or not it is cached") {
+		// sqrt(3) squared is not 3
+		auto const ev = comp6771::euclidean_vector{1, -1, 1};
+
+		CHECK(comp6771::squared_euclidean_norm(ev) == 3);
+		CHECK(comp6771::squared_euclidean_norm(ev) == 3);
+		CHECK(comp6771::euclidean_norm(ev) == std::sqrt(3.0));
+		CHECK(comp6771::squared_euclidean_norm(comp6771::euclidean_vector(0)) == 0);
+	}
 }
 
 /*
@@ -0,0 +1,119 @@
+#include "comp6771/euclidean_vector.hpp"
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <vector>
+
+/*
+    Tests in this file test that the arithmetic friends are lazily evaluated, and that the
+    resulting expressions behave exactly like the euclidean_vector they evaluate to.
+
+    These tests assume that the constructors and casting to std::vector are correct.
+
+    Rational: The expressions are an implementation detail of the arithmetic operators, so the
+    only observable behaviour is the value they produce wherever a euclidean_vector is expected,
+    and when they throw.
+*/
+
+/*
+   Test cases:
+   - An expression evaluates to the expected magnitudes when converted to a euclidean_vector
+   - An expression can be assigned to a vector that it reads from
+   - An expression can be assigned to a vector of a different dimension
+
+   Rational: Assignment reuses the storage of the target, so the target being one of the
+   operands must still produce the right result.
+*/
+TEST_CASE("Expression Evaluation") {
+	auto const ev1 = comp6771::euclidean_vector{2.54, 7.98, -3.76, 4.25};
+	auto const ev2 = comp6771::euclidean_vector{-8.964, 5.2, 13.19, -5.2};
+
+	SECTION("Convert to euclidean_vector") {
+		comp6771::euclidean_vector const result = ev1 * 0.3 + ev2 / -2.5;
+
+		CHECK(result.dimensions() == 4);
+		CHECK_THAT(static_cast<std::vector<double>>(result),
+		           Catch::Approx(std::vector<double>{4.3476, 0.314, -6.404, 3.355}));
+	}
+
+	SECTION("Unary minus of an expression") {
+		comp6771::euclidean_vector const result = -(ev1 - ev2);
+
+		CHECK_THAT(static_cast<std::vector<double>>(result),
+		           Catch::Approx(std::vector<double>{-11.504, -2.78, 16.95, -9.45}));
+	}
+
+	SECTION("Assign to an operand") {
+		auto ev = ev1;
+		ev = ev + ev2 * 2;
+
+		CHECK_THAT(static_cast<std::vector<double>>(ev),
+		           Catch::Approx(std::vector<double>{-15.388, 18.38, 22.62, -6.15}));
+	}
+
+	SECTION("Assign to a vector of a different dimension") {
+		auto ev = comp6771::euclidean_vector(2, 1.0);
+		ev = ev1 - ev2;
+
+		CHECK(ev.dimensions() == 4);
+		CHECK_THAT(static_cast<std::vector<double>>(ev),
+		           Catch::Approx(std::vector<double>{11.504, 2.78, -16.95, 9.45}));
+	}
+
+	SECTION("Compound assignment") {
+		auto ev = ev1;
+		ev += ev2 * 2;
+		ev -= ev1 / 2;
+
+		CHECK_THAT(static_cast<std::vector<double>>(ev),
+		           Catch::Approx(std::vector<double>{-16.658, 14.39, 24.5, -8.275}));
+	}
+
+	SECTION("Output stream") {
+		auto oss = std::ostringstream{};
+		oss << (ev1 + ev2);
+		CHECK(oss.str() == "[-6.424 13.18 9.43 -0.95]");
+	}
+}
+
+/*
+   Test cases:
+   - dot and euclidean_norm accept expressions directly
+   - The norm cache of a vector in an expression is untouched
+
+   Rational: These consume expressions without materialising them, so they should agree with
+   computing the same value on an evaluated vector.
+*/
+TEST_CASE("Expression Reductions") {
+	auto const ev1 = comp6771::euclidean_vector{1, 2, 3};
+	auto const ev2 = comp6771::euclidean_vector{4, -5, 6};
+
+	SECTION("Norm") {
+		CHECK(comp6771::euclidean_norm(ev1 + ev2) == Approx(10.723805294764));
+		CHECK(comp6771::euclidean_norm(ev1 * 2) == Approx(7.4833147735479));
+		CHECK(comp6771::euclidean_norm(ev1) == Approx(3.7416573867739));
+	}
+
+	SECTION("Dot product") {
+		CHECK(comp6771::dot(ev1 + ev2, ev1) == Approx(26));
+		CHECK(comp6771::dot(ev1, ev2 / 2) == Approx(6));
+		CHECK(comp6771::dot(-ev1, ev1 - ev2) == Approx(-2));
+	}
+}
+
+TEST_CASE("Expression Exceptions") {
+	auto const ev1 = comp6771::euclidean_vector{1, 2, 3};
+	auto const ev2 = comp6771::euclidean_vector{4, -5};
+
+	CHECK_THROWS_MATCHES(ev1 * 2 + ev2,
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not match"));
+
+	CHECK_THROWS_MATCHES(comp6771::dot(ev1 * 2, ev2),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not match"));
+
+	CHECK_THROWS_MATCHES((ev1 + ev1) / 0,
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Invalid vector division by 0"));
+}
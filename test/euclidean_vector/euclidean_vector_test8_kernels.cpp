@@ -0,0 +1,452 @@
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+/*
+    Tests in this file test the reduction kernels behind dot and euclidean_norm, and the
+    element-wise kernels behind the arithmetic operators.
+
+    Expected reductions are computed with std::inner_product, which is the serial reduction the
+    kernels replace. Element-wise kernels round each magnitude once, exactly as a serial loop does,
+    so they must match it exactly.
+
+    Rational: Every kernel the host supports must agree with the serial reduction, for sizes that
+    are and are not a multiple of the number of accumulators, since the tail is handled
+    separately from the main loop.
+*/
+
+namespace {
+	auto make_magnitudes(std::size_t size, double seed) -> std::vector<double> {
+		auto magnitudes = std::vector<double>(size);
+		for (auto i = std::size_t{0}; i < size; ++i) {
+			magnitudes[i] = seed * static_cast<double>(i % 17) - static_cast<double>(i % 5);
+		}
+		return magnitudes;
+	}
+} // namespace
+
+TEST_CASE("Kernel Selection") {
+	using comp6771::kernels::instruction_set;
+
+	SECTION("The scalar kernel is always supported") {
+		CHECK(comp6771::kernels::is_supported(instruction_set::scalar));
+	}
+
+	SECTION("The selected kernel is supported") {
+		CHECK(comp6771::kernels::is_supported(comp6771::kernels::selected_instruction_set()));
+	}
+
+	SECTION("Names") {
+		CHECK(comp6771::kernels::name(instruction_set::scalar) == "scalar");
+		CHECK(comp6771::kernels::name(instruction_set::avx2) == "avx2");
+		CHECK(comp6771::kernels::name(instruction_set::avx512) == "avx512");
+	}
+}
+
+TEST_CASE("Kernels match a serial reduction") {
+	using comp6771::kernels::instruction_set;
+
+	auto const isa = GENERATE(instruction_set::scalar, instruction_set::avx2, instruction_set::avx512);
+	auto const size = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{31}, std::size_t{64},
+	                           std::size_t{1000});
+
+	auto const x = make_magnitudes(size, 0.25);
+	auto const y = make_magnitudes(size, -1.5);
+
+	auto const dot_exp = std::inner_product(x.begin(), x.end(), y.begin(), 0.0);
+	auto const squares_exp = std::inner_product(x.begin(), x.end(), x.begin(), 0.0);
+
+	if (comp6771::kernels::is_supported(isa)) {
+		CHECK(comp6771::kernels::dot(isa, x.data(), y.data(), size) == Approx(dot_exp));
+		CHECK(comp6771::kernels::sum_of_squares(isa, x.data(), size) == Approx(squares_exp));
+	}
+	else {
+		CHECK_THROWS_AS(comp6771::kernels::dot(isa, x.data(), y.data(), size),
+		                comp6771::euclidean_vector_error);
+	}
+}
+
+TEST_CASE("Compressed kernels match a serial reduction") {
+	using comp6771::kernels::instruction_set;
+
+	auto const isa = GENERATE(instruction_set::scalar, instruction_set::avx2, instruction_set::avx512);
+	auto const size = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{31}, std::size_t{64},
+	                           std::size_t{1000});
+
+	auto const x = make_magnitudes(size, 0.25);
+	auto const y = make_magnitudes(size, -1.5);
+
+	// Every magnitude of <y> is exact in each of the compressed types
+	auto floats = std::vector<float>(size);
+	auto bytes = std::vector<std::int8_t>(size);
+	auto halves = std::vector<std::uint16_t>(size);
+	auto bfloats = std::vector<std::uint16_t>(size);
+	for (auto i = std::size_t{0}; i < size; ++i) {
+		floats[i] = static_cast<float>(y[i]);
+		bytes[i] = static_cast<std::int8_t>(y[i] * 2);
+		halves[i] = comp6771::kernels::to_float16(floats[i]);
+		bfloats[i] = comp6771::kernels::to_bfloat16(floats[i]);
+	}
+
+	auto const dot_exp = std::inner_product(x.begin(), x.end(), y.begin(), 0.0);
+
+	if (comp6771::kernels::is_supported(isa)) {
+		CHECK(comp6771::kernels::dot(isa, x.data(), floats.data(), size) == Approx(dot_exp));
+		CHECK(comp6771::kernels::dot(isa, x.data(), bytes.data(), size) == Approx(2 * dot_exp));
+		CHECK(comp6771::kernels::dot_float16(isa, x.data(), halves.data(), size) == Approx(dot_exp));
+		CHECK(comp6771::kernels::dot_bfloat16(isa, x.data(), bfloats.data(), size) == Approx(dot_exp));
+	}
+	else {
+		CHECK_THROWS_AS(comp6771::kernels::dot(isa, x.data(), floats.data(), size),
+		                comp6771::euclidean_vector_error);
+		CHECK_THROWS_AS(comp6771::kernels::dot_float16(isa, x.data(), halves.data(), size),
+		                comp6771::euclidean_vector_error);
+	}
+
+	CHECK(comp6771::kernels::dot(x.data(), floats.data(), size) == Approx(dot_exp));
+	CHECK(comp6771::kernels::dot_float16(x.data(), halves.data(), size) == Approx(dot_exp));
+}
+
+TEST_CASE("Float kernels accumulate in double") {
+	using comp6771::kernels::instruction_set;
+
+	auto const isa = GENERATE(instruction_set::scalar, instruction_set::avx2, instruction_set::avx512);
+	auto const size = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{31}, std::size_t{64},
+	                           std::size_t{1000});
+
+	// Every magnitude is exact in float, and every product and sum is exact in double
+	auto const x = make_magnitudes(size, 0.25);
+	auto const y = make_magnitudes(size, -1.5);
+	auto x_floats = std::vector<float>(size);
+	auto y_floats = std::vector<float>(size);
+	for (auto i = std::size_t{0}; i < size; ++i) {
+		x_floats[i] = static_cast<float>(x[i]);
+		y_floats[i] = static_cast<float>(y[i]);
+	}
+
+	auto const dot_exp = std::inner_product(x.begin(), x.end(), y.begin(), 0.0);
+	auto const squares_exp = std::inner_product(x.begin(), x.end(), x.begin(), 0.0);
+
+	if (comp6771::kernels::is_supported(isa)) {
+		CHECK(comp6771::kernels::dot(isa, x_floats.data(), y_floats.data(), size) == dot_exp);
+		CHECK(comp6771::kernels::sum_of_squares(isa, x_floats.data(), size) == squares_exp);
+
+		auto narrowed = std::vector<float>(size);
+		auto widened = std::vector<double>(size);
+		comp6771::kernels::convert(isa, x.data(), narrowed.data(), size);
+		comp6771::kernels::convert(isa, narrowed.data(), widened.data(), size);
+		CHECK(narrowed == x_floats);
+		CHECK(widened == x);
+	}
+	else {
+		CHECK_THROWS_AS(comp6771::kernels::dot(isa, x_floats.data(), y_floats.data(), size),
+		                comp6771::euclidean_vector_error);
+	}
+
+	CHECK(comp6771::kernels::dot(x_floats.data(), y_floats.data(), size) == dot_exp);
+}
+
+TEST_CASE("Float conversions round to nearest") {
+	using comp6771::kernels::instruction_set;
+
+	auto const isa = GENERATE(instruction_set::scalar, instruction_set::avx2, instruction_set::avx512);
+	auto const doubles = std::vector<double>{0.1,
+	                                         -1.0 / 3,
+	                                         1e300,
+	                                         -1e300,
+	                                         1e-50,
+	                                         std::numeric_limits<double>::infinity(),
+	                                         2.5,
+	                                         3.0,
+	                                         -0.0};
+	auto expected = std::vector<float>();
+	for (auto const d : doubles) {
+		expected.push_back(static_cast<float>(d));
+	}
+
+	if (comp6771::kernels::is_supported(isa)) {
+		auto narrowed = std::vector<float>(doubles.size());
+		comp6771::kernels::convert(isa, doubles.data(), narrowed.data(), doubles.size());
+		CHECK(narrowed == expected);
+	}
+}
+
+TEST_CASE("Gather kernels match a serial reduction") {
+	using comp6771::kernels::instruction_set;
+
+	auto const isa = GENERATE(instruction_set::scalar, instruction_set::avx2, instruction_set::avx512);
+	auto const size = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{31}, std::size_t{64},
+	                           std::size_t{1000});
+
+	// Every third magnitude of a dense vector three times as long
+	auto const x = make_magnitudes(size, 0.25);
+	auto const dense = make_magnitudes(3 * size, -1.5);
+	auto indices = std::vector<int>(size);
+	auto dot_exp = 0.0;
+	for (auto i = std::size_t{0}; i < size; ++i) {
+		indices[i] = static_cast<int>(3 * i + i % 3);
+		dot_exp += x[i] * dense[static_cast<std::size_t>(indices[i])];
+	}
+
+	if (comp6771::kernels::is_supported(isa)) {
+		CHECK(comp6771::kernels::dot_gather(isa, x.data(), indices.data(), size, dense.data())
+		      == Approx(dot_exp));
+	}
+	else {
+		CHECK_THROWS_AS(comp6771::kernels::dot_gather(isa, x.data(), indices.data(), size, dense.data()),
+		                comp6771::euclidean_vector_error);
+	}
+
+	CHECK(comp6771::kernels::dot_gather(x.data(), indices.data(), size, dense.data())
+	      == Approx(dot_exp));
+}
+
+TEST_CASE("Distance kernels match a serial reduction") {
+	using comp6771::kernels::instruction_set;
+
+	auto const isa = GENERATE(instruction_set::scalar, instruction_set::avx2, instruction_set::avx512);
+	auto const size = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{31}, std::size_t{64},
+	                           std::size_t{1000});
+
+	// Every magnitude is exact in float
+	auto const x = make_magnitudes(size, 0.25);
+	auto const y = make_magnitudes(size, -1.5);
+	auto x_floats = std::vector<float>(size);
+	auto y_floats = std::vector<float>(size);
+	auto squared_exp = 0.0;
+	auto manhattan_exp = 0.0;
+	auto chebyshev_exp = 0.0;
+	for (auto i = std::size_t{0}; i < size; ++i) {
+		x_floats[i] = static_cast<float>(x[i]);
+		y_floats[i] = static_cast<float>(y[i]);
+		squared_exp += (x[i] - y[i]) * (x[i] - y[i]);
+		manhattan_exp += std::fabs(x[i] - y[i]);
+		chebyshev_exp = std::max(chebyshev_exp, std::fabs(x[i] - y[i]));
+	}
+	auto const dot_exp = std::inner_product(x.begin(), x.end(), y.begin(), 0.0);
+	auto const x_exp = std::inner_product(x.begin(), x.end(), x.begin(), 0.0);
+	auto const y_exp = std::inner_product(y.begin(), y.end(), y.begin(), 0.0);
+
+	if (comp6771::kernels::is_supported(isa)) {
+		CHECK(comp6771::kernels::squared_distance(isa, x.data(), y.data(), size) == Approx(squared_exp));
+		CHECK(comp6771::kernels::manhattan(isa, x.data(), y.data(), size) == Approx(manhattan_exp));
+		CHECK(comp6771::kernels::chebyshev(isa, x.data(), y.data(), size) == chebyshev_exp);
+		CHECK(comp6771::kernels::squared_distance(isa, x_floats.data(), y_floats.data(), size)
+		      == Approx(squared_exp));
+		CHECK(comp6771::kernels::manhattan(isa, x_floats.data(), y_floats.data(), size)
+		      == Approx(manhattan_exp));
+		CHECK(comp6771::kernels::chebyshev(isa, x_floats.data(), y_floats.data(), size)
+		      == chebyshev_exp);
+
+		for (auto const products : {comp6771::kernels::dot_and_squares(isa, x.data(), y.data(), size),
+		                            comp6771::kernels::dot_and_squares(isa,
+		                                                               x_floats.data(),
+		                                                               y_floats.data(),
+		                                                               size)}) {
+			CHECK(products.xy == Approx(dot_exp));
+			CHECK(products.xx == Approx(x_exp));
+			CHECK(products.yy == Approx(y_exp));
+		}
+	}
+	else {
+		CHECK_THROWS_AS(comp6771::kernels::squared_distance(isa, x.data(), y.data(), size),
+		                comp6771::euclidean_vector_error);
+		CHECK_THROWS_AS(comp6771::kernels::chebyshev(isa, x_floats.data(), y_floats.data(), size),
+		                comp6771::euclidean_vector_error);
+		CHECK_THROWS_AS(comp6771::kernels::dot_and_squares(isa, x.data(), y.data(), size),
+		                comp6771::euclidean_vector_error);
+	}
+
+	CHECK(comp6771::kernels::squared_distance(x.data(), y.data(), size) == Approx(squared_exp));
+	CHECK(comp6771::kernels::chebyshev(x_floats.data(), y_floats.data(), size) == chebyshev_exp);
+	CHECK(comp6771::kernels::dot_and_squares(x.data(), y.data(), size).xy == Approx(dot_exp));
+}
+
+TEST_CASE("Tile kernels match a serial reduction") {
+	using comp6771::kernels::instruction_set;
+	using comp6771::kernels::tile_columns;
+	using comp6771::kernels::tile_rows;
+
+	auto const isa = GENERATE(instruction_set::scalar, instruction_set::avx2, instruction_set::avx512);
+	auto const depth = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{31}, std::size_t{64},
+	                            std::size_t{1000});
+
+	// Vector i of <a> and vector j of <b>, packed as dot_tile reads them
+	auto const a = make_magnitudes(tile_rows * depth, 0.25);
+	auto const b = make_magnitudes(tile_columns * depth, -1.5);
+	auto expected = std::vector<double>(tile_rows * tile_columns);
+	auto expected_distances = std::vector<double>(tile_rows * tile_columns);
+	for (auto k = std::size_t{0}; k < depth; ++k) {
+		for (auto i = std::size_t{0}; i < tile_rows; ++i) {
+			for (auto j = std::size_t{0}; j < tile_columns; ++j) {
+				auto const x = a[k * tile_rows + i];
+				auto const y = b[k * tile_columns + j];
+				expected[i * tile_columns + j] += x * y;
+				expected_distances[i * tile_columns + j] += (x - y) * (x - y);
+			}
+		}
+	}
+
+	auto tile = std::vector<double>(tile_rows * tile_columns, -1);
+	if (comp6771::kernels::is_supported(isa)) {
+		comp6771::kernels::dot_tile(isa, a.data(), b.data(), depth, tile.data());
+		for (auto i = std::size_t{0}; i < tile.size(); ++i) {
+			CHECK(tile[i] == Approx(expected[i]));
+		}
+	}
+	else {
+		CHECK_THROWS_AS(comp6771::kernels::dot_tile(isa, a.data(), b.data(), depth, tile.data()),
+		                comp6771::euclidean_vector_error);
+	}
+
+	comp6771::kernels::dot_tile(a.data(), b.data(), depth, tile.data());
+	for (auto i = std::size_t{0}; i < tile.size(); ++i) {
+		CHECK(tile[i] == Approx(expected[i]));
+	}
+
+	if (comp6771::kernels::is_supported(isa)) {
+		comp6771::kernels::squared_distance_tile(isa, a.data(), b.data(), depth, tile.data());
+		for (auto i = std::size_t{0}; i < tile.size(); ++i) {
+			CHECK(tile[i] == Approx(expected_distances[i]));
+		}
+	}
+	else {
+		CHECK_THROWS_AS(
+		   comp6771::kernels::squared_distance_tile(isa, a.data(), b.data(), depth, tile.data()),
+		   comp6771::euclidean_vector_error);
+	}
+
+	comp6771::kernels::squared_distance_tile(a.data(), b.data(), depth, tile.data());
+	for (auto i = std::size_t{0}; i < tile.size(); ++i) {
+		CHECK(tile[i] == Approx(expected_distances[i]));
+	}
+}
+
+TEST_CASE("Element-wise kernels match a serial loop") {
+	using comp6771::kernels::instruction_set;
+
+	auto const isa = GENERATE(instruction_set::scalar, instruction_set::avx2, instruction_set::avx512);
+	auto const size = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{3}, std::size_t{31},
+	                           std::size_t{1000});
+	// Starting part way into the storage exercises the unaligned prefix, and the magnitudes
+	// either side of [offset, offset + size) must not be written
+	auto const offset = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{3});
+	auto const padding = std::size_t{17};
+
+	auto const original = make_magnitudes(offset + size + padding, 0.3);
+	auto const other = make_magnitudes(offset + size + padding, -0.7);
+	auto const original_floats = std::vector<float>(original.begin(), original.end());
+	auto const other_floats = std::vector<float>(other.begin(), other.end());
+
+	auto expected_sum = original;
+	auto expected_difference = original;
+	auto expected_product = original;
+	auto expected_quotient = original;
+	auto expected_float_sum = original_floats;
+	auto expected_float_quotient = original_floats;
+	for (auto i = offset; i < offset + size; ++i) {
+		expected_sum[i] += other[i];
+		expected_difference[i] -= other[i];
+		expected_product[i] *= 0.1;
+		expected_quotient[i] /= 3.0;
+		expected_float_sum[i] += other_floats[i];
+		expected_float_quotient[i] /= 3.0F;
+	}
+
+	if (comp6771::kernels::is_supported(isa)) {
+		auto sum = original;
+		comp6771::kernels::add(isa, sum.data() + offset, other.data() + offset, size);
+		CHECK(sum == expected_sum);
+
+		auto difference = original;
+		comp6771::kernels::subtract(isa, difference.data() + offset, other.data() + offset, size);
+		CHECK(difference == expected_difference);
+
+		auto product = original;
+		comp6771::kernels::multiply(isa, product.data() + offset, 0.1, size);
+		CHECK(product == expected_product);
+
+		auto quotient = original;
+		comp6771::kernels::divide(isa, quotient.data() + offset, 3.0, size);
+		CHECK(quotient == expected_quotient);
+
+		auto float_sum = original_floats;
+		comp6771::kernels::add(isa, float_sum.data() + offset, other_floats.data() + offset, size);
+		CHECK(float_sum == expected_float_sum);
+
+		auto float_quotient = original_floats;
+		comp6771::kernels::divide(isa, float_quotient.data() + offset, 3.0F, size);
+		CHECK(float_quotient == expected_float_quotient);
+	}
+	else {
+		auto sum = original;
+		CHECK_THROWS_AS(comp6771::kernels::add(isa, sum.data(), other.data(), size),
+		                comp6771::euclidean_vector_error);
+		CHECK_THROWS_AS(comp6771::kernels::divide(isa, sum.data(), 3.0, size),
+		                comp6771::euclidean_vector_error);
+	}
+
+	auto sum = original;
+	comp6771::kernels::add(sum.data() + offset, other.data() + offset, size);
+	CHECK(sum == expected_sum);
+}
+
+TEST_CASE("Half precision conversions") {
+	using comp6771::kernels::from_bfloat16;
+	using comp6771::kernels::from_float16;
+	using comp6771::kernels::to_bfloat16;
+	using comp6771::kernels::to_float16;
+
+	auto const infinity = std::numeric_limits<float>::infinity();
+
+	SECTION("float16 round trips values it can represent") {
+		for (auto const value : {0.0F, -0.0F, 1.0F, -2.5F, 0.099975586F, 65504.0F, 6.1035156e-05F,
+		                         5.9604645e-08F}) {
+			CHECK(from_float16(to_float16(value)) == value);
+		}
+		CHECK(to_float16(1.0F) == 0x3c00);
+		CHECK(to_float16(-2.0F) == 0xc000);
+	}
+
+	SECTION("float16 rounds to nearest even") {
+		// 1 + 2^-11 is halfway between 1 and the next half, 1 + 2^-10
+		CHECK(from_float16(to_float16(1.0F + 0x1p-11F)) == 1.0F);
+		CHECK(from_float16(to_float16(1.0F + 0x1p-10F + 0x1p-11F)) == 1.0F + 0x1p-9F);
+	}
+
+	SECTION("float16 overflows to infinity and keeps NaN") {
+		CHECK(from_float16(to_float16(65536.0F)) == infinity);
+		CHECK(from_float16(to_float16(-1e10F)) == -infinity);
+		CHECK(from_float16(to_float16(infinity)) == infinity);
+		CHECK(std::isnan(from_float16(to_float16(std::numeric_limits<float>::quiet_NaN()))));
+		CHECK(from_float16(to_float16(1e-10F)) == 0.0F);
+	}
+
+	SECTION("bfloat16 keeps float's range") {
+		CHECK(from_bfloat16(to_bfloat16(1e30F)) == Approx(1e30F).epsilon(1.0 / 128));
+		CHECK(from_bfloat16(to_bfloat16(-3.0F)) == -3.0F);
+		CHECK(from_bfloat16(to_bfloat16(infinity)) == infinity);
+		CHECK(std::isnan(from_bfloat16(to_bfloat16(std::numeric_limits<float>::quiet_NaN()))));
+		CHECK(from_bfloat16(to_bfloat16(1.0F + 0x1p-8F)) == 1.0F);
+	}
+}
+
+TEST_CASE("dot and euclidean_norm use the selected kernel") {
+	auto const x = make_magnitudes(1000, 0.25);
+	auto const y = make_magnitudes(1000, -1.5);
+
+	auto const ev_x = comp6771::euclidean_vector(x.begin(), x.end());
+	auto const ev_y = comp6771::euclidean_vector(y.begin(), y.end());
+
+	CHECK(comp6771::dot(ev_x, ev_y) == comp6771::kernels::dot(x.data(), y.data(), x.size()));
+	CHECK(comp6771::euclidean_norm(ev_x)
+	      == Approx(std::sqrt(std::inner_product(x.begin(), x.end(), x.begin(), 0.0))));
+}
@@ -0,0 +1,100 @@
+#include "comp6771/euclidean_vector.hpp"
+
+#include <catch2/catch.hpp>
+#include <utility>
+#include <vector>
+
+/*
+    Tests in this file test that vectors with few dimensions, which are stored inside the object
+    rather than on the heap, have the same copy, move and swap semantics as any other vector.
+
+    These tests assume that the constructors and casting to std::vector are correct.
+
+    Rational: Small and large vectors use different storage, so every combination of the two
+    must be tested on both sides of copy, move and swap. The boundary is at four dimensions, so
+    vectors of 4 and 5 dimensions are used.
+*/
+
+namespace {
+	auto const small_exp = std::vector<double>{1.5, -2.5, 3.5, 4.5};
+	auto const large_exp = std::vector<double>{9.0, 8.0, -7.0, 6.0, 5.0};
+} // namespace
+
+TEST_CASE("Small Vector Copy") {
+	auto const small = comp6771::euclidean_vector{1.5, -2.5, 3.5, 4.5};
+	auto const large = comp6771::euclidean_vector{9.0, 8.0, -7.0, 6.0, 5.0};
+
+	SECTION("Copy construct") {
+		auto small_copy = small;
+		small_copy[0] = 100;
+
+		CHECK_THAT(static_cast<std::vector<double>>(small), Catch::Approx(small_exp));
+		CHECK(small_copy[0] == Approx(100));
+	}
+
+	SECTION("Copy assign small to large") {
+		auto ev = large;
+		ev = small;
+
+		CHECK(ev.dimensions() == 4);
+		CHECK_THAT(static_cast<std::vector<double>>(ev), Catch::Approx(small_exp));
+	}
+
+	SECTION("Copy assign large to small") {
+		auto ev = small;
+		ev = large;
+
+		CHECK(ev.dimensions() == 5);
+		CHECK_THAT(static_cast<std::vector<double>>(ev), Catch::Approx(large_exp));
+	}
+}
+
+TEST_CASE("Small Vector Move") {
+	auto small = comp6771::euclidean_vector{1.5, -2.5, 3.5, 4.5};
+	auto large = comp6771::euclidean_vector{9.0, 8.0, -7.0, 6.0, 5.0};
+
+	SECTION("Move construct") {
+		auto moved = std::move(small);
+
+		CHECK_THAT(static_cast<std::vector<double>>(moved), Catch::Approx(small_exp));
+		CHECK(small.dimensions() == 0); // NOLINT(bugprone-use-after-move)
+	}
+
+	SECTION("Move assign small to large") {
+		large = std::move(small);
+
+		CHECK_THAT(static_cast<std::vector<double>>(large), Catch::Approx(small_exp));
+		CHECK(small.dimensions() == 0); // NOLINT(bugprone-use-after-move)
+	}
+
+	SECTION("Move assign large to small") {
+		small = std::move(large);
+
+		CHECK_THAT(static_cast<std::vector<double>>(small), Catch::Approx(large_exp));
+		CHECK(large.dimensions() == 0); // NOLINT(bugprone-use-after-move)
+	}
+
+	SECTION("Swap small and large") {
+		std::swap(small, large);
+
+		CHECK_THAT(static_cast<std::vector<double>>(small), Catch::Approx(large_exp));
+		CHECK_THAT(static_cast<std::vector<double>>(large), Catch::Approx(small_exp));
+	}
+}
+
+/*
+   Rational: Arithmetic on small vectors should give the same results as on large ones, including
+   when the result is assigned back to one of the operands.
+*/
+TEST_CASE("Small Vector Arithmetic") {
+	auto ev = comp6771::euclidean_vector{3, 4};
+
+	ev += comp6771::euclidean_vector{1, 1};
+	ev *= 2;
+	ev = ev - comp6771::euclidean_vector{2, 2};
+
+	CHECK_THAT(static_cast<std::vector<double>>(ev), Catch::Approx(std::vector<double>{6, 8}));
+	CHECK(comp6771::euclidean_norm(ev) == Approx(10));
+	CHECK_THAT(static_cast<std::vector<double>>(comp6771::unit(ev)),
+	           Catch::Approx(std::vector<double>{0.6, 0.8}));
+}
@@ -0,0 +1,270 @@
+#include "comp6771/euclidean_vector_batch.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+/*
+    Tests in this file test euclidean_vector_batch, which stores many vectors of the same
+    dimension in a single buffer, and the views it hands out for each row.
+
+    These tests assume that euclidean_vector is correct, and use the same expected values as the
+    euclidean_vector tests where possible.
+
+    Rational: A row must behave like a euclidean_vector, so each row operation is compared with
+    the result of the same operation on a euclidean_vector. The batched operations must give the
+    same answer as applying the operation to every row in turn.
+*/
+
+namespace {
+	auto make_batch() -> comp6771::euclidean_vector_batch {
+		auto batch = comp6771::euclidean_vector_batch(3);
+		batch.push_back(comp6771::euclidean_vector{1, 2, 3});
+		batch.push_back(comp6771::euclidean_vector{4, -5, 6});
+		batch.push_back(comp6771::euclidean_vector{0, 8, 6});
+		return batch;
+	}
+
+	auto row_vector(comp6771::const_euclidean_vector_view row) -> std::vector<double> {
+		return static_cast<std::vector<double>>(row);
+	}
+} // namespace
+
+TEST_CASE("Batch Construction") {
+	SECTION("Empty batch") {
+		auto const batch = comp6771::euclidean_vector_batch(5);
+
+		CHECK(batch.empty());
+		CHECK(batch.size() == 0);
+		CHECK(batch.dimensions() == 5);
+	}
+
+	SECTION("Filled batch") {
+		auto const batch = comp6771::euclidean_vector_batch(10, 3, 1.5);
+
+		CHECK(batch.size() == 10);
+		CHECK_THAT(row_vector(batch[9]), Catch::Approx(std::vector<double>{1.5, 1.5, 1.5}));
+	}
+
+	SECTION("Buffer is 64-byte aligned") {
+		auto const batch = comp6771::euclidean_vector_batch(100, 7, 0.0);
+
+		CHECK(reinterpret_cast<std::uintptr_t>(batch.data()) % 64 == 0);
+	}
+
+	SECTION("Rows are contiguous") {
+		auto const batch = make_batch();
+
+		CHECK(batch[1].data() == batch.data() + 3);
+		CHECK(batch[2].data() == batch.data() + 6);
+	}
+
+	SECTION("Push back keeps earlier rows when growing") {
+		auto batch = comp6771::euclidean_vector_batch(2);
+		for (auto i = 0; i < 100; ++i) {
+			batch.push_back(comp6771::euclidean_vector{static_cast<double>(i), -1.0});
+		}
+
+		CHECK(batch.size() == 100);
+		CHECK(batch.capacity() >= 100);
+		CHECK_THAT(row_vector(batch[42]), Catch::Approx(std::vector<double>{42, -1}));
+	}
+
+	SECTION("Push back a row of the same batch") {
+		auto batch = comp6771::euclidean_vector_batch(2);
+		batch.push_back(comp6771::euclidean_vector{1, 2});
+		for (auto i = 0; i < 20; ++i) {
+			batch.push_back(batch[0] * 2);
+		}
+
+		CHECK_THAT(row_vector(batch[20]), Catch::Approx(std::vector<double>{2, 4}));
+	}
+
+	SECTION("Copy and move") {
+		auto batch = make_batch();
+		auto copy = batch;
+		copy[0][0] = 100;
+
+		CHECK(batch[0][0] == Approx(1));
+
+		auto const moved = std::move(copy);
+		CHECK(moved[0][0] == Approx(100));
+		CHECK(moved.size() == 3);
+	}
+
+	SECTION("Uses the given memory resource") {
+		auto arena = std::pmr::monotonic_buffer_resource();
+		auto batch = comp6771::euclidean_vector_batch(3, &arena);
+		batch.push_back(comp6771::euclidean_vector{1, 2, 3});
+
+		CHECK(batch.get_allocator().resource() == &arena);
+		CHECK(comp6771::unit(batch).get_allocator().resource() == &arena);
+
+		auto const copy = batch;
+		CHECK(copy.get_allocator().resource() == std::pmr::get_default_resource());
+	}
+
+	SECTION("Exception: Dimensions do not match") {
+		auto batch = comp6771::euclidean_vector_batch(3);
+
+		CHECK_THROWS_MATCHES(batch.push_back(comp6771::euclidean_vector{1, 2}),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not match"));
+	}
+}
+
+TEST_CASE("Batch Rows") {
+	auto batch = make_batch();
+	auto const ev = comp6771::euclidean_vector{1, 1, 1};
+
+	SECTION("Rows can be written through") {
+		batch[1][0] = 7;
+		batch.at(2).at(1) = -1;
+		batch[0] += ev;
+		batch[0] *= 2;
+
+		CHECK_THAT(row_vector(batch[0]), Catch::Approx(std::vector<double>{4, 6, 8}));
+		CHECK_THAT(row_vector(batch[1]), Catch::Approx(std::vector<double>{7, -5, 6}));
+		CHECK_THAT(row_vector(batch[2]), Catch::Approx(std::vector<double>{0, -1, 6}));
+	}
+
+	SECTION("Rows mix with euclidean_vector") {
+		comp6771::euclidean_vector const sum = batch[0] + ev * 2 - batch[1];
+
+		CHECK_THAT(static_cast<std::vector<double>>(sum),
+		           Catch::Approx(std::vector<double>{-1, 9, -1}));
+		CHECK(comp6771::dot(batch[0], ev) == Approx(6));
+		CHECK(comp6771::euclidean_norm(batch[2]) == Approx(10));
+	}
+
+	SECTION("Rows compare in place") {
+		batch.push_back(batch[0]);
+		auto const& rows = batch;
+
+		CHECK(rows[0] == rows[3]);
+		CHECK(batch[0] == rows[3]);
+		CHECK(rows[0] != rows[2]);
+		CHECK(rows[0] == comp6771::euclidean_vector{1, 2, 3});
+		CHECK(comp6771::euclidean_vector{1, 2, 3} == batch[0]);
+		CHECK(rows[0] != comp6771::euclidean_vector{1, 2});
+		CHECK(comp6771::dot(rows[0], rows[2]) == Approx(comp6771::dot(batch[0], ev * 0 + rows[2])));
+	}
+
+	SECTION("Exception: Index out of range") {
+		CHECK_THROWS_MATCHES(batch.at(3),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Index 3 is not valid for this "
+		                                              "euclidean_vector_batch object"));
+
+		CHECK_THROWS_MATCHES(batch[0].at(3),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Index 3 is not valid for this "
+		                                              "euclidean_vector object"));
+	}
+}
+
+TEST_CASE("Batch Operations") {
+	auto batch = make_batch();
+
+	SECTION("+= and -= row by row") {
+		batch += make_batch();
+		CHECK_THAT(row_vector(batch[1]), Catch::Approx(std::vector<double>{8, -10, 12}));
+
+		batch -= make_batch();
+		CHECK_THAT(row_vector(batch[1]), Catch::Approx(std::vector<double>{4, -5, 6}));
+	}
+
+	SECTION("+= and -= a single vector") {
+		batch += comp6771::euclidean_vector{1, 1, 1};
+		batch -= comp6771::euclidean_vector{0, 0, 2};
+
+		CHECK_THAT(row_vector(batch[0]), Catch::Approx(std::vector<double>{2, 3, 2}));
+		CHECK_THAT(row_vector(batch[2]), Catch::Approx(std::vector<double>{1, 9, 5}));
+	}
+
+	SECTION("*= and /=") {
+		batch *= 2;
+		batch /= 4;
+
+		CHECK_THAT(row_vector(batch[1]), Catch::Approx(std::vector<double>{2, -2.5, 3}));
+	}
+
+	SECTION("Large batches on the thread pool match row by row") {
+		// An odd number of dimensions, so chunks start part way into rows and at unaligned
+		// magnitudes
+		auto const rows = 500;
+		auto const dimensions = 333;
+		auto large = comp6771::euclidean_vector_batch(dimensions);
+		auto other = comp6771::euclidean_vector_batch(dimensions);
+		for (auto i = 0; i < rows; ++i) {
+			auto row = comp6771::euclidean_vector(dimensions);
+			for (auto j = 0; j < dimensions; ++j) {
+				row[j] = 0.1 * (i % 7) - 0.3 * (j % 11);
+			}
+			large.push_back(row);
+			other.push_back(row * 0.7);
+		}
+		auto expected = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < rows; ++i) {
+			auto row = comp6771::euclidean_vector(large[i]);
+			row += comp6771::euclidean_vector(other[i]);
+			row -= comp6771::euclidean_vector(other[i]) * 3;
+			row *= 1.5;
+			row /= 3;
+			expected.push_back(row);
+		}
+
+		auto const previous = comp6771::parallel_threshold();
+		comp6771::set_parallel_threshold(0);
+		large += other;
+		other *= 3;
+		large -= other;
+		large *= 1.5;
+		large /= 3;
+		comp6771::set_parallel_threshold(previous);
+
+		auto matches = 0;
+		for (auto i = 0; i < rows; ++i) {
+			matches += comp6771::euclidean_vector(large[i]) == expected[static_cast<std::size_t>(i)];
+		}
+		CHECK(matches == rows);
+	}
+
+	SECTION("Dot product") {
+		CHECK_THAT(comp6771::dot(batch, make_batch()),
+		           Catch::Approx(std::vector<double>{14, 77, 100}));
+		CHECK_THAT(comp6771::dot(batch, comp6771::euclidean_vector{1, 2, 3}),
+		           Catch::Approx(std::vector<double>{14, 12, 34}));
+	}
+
+	SECTION("Norm") {
+		CHECK_THAT(comp6771::euclidean_norm(batch),
+		           Catch::Approx(std::vector<double>{3.7416573867739, 8.7749643873921, 10}));
+	}
+
+	SECTION("Unit") {
+		auto const units = comp6771::unit(batch);
+
+		CHECK_THAT(row_vector(units[2]), Catch::Approx(std::vector<double>{0, 0.8, 0.6}));
+		CHECK_THAT(comp6771::euclidean_norm(units), Catch::Approx(std::vector<double>{1, 1, 1}));
+	}
+
+	SECTION("Exceptions") {
+		auto const fewer = comp6771::euclidean_vector_batch(2, 3, 1.0);
+
+		CHECK_THROWS_MATCHES(batch += fewer,
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Sizes of LHS(3) and RHS(2) do not match"));
+
+		CHECK_THROWS_MATCHES(batch /= 0,
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid vector division by 0"));
+
+		batch.push_back(comp6771::euclidean_vector(3));
+		CHECK_THROWS_MATCHES(comp6771::unit(batch),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("euclidean_vector with zero euclidean normal "
+		                                              "does not have a unit vector"));
+	}
+}
@@ -0,0 +1,131 @@
+#include "comp6771/fixed_euclidean_vector.hpp"
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+/*
+    Tests in this file test fixed_euclidean_vector, the compile-time sized euclidean vector.
+
+    Most tests are evaluated at compile time with STATIC_REQUIRE, since everything other than the
+    conversions and output stream is constexpr. The expected values match the ones used to test
+    euclidean_vector.
+
+    Rational: The arithmetic is the same as euclidean_vector's, so it is sufficient to check each
+    operation once, that it is usable in a constant expression, and that mismatched dimensions
+    do not compile.
+*/
+
+namespace {
+	using vec3 = comp6771::fixed_euclidean_vector<3>;
+
+	template<typename T, typename U>
+	concept addable = requires(T t, U u) {
+		t + u;
+	};
+
+	template<typename T, typename U>
+	concept dottable = requires(T t, U u) {
+		comp6771::dot(t, u);
+	};
+} // namespace
+
+TEST_CASE("Fixed Constructors") {
+	SECTION("Default constructor is all zeros") {
+		constexpr auto v = vec3();
+		STATIC_REQUIRE(v[0] == 0.0);
+		STATIC_REQUIRE(v[2] == 0.0);
+	}
+
+	SECTION("Deduced from the magnitudes") {
+		constexpr auto v = comp6771::fixed_euclidean_vector{1.0, 2.0, 3.0, 4.0};
+		STATIC_REQUIRE(std::is_same_v<decltype(v), comp6771::fixed_euclidean_vector<4> const>);
+		STATIC_REQUIRE(v.dimensions() == 4);
+		STATIC_REQUIRE(v[3] == 4.0);
+	}
+
+	SECTION("Wrong number of magnitudes does not compile") {
+		STATIC_REQUIRE(std::is_constructible_v<vec3, double, double, double>);
+		STATIC_REQUIRE_FALSE(std::is_constructible_v<vec3, double, double>);
+		STATIC_REQUIRE_FALSE(std::is_constructible_v<vec3, double, double, double, double>);
+	}
+}
+
+TEST_CASE("Fixed Arithmetic") {
+	constexpr auto v = vec3{1.0, 2.0, 3.0};
+	constexpr auto w = vec3{4.0, -5.0, 6.0};
+
+	STATIC_REQUIRE(v + w == vec3{5.0, -3.0, 9.0});
+	STATIC_REQUIRE(v - w == vec3{-3.0, 7.0, -3.0});
+	STATIC_REQUIRE(-v == vec3{-1.0, -2.0, -3.0});
+	STATIC_REQUIRE(v * 2 == vec3{2.0, 4.0, 6.0});
+	STATIC_REQUIRE(w / 2 == vec3{2.0, -2.5, 3.0});
+	STATIC_REQUIRE(v != w);
+
+	SECTION("Mismatched dimensions do not compile") {
+		STATIC_REQUIRE(addable<vec3, vec3>);
+		STATIC_REQUIRE_FALSE(addable<vec3, comp6771::fixed_euclidean_vector<4>>);
+		STATIC_REQUIRE_FALSE(dottable<vec3, comp6771::fixed_euclidean_vector<2>>);
+	}
+
+	SECTION("Exception: Division by 0") {
+		CHECK_THROWS_MATCHES(v / 0,
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid vector division by 0"));
+	}
+
+	SECTION("Exception: Index out of range") {
+		CHECK_THROWS_MATCHES(v.at(3),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Index 3 is not valid for this "
+		                                              "euclidean_vector object"));
+	}
+}
+
+TEST_CASE("Fixed Utility") {
+	constexpr auto v = vec3{1.0, 2.0, 3.0};
+	constexpr auto w = vec3{4.0, -5.0, 6.0};
+
+	STATIC_REQUIRE(comp6771::dot(v, w) == 12.0);
+	STATIC_REQUIRE(comp6771::euclidean_norm(comp6771::fixed_euclidean_vector{3.0, 4.0}) == 5.0);
+	STATIC_REQUIRE(comp6771::unit(comp6771::fixed_euclidean_vector{0.0, 8.0, 6.0, 0.0})
+	               == comp6771::fixed_euclidean_vector{0.0, 0.8, 0.6, 0.0});
+
+	// Evaluated at run time, this uses std::sqrt
+	CHECK(comp6771::euclidean_norm(v) == Approx(3.7416573867739));
+
+	CHECK_THROWS_MATCHES(comp6771::unit(vec3()),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("euclidean_vector with zero euclidean normal "
+	                                              "does not have a unit vector"));
+}
+
+TEST_CASE("Fixed Conversions") {
+	SECTION("To euclidean_vector") {
+		auto const ev = static_cast<comp6771::euclidean_vector>(vec3{1.5, -2.0, 3.25});
+
+		CHECK(ev.dimensions() == 3);
+		CHECK_THAT(static_cast<std::vector<double>>(ev),
+		           Catch::Approx(std::vector<double>{1.5, -2.0, 3.25}));
+	}
+
+	SECTION("From euclidean_vector") {
+		auto const v = vec3(comp6771::euclidean_vector{1.5, -2.0, 3.25});
+
+		CHECK(v == vec3{1.5, -2.0, 3.25});
+	}
+
+	SECTION("Exception: From euclidean_vector of a different dimension") {
+		CHECK_THROWS_MATCHES(vec3(comp6771::euclidean_vector{1.5, -2.0}),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not "
+		                                              "match"));
+	}
+
+	SECTION("Output stream") {
+		auto oss = std::ostringstream{};
+		oss << vec3{3, 5.7, 8.39};
+		CHECK(oss.str() == "[3 5.7 8.39]");
+	}
+}
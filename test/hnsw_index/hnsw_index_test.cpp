@@ -0,0 +1,357 @@
+#include "comp6771/hnsw_index.hpp"
+#include "comp6771/testing/random_batch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+    Tests in this file test hnsw_index, which finds approximately the k nearest neighbours of a
+    query.
+
+    These tests assume that brute_force_index is correct.
+
+    Rational: Results are approximate, so they are compared with brute_force_index by recall (the
+    share of the true k nearest neighbours that were found) rather than exactly. The graph only
+    depends on the seed and the order of inserts, so a saved and loaded index must give exactly
+    the same results as the original. A search trusts the graph it walks, so files describing a
+    graph that save() could not have written must not load.
+*/
+
+namespace {
+	using comp6771::testing::random_batch;
+
+	auto build(comp6771::euclidean_vector_batch const& vectors,
+	           comp6771::metric m,
+	           comp6771::hnsw_parameters parameters = {}) -> comp6771::hnsw_index {
+		auto index = comp6771::hnsw_index(vectors.dimensions(), m, parameters);
+		for (auto i = 0; i < vectors.size(); ++i) {
+			index.add(vectors[i]);
+		}
+		return index;
+	}
+
+	auto recall(comp6771::hnsw_index const& index,
+	            comp6771::brute_force_index const& exact,
+	            comp6771::euclidean_vector_batch const& queries,
+	            int k) -> double {
+		auto found = 0;
+		for (auto q = 0; q < queries.size(); ++q) {
+			auto const approximate = index.search(queries[q], k);
+			for (auto const& n : exact.search(queries[q], k)) {
+				found += std::any_of(approximate.begin(), approximate.end(), [&n](auto const& a) {
+					return a.index == n.index;
+				});
+			}
+		}
+		return static_cast<double>(found) / (queries.size() * k);
+	}
+
+	using graph = std::vector<std::vector<std::vector<std::int32_t>>>;
+
+	// Writes the file save() would for one dimensional vectors 0, 1, 2, ... linked by <links>
+	auto write_index(std::string const& path,
+	                 std::int32_t metric,
+	                 std::int32_t entry_point,
+	                 std::int32_t top_level,
+	                 graph const& links) -> void {
+		auto out = std::ofstream(path, std::ios::binary);
+		auto const write = [&out](auto const value) {
+			out.write(reinterpret_cast<char const*>(&value), sizeof(value));
+		};
+
+		out.write("C6771HNW", 8);
+		write(std::uint32_t{1});
+		write(std::int32_t{1});
+		write(metric);
+		for (auto const parameter : {8, 200, 50}) {
+			write(std::int32_t{parameter});
+		}
+		write(std::uint64_t{100});
+		write(static_cast<std::int32_t>(links.size()));
+		write(entry_point);
+		write(top_level);
+		for (auto i = std::size_t{0}; i < links.size(); ++i) {
+			write(static_cast<double>(i));
+		}
+		for (auto const& levels : links) {
+			write(static_cast<std::int32_t>(levels.size()));
+			for (auto const& level : levels) {
+				write(static_cast<std::int32_t>(level.size()));
+				for (auto const node : level) {
+					write(node);
+				}
+			}
+		}
+	}
+
+	// Reads back the links of each node from a file written by save()
+	auto read_links(std::string const& path) -> graph {
+		auto in = std::ifstream(path, std::ios::binary);
+		auto const read = [&in] {
+			auto value = std::int32_t{0};
+			in.read(reinterpret_cast<char*>(&value), sizeof(value));
+			return value;
+		};
+
+		in.seekg(12);
+		auto const dimensions = read();
+		in.seekg(40);
+		auto const size = read();
+		in.seekg(52 + static_cast<std::streamoff>(sizeof(double)) * size * dimensions);
+
+		auto links = graph(static_cast<std::size_t>(size));
+		for (auto& levels : links) {
+			levels.resize(static_cast<std::size_t>(read()));
+			for (auto& level : levels) {
+				level.resize(static_cast<std::size_t>(read()));
+				for (auto& node : level) {
+					node = read();
+				}
+			}
+		}
+		return links;
+	}
+} // namespace
+
+TEST_CASE("HNSW Small Index") {
+	auto index = comp6771::hnsw_index(2);
+
+	SECTION("Empty index") {
+		CHECK(index.size() == 0);
+		CHECK(index.search(comp6771::euclidean_vector{0, 0}, 3).empty());
+	}
+
+	SECTION("Finds exact neighbours when every vector is a candidate") {
+		CHECK(index.add(comp6771::euclidean_vector{3, 4}) == 0);
+		CHECK(index.add(comp6771::euclidean_vector{1, 0}) == 1);
+		CHECK(index.add(comp6771::euclidean_vector{0, 0}) == 2);
+		CHECK(index.add(comp6771::euclidean_vector{-2, 0}) == 3);
+
+		auto const result = index.search(comp6771::euclidean_vector{0, 0}, 10);
+
+		REQUIRE(result.size() == 4);
+		CHECK(result[0].index == 2);
+		CHECK(result[1].index == 1);
+		CHECK(result[1].distance == Approx(1));
+		CHECK(result[3].distance == Approx(5));
+	}
+
+	SECTION("Vectors far from the origin") {
+		index.add(comp6771::euclidean_vector{1e8 + 3, 1e8 + 4});
+		index.add(comp6771::euclidean_vector{1e8 + 1, 1e8});
+
+		auto const result = index.search(comp6771::euclidean_vector{1e8, 1e8}, 2);
+
+		REQUIRE(result.size() == 2);
+		CHECK(result[0] == comp6771::neighbour{1, 1});
+		CHECK(result[1] == comp6771::neighbour{0, 5});
+	}
+
+	SECTION("Exceptions") {
+		CHECK_THROWS_MATCHES(index.add(comp6771::euclidean_vector{1, 2, 3}),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(2) and RHS(3) do not match"));
+
+		CHECK_THROWS_MATCHES(index.search(comp6771::euclidean_vector{1, 2}, -1),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid number of neighbours -1"));
+
+		CHECK_THROWS_MATCHES(index.set_ef_search(0),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid hnsw_index ef_search 0"));
+
+		CHECK_THROWS_MATCHES(comp6771::hnsw_index(2, comp6771::metric::l2, {.m = 1}),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid hnsw_index m 1"));
+	}
+}
+
+TEST_CASE("HNSW Recall") {
+	auto const m = GENERATE(comp6771::metric::l2, comp6771::metric::inner_product, comp6771::metric::cosine);
+
+	auto const vectors = random_batch(1500, 12, 1);
+	auto const queries = random_batch(50, 12, 2);
+	auto const exact = comp6771::brute_force_index(vectors, m);
+	auto index = build(vectors, m, {.m = 12, .ef_construction = 64, .ef_search = 10});
+
+	CHECK(index.size() == 1500);
+
+	auto const low = recall(index, exact, queries, 10);
+	index.set_ef_search(200);
+	auto const high = recall(index, exact, queries, 10);
+
+	CHECK(high >= 0.95);
+	CHECK(high >= low);
+}
+
+TEST_CASE("HNSW Save and Load") {
+	auto const vectors = random_batch(500, 8, 3);
+	auto const queries = random_batch(20, 8, 4);
+	auto const index = build(vectors, comp6771::metric::cosine, {.m = 8, .ef_search = 20});
+
+	auto const path = std::string("hnsw_index_test.bin");
+	index.save(path);
+	auto const loaded = comp6771::hnsw_index::load(path);
+
+	CHECK(loaded.size() == index.size());
+	CHECK(loaded.dimensions() == 8);
+	CHECK(loaded.distance_metric() == comp6771::metric::cosine);
+	CHECK(loaded.parameters().m == 8);
+	CHECK(loaded.parameters().ef_search == 20);
+	for (auto q = 0; q < queries.size(); ++q) {
+		CHECK(loaded.search(queries[q], 5) == index.search(queries[q], 5));
+	}
+
+	SECTION("Exceptions") {
+		{
+			auto out = std::ofstream(path, std::ios::binary);
+			out << "not an index";
+		}
+
+		CHECK_THROWS_MATCHES(comp6771::hnsw_index::load(path),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Cannot read hnsw_index from " + path));
+		CHECK_THROWS_MATCHES(comp6771::hnsw_index::load("does/not/exist.bin"),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Cannot read hnsw_index from does/not/exist.bin"));
+	}
+
+	std::remove(path.c_str());
+}
+
+TEST_CASE("HNSW Load Checks The Graph") {
+	auto const path = std::string("hnsw_index_graph_test.bin");
+	auto const load_throws = [&path] {
+		CHECK_THROWS_MATCHES(comp6771::hnsw_index::load(path),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Cannot read hnsw_index from " + path));
+	};
+
+	// Node 0 is on layers 0 and 1, and node 1 only on layer 0
+	write_index(path, 0, 0, 1, graph{{{1}, {}}, {{0}}});
+	auto const index = comp6771::hnsw_index::load(path);
+	CHECK(index.size() == 2);
+	CHECK(index.search(comp6771::euclidean_vector{0.75}, 1).front().index == 1);
+
+	SECTION("Unknown metric") {
+		write_index(path, 3, 0, 1, graph{{{1}, {}}, {{0}}});
+		load_throws();
+		write_index(path, -1, 0, 1, graph{{{1}, {}}, {{0}}});
+		load_throws();
+	}
+
+	SECTION("Top level is not the entry point's") {
+		write_index(path, 0, 0, 2, graph{{{1}, {}}, {{0}}});
+		load_throws();
+		write_index(path, 0, 0, 0, graph{{{1}, {}}, {{0}}});
+		load_throws();
+		write_index(path, 0, 1, 1, graph{{{1}, {}}, {{0}}});
+		load_throws();
+	}
+
+	SECTION("No entry point") {
+		write_index(path, 0, -1, -1, graph{{{1}}, {{0}}});
+		load_throws();
+	}
+
+	SECTION("Link to a node that is not on the layer") {
+		write_index(path, 0, 0, 1, graph{{{1}, {1}}, {{0}}});
+		load_throws();
+	}
+
+	SECTION("Link to a node that does not exist") {
+		write_index(path, 0, 0, 1, graph{{{2}, {}}, {{0}}});
+		load_throws();
+	}
+
+	SECTION("Forged header") {
+		// Sizes that would need far more magnitudes than the file holds
+		index.save(path);
+		auto const forge = [&path](std::streamoff offset, std::int32_t value) {
+			auto file = std::fstream(path, std::ios::binary | std::ios::in | std::ios::out);
+			file.seekp(offset);
+			file.write(reinterpret_cast<char const*>(&value), sizeof(value));
+		};
+		auto constexpr dimensions_offset = 12;
+		auto constexpr size_offset = 40;
+		forge(dimensions_offset, std::numeric_limits<std::int32_t>::max());
+		forge(size_offset, std::numeric_limits<std::int32_t>::max());
+		load_throws();
+		forge(dimensions_offset, 1);
+		load_throws();
+
+		// A top level no node could reach
+		write_index(path, 0, 0, std::numeric_limits<std::int32_t>::max(), graph{{{1}, {}}, {{0}}});
+		load_throws();
+		write_index(path, 0, 0, -2, graph{{{1}, {}}, {{0}}});
+		load_throws();
+	}
+
+	std::remove(path.c_str());
+}
+
+TEST_CASE("HNSW Concurrent Search and Insert") {
+	auto const vectors = random_batch(2000, 8, 5);
+	auto index = comp6771::hnsw_index(8);
+
+	auto inserted = std::atomic<int>(0);
+	auto writers = std::vector<std::thread>();
+	for (auto w = 0; w < 2; ++w) {
+		writers.emplace_back([&, w] {
+			for (auto i = w; i < vectors.size(); i += 2) {
+				index.add(vectors[i]);
+				++inserted;
+			}
+		});
+	}
+
+	auto searches = 0;
+	while (inserted < vectors.size()) {
+		auto const result = index.search(vectors[searches % vectors.size()], 5);
+		CHECK(result.size() <= 5);
+		++searches;
+	}
+	for (auto& writer : writers) {
+		writer.join();
+	}
+
+	CHECK(index.size() == 2000);
+
+	// Every vector can be found once inserting has finished
+	auto found = 0;
+	for (auto i = 0; i < vectors.size(); i += 10) {
+		found += index.search(vectors[i], 1).front().distance == Approx(0).margin(1e-9);
+	}
+	CHECK(found >= 195);
+
+	// An insert that raced another raising the top level must still be linked on every level it
+	// is on, or no search could reach it there
+	auto const path = std::string("hnsw_index_concurrent_test.bin");
+	index.save(path);
+	auto const links = read_links(path);
+	std::remove(path.c_str());
+
+	auto nodes_on_level = std::vector<int>();
+	for (auto const& levels : links) {
+		nodes_on_level.resize(std::max(nodes_on_level.size(), levels.size()));
+		for (auto l = std::size_t{0}; l < levels.size(); ++l) {
+			++nodes_on_level[l];
+		}
+	}
+	auto unlinked = 0;
+	for (auto const& levels : links) {
+		for (auto l = std::size_t{0}; l < levels.size(); ++l) {
+			unlinked += nodes_on_level[l] > 1 and levels[l].empty();
+		}
+	}
+	CHECK(unlinked == 0);
+}
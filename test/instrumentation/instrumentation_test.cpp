@@ -0,0 +1,174 @@
+#include "comp6771/instrumentation.hpp"
+
+#include "comp6771/euclidean_vector.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+
+/*
+    Tests in this file test the counters and latency histograms behind euclidean_vector, and the
+    text they are dumped as.
+
+    Each test resets the counters first and only checks what it did itself, since Catch runs
+    every test on the same thread.
+
+    Rational: Counts are only useful if they match what the code did, so each hook is checked
+    against a case where the exact count is known. When instrumentation is compiled out, every
+    snapshot must be 0 and the dump must still be well formed, so a scraper does not need to
+    know how the library was built.
+*/
+
+namespace instrumentation = comp6771::instrumentation;
+
+using instrumentation::counter;
+using instrumentation::operation;
+
+namespace {
+	// Larger than a vector stored inline
+	constexpr auto dimensions = 100;
+	constexpr auto bytes = std::uint64_t{dimensions * sizeof(double)};
+
+	auto expected(std::uint64_t n) -> std::uint64_t {
+		return instrumentation::enabled ? n : 0;
+	}
+} // namespace
+
+TEST_CASE("Counters") {
+	auto const v = comp6771::euclidean_vector(dimensions, 1.0);
+	instrumentation::reset();
+
+	SECTION("Copies") {
+		auto copy = v;
+		copy = v;
+		auto const s = instrumentation::take_snapshot();
+		CHECK(s[counter::copies] == expected(2));
+		CHECK(s[counter::copied_bytes] == expected(2 * bytes));
+		CHECK(s[counter::allocations] == expected(1));
+		CHECK(s[counter::allocated_bytes] == expected(bytes));
+	}
+
+	SECTION("Moves do not copy") {
+		auto copy = v;
+		auto moved = std::move(copy);
+		copy = std::move(moved);
+		auto const s = instrumentation::take_snapshot();
+		CHECK(s[counter::copies] == expected(1));
+		CHECK(s[counter::moves] == expected(2));
+	}
+
+	SECTION("Small vectors do not allocate") {
+		auto const small = comp6771::euclidean_vector{1, 2, 3};
+		auto const copy = small;
+		auto const s = instrumentation::take_snapshot();
+		CHECK(s[counter::copies] == expected(1));
+		CHECK(s[counter::allocations] == 0);
+	}
+
+	SECTION("Deallocations") {
+		{ auto const copy = v; }
+		CHECK(instrumentation::take_snapshot()[counter::deallocations] == expected(1));
+	}
+
+	SECTION("Norm cache") {
+		auto w = v;
+		CHECK(comp6771::euclidean_norm(w) == 10);
+		CHECK(comp6771::euclidean_norm(w) == 10);
+		// Writing a magnitude updates the squared norm, but assigning an expression discards it
+		w[0] = 1;
+		CHECK(comp6771::euclidean_norm(w) == 10);
+		w = v * 1;
+		CHECK(comp6771::euclidean_norm(w) == 10);
+
+		auto const s = instrumentation::take_snapshot();
+		CHECK(s[counter::norm_cache_hits] == expected(2));
+		CHECK(s[counter::norm_cache_misses] == expected(2));
+		CHECK(s[operation::euclidean_norm].count() == expected(2));
+	}
+}
+
+TEST_CASE("Latencies") {
+	auto const v = comp6771::euclidean_vector(dimensions, 1.0);
+	instrumentation::reset();
+
+	auto w = comp6771::euclidean_vector(v + v);
+	w += v;
+	w *= 2;
+	CHECK(comp6771::dot(v, w) == 600);
+	auto const u = comp6771::unit(v);
+
+	auto const s = instrumentation::take_snapshot();
+	CHECK(s[operation::evaluate].count() == expected(1));
+	CHECK(s[operation::arithmetic].count() == expected(3));
+	CHECK(s[operation::dot].count() == expected(1));
+	CHECK(s[operation::unit].count() == expected(1));
+	if constexpr (instrumentation::enabled) {
+		CHECK(s[operation::dot].total_nanoseconds > 0);
+	}
+}
+
+TEST_CASE("Snapshots and Reset") {
+	auto const v = comp6771::euclidean_vector(dimensions, 1.0);
+	instrumentation::reset();
+
+	SECTION("Reset starts from 0") {
+		auto const copy = v;
+		CHECK(instrumentation::take_snapshot()[counter::copies] == expected(1));
+		instrumentation::reset();
+		CHECK(instrumentation::take_snapshot()[counter::copies] == 0);
+	}
+
+	SECTION("Threads that have exited are still counted") {
+		auto thread = std::thread([&v] {
+			for (auto i = 0; i < 10; ++i) {
+				auto const copy = v;
+			}
+		});
+		thread.join();
+		CHECK(instrumentation::take_snapshot()[counter::copies] == expected(10));
+	}
+}
+
+TEST_CASE("Metrics Text") {
+	auto const v = comp6771::euclidean_vector(dimensions, 1.0);
+	instrumentation::reset();
+	auto const copy = v;
+
+	auto os = std::ostringstream();
+	instrumentation::write_metrics(os, instrumentation::take_snapshot());
+	auto const text = os.str();
+
+	SECTION("Counters") {
+		CHECK(text.find("# TYPE comp6771_euclidean_vector_copies_total counter\n") != std::string::npos);
+		CHECK(text.find("\ncomp6771_euclidean_vector_copies_total " + std::to_string(expected(1)) + "\n")
+		      != std::string::npos);
+		CHECK(text.find("\ncomp6771_euclidean_vector_norm_cache_misses_total 0\n") != std::string::npos);
+	}
+
+	SECTION("Histograms") {
+		CHECK(text.find("# TYPE comp6771_euclidean_vector_latency_seconds histogram\n")
+		      != std::string::npos);
+		CHECK(text.find("comp6771_euclidean_vector_latency_seconds_bucket{operation=\"dot\",le=\"1e-09\"} 0\n")
+		      != std::string::npos);
+		CHECK(text.find("comp6771_euclidean_vector_latency_seconds_bucket{operation=\"dot\",le=\"+Inf\"} 0\n")
+		      != std::string::npos);
+		CHECK(text.find("comp6771_euclidean_vector_latency_seconds_count{operation=\"unit\"} 0\n")
+		      != std::string::npos);
+	}
+
+	SECTION("Every line is a comment or a sample") {
+		auto is = std::istringstream(text);
+		auto lines = 0;
+		for (auto line = std::string(); std::getline(is, line); ++lines) {
+			CHECK((line.starts_with("# TYPE comp6771_euclidean_vector_")
+			       or line.starts_with("comp6771_euclidean_vector_")));
+		}
+		// 2 lines per counter, and a bucket, sum and count per operation after the histogram's type
+		CHECK(lines
+		      == static_cast<int>(2 * instrumentation::counter_count + 1
+		                          + instrumentation::operation_count
+		                               * (instrumentation::histogram_buckets + 2)));
+	}
+}
@@ -0,0 +1,192 @@
+#include "comp6771/nearest_neighbours.hpp"
+#include "comp6771/testing/random_batch.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/*
+    Tests in this file test brute_force_index, which finds the exact k nearest neighbours of a
+    query.
+
+    These tests assume that euclidean_vector_batch, dot and euclidean_norm are correct.
+
+    Rational: The index must give the same answer as comparing the query with every vector one at
+    a time, so results are compared with that. Large random data sets are used so that the
+    database is split into several blocks and several tasks, and small hand-written ones to check
+    the distances and tie breaking. Vectors far from the origin but close to each other check that
+    euclidean distances do not lose their precision to the size of the vectors.
+*/
+
+namespace {
+	using comp6771::testing::random_batch;
+
+	// Compares <query> with every vector in turn
+	auto naive_search(comp6771::euclidean_vector_batch const& vectors,
+	                  comp6771::const_euclidean_vector_view query,
+	                  int k,
+	                  comp6771::metric m) -> std::vector<int> {
+		auto distances = std::vector<std::pair<double, int>>();
+		for (auto i = 0; i < vectors.size(); ++i) {
+			auto const row = vectors[i];
+			switch (m) {
+			case comp6771::metric::l2:
+				distances.emplace_back(comp6771::euclidean_norm(row - query), i);
+				break;
+			case comp6771::metric::inner_product:
+				distances.emplace_back(-comp6771::dot(row, query), i);
+				break;
+			case comp6771::metric::cosine:
+				distances.emplace_back(1 - comp6771::dot(row, query)
+				                              / (comp6771::euclidean_norm(row)
+				                                 * comp6771::euclidean_norm(query)),
+				                       i);
+				break;
+			}
+		}
+
+		std::sort(distances.begin(), distances.end());
+		auto indices = std::vector<int>();
+		for (auto i = 0; i < std::min(k, vectors.size()); ++i) {
+			indices.push_back(distances[static_cast<std::size_t>(i)].second);
+		}
+		return indices;
+	}
+
+	auto indices_of(std::vector<comp6771::neighbour> const& neighbours) -> std::vector<int> {
+		auto indices = std::vector<int>();
+		for (auto const& n : neighbours) {
+			indices.push_back(n.index);
+		}
+		return indices;
+	}
+} // namespace
+
+TEST_CASE("Brute Force Distances") {
+	auto index = comp6771::brute_force_index(2);
+	index.add(comp6771::euclidean_vector{3, 4});
+	index.add(comp6771::euclidean_vector{1, 0});
+	index.add(comp6771::euclidean_vector{0, 0});
+	index.add(comp6771::euclidean_vector{-2, 0});
+
+	CHECK(index.size() == 4);
+	CHECK(index.dimensions() == 2);
+
+	SECTION("L2") {
+		auto const result = index.search(comp6771::euclidean_vector{0, 0}, 3);
+
+		CHECK(indices_of(result) == std::vector<int>{2, 1, 3});
+		CHECK(result[0].distance == Approx(0).margin(1e-12));
+		CHECK(result[1].distance == Approx(1));
+		CHECK(result[2].distance == Approx(2));
+	}
+
+	SECTION("Inner product") {
+		auto const ip = comp6771::brute_force_index(index.vectors(), comp6771::metric::inner_product);
+		auto const result = ip.search(comp6771::euclidean_vector{1, 1}, 2);
+
+		CHECK(indices_of(result) == std::vector<int>{0, 1});
+		CHECK(result[0].distance == Approx(-7));
+	}
+
+	SECTION("Cosine") {
+		auto const cosine = comp6771::brute_force_index(index.vectors(), comp6771::metric::cosine);
+		auto const result = cosine.search(comp6771::euclidean_vector{2, 0}, 4);
+
+		CHECK(indices_of(result) == std::vector<int>{1, 0, 2, 3});
+		CHECK(result[1].distance == Approx(0.4));
+		CHECK(result[2].distance == Approx(1));
+		CHECK(result[3].distance == Approx(2));
+	}
+
+	SECTION("Ties are broken by the smaller index") {
+		index.add(comp6771::euclidean_vector{1, 0});
+		auto const result = index.search(comp6771::euclidean_vector{1, 0}, 2);
+
+		CHECK(indices_of(result) == std::vector<int>{1, 4});
+	}
+
+	SECTION("k larger than the index") {
+		CHECK(index.search(comp6771::euclidean_vector{0, 0}, 10).size() == 4);
+		CHECK(index.search(comp6771::euclidean_vector{0, 0}, 0).empty());
+	}
+
+	SECTION("Queries can be expressions and views") {
+		auto const query = comp6771::euclidean_vector{1, 2};
+		CHECK(indices_of(index.search(query * 2 - query, 1)) == std::vector<int>{1});
+		CHECK(indices_of(index.search(index.vectors()[3], 1)) == std::vector<int>{3});
+	}
+
+	SECTION("Exceptions") {
+		CHECK_THROWS_MATCHES(index.search(comp6771::euclidean_vector{1, 2, 3}, 1),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(2) and RHS(3) do not match"));
+
+		CHECK_THROWS_MATCHES(index.search(comp6771::euclidean_vector{1, 2}, -1),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid number of neighbours -1"));
+
+		CHECK_THROWS_MATCHES(index.add(comp6771::euclidean_vector{1}),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(2) and RHS(1) do not match"));
+	}
+}
+
+TEST_CASE("Brute Force Matches Naive Search") {
+	auto const m = GENERATE(comp6771::metric::l2, comp6771::metric::inner_product, comp6771::metric::cosine);
+	auto const threads = GENERATE(1, 4);
+
+	auto pool = comp6771::thread_pool(threads);
+	auto const vectors = random_batch(5000, 13, 1);
+	auto const queries = random_batch(21, 13, 2);
+	auto const index = comp6771::brute_force_index(vectors, m);
+
+	SECTION("One query at a time") {
+		for (auto q = 0; q < queries.size(); ++q) {
+			CHECK(indices_of(index.search(queries[q], 10, pool))
+			      == naive_search(vectors, queries[q], 10, m));
+		}
+	}
+
+	SECTION("A batch of queries") {
+		auto const results = index.search(queries, 10, pool);
+
+		REQUIRE(results.size() == 21);
+		for (auto q = 0; q < queries.size(); ++q) {
+			CHECK(indices_of(results[static_cast<std::size_t>(q)])
+			      == naive_search(vectors, queries[q], 10, m));
+		}
+	}
+}
+
+TEST_CASE("Brute Force Far From The Origin") {
+	SECTION("Distances") {
+		auto index = comp6771::brute_force_index(2);
+		index.add(comp6771::euclidean_vector{1e8 + 1, 1e8});
+		index.add(comp6771::euclidean_vector{1e8 + 3, 1e8 + 4});
+
+		auto const result = index.search(comp6771::euclidean_vector{1e8, 1e8}, 2);
+		CHECK(indices_of(result) == std::vector<int>{0, 1});
+		CHECK(result[0].distance == 1);
+		CHECK(result[1].distance == 5);
+	}
+
+	SECTION("Ranking") {
+		auto vectors = random_batch(2000, 8, 3);
+		auto queries = random_batch(100, 8, 4);
+		for (auto* batch : {&vectors, &queries}) {
+			std::transform(batch->data(),
+			               batch->data() + batch->size() * batch->dimensions(),
+			               batch->data(),
+			               [](double const x) { return 1e6 + 0.01 * x; });
+		}
+		auto const index = comp6771::brute_force_index(vectors);
+
+		for (auto q = 0; q < queries.size(); ++q) {
+			CHECK(indices_of(index.search(queries[q], 5))
+			      == naive_search(vectors, queries[q], 5, comp6771::metric::l2));
+		}
+	}
+}
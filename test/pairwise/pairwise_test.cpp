@@ -0,0 +1,223 @@
+#include "comp6771/pairwise.hpp"
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <tuple>
+#include <vector>
+
+/*
+    Tests in this file test the matrices of dot products, squared distances and cosine
+    similarities between two sets of vectors.
+
+    These tests assume that euclidean_vector, euclidean_vector_batch, dot and euclidean_norm are
+    correct.
+
+    Rational: Every entry must match comparing the two vectors on their own, so results are
+    compared with that. Sizes are chosen so that the matrix has several blocks, partial tiles at
+    its edges, and vectors with more magnitudes than are packed at once. Symmetric inputs are only
+    half computed, so they must still give the whole matrix, exactly mirrored. Squared distances
+    between vectors far from the origin must not lose their precision to the size of the vectors.
+*/
+
+namespace {
+	auto random_vectors(int size, int dimensions, unsigned seed)
+	   -> std::vector<comp6771::euclidean_vector> {
+		auto engine = std::mt19937(seed);
+		auto distribution = std::uniform_real_distribution<double>(-1, 1);
+
+		auto vectors = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < size; ++i) {
+			auto v = comp6771::euclidean_vector(dimensions);
+			for (auto j = 0; j < dimensions; ++j) {
+				v[j] = distribution(engine);
+			}
+			vectors.push_back(v);
+		}
+		return vectors;
+	}
+
+	auto batch_of(std::vector<comp6771::euclidean_vector> const& vectors, int dimensions)
+	   -> comp6771::euclidean_vector_batch {
+		auto batch = comp6771::euclidean_vector_batch(dimensions);
+		for (auto const& v : vectors) {
+			batch.push_back(v);
+		}
+		return batch;
+	}
+
+	auto squared_distance(comp6771::euclidean_vector const& x, comp6771::euclidean_vector const& y)
+	   -> double {
+		auto const norm = comp6771::euclidean_norm(x - y);
+		return norm * norm;
+	}
+
+	auto cosine_similarity(comp6771::euclidean_vector const& x, comp6771::euclidean_vector const& y)
+	   -> double {
+		auto const norms = comp6771::euclidean_norm(x) * comp6771::euclidean_norm(y);
+		return norms == 0 ? 0 : comp6771::dot(x, y) / norms;
+	}
+
+	// Checks every entry of <result> against <f>(x[i], y[j])
+	template<typename F>
+	auto check_matrix(std::vector<comp6771::euclidean_vector> const& x,
+	                  std::vector<comp6771::euclidean_vector> const& y,
+	                  std::vector<double> const& result,
+	                  F f) -> void {
+		REQUIRE(result.size() == x.size() * y.size());
+		auto mismatches = 0;
+		for (auto i = std::size_t{0}; i < x.size(); ++i) {
+			for (auto j = std::size_t{0}; j < y.size(); ++j) {
+				if (result[i * y.size() + j] != Approx(f(x[i], y[j])).margin(1e-9)) {
+					++mismatches;
+				}
+			}
+		}
+		CHECK(mismatches == 0);
+	}
+
+	auto dot_product(comp6771::euclidean_vector const& x, comp6771::euclidean_vector const& y)
+	   -> double {
+		return comp6771::dot(x, y);
+	}
+} // namespace
+
+TEST_CASE("Pairwise Matrices") {
+	auto const [x_size, y_size, dimensions] = GENERATE(std::tuple{1, 1, 1},
+	                                                   std::tuple{7, 13, 5},
+	                                                   std::tuple{130, 257, 300});
+	auto const x = random_vectors(x_size, dimensions, 6771);
+	auto const y = random_vectors(y_size, dimensions, 1024);
+	auto result = std::vector<double>(x.size() * y.size());
+
+	SECTION("Dot products") {
+		comp6771::pairwise_dot(x, y, result);
+		check_matrix(x, y, result, dot_product);
+	}
+
+	SECTION("Squared distances") {
+		comp6771::pairwise_squared_distance(x, y, result);
+		check_matrix(x, y, result, squared_distance);
+	}
+
+	SECTION("Cosine similarities") {
+		comp6771::pairwise_cosine_similarity(x, y, result);
+		check_matrix(x, y, result, cosine_similarity);
+	}
+
+	SECTION("Batches give the same matrix") {
+		comp6771::pairwise_squared_distance(batch_of(x, dimensions), batch_of(y, dimensions), result);
+		check_matrix(x, y, result, squared_distance);
+	}
+
+	SECTION("On a given thread pool") {
+		auto pool = comp6771::thread_pool(3);
+		comp6771::pairwise_cosine_similarity(x, y, result, pool);
+		check_matrix(x, y, result, cosine_similarity);
+	}
+}
+
+TEST_CASE("Symmetric Matrices") {
+	auto const [size, dimensions] = GENERATE(std::tuple{5, 3}, std::tuple{300, 200});
+	auto const x = random_vectors(size, dimensions, 6771);
+	auto result = std::vector<double>(x.size() * x.size());
+
+	auto const check_symmetric = [&] {
+		auto mismatches = 0;
+		for (auto i = std::size_t{0}; i < x.size(); ++i) {
+			for (auto j = std::size_t{0}; j < x.size(); ++j) {
+				mismatches += result[i * x.size() + j] != result[j * x.size() + i] ? 1 : 0;
+			}
+		}
+		CHECK(mismatches == 0);
+	};
+
+	SECTION("Dot products") {
+		comp6771::pairwise_dot(x, x, result);
+		check_matrix(x, x, result, dot_product);
+		check_symmetric();
+	}
+
+	SECTION("Squared distances are 0 on the diagonal") {
+		comp6771::pairwise_squared_distance(x, x, result);
+		check_matrix(x, x, result, squared_distance);
+		check_symmetric();
+		for (auto i = std::size_t{0}; i < x.size(); ++i) {
+			CHECK(result[i * x.size() + i] == 0);
+		}
+	}
+
+	SECTION("Cosine similarities are 1 on the diagonal") {
+		comp6771::pairwise_cosine_similarity(x, x, result);
+		check_matrix(x, x, result, cosine_similarity);
+		check_symmetric();
+		for (auto i = std::size_t{0}; i < x.size(); ++i) {
+			CHECK(result[i * x.size() + i] == 1);
+		}
+	}
+
+	SECTION("The same batch") {
+		auto const batch = batch_of(x, dimensions);
+		comp6771::pairwise_dot(batch, batch, result);
+		check_matrix(x, x, result, dot_product);
+		check_symmetric();
+	}
+}
+
+TEST_CASE("Pairwise Edge Cases") {
+	SECTION("Vectors with no magnitude") {
+		auto const x = std::vector<comp6771::euclidean_vector>{{0, 0}, {3, 4}};
+		auto result = std::vector<double>(4);
+		comp6771::pairwise_cosine_similarity(x, x, result);
+		CHECK(result == std::vector<double>{0, 0, 0, 1});
+		comp6771::pairwise_squared_distance(x, x, result);
+		CHECK(result == std::vector<double>{0, 25, 25, 0});
+	}
+
+	SECTION("Vectors with no dimensions") {
+		auto const x = std::vector<comp6771::euclidean_vector>(3, comp6771::euclidean_vector(0));
+		auto const y = std::vector<comp6771::euclidean_vector>(2, comp6771::euclidean_vector(0));
+		auto result = std::vector<double>(6, -1);
+		comp6771::pairwise_dot(x, y, result);
+		CHECK(result == std::vector<double>(6, 0));
+	}
+
+	SECTION("No vectors") {
+		auto const x = std::vector<comp6771::euclidean_vector>();
+		auto const y = random_vectors(3, 2, 1);
+		auto result = std::vector<double>();
+		CHECK_NOTHROW(comp6771::pairwise_dot(x, y, result));
+		CHECK_NOTHROW(comp6771::pairwise_dot(y, x, result));
+	}
+
+	SECTION("Vectors far from the origin") {
+		auto const x = std::vector<comp6771::euclidean_vector>{{1e8 + 1, 1e8}, {1e8 + 3, 1e8 + 4}};
+		auto const y = std::vector<comp6771::euclidean_vector>{{1e8, 1e8}};
+		auto result = std::vector<double>(2);
+		comp6771::pairwise_squared_distance(x, y, result);
+		CHECK(result == std::vector<double>{1, 25});
+
+		auto symmetric = std::vector<double>(4);
+		comp6771::pairwise_squared_distance(x, x, symmetric);
+		CHECK(symmetric == std::vector<double>{0, 20, 20, 0});
+	}
+
+	SECTION("The result must fit the matrix") {
+		auto const x = random_vectors(3, 2, 1);
+		auto result = std::vector<double>(8);
+		CHECK_THROWS_WITH(comp6771::pairwise_dot(x, x, result),
+		                  "Size of result(8) does not match LHS(3) times RHS(3)");
+	}
+
+	SECTION("Vectors must have the same dimensions") {
+		auto const x = random_vectors(3, 2, 1);
+		auto y = random_vectors(2, 2, 1);
+		y.emplace_back(3);
+		auto result = std::vector<double>(9);
+		CHECK_THROWS_AS(comp6771::pairwise_dot(x, y, result), comp6771::euclidean_vector_error);
+		auto empty = std::vector<double>();
+		CHECK_THROWS_AS(comp6771::pairwise_dot(batch_of(x, 2), comp6771::euclidean_vector_batch(3), empty),
+		                comp6771::euclidean_vector_error);
+	}
+}
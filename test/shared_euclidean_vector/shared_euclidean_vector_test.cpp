@@ -0,0 +1,189 @@
+#include "comp6771/shared_euclidean_vector.hpp"
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <memory_resource>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+    Tests in this file test shared_euclidean_vector, whose copies share their magnitudes until one
+    of them is changed.
+
+    These tests assume that euclidean_vector is correct.
+
+    Rational: Copies must share magnitudes (checked through data() and is_shared()), and every way
+    of changing a vector must first stop sharing, so that the change is never seen through another
+    copy, even one made after a reference to the magnitude was taken. Reading must not stop
+    sharing. Copies are changed from several threads at once to check the reference count, which is
+    most useful when run under ThreadSanitizer.
+*/
+
+TEST_CASE("Shared Constructors") {
+	auto const v = comp6771::shared_euclidean_vector{1, 2, 3, 4, 5};
+	CHECK(v.dimensions() == 5);
+	CHECK(v[4] == 5);
+	CHECK_FALSE(v.is_shared());
+
+	CHECK(comp6771::shared_euclidean_vector().dimensions() == 1);
+	CHECK(comp6771::shared_euclidean_vector(3, 1.5) == comp6771::shared_euclidean_vector{1.5, 1.5, 1.5});
+	CHECK(comp6771::shared_euclidean_vector(0).data() == nullptr);
+
+	SECTION("From euclidean_vectors and expressions") {
+		auto const ev = comp6771::euclidean_vector{1, 2, 3};
+		auto const from_ev = comp6771::shared_euclidean_vector(ev);
+		CHECK(from_ev == comp6771::shared_euclidean_vector{1, 2, 3});
+
+		auto const from_expression = comp6771::shared_euclidean_vector(ev + from_ev * 2);
+		CHECK(from_expression == comp6771::shared_euclidean_vector{3, 6, 9});
+		CHECK(comp6771::euclidean_vector(from_expression) == comp6771::euclidean_vector{3, 6, 9});
+	}
+
+	SECTION("Magnitudes come from the given memory resource") {
+		auto arena = std::pmr::monotonic_buffer_resource();
+		auto const in_arena = comp6771::shared_euclidean_vector(8, 1.0, &arena);
+		auto const copy = in_arena;
+		CHECK(copy.get_allocator().resource() == &arena);
+	}
+}
+
+TEST_CASE("Copies Share Until Changed") {
+	auto const original = comp6771::shared_euclidean_vector{1, 2, 3, 4, 5};
+	auto copy = original;
+	CHECK(copy.data() == original.data());
+	CHECK(original.is_shared());
+	CHECK(copy == original);
+
+	auto const plus = +original;
+	CHECK(plus.data() == original.data());
+
+	SECTION("operator[]") {
+		copy[0] = 10;
+		CHECK(copy.data() != original.data());
+		CHECK(original[0] == 1);
+		CHECK(copy[0] == 10);
+		CHECK_FALSE(copy.is_shared());
+
+		// No longer shared, so changed in place
+		auto const* const data = copy.data();
+		copy[1] = 20;
+		CHECK(copy.data() == data);
+	}
+
+	SECTION("Reading through the mutable operator[] and at() still shares") {
+		auto sum = 0.0;
+		for (auto i = 0; i < copy.dimensions(); ++i) {
+			sum += copy[i];
+		}
+		sum += copy.at(0);
+		CHECK(sum == 16);
+		CHECK(copy.data() == original.data());
+		CHECK(copy.is_shared());
+	}
+
+	SECTION("A reference taken before a copy does not change the copy") {
+		auto reference = copy[0];
+		auto later = copy;
+		reference = 42;
+		CHECK(copy[0] == 42);
+		CHECK(later[0] == 1);
+		CHECK(later.data() == original.data());
+
+		auto at = later.at(1);
+		auto const last = later;
+		at += 10;
+		CHECK(later[1] == 12);
+		CHECK(last[1] == 2);
+	}
+
+	SECTION("at") {
+		copy.at(4) = -1;
+		CHECK(original[4] == 5);
+		CHECK_THROWS_MATCHES(copy.at(5),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Index 5 is not valid for this euclidean_vector "
+		                                              "object"));
+	}
+
+	SECTION("Compound assignment") {
+		copy += original;
+		CHECK(copy == comp6771::shared_euclidean_vector{2, 4, 6, 8, 10});
+		copy -= comp6771::euclidean_vector{1, 1, 1, 1, 1};
+		copy *= 2;
+		copy /= 4;
+		CHECK(copy == comp6771::shared_euclidean_vector{0.5, 1.5, 2.5, 3.5, 4.5});
+		CHECK(original == comp6771::shared_euclidean_vector{1, 2, 3, 4, 5});
+
+		CHECK_THROWS_MATCHES(copy /= 0,
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid vector division by 0"));
+	}
+
+	SECTION("Adding a vector to itself") {
+		copy += copy;
+		CHECK(copy == comp6771::shared_euclidean_vector{2, 4, 6, 8, 10});
+		copy -= copy * 0.5;
+		CHECK(copy == comp6771::shared_euclidean_vector{1, 2, 3, 4, 5});
+		CHECK(original[0] == 1);
+	}
+
+	SECTION("Assignment") {
+		auto other = comp6771::shared_euclidean_vector{9};
+		other = original;
+		CHECK(other.data() == original.data());
+		other = std::move(copy);
+		CHECK(other.data() == original.data());
+		CHECK(copy.dimensions() == 0);
+	}
+}
+
+TEST_CASE("Shared Vectors In Expressions") {
+	auto const x = comp6771::shared_euclidean_vector{3, 4};
+	auto const y = x;
+
+	CHECK(comp6771::euclidean_norm(x) == 5);
+	CHECK(comp6771::dot(x, y) == 25);
+	CHECK(comp6771::euclidean_vector(x - y * 2) == comp6771::euclidean_vector{-3, -4});
+	CHECK(unit(x) == comp6771::shared_euclidean_vector{0.6, 0.8});
+	CHECK(x == comp6771::const_euclidean_vector_view(comp6771::euclidean_vector{3, 4}));
+
+	auto oss = std::ostringstream{};
+	oss << x;
+	CHECK(oss.str() == "[3 4]");
+
+	CHECK_THROWS_MATCHES(unit(comp6771::shared_euclidean_vector(2)),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("euclidean_vector with zero euclidean normal does "
+	                                              "not have a unit vector"));
+}
+
+TEST_CASE("Copies Are Changed From Several Threads") {
+	auto const original = comp6771::shared_euclidean_vector(1000, 1.0);
+
+	auto results = std::vector<comp6771::shared_euclidean_vector>(8, original);
+	auto threads = std::vector<std::thread>();
+	for (auto t = std::size_t{0}; t < results.size(); ++t) {
+		threads.emplace_back([&original, &result = results[t], t] {
+			for (auto i = 0; i < 100; ++i) {
+				auto copy = original;
+				copy[i] = static_cast<double>(t);
+				result = std::move(copy);
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	for (auto t = std::size_t{0}; t < results.size(); ++t) {
+		CHECK(results[t][99] == static_cast<double>(t));
+		CHECK(results[t][98] == 1.0);
+	}
+	CHECK(original == comp6771::shared_euclidean_vector(1000, 1.0));
+	CHECK_FALSE(original.is_shared());
+}
@@ -0,0 +1,180 @@
+#include "comp6771/sparse_euclidean_vector.hpp"
+
+#include "comp6771/euclidean_vector.hpp"
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+/*
+    Tests in this file test sparse_euclidean_vector, the euclidean vector that stores only its
+    non-zero magnitudes.
+
+    These tests assume that euclidean_vector is correct, and most expected values are computed by
+    converting to it.
+
+    Rational: Every operation must give the same result as on the dense vector, and must keep the
+    indices sorted and free of zeros, since the merges depend on it. The sparse-sparse dot product
+    is checked both when the vectors have similar numbers of non-zeros, which merges, and when one
+    has far more, which gallops.
+*/
+
+namespace {
+	// About <density> of <dimensions> magnitudes are non-zero
+	auto make_sparse(int dimensions, double density, std::uint_fast32_t seed)
+	   -> comp6771::sparse_euclidean_vector {
+		auto engine = std::mt19937(seed);
+		auto chosen = std::bernoulli_distribution(density);
+		auto magnitude = std::uniform_real_distribution<double>(-1, 1);
+
+		auto indices = std::vector<int>();
+		auto magnitudes = std::vector<double>();
+		for (auto i = dimensions - 1; i >= 0; --i) {
+			if (chosen(engine)) {
+				indices.push_back(i);
+				magnitudes.push_back(magnitude(engine));
+			}
+		}
+		return comp6771::sparse_euclidean_vector(dimensions, indices, magnitudes);
+	}
+
+	auto is_normalised(comp6771::sparse_euclidean_vector const& v) -> bool {
+		auto const indices = v.indices();
+		auto const magnitudes = v.magnitudes();
+		for (auto i = std::size_t{0}; i < indices.size(); ++i) {
+			if (magnitudes[i] == 0 or (i > 0 and indices[i - 1] >= indices[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+} // namespace
+
+TEST_CASE("Sparse Constructors") {
+	SECTION("Default constructor has one dimension") {
+		auto const v = comp6771::sparse_euclidean_vector();
+		CHECK(v.dimensions() == 1);
+		CHECK(v.non_zeros() == 0);
+		CHECK(v[0] == 0);
+	}
+
+	SECTION("Pairs in any order, with zeros dropped") {
+		auto const v = comp6771::sparse_euclidean_vector(1000000, {{999999, 2.5}, {7, -1}, {30, 0}});
+		CHECK(v.dimensions() == 1000000);
+		CHECK(v.non_zeros() == 2);
+		CHECK(is_normalised(v));
+		CHECK(v[7] == -1);
+		CHECK(v[30] == 0);
+		CHECK(v.at(999999) == 2.5);
+	}
+
+	SECTION("Invalid indices") {
+		CHECK_THROWS_MATCHES(comp6771::sparse_euclidean_vector(3, {{3, 1.0}}),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Index 3 is not valid for this "
+		                                              "sparse_euclidean_vector object"));
+		CHECK_THROWS_MATCHES(comp6771::sparse_euclidean_vector(3, {{1, 1.0}, {1, 2.0}}),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Index 1 is given more than once"));
+		CHECK_THROWS_MATCHES(comp6771::sparse_euclidean_vector(3, {0, 1}, {1.0}),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Numbers of indices(2) and magnitudes(1) do "
+		                                              "not match"));
+		CHECK_THROWS_MATCHES(comp6771::sparse_euclidean_vector(3).at(-1),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Index -1 is not valid for this "
+		                                              "sparse_euclidean_vector object"));
+	}
+
+	SECTION("Conversions to and from euclidean_vector") {
+		auto const dense = comp6771::euclidean_vector{0, 1.5, 0, 0, -2, 0};
+		auto const sparse = comp6771::sparse_euclidean_vector(dense);
+		CHECK(sparse.non_zeros() == 2);
+		CHECK(sparse == comp6771::sparse_euclidean_vector(6, {{1, 1.5}, {4, -2}}));
+		CHECK(static_cast<comp6771::euclidean_vector>(sparse) == dense);
+	}
+}
+
+TEST_CASE("Sparse Arithmetic Matches Dense") {
+	auto const x = make_sparse(5000, 0.02, 1);
+	auto const y = make_sparse(5000, 0.02, 2);
+	auto const dense_x = static_cast<comp6771::euclidean_vector>(x);
+	auto const dense_y = static_cast<comp6771::euclidean_vector>(y);
+
+	auto const check = [](comp6771::sparse_euclidean_vector const& v,
+	                      comp6771::euclidean_vector const& expected) {
+		CHECK(is_normalised(v));
+		CHECK(static_cast<comp6771::euclidean_vector>(v) == expected);
+	};
+
+	check(x + y, dense_x + dense_y);
+	check(x - y, dense_x - dense_y);
+	check(-x, -dense_x);
+	check(+x, dense_x);
+	check(x * 3, dense_x * 3);
+	check(3 * x, dense_x * 3);
+	check(x / 4, dense_x / 4);
+	check(x - x, comp6771::euclidean_vector(5000));
+	check(x * 0, comp6771::euclidean_vector(5000));
+
+	CHECK(x + dense_y == dense_x + dense_y);
+	CHECK(dense_y + x == dense_x + dense_y);
+	CHECK(x - dense_y == dense_x - dense_y);
+	CHECK(dense_y - x == dense_y - dense_x);
+
+	CHECK(euclidean_norm(x) == Approx(comp6771::euclidean_norm(dense_x)));
+	check(unit(x), comp6771::unit(dense_x));
+
+	CHECK_THROWS_MATCHES(x / 0,
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Invalid vector division by 0"));
+	CHECK_THROWS_MATCHES(x + comp6771::sparse_euclidean_vector(4),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(5000) and RHS(4) do not match"));
+	CHECK_THROWS_MATCHES(unit(comp6771::sparse_euclidean_vector(4)),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("euclidean_vector with zero euclidean normal does "
+	                                              "not have a unit vector"));
+}
+
+TEST_CASE("Sparse Dot Products") {
+	auto const dimensions = 100000;
+	auto const x = make_sparse(dimensions, 0.01, 3);
+	auto const dense_x = static_cast<comp6771::euclidean_vector>(x);
+
+	SECTION("Similar numbers of non-zeros are merged") {
+		auto const y = make_sparse(dimensions, 0.02, 4);
+		auto const expected = comp6771::dot(dense_x, static_cast<comp6771::euclidean_vector>(y));
+		CHECK(dot(x, y) == Approx(expected));
+		CHECK(dot(y, x) == Approx(expected));
+	}
+
+	SECTION("Very different numbers of non-zeros gallop") {
+		auto const y = make_sparse(dimensions, 0.0002, 5);
+		REQUIRE(y.non_zeros() * 16 < x.non_zeros());
+		auto const expected = comp6771::dot(dense_x, static_cast<comp6771::euclidean_vector>(y));
+		CHECK(dot(x, y) == Approx(expected));
+		CHECK(dot(y, x) == Approx(expected));
+
+		// Shares every index with x
+		auto const z = comp6771::sparse_euclidean_vector(dimensions,
+		                                                 {{x.indices()[0], 2.0}, {x.indices().back(), -1.0}});
+		CHECK(dot(z, x) == Approx(2 * x.magnitudes()[0] - x.magnitudes().back()));
+	}
+
+	SECTION("Sparse with dense") {
+		auto const y = comp6771::euclidean_vector(dimensions, 0.5);
+		auto const expected = comp6771::dot(dense_x, y);
+		CHECK(dot(x, y) == Approx(expected));
+		CHECK(dot(y, x) == Approx(expected));
+	}
+
+	SECTION("No non-zeros") {
+		auto const zero = comp6771::sparse_euclidean_vector(dimensions);
+		CHECK(dot(x, zero) == 0);
+		CHECK(dot(zero, comp6771::euclidean_vector(dimensions, 1.0)) == 0);
+		CHECK(euclidean_norm(zero) == 0);
+	}
+}
@@ -0,0 +1,107 @@
+#include "comp6771/spatial_index.hpp"
+#include "comp6771/testing/random_batch.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <vector>
+
+/*
+    Tests in this file test spatial_index, which finds exact euclidean nearest neighbours with a
+    kd_tree or ball_tree.
+
+    These tests assume that brute_force_index is correct.
+
+    Rational: Both trees must give exactly the same results as brute_force_index, including the
+    order of ties, so results are compared with it. Enough vectors are used that the tree is
+    several levels deep, and that the top of the tree is built in parallel.
+*/
+
+namespace {
+	using comp6771::testing::random_batch;
+
+	auto indices_of(std::vector<comp6771::neighbour> const& neighbours) -> std::vector<int> {
+		auto indices = std::vector<int>();
+		for (auto const& n : neighbours) {
+			indices.push_back(n.index);
+		}
+		return indices;
+	}
+} // namespace
+
+TEST_CASE("Spatial Index Small") {
+	auto const partitioning =
+	   GENERATE(comp6771::spatial_partitioning::kd_tree, comp6771::spatial_partitioning::ball_tree);
+
+	auto const vectors = std::vector<comp6771::euclidean_vector>{{3, 4}, {1, 0}, {0, 0}, {-2, 0}, {1, 0}};
+	auto const index = comp6771::spatial_index(vectors, partitioning);
+
+	CHECK(index.size() == 5);
+	CHECK(index.dimensions() == 2);
+	CHECK(index.partitioning() == partitioning);
+
+	SECTION("Nearest") {
+		auto const nearest = index.nearest(comp6771::euclidean_vector{3, 3});
+
+		CHECK(nearest.index == 0);
+		CHECK(nearest.distance == Approx(1));
+	}
+
+	SECTION("k nearest, ties broken by the smaller index") {
+		CHECK(indices_of(index.search(comp6771::euclidean_vector{1, 0}, 3)) == std::vector<int>{1, 4, 2});
+		CHECK(index.search(comp6771::euclidean_vector{1, 0}, 10).size() == 5);
+		CHECK(index.search(comp6771::euclidean_vector{1, 0}, 0).empty());
+	}
+
+	SECTION("Radius") {
+		auto const within = index.radius_search(comp6771::euclidean_vector{0, 0}, 2);
+
+		CHECK(indices_of(within) == std::vector<int>{2, 1, 4, 3});
+		CHECK(within.back().distance == Approx(2));
+		CHECK(index.radius_search(comp6771::euclidean_vector{10, 10}, 1).empty());
+	}
+
+	SECTION("Exceptions") {
+		CHECK_THROWS_MATCHES(index.nearest(comp6771::euclidean_vector{1, 2, 3}),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(2) and RHS(3) do not match"));
+
+		CHECK_THROWS_MATCHES(index.search(comp6771::euclidean_vector{1, 2}, -1),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid number of neighbours -1"));
+
+		CHECK_THROWS_MATCHES(index.radius_search(comp6771::euclidean_vector{1, 2}, -1),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid radius -1.000000"));
+
+		auto const empty = comp6771::spatial_index(comp6771::euclidean_vector_batch(2));
+		CHECK_THROWS_MATCHES(empty.nearest(comp6771::euclidean_vector{1, 2}),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("spatial_index is empty"));
+	}
+}
+
+TEST_CASE("Spatial Index Matches Brute Force") {
+	auto const partitioning =
+	   GENERATE(comp6771::spatial_partitioning::kd_tree, comp6771::spatial_partitioning::ball_tree);
+	auto const dimensions = GENERATE(2, 7, 16);
+
+	auto pool = comp6771::thread_pool(4);
+	auto const vectors = random_batch(20000, dimensions, 1);
+	auto const queries = random_batch(20, dimensions, 2);
+	auto const exact = comp6771::brute_force_index(vectors);
+	auto const index = comp6771::spatial_index(vectors, partitioning, pool);
+
+	for (auto q = 0; q < queries.size(); ++q) {
+		CHECK(indices_of(index.search(queries[q], 10)) == indices_of(exact.search(queries[q], 10)));
+
+		// Radius of the 50th nearest, so about 50 vectors are within it
+		auto const radius = exact.search(queries[q], 50).back().distance;
+		auto const within = index.radius_search(queries[q], radius);
+		CHECK(within.size() >= 49);
+		CHECK(std::all_of(within.begin(), within.end(), [radius](auto const& n) {
+			return n.distance <= radius;
+		}));
+		CHECK(indices_of(within) == indices_of(exact.search(queries[q], static_cast<int>(within.size()))));
+	}
+}
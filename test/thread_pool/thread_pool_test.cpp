@@ -0,0 +1,72 @@
+#include "comp6771/thread_pool.hpp"
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+/*
+    Tests in this file test that thread_pool::parallel_for calls the body exactly once for every
+    index, whatever the number of workers.
+
+    Rational: The order and the thread each index runs on are not observable through the
+    interface, so the tests only check that each index was visited once, that nesting works, and
+    that exceptions reach the caller.
+*/
+
+TEST_CASE("Thread Pool") {
+	auto const threads = GENERATE(1, 3, 8);
+	auto pool = comp6771::thread_pool(threads);
+
+	CHECK(pool.size() == threads);
+
+	SECTION("Every index is visited once") {
+		auto visits = std::vector<std::atomic<int>>(1000);
+		pool.parallel_for(visits.size(), [&visits](std::size_t const i) { ++visits[i]; });
+
+		CHECK(std::all_of(visits.begin(), visits.end(), [](auto const& v) { return v == 1; }));
+	}
+
+	SECTION("No indices") {
+		auto calls = 0;
+		pool.parallel_for(0, [&calls](std::size_t) { ++calls; });
+
+		CHECK(calls == 0);
+	}
+
+	SECTION("The pool is reused") {
+		auto sum = std::atomic<std::size_t>(0);
+		for (auto round = 0; round < 50; ++round) {
+			pool.parallel_for(10, [&sum](std::size_t const i) { sum += i; });
+		}
+
+		CHECK(sum == 50 * 45);
+	}
+
+	SECTION("Nested parallel_for") {
+		auto sum = std::atomic<std::size_t>(0);
+		pool.parallel_for(8, [&](std::size_t) {
+			pool.parallel_for(8, [&sum](std::size_t const j) { sum += j; });
+		});
+
+		CHECK(sum == 8 * 28);
+	}
+
+	SECTION("Exceptions reach the caller") {
+		CHECK_THROWS_MATCHES(pool.parallel_for(100,
+		                                       [](std::size_t const i) {
+			                                       if (i == 42) {
+				                                       throw std::runtime_error("42");
+			                                       }
+		                                       }),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("42"));
+	}
+}
+
+TEST_CASE("Default Thread Pool") {
+	CHECK(comp6771::default_thread_pool().size() >= 1);
+	CHECK(&comp6771::default_thread_pool() == &comp6771::default_thread_pool());
+}
@@ -0,0 +1,171 @@
+#include "comp6771/vector_file.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+    Tests in this file test writing vector files and mapping them back into memory.
+
+    These tests assume that euclidean_vector_batch and const_euclidean_vector_view are correct.
+
+    Rational: The format is read without parsing, so the tests check that rows come back exactly
+    as written, including dimensions that do not fill a 64 byte line, and that every kind of
+    damaged or foreign file is rejected when it is opened rather than read out of bounds later.
+*/
+
+namespace {
+	auto make_batch(int size, int dimensions) -> comp6771::euclidean_vector_batch {
+		auto batch = comp6771::euclidean_vector_batch(size, dimensions, 0.0);
+		for (auto v = 0; v < size; ++v) {
+			for (auto i = 0; i < dimensions; ++i) {
+				batch[v][i] = v * 0.5 - i;
+			}
+		}
+		return batch;
+	}
+
+	// Overwrites <bytes> at <offset> in the file at <path>
+	auto patch(std::string const& path, std::streamoff offset, std::vector<char> const& bytes) -> void {
+		auto file = std::fstream(path, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(offset);
+		file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	}
+} // namespace
+
+TEST_CASE("Vector File Round Trip") {
+	auto const path = std::string("vector_file_test.bin");
+
+	SECTION("Rows are read back exactly") {
+		for (auto const dimensions : {1, 3, 8, 13}) {
+			auto const batch = make_batch(50, dimensions);
+			comp6771::write_vector_file(path, batch);
+
+			auto const file = comp6771::mapped_vector_file(path);
+			REQUIRE(file.size() == 50);
+			REQUIRE(file.dimensions() == dimensions);
+			CHECK(file.stride() % 8 == 0);
+			CHECK(file.stride() >= static_cast<std::size_t>(dimensions));
+			for (auto v = 0; v < file.size(); ++v) {
+				CHECK(file[v] == batch[v]);
+				CHECK(reinterpret_cast<std::uintptr_t>(file[v].data()) % 64 == 0);
+			}
+		}
+	}
+
+	SECTION("Rows work in expressions without copying") {
+		comp6771::write_vector_file(path, make_batch(3, 2));
+		auto const file = comp6771::mapped_vector_file(path);
+
+		CHECK(file[1] == comp6771::euclidean_vector{0.5, -0.5});
+		CHECK(file[1] != file[2]);
+		CHECK(comp6771::dot(file[1], file[2]) == Approx(0.5 * 1.0 + -0.5 * 0.0));
+		CHECK(comp6771::euclidean_norm(file[2]) == Approx(1.0));
+		CHECK(comp6771::euclidean_vector(file[1] + file[2]) == comp6771::euclidean_vector{1.5, -0.5});
+		CHECK(file.at(2).at(0) == 1.0);
+	}
+
+	SECTION("Writing one row at a time") {
+		{
+			auto writer = comp6771::vector_file_writer(path, 3);
+			writer.push_back(comp6771::euclidean_vector{1, 2, 3});
+			writer.push_back(comp6771::euclidean_vector{4, 5, 6} * 2);
+			CHECK(writer.size() == 2);
+			CHECK_THROWS_MATCHES(writer.push_back(comp6771::euclidean_vector{1, 2}),
+			                     comp6771::euclidean_vector_error,
+			                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not match"));
+		}
+
+		auto const file = comp6771::mapped_vector_file(path);
+		REQUIRE(file.size() == 2);
+		CHECK(file[0] == comp6771::euclidean_vector{1, 2, 3});
+		CHECK(file[1] == comp6771::euclidean_vector{8, 10, 12});
+	}
+
+	SECTION("Empty files") {
+		comp6771::write_vector_file(path, comp6771::euclidean_vector_batch(4));
+		auto const file = comp6771::mapped_vector_file(path);
+		CHECK(file.empty());
+		CHECK(file.dimensions() == 4);
+	}
+
+	SECTION("Moving keeps the mapping") {
+		comp6771::write_vector_file(path, make_batch(5, 4));
+		auto file = comp6771::mapped_vector_file(path);
+		auto const row = file[4];
+
+		auto moved = std::move(file);
+		CHECK(moved.size() == 5);
+		CHECK(moved[4].data() == row.data());
+
+		file = std::move(moved);
+		CHECK(file.size() == 5);
+		CHECK(file[4] == row);
+		file.advise(comp6771::access_pattern::sequential);
+	}
+
+	std::remove(path.c_str());
+}
+
+TEST_CASE("Vector File Exceptions") {
+	auto const path = std::string("vector_file_exceptions_test.bin");
+	comp6771::write_vector_file(path, make_batch(4, 3));
+
+	SECTION("Missing file") {
+		CHECK_THROWS_MATCHES(comp6771::mapped_vector_file("no_such_vector_file.bin"),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Cannot read vector file no_such_vector_file.bin"));
+	}
+
+	SECTION("Index out of range") {
+		auto const file = comp6771::mapped_vector_file(path);
+		CHECK_THROWS_MATCHES(file.at(4),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Index 4 is not valid for this mapped_vector_file object"));
+	}
+
+	SECTION("Wrong magic") {
+		patch(path, 0, {'X'});
+		CHECK_THROWS_MATCHES(comp6771::mapped_vector_file(path),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Cannot read vector file " + path));
+	}
+
+	SECTION("Newer version") {
+		patch(path, 8, {2, 0, 0, 0});
+		CHECK_THROWS_MATCHES(comp6771::mapped_vector_file(path),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Unsupported vector file version 2 in " + path));
+	}
+
+	SECTION("Other byte order") {
+		patch(path, 12, {1, 2, 3, 4});
+		CHECK_THROWS_AS(comp6771::mapped_vector_file(path), comp6771::euclidean_vector_error);
+	}
+
+	SECTION("Truncated") {
+		{
+			auto out = std::ofstream(path, std::ios::binary);
+			auto const header = std::vector<char>(40);
+			out.write(header.data(), static_cast<std::streamsize>(header.size()));
+		}
+		CHECK_THROWS_AS(comp6771::mapped_vector_file(path), comp6771::euclidean_vector_error);
+	}
+
+	SECTION("More rows than the file holds") {
+		patch(path, 32, {5});
+		CHECK_THROWS_AS(comp6771::mapped_vector_file(path), comp6771::euclidean_vector_error);
+	}
+
+	SECTION("Unwritable path") {
+		CHECK_THROWS_MATCHES(comp6771::vector_file_writer("no_such_directory/file.bin", 3),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Cannot write vector file no_such_directory/file.bin"));
+	}
+
+	std::remove(path.c_str());
+}